@@ -0,0 +1,93 @@
+//
+// Copyright (C) 2013 Jacob McIntosh <nacitar at ubercpp dot com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+/// @file arithmetic_benchmark.cc
+/// @brief Compares the array kernels of arithmetic.h against a loop that
+/// clamps with branches.
+
+#include <random>
+#include <string>
+#include <vector>
+#include "nx/arithmetic.h"
+#include "nx/to_string.h"
+#include "benchmark/benchmark.h"
+
+namespace {
+
+/// @brief Adds in a wider type and clamps the sum with comparisons.
+template <class T>
+void BranchLoop(const std::vector<T>&lhs, const std::vector<T>&rhs,
+                std::vector<T>*result) {
+  const nx::int64_t max = nx::detail::MaximumValue<T>();
+  const nx::int64_t min = nx::detail::MinimumValue<T>();
+  for (nx::size_t i = 0; i < lhs.size(); ++i) {
+    const nx::int64_t sum = static_cast<nx::int64_t>(lhs[i]) + rhs[i];
+    (*result)[i] = static_cast<T>(sum > max ? max : sum < min ? min : sum);
+  }
+}
+
+template <class T>
+void BenchmarkKernels(const char*type, nx::size_t bytes) {
+  using nx::detail::SaturatingKernel;
+  const struct {
+    SaturatingKernel kernel;
+    const char*name;
+  } kernels[] = {
+    { SaturatingKernel::kScalar, "scalar" },
+    { SaturatingKernel::kSse2, "sse2" },
+    { SaturatingKernel::kAvx2, "avx2" }
+  };
+  std::mt19937_64 random;
+  std::vector<T> lhs(bytes / sizeof(T));
+  std::vector<T> rhs(lhs.size());
+  for (nx::size_t i = 0; i < lhs.size(); ++i) {
+    lhs[i] = static_cast<T>(random());
+    rhs[i] = static_cast<T>(random());
+  }
+  std::vector<T> result(lhs.size());
+  const std::string suffix =
+      std::string(" ") + type + " (" + nx::ToString(bytes / 1024) + "KiB)";
+  if (sizeof(T) < 8) {
+    benchmark::Report("branches" + suffix, benchmark::Measure([&] {
+      BranchLoop(lhs, rhs, &result);
+      benchmark::Consume(result[0]);
+    }), static_cast<double>(bytes), "byte");
+  }
+  for (const auto&entry : kernels) {
+    if (!nx::detail::SaturatingSupported(entry.kernel)) {
+      continue;
+    }
+    benchmark::Report(entry.name + suffix, benchmark::Measure([&] {
+      nx::detail::SaturatingAddBuffer(
+          entry.kernel, lhs.data(), rhs.data(), result.data(), lhs.size(),
+          sizeof(T), nx::IsSigned<T>::value);
+      benchmark::Consume(result[0]);
+    }), static_cast<double>(bytes), "byte");
+  }
+}
+
+}  // namespace
+
+int main() {
+  for (nx::size_t bytes : { 4096u, 1048576u }) {
+    BenchmarkKernels<nx::uint8_t>("uint8", bytes);
+    BenchmarkKernels<nx::int16_t>("int16", bytes);
+    BenchmarkKernels<nx::int32_t>("int32", bytes);
+    BenchmarkKernels<nx::uint64_t>("uint64", bytes);
+    BenchmarkKernels<nx::int64_t>("int64", bytes);
+  }
+  return 0;
+}
@@ -0,0 +1,104 @@
+//
+// Copyright (C) 2013 Jacob McIntosh <nacitar at ubercpp dot com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+/// @file benchmark.h
+/// @brief Minimal timing helpers shared by the benchmark executables.
+
+#ifndef BENCHMARK_BENCHMARK_H_
+#define BENCHMARK_BENCHMARK_H_
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+/// @brief Benchmark helpers; not part of the library.
+namespace benchmark {
+
+/// @brief Storage the optimizer must assume is observed.
+template <class T>
+class Sink {
+ public:
+  /// @brief The last value consumed.
+  static volatile T value;
+};
+
+template <class T>
+volatile T Sink<T>::value;
+
+/// @brief Stores a value somewhere the optimizer must assume is observed, so
+/// that the computation producing it is not discarded.
+template <class T>
+void Consume(T value) {
+  Sink<T>::value = value;
+}
+
+/// @brief Makes the optimizer assume the pointed-to object may be read and
+/// modified here, so that computations on it are not hoisted out of the
+/// measured loop.
+inline void Escape(const void*pointer) {
+#if defined(__GNUC__)
+  __asm__ __volatile__("" : : "g"(pointer) : "memory");
+#else
+  Sink<const void*>::value = pointer;
+#endif
+}
+
+/// @brief Calls the function repeatedly until roughly the requested time has
+/// passed.
+///
+/// @param function The operation to measure.
+/// @param milliseconds The minimum time to spend measuring.
+///
+/// @return The average number of nanoseconds taken per call.
+template <class Function>
+double Measure(Function function, unsigned int milliseconds = 200) {
+  typedef std::chrono::steady_clock Clock;
+  const Clock::duration budget = std::chrono::milliseconds(milliseconds);
+  // warm up caches and any lazily selected kernels
+  function();
+  unsigned long long calls = 0;  // NOLINT(runtime/int)
+  const Clock::time_point start = Clock::now();
+  Clock::duration elapsed;
+  do {
+    for (unsigned int i = 0; i < 16; ++i) {
+      function();
+    }
+    calls += 16;
+    elapsed = Clock::now() - start;
+  } while (elapsed < budget);
+  return std::chrono::duration<double, std::nano>(elapsed).count() / calls;
+}
+
+/// @brief Prints a line describing a measurement.
+///
+/// @param name The name of what was measured.
+/// @param nanoseconds The nanoseconds taken per call.
+/// @param items The number of items processed per call.
+/// @param unit The name of an item.
+inline void Report(
+    const std::string&name, double nanoseconds,
+    double items = 1, const std::string&unit = "op") {
+  std::cout << std::left << std::setw(40) << name << std::right
+      << std::fixed << std::setprecision(3)
+      << std::setw(14) << nanoseconds << " ns/call"
+      << std::setw(12) << (nanoseconds / items) << " ns/" << unit
+      << std::endl;
+}
+
+}  // namespace benchmark
+
+#endif  // BENCHMARK_BENCHMARK_H_
@@ -0,0 +1,100 @@
+//
+// Copyright (C) 2013 Jacob McIntosh <nacitar at ubercpp dot com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+/// @file bit_array_benchmark.cc
+/// @brief Compares BitArray against std::bitset for the operations used on
+/// per-shard feature masks.
+
+#include <bitset>
+#include <random>
+#include <string>
+#include "nx/bit_array.h"
+#include "nx/to_string.h"
+#include "benchmark/benchmark.h"
+
+namespace {
+
+template <unsigned int kBits>
+void Benchmark(unsigned int one_in) {
+  std::mt19937 random;
+  nx::BitArray<kBits> a, b;
+  std::bitset<kBits> c, d;
+  for (unsigned int i = 0; i < kBits; ++i) {
+    if (random() % one_in == 0) {
+      a.Set(i);
+      c.set(i);
+    }
+    if (random() % 2 == 0) {
+      b.Set(i);
+      d.set(i);
+    }
+  }
+  const std::string suffix = " (" + nx::ToString(kBits) + " bits, 1/" +
+      nx::ToString(one_in) + " set)";
+  const double bits = kBits;
+
+  benchmark::Report("bitset count" + suffix, benchmark::Measure([&] {
+    benchmark::Escape(&c);
+    benchmark::Consume(c.count());
+  }), bits, "bit");
+  benchmark::Report("BitArray count" + suffix, benchmark::Measure([&] {
+    benchmark::Escape(&a);
+    benchmark::Consume(a.Count());
+  }), bits, "bit");
+
+  // Work on copies, so the iteration below sees the original densities.
+  std::bitset<kBits> g = c;
+  benchmark::Report("bitset and/xor" + suffix, benchmark::Measure([&] {
+    g &= d;
+    g ^= d;
+    benchmark::Consume(g.test(0));
+  }), bits, "bit");
+  nx::BitArray<kBits> e = a;
+  benchmark::Report("BitArray and/xor" + suffix, benchmark::Measure([&] {
+    e &= b;
+    e ^= b;
+    benchmark::Consume(e[0]);
+  }), bits, "bit");
+
+  // std::bitset can only be iterated by testing every bit.
+  benchmark::Report("bitset iterate" + suffix, benchmark::Measure([&] {
+    nx::size_t sum = 0;
+    for (nx::size_t i = 0; i < kBits; ++i) {
+      if (c[i]) {
+        sum += i;
+      }
+    }
+    benchmark::Consume(sum);
+  }), bits, "bit");
+  benchmark::Report("BitArray iterate" + suffix, benchmark::Measure([&] {
+    nx::size_t sum = 0;
+    for (nx::size_t i = a.FindFirst(); i != a.size(); i = a.FindNext(i)) {
+      sum += i;
+    }
+    benchmark::Consume(sum);
+  }), bits, "bit");
+}
+
+}  // namespace
+
+int main() {
+  Benchmark<256>(16);
+  Benchmark<1024>(16);
+  Benchmark<4096>(16);
+  Benchmark<4096>(256);
+  return 0;
+}
@@ -0,0 +1,83 @@
+//
+// Copyright (C) 2013 Jacob McIntosh <nacitar at ubercpp dot com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+/// @file byte_order_benchmark.cc
+/// @brief Compares the array kernels of byte_order.h against a loop of
+/// scalar ByteSwap() calls.
+
+#include <random>
+#include <string>
+#include <vector>
+#include "nx/byte_order.h"
+#include "nx/to_string.h"
+#include "benchmark/benchmark.h"
+
+namespace {
+
+template <class T>
+void ScalarLoop(const std::vector<T>&source, std::vector<T>*destination) {
+  for (nx::size_t i = 0; i < source.size(); ++i) {
+    (*destination)[i] = nx::ByteSwap(source[i]);
+  }
+}
+
+template <class T>
+void BenchmarkKernels(const char*type, nx::size_t bytes) {
+  using nx::detail::ByteSwapKernel;
+  const struct {
+    ByteSwapKernel kernel;
+    const char*name;
+  } kernels[] = {
+    { ByteSwapKernel::kScalar, "scalar" },
+    { ByteSwapKernel::kSsse3, "ssse3" },
+    { ByteSwapKernel::kAvx2, "avx2" }
+  };
+  std::mt19937_64 random;
+  std::vector<T> source(bytes / sizeof(T));
+  for (T&value : source) {
+    value = static_cast<T>(random());
+  }
+  std::vector<T> destination(source.size());
+  const std::string suffix =
+      std::string(" ") + type + " (" + nx::ToString(bytes / 1024) + "KiB)";
+  benchmark::Report("loop" + suffix, benchmark::Measure([&] {
+    ScalarLoop(source, &destination);
+    benchmark::Consume(destination[0]);
+  }), static_cast<double>(bytes), "byte");
+  for (const auto&entry : kernels) {
+    if (!nx::detail::ByteSwapSupported(entry.kernel)) {
+      continue;
+    }
+    benchmark::Report(entry.name + suffix, benchmark::Measure([&] {
+      nx::detail::ByteSwapBuffer(entry.kernel, source.data(),
+                                 destination.data(), source.size(),
+                                 sizeof(T));
+      benchmark::Consume(destination[0]);
+    }), static_cast<double>(bytes), "byte");
+  }
+}
+
+}  // namespace
+
+int main() {
+  for (nx::size_t bytes : { 4096u, 1048576u }) {
+    BenchmarkKernels<nx::uint16_t>("uint16", bytes);
+    BenchmarkKernels<nx::uint32_t>("uint32", bytes);
+    BenchmarkKernels<nx::uint64_t>("uint64", bytes);
+  }
+  return 0;
+}
@@ -0,0 +1,86 @@
+//
+// Copyright (C) 2013 Jacob McIntosh <nacitar at ubercpp dot com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+/// @file fixed_benchmark.cc
+/// @brief Compares multiply-accumulate loops over Fixed values against the
+/// same loops over doubles.
+
+#include <random>
+#include <string>
+#include <vector>
+#include "nx/fixed.h"
+#include "benchmark/benchmark.h"
+
+namespace {
+
+/// @brief Sums the products of the pairs of elements.
+template <class T>
+T MultiplyAccumulate(const std::vector<T>&lhs, const std::vector<T>&rhs) {
+  T sum = T();
+  for (nx::size_t i = 0; i < lhs.size(); ++i) {
+    sum += lhs[i] * rhs[i];
+  }
+  return sum;
+}
+
+/// @brief Provides a floating-point value to consume.
+template <class T>
+T Observable(T value) {
+  return value;
+}
+
+/// @brief Provides the raw value of a fixed-point one to consume, as the
+/// sink holds only builtin types.
+template <unsigned int kIntBits, unsigned int kFracBits>
+nx::int64_t Observable(nx::Fixed<kIntBits, kFracBits> value) {
+  return value.raw();
+}
+
+/// @brief Converts the values to T and reports the loop over them.
+template <class T>
+void Benchmark(const std::string&name, const std::vector<double>&lhs,
+               const std::vector<double>&rhs) {
+  std::vector<T> lhs_values(lhs.size());
+  std::vector<T> rhs_values(rhs.size());
+  for (nx::size_t i = 0; i < lhs.size(); ++i) {
+    lhs_values[i] = T(lhs[i]);
+    rhs_values[i] = T(rhs[i]);
+  }
+  benchmark::Report(name, benchmark::Measure([&] {
+    benchmark::Consume(
+        Observable(MultiplyAccumulate(lhs_values, rhs_values)));
+  }), static_cast<double>(lhs.size()), "element");
+}
+
+}  // namespace
+
+int main() {
+  const nx::size_t count = 4096;
+  std::mt19937_64 random;
+  std::uniform_real_distribution<double> distribution(-8.0, 8.0);
+  std::vector<double> lhs(count);
+  std::vector<double> rhs(count);
+  for (nx::size_t i = 0; i < count; ++i) {
+    lhs[i] = distribution(random);
+    rhs[i] = distribution(random);
+  }
+  Benchmark<double>("double", lhs, rhs);
+  Benchmark<float>("float", lhs, rhs);
+  Benchmark<nx::Fixed<16, 16>>("Fixed<16, 16>", lhs, rhs);
+  Benchmark<nx::Fixed<32, 32>>("Fixed<32, 32>", lhs, rhs);
+  Benchmark<nx::Fixed<24, 40>>("Fixed<24, 40>", lhs, rhs);
+  return 0;
+}
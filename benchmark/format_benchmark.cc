@@ -0,0 +1,119 @@
+//
+// Copyright (C) 2013 Jacob McIntosh <nacitar at ubercpp dot com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+/// @file format_benchmark.cc
+/// @brief Measures Format() writing a typical log line, with a level, a
+/// method padded to a width, a zero-padded hexadecimal request id, a status,
+/// a latency and a path, against snprintf and an std::ostringstream doing
+/// the same.  Each writes the lines for a buffer of random requests, and
+/// the last line each wrote is compared to check they agree.
+
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "nx/format.h"
+#include "benchmark/benchmark.h"
+
+namespace {
+
+/// @brief The fields of a log line.
+struct Request {
+  const char*method;
+  nx::uint64_t id;
+  int status;
+  unsigned int microseconds;
+  std::string path;
+};
+
+constexpr nx::FormatString kLine(
+    "[info] {:<6} id={:016x} status={} latency={:>6}us path={}");
+
+/// @brief Measures writing every request, reporting the time per line.
+template <class Function>
+void Run(const std::string&name, const std::vector<Request>&requests,
+         Function function) {
+  benchmark::Report(name, benchmark::Measure([&] {
+    size_t length = 0;
+    for (const Request&request : requests) {
+      length += function(request);
+    }
+    benchmark::Consume(length);
+  }), static_cast<double>(requests.size()), "line");
+}
+
+}  // namespace
+
+int main() {
+  std::mt19937_64 random;
+  const char*const methods[] = {"GET", "POST", "PUT", "DELETE"};
+  const int statuses[] = {200, 201, 304, 404, 500};
+  std::vector<Request> requests(1024);
+  for (Request&request : requests) {
+    request.method = methods[random() % 4];
+    request.id = random();
+    request.status = statuses[random() % 5];
+    request.microseconds = static_cast<unsigned int>(random() % 100000);
+    request.path = "/api/v1/items/" + std::to_string(random() % 100000);
+  }
+
+  char buffer[256];
+  std::string last[3];
+  Run("snprintf", requests, [&](const Request&request) {
+    const int length = std::snprintf(
+        buffer, sizeof(buffer),
+        "[info] %-6s id=%016llx status=%d latency=%6uus path=%s",
+        request.method,
+        static_cast<unsigned long long>(request.id),  // NOLINT(runtime/int)
+        request.status, request.microseconds, request.path.c_str());
+    benchmark::Escape(buffer);
+    return static_cast<size_t>(length);
+  });
+  last[0] = buffer;
+  std::ostringstream stream;
+  Run("ostringstream", requests, [&](const Request&request) {
+    stream.str(std::string());
+    stream << "[info] " << std::left << std::setw(6) << request.method
+        << " id=" << std::right << std::hex << std::setfill('0')
+        << std::setw(16) << request.id << std::dec << std::setfill(' ')
+        << " status=" << request.status << " latency=" << std::setw(6)
+        << request.microseconds << "us path=" << request.path;
+    return stream.str().size();
+  });
+  last[1] = stream.str();
+  Run("Format", requests, [&](const Request&request) {
+    const size_t length = nx::Format(
+        buffer, sizeof(buffer), kLine, request.method, request.id,
+        request.status, request.microseconds, request.path);
+    benchmark::Escape(buffer);
+    return length;
+  });
+  std::string text;
+  Run("Format std::string", requests, [&](const Request&request) {
+    text.clear();
+    return nx::Format(&text, kLine, request.method, request.id,
+                      request.status, request.microseconds, request.path);
+  });
+  last[2] = text;
+  if (last[0] != last[1] || last[0] != last[2]) {
+    std::cout << "mismatch:\n" << last[0] << '\n' << last[1] << '\n'
+        << last[2] << std::endl;
+  }
+  return 0;
+}
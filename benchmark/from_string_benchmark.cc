@@ -0,0 +1,205 @@
+//
+// Copyright (C) 2013 Jacob McIntosh <nacitar at ubercpp dot com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+/// @file from_string_benchmark.cc
+/// @brief Measures parsing comma separated decimal values, comparing
+/// FromString() against strtoull and std::from_chars (when built as C++17),
+/// and the array kernels of from_string.h against each other.  ParseDouble()
+/// is likewise compared against strtod and std::from_chars, and its results
+/// checked against those of strtod.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "nx/from_string.h"
+#include "nx/to_string.h"
+#include "benchmark/benchmark.h"
+
+#if defined(__cpp_lib_to_chars) || __cplusplus >= 201703L
+  #include <charconv>
+  #define NX_BENCHMARK_FROM_CHARS 1
+#endif
+
+namespace {
+
+/// @brief Measures parsing the text, which holds count values.
+void Run(const std::string&name, const std::string&text, size_t count) {
+  const char*begin = text.data();
+  const char*end = begin + text.size();
+  const double values = static_cast<double>(count);
+  std::vector<nx::uint64_t> parsed(count);
+
+  benchmark::Report("strtoull " + name, benchmark::Measure([&] {
+    const char*position = begin;
+    for (size_t i = 0; i < count; ++i) {
+      char*field_end;
+      parsed[i] = std::strtoull(position, &field_end, 10);
+      position = field_end + 1;
+    }
+    benchmark::Escape(parsed.data());
+  }), values, "value");
+
+#if defined(NX_BENCHMARK_FROM_CHARS)
+  benchmark::Report("from_chars " + name, benchmark::Measure([&] {
+    const char*position = begin;
+    for (size_t i = 0; i < count; ++i) {
+      position = std::from_chars(position, end, parsed[i]).ptr + 1;
+    }
+    benchmark::Escape(parsed.data());
+  }), values, "value");
+#endif
+
+  benchmark::Report("FromString " + name, benchmark::Measure([&] {
+    const char*position = begin;
+    for (size_t i = 0; i < count; ++i) {
+      position = nx::FromString(position, end, &parsed[i]).end + 1;
+    }
+    benchmark::Escape(parsed.data());
+  }), values, "value");
+
+  using nx::detail::FromStringKernel;
+  const struct {
+    FromStringKernel kernel;
+    const char*name;
+  } kernels[] = {
+    { FromStringKernel::kScalar, "scalar" },
+    { FromStringKernel::kSse41, "SSE4.1" },
+    { FromStringKernel::kAvx2, "AVX2" }
+  };
+  const nx::detail::ParseLimits limits =
+      nx::detail::MakeParseLimits<nx::uint64_t>();
+  for (const auto&entry : kernels) {
+    if (!nx::detail::FromStringSupported(entry.kernel)) {
+      continue;
+    }
+    benchmark::Report(std::string(entry.name) + " kernel " + name,
+                      benchmark::Measure([&] {
+      size_t parsed_count;
+      nx::detail::FromStringFields(entry.kernel, begin, end, ',', limits,
+                                   parsed.data(), count, &parsed_count);
+      benchmark::Escape(parsed.data());
+    }), values, "value");
+  }
+}
+
+/// @brief Measures parsing the text, which holds count doubles, and reports
+/// how many ParseDouble() parsed differently from strtod.
+void RunFloatingPoint(const std::string&name, const std::string&text,
+                      size_t count) {
+  const char*begin = text.data();
+  const char*end = begin + text.size();
+  const double values = static_cast<double>(count);
+  std::vector<double> expected(count);
+  std::vector<double> parsed(count);
+
+  benchmark::Report("strtod " + name, benchmark::Measure([&] {
+    const char*position = begin;
+    for (size_t i = 0; i < count; ++i) {
+      char*field_end;
+      expected[i] = std::strtod(position, &field_end);
+      position = field_end + 1;
+    }
+    benchmark::Escape(expected.data());
+  }), values, "value");
+
+#if defined(NX_BENCHMARK_FROM_CHARS) && defined(__cpp_lib_to_chars)
+  benchmark::Report("from_chars " + name, benchmark::Measure([&] {
+    const char*position = begin;
+    for (size_t i = 0; i < count; ++i) {
+      position = std::from_chars(position, end, parsed[i]).ptr + 1;
+    }
+    benchmark::Escape(parsed.data());
+  }), values, "value");
+#endif
+
+  benchmark::Report("ParseDouble " + name, benchmark::Measure([&] {
+    const char*position = begin;
+    for (size_t i = 0; i < count; ++i) {
+      position = nx::ParseDouble(position, end, &parsed[i]).end + 1;
+    }
+    benchmark::Escape(parsed.data());
+  }), values, "value");
+
+  std::vector<double> array;
+  array.reserve(count);
+  benchmark::Report("ParseDouble array " + name, benchmark::Measure([&] {
+    array.clear();
+    nx::ParseDouble(begin, end, ',', &array);
+    benchmark::Escape(array.data());
+  }), values, "value");
+
+  unsigned int mismatches = 0;
+  for (size_t i = 0; i < count; ++i) {
+    mismatches += std::memcmp(&expected[i], &parsed[i], sizeof(double)) != 0;
+  }
+  std::cout << "  mismatches with strtod: " << mismatches << " of " << count
+      << std::endl;
+}
+
+/// @brief Formats the values as comma separated text.
+std::string MakeText(const std::vector<nx::uint64_t>&values) {
+  std::string text;
+  nx::ToString(values.data(), values.size(), &text);
+  return text;
+}
+
+}  // namespace
+
+int main() {
+  std::mt19937_64 random;
+  std::vector<nx::uint64_t> values(4096);
+  for (nx::uint64_t&value : values) {
+    value = random();
+  }
+  Run("64-bit", MakeText(values), values.size());
+  for (nx::uint64_t&value : values) {
+    value = random() >> 24;
+  }
+  Run("40-bit", MakeText(values), values.size());
+  for (nx::uint64_t&value : values) {
+    value = random() % 1000;
+  }
+  Run("small", MakeText(values), values.size());
+
+  std::string shortest;
+  std::string precise;
+  std::string decimals;
+  char buffer[32];
+  for (size_t i = 0; i < values.size(); ++i) {
+    const nx::uint64_t bits = random();
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    if (value - value != 0) {
+      value = 0;
+    }
+    nx::ToString(value, &shortest);
+    shortest += ',';
+    snprintf(buffer, sizeof(buffer), "%.17g,", value);
+    precise += buffer;
+    snprintf(buffer, sizeof(buffer), "%.2f,",
+             static_cast<double>(random() % 10000000) / 100);
+    decimals += buffer;
+  }
+  RunFloatingPoint("shortest", shortest, values.size());
+  RunFloatingPoint("%.17g", precise, values.size());
+  RunFloatingPoint("prices", decimals, values.size());
+  return 0;
+}
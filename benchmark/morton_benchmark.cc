@@ -0,0 +1,79 @@
+//
+// Copyright (C) 2013 Jacob McIntosh <nacitar at ubercpp dot com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+/// @file morton_benchmark.cc
+/// @brief Compares the array kernels of morton.h, and the generic
+/// BitDeposit loop they avoid.
+
+#include <random>
+#include <string>
+#include <vector>
+#include "nx/morton.h"
+#include "benchmark/benchmark.h"
+
+int main() {
+  const struct {
+    nx::MortonKernel kernel;
+    const char*name;
+  } kernels[] = {
+    { nx::MortonKernel::kShiftMask, "shift-mask" },
+    { nx::MortonKernel::kBmi2, "bmi2" }
+  };
+  const nx::size_t length = 65536;
+  std::mt19937 random;
+  std::vector<nx::uint32_t> x(length), y(length), z(length);
+  for (nx::size_t i = 0; i < length; ++i) {
+    x[i] = static_cast<nx::uint32_t>(random());
+    y[i] = static_cast<nx::uint32_t>(random());
+    z[i] = static_cast<nx::uint32_t>(random());
+  }
+  std::vector<nx::uint64_t> codes(length);
+  const double items = static_cast<double>(length);
+  benchmark::Report("generic loop encode2", benchmark::Measure([&] {
+    for (nx::size_t i = 0; i < length; ++i) {
+      codes[i] = nx::detail::BitDepositLoop<nx::uint64_t>(
+          x[i], nx::detail::kMorton2Mask, 1, 0) |
+          nx::detail::BitDepositLoop<nx::uint64_t>(
+          y[i], nx::detail::kMorton2Mask << 1, 1, 0);
+    }
+    benchmark::Consume(codes[0]);
+  }), items, "code");
+  for (const auto&entry : kernels) {
+    if (!nx::MortonSupported(entry.kernel)) {
+      continue;
+    }
+    nx::SetMortonKernel(entry.kernel);
+    const std::string name = entry.name;
+    benchmark::Report(name + " encode2", benchmark::Measure([&] {
+      nx::MortonEncode(x.data(), y.data(), codes.data(), length);
+      benchmark::Consume(codes[0]);
+    }), items, "code");
+    benchmark::Report(name + " decode2", benchmark::Measure([&] {
+      nx::MortonDecode(codes.data(), x.data(), y.data(), length);
+      benchmark::Consume(x[0]);
+    }), items, "code");
+    benchmark::Report(name + " encode3", benchmark::Measure([&] {
+      nx::MortonEncode(x.data(), y.data(), z.data(), codes.data(), length);
+      benchmark::Consume(codes[0]);
+    }), items, "code");
+    benchmark::Report(name + " decode3", benchmark::Measure([&] {
+      nx::MortonDecode(codes.data(), x.data(), y.data(), z.data(), length);
+      benchmark::Consume(x[0]);
+    }), items, "code");
+  }
+  return 0;
+}
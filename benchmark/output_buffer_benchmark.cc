@@ -0,0 +1,113 @@
+//
+// Copyright (C) 2013 Jacob McIntosh <nacitar at ubercpp dot com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+/// @file output_buffer_benchmark.cc
+/// @brief Measures writing log lines to /dev/null through OutputBuffer,
+/// appending each field and formatting each line, with and without the
+/// flush thread, against building each line in a std::string with
+/// ToString() and writing it with fwrite, and against fprintf.
+
+#include <fcntl.h>  // NOLINT(build/include_order)
+#include <unistd.h>  // NOLINT(build/include_order)
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+#include "nx/output_buffer.h"
+#include "nx/to_string.h"
+#include "benchmark/benchmark.h"
+
+namespace {
+
+/// @brief The fields of a log line.
+struct Request {
+  nx::uint64_t id;
+  int status;
+  unsigned int microseconds;
+};
+
+constexpr nx::FormatString kLine(
+    "request id={:016x} status={} latency={}us\n");
+
+/// @brief Measures writing every request, reporting the time per line.
+template <class Function>
+void Run(const std::string&name, const std::vector<Request>&requests,
+         Function function) {
+  benchmark::Report(name, benchmark::Measure([&] {
+    for (const Request&request : requests) {
+      function(request);
+    }
+  }), static_cast<double>(requests.size()), "line");
+}
+
+/// @brief Measures the OutputBuffer variants writing to the descriptor.
+void RunOutputBuffer(const std::string&name, int descriptor,
+                     const std::vector<Request>&requests, bool thread) {
+  nx::OutputBuffer buffer(descriptor);
+  if (thread) {
+    buffer.StartFlushThread();
+  }
+  Run("OutputBuffer Append " + name, requests, [&](const Request&request) {
+    buffer.Append("request id=");
+    buffer.Append<16>(request.id, 16);
+    buffer.Append(" status=");
+    buffer.Append(request.status);
+    buffer.Append(" latency=");
+    buffer.Append(request.microseconds);
+    buffer.Append("us\n");
+  });
+  Run("OutputBuffer AppendFormat " + name, requests,
+      [&](const Request&request) {
+    buffer.AppendFormat(kLine, request.id, request.status,
+                        request.microseconds);
+  });
+}
+
+}  // namespace
+
+int main() {
+  std::mt19937_64 random;
+  std::vector<Request> requests(4096);
+  for (Request&request : requests) {
+    request.id = random();
+    request.status = 200 + static_cast<int>(random() % 300);
+    request.microseconds = static_cast<unsigned int>(random() % 100000);
+  }
+  std::FILE*file = std::fopen("/dev/null", "w");
+  if (!file) {
+    return 1;
+  }
+  Run("fprintf", requests, [&](const Request&request) {
+    std::fprintf(file, "request id=%016llx status=%d latency=%uus\n",
+                 static_cast<unsigned long long>(  // NOLINT(runtime/int)
+                     request.id),
+                 request.status, request.microseconds);
+  });
+  Run("std::string ToString fwrite", requests, [&](const Request&request) {
+    std::string line("request id=");
+    nx::ToString<16>(request.id, &line, 16);
+    line += " status=";
+    nx::ToString(request.status, &line);
+    line += " latency=";
+    nx::ToString(request.microseconds, &line);
+    line += "us\n";
+    std::fwrite(line.data(), 1, line.size(), file);
+  });
+  RunOutputBuffer("", fileno(file), requests, false);
+  RunOutputBuffer("thread", fileno(file), requests, true);
+  std::fclose(file);
+  return 0;
+}
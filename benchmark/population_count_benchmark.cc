@@ -0,0 +1,78 @@
+//
+// Copyright (C) 2013 Jacob McIntosh <nacitar at ubercpp dot com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+/// @file population_count_benchmark.cc
+/// @brief Compares the buffer kernels of population_count.h against a loop
+/// of scalar PopulationCount() calls.
+
+#include <random>
+#include <string>
+#include <vector>
+#include "nx/population_count.h"
+#include "nx/to_string.h"
+#include "benchmark/benchmark.h"
+
+namespace {
+
+nx::uint64_t ScalarLoop(const std::vector<nx::uint64_t>&words) {
+  nx::uint64_t count = 0;
+  for (nx::uint64_t word : words) {
+    count += nx::PopulationCount(word);
+  }
+  return count;
+}
+
+}  // namespace
+
+int main() {
+  using nx::detail::PopulationCountKernel;
+  const struct {
+    PopulationCountKernel kernel;
+    const char*name;
+  } kernels[] = {
+    { PopulationCountKernel::kScalar, "scalar" },
+    { PopulationCountKernel::kPopcnt, "popcnt" },
+    { PopulationCountKernel::kHarleySeal, "harley-seal" },
+    { PopulationCountKernel::kAvx2, "avx2" },
+    { PopulationCountKernel::kAvx512, "avx512" }
+  };
+  std::mt19937_64 random;
+  for (nx::size_t words : { 512u, 131072u, 2097152u }) {
+    std::vector<nx::uint64_t> data(words);
+    for (nx::uint64_t&word : data) {
+      word = random();
+    }
+    const std::string suffix = " (" + nx::ToString(words * 8 / 1024) + "KiB)";
+    const double bytes = static_cast<double>(words * 8);
+    benchmark::Report("loop" + suffix, benchmark::Measure([&data] {
+      benchmark::Consume(ScalarLoop(data));
+    }), bytes, "byte");
+    for (const auto&entry : kernels) {
+      if (!nx::detail::PopulationCountSupported(entry.kernel)) {
+        continue;
+      }
+      benchmark::Report(entry.name + suffix, benchmark::Measure([&] {
+        benchmark::Consume(nx::detail::PopulationCountBuffer(
+            entry.kernel, data.data(), data.size() * 8));
+      }), bytes, "byte");
+    }
+    benchmark::Report("dispatched" + suffix, benchmark::Measure([&data] {
+      benchmark::Consume(nx::PopulationCount(data.data(), data.size()));
+    }), bytes, "byte");
+  }
+  return 0;
+}
@@ -0,0 +1,70 @@
+//
+// Copyright (C) 2013 Jacob McIntosh <nacitar at ubercpp dot com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+/// @file rank_select_bit_vector_benchmark.cc
+/// @brief Measures rank and select throughput of a RankSelectBitVector.
+/// @details The number of bits defaults to 1e9 and may be passed as the
+/// first argument.
+
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "nx/rank_select_bit_vector.h"
+#include "nx/to_string.h"
+#include "benchmark/benchmark.h"
+
+int main(int argc, char*argv[]) {
+  const nx::uint64_t bits = argc > 1
+      ? std::strtoull(argv[1], nullptr, 10) : 1000000000ull;
+  std::mt19937_64 random;
+  for (unsigned int sparsity : { 0u, 3u }) {
+    std::vector<nx::uint64_t> words((bits + 63) / 64);
+    for (nx::uint64_t&word : words) {
+      word = random();
+      for (unsigned int i = 0; i < sparsity; ++i) {
+        word &= random();
+      }
+    }
+    const nx::RankSelectBitVector vector(std::move(words), bits);
+    const std::string density = " (density 1/" + nx::ToString(1u << sparsity)
+        + ", " + nx::ToString(vector.index_bytes() * 1000 / (bits / 8))
+        + " permille overhead)";
+
+    constexpr unsigned int kQueries = 1 << 20;
+    std::vector<nx::uint64_t> positions(kQueries);
+    std::vector<nx::uint64_t> ranks(kQueries);
+    for (unsigned int i = 0; i < kQueries; ++i) {
+      positions[i] = random() % (bits + 1);
+      ranks[i] = random() % vector.count();
+    }
+    benchmark::Report("rank" + density, benchmark::Measure([&] {
+      nx::uint64_t sum = 0;
+      for (nx::uint64_t position : positions) {
+        sum += vector.Rank(position);
+      }
+      benchmark::Consume(sum);
+    }), kQueries, "query");
+    benchmark::Report("select" + density, benchmark::Measure([&] {
+      nx::uint64_t sum = 0;
+      for (nx::uint64_t rank : ranks) {
+        sum += vector.Select(rank);
+      }
+      benchmark::Consume(sum);
+    }), kQueries, "query");
+  }
+  return 0;
+}
@@ -0,0 +1,113 @@
+//
+// Copyright (C) 2013 Jacob McIntosh <nacitar at ubercpp dot com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+/// @file reverse_benchmark.cc
+/// @brief Compares the array kernels and bit-reversal permutation of
+/// reverse.h against loops of scalar Reverse() calls.
+
+#include <random>
+#include <string>
+#include <vector>
+#include "nx/reverse.h"
+#include "nx/to_string.h"
+#include "benchmark/benchmark.h"
+
+namespace {
+
+template <class T>
+void ScalarLoop(const std::vector<T>&source, std::vector<T>*destination) {
+  for (nx::size_t i = 0; i < source.size(); ++i) {
+    (*destination)[i] = nx::Reverse(source[i]);
+  }
+}
+
+/// @brief The textbook permutation, which writes with a stride of half the
+/// array.
+template <class T>
+void NaivePermutation(const std::vector<T>&source,
+                      std::vector<T>*destination, unsigned int log2_length) {
+  for (nx::size_t i = 0; i < source.size(); ++i) {
+    (*destination)[nx::Reverse(static_cast<nx::uint64_t>(i))
+        >> (64 - log2_length)] = source[i];
+  }
+}
+
+template <class T>
+void BenchmarkKernels(const char*type, nx::size_t bytes) {
+  using nx::detail::ReverseBitsKernel;
+  const struct {
+    ReverseBitsKernel kernel;
+    const char*name;
+  } kernels[] = {
+    { ReverseBitsKernel::kScalar, "scalar" },
+    { ReverseBitsKernel::kSsse3, "ssse3" },
+    { ReverseBitsKernel::kAvx2, "avx2" }
+  };
+  std::mt19937_64 random;
+  std::vector<T> source(bytes / sizeof(T));
+  for (T&value : source) {
+    value = static_cast<T>(random());
+  }
+  std::vector<T> destination(source.size());
+  const std::string suffix =
+      std::string(" ") + type + " (" + nx::ToString(bytes / 1024) + "KiB)";
+  benchmark::Report("loop" + suffix, benchmark::Measure([&] {
+    ScalarLoop(source, &destination);
+    benchmark::Consume(destination[0]);
+  }), static_cast<double>(bytes), "byte");
+  for (const auto&entry : kernels) {
+    if (!nx::detail::ReverseBitsSupported(entry.kernel)) {
+      continue;
+    }
+    benchmark::Report(entry.name + suffix, benchmark::Measure([&] {
+      nx::detail::ReverseBitsBuffer(entry.kernel, source.data(),
+                                    destination.data(), source.size(),
+                                    sizeof(T));
+      benchmark::Consume(destination[0]);
+    }), static_cast<double>(bytes), "byte");
+  }
+}
+
+}  // namespace
+
+int main() {
+  for (nx::size_t bytes : { 4096u, 1048576u }) {
+    BenchmarkKernels<nx::uint8_t>("uint8", bytes);
+    BenchmarkKernels<nx::uint32_t>("uint32", bytes);
+    BenchmarkKernels<nx::uint64_t>("uint64", bytes);
+  }
+  for (unsigned int log2_length : { 12u, 20u, 24u }) {
+    std::vector<nx::uint64_t> source(static_cast<nx::size_t>(1)
+                                     << log2_length);
+    for (nx::size_t i = 0; i < source.size(); ++i) {
+      source[i] = i;
+    }
+    std::vector<nx::uint64_t> destination(source.size());
+    const std::string suffix = " (2^" + nx::ToString(log2_length) + ")";
+    const double items = static_cast<double>(source.size());
+    benchmark::Report("naive permutation" + suffix, benchmark::Measure([&] {
+      NaivePermutation(source, &destination, log2_length);
+      benchmark::Consume(destination[1]);
+    }), items, "element");
+    benchmark::Report("blocked permutation" + suffix, benchmark::Measure([&] {
+      nx::BitReversalPermutation(source.data(), destination.data(),
+                                 log2_length);
+      benchmark::Consume(destination[1]);
+    }), items, "element");
+  }
+  return 0;
+}
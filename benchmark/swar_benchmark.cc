@@ -0,0 +1,105 @@
+//
+// Copyright (C) 2013 Jacob McIntosh <nacitar at ubercpp dot com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+/// @file swar_benchmark.cc
+/// @brief Compares the 8-bit lookup table, 16-bit lookup table and SWAR
+/// generic fallbacks, and the implementation the build selected, over a
+/// buffer of words.  Define NX_USE_WIDE_TABLES or NX_USE_SWAR where either
+/// comes out ahead.
+
+#include <random>
+#include <string>
+#include <vector>
+#include "nx/bit_scan_forward.h"
+#include "nx/bit_scan_reverse.h"
+#include "nx/population_count.h"
+#include "nx/reverse.h"
+#include "nx/swar.h"
+#include "benchmark/benchmark.h"
+
+namespace {
+
+/// @brief Measures a function over every word, reporting the time per word.
+template <class Function>
+void Run(const std::string&name, const std::vector<nx::uint64_t>&words,
+         Function function) {
+  benchmark::Report(name, benchmark::Measure([&] {
+    nx::uint64_t sum = 0;
+    for (nx::uint64_t word : words) {
+      sum += function(word);
+    }
+    benchmark::Consume(sum);
+  }), static_cast<double>(words.size()), "word");
+}
+
+}  // namespace
+
+int main() {
+  namespace version = nx::detail::version;
+  std::mt19937_64 random;
+  std::vector<nx::uint64_t> words(4096);
+  for (nx::uint64_t&word : words) {
+    word = random() >> (random() % 64);
+  }
+
+  Run("table PopulationCount", words, [](nx::uint64_t word) {
+    return version::PopulationCount<64>(word);
+  });
+  Run("wide table PopulationCount", words, [](nx::uint64_t word) {
+    return version::WidePopulationCount<64>(word);
+  });
+  Run("swar PopulationCount", words, [](nx::uint64_t word) {
+    return nx::swar::PopulationCount(word);
+  });
+  Run("selected PopulationCount", words, [](nx::uint64_t word) {
+    return nx::PopulationCount(word);
+  });
+
+  Run("de Bruijn BitScanForward", words, [](nx::uint64_t word) {
+    return version::BitScanForward<64>(word);
+  });
+  Run("swar BitScanForward", words, [](nx::uint64_t word) {
+    return nx::swar::BitScanForward(word);
+  });
+  Run("selected BitScanForward", words, [](nx::uint64_t word) {
+    return nx::BitScanForward(word);
+  });
+
+  Run("table BitScanReverse", words, [](nx::uint64_t word) {
+    return version::BitScanReverse<64>(word);
+  });
+  Run("wide table BitScanReverse", words, [](nx::uint64_t word) {
+    return version::WideBitScanReverse<64>(word);
+  });
+  Run("swar BitScanReverse", words, [](nx::uint64_t word) {
+    return nx::swar::BitScanReverse(word);
+  });
+  Run("selected BitScanReverse", words, [](nx::uint64_t word) {
+    return nx::BitScanReverse(word);
+  });
+
+  Run("table Reverse", words, [](nx::uint64_t word) {
+    return version::Reverse<64>(word);
+  });
+  Run("wide table Reverse", words, [](nx::uint64_t word) {
+    return version::WideReverse<64>(word);
+  });
+  Run("swar Reverse", words, [](nx::uint64_t word) {
+    return nx::swar::Reverse(word);
+  });
+  return 0;
+}
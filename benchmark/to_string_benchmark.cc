@@ -0,0 +1,264 @@
+//
+// Copyright (C) 2013 Jacob McIntosh <nacitar at ubercpp dot com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+/// @file to_string_benchmark.cc
+/// @brief Measures ToString over buffers of values.  64-bit values are
+/// compared against a loop writing one digit per division and against
+/// snprintf, for both uniformly random and small values; 128-bit values are
+/// compared against a loop dividing the whole value by 10 per digit.  Arrays
+/// converted into one string are compared against appending each value, and
+/// the array kernels against each other.  Doubles and floats from random bit
+/// patterns and from short decimals are compared against snprintf with
+/// enough digits to round-trip, and every result is read back with strtod to
+/// count any that do not.  Hexadecimal conversion of 64-bit values is
+/// compared against a loop writing one digit per shift and against snprintf,
+/// and the kernels writing the bytes of a buffer against each other.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "nx/to_string.h"
+#include "benchmark/benchmark.h"
+
+namespace {
+
+/// @brief Measures a conversion over every value, reporting the time per
+/// value.
+template <class T, class Function>
+void Run(const std::string&name, const std::vector<T>&values,
+         Function function) {
+  char buffer[64];
+  benchmark::Report(name, benchmark::Measure([&] {
+    unsigned int length = 0;
+    for (const T&value : values) {
+      length += function(value, buffer);
+      benchmark::Escape(buffer);
+    }
+    benchmark::Consume(length);
+  }), static_cast<double>(values.size()), "value");
+}
+
+/// @brief One 64-bit division per digit.
+unsigned int DivisionToString(nx::uint64_t value, char*buffer) {
+  const unsigned int digits = nx::Digits(value);
+  for (char*end = buffer + digits; end != buffer; value /= 10) {
+    *(--end) = static_cast<char>('0' + value % 10);
+  }
+  return digits;
+}
+
+/// @brief Measures the 64-bit conversions over the values.
+void Run64(const std::string&name, const std::vector<nx::uint64_t>&values) {
+  Run("division loop " + name, values, DivisionToString);
+  Run("snprintf " + name, values, [](nx::uint64_t value, char*buffer) {
+    return static_cast<unsigned int>(snprintf(buffer, 64, "%llu",
+        static_cast<unsigned long long>(value)));  // NOLINT(runtime/int)
+  });
+  Run("ToString " + name, values, [](nx::uint64_t value, char*buffer) {
+    return nx::ToString(value, buffer);
+  });
+}
+
+/// @brief Measures converting the values into a comma separated string.
+void RunArray(const std::string&name,
+              const std::vector<nx::uint64_t>&values) {
+  const double count = static_cast<double>(values.size());
+  benchmark::Report("append each " + name, benchmark::Measure([&] {
+    std::string text;
+    for (nx::uint64_t value : values) {
+      nx::ToString(value, &text);
+      text += ',';
+    }
+    benchmark::Escape(&text[0]);
+  }), count, "value");
+  benchmark::Report("array " + name, benchmark::Measure([&] {
+    std::string text;
+    nx::ToString(values.data(), values.size(), &text);
+    benchmark::Escape(&text[0]);
+  }), count, "value");
+  using nx::detail::ToStringKernel;
+  const struct {
+    ToStringKernel kernel;
+    const char*name;
+  } kernels[] = {
+    { ToStringKernel::kScalar, "scalar" },
+    { ToStringKernel::kSse41, "SSE4.1" },
+    { ToStringKernel::kAvx2, "AVX2" }
+  };
+  const nx::FieldFormat format;
+  std::string text(values.size() * 21 + nx::detail::kToStringFieldsSlack,
+                   ' ');
+  for (const auto&entry : kernels) {
+    if (!nx::detail::ToStringSupported(entry.kernel)) {
+      continue;
+    }
+    benchmark::Report(std::string(entry.name) + " kernel " + name,
+                      benchmark::Measure([&] {
+      nx::detail::ToStringFields(entry.kernel, values.data(), values.size(),
+                                 format, &text[0], &text[0], nullptr);
+      benchmark::Escape(&text[0]);
+    }), count, "value");
+  }
+}
+
+/// @brief One shift per hexadecimal digit.
+unsigned int ShiftHex(nx::uint64_t value, char*buffer) {
+  const unsigned int digits = nx::Digits<16>(value);
+  for (char*end = buffer + digits; end != buffer; value >>= 4) {
+    *(--end) = "0123456789abcdef"[value & 15];
+  }
+  return digits;
+}
+
+/// @brief Measures the hexadecimal conversions of the values, and of their
+/// bytes as one buffer.
+void RunHex(const std::vector<nx::uint64_t>&values) {
+  Run("shift loop hex", values, ShiftHex);
+  Run("snprintf hex", values, [](nx::uint64_t value, char*buffer) {
+    return static_cast<unsigned int>(snprintf(buffer, 64, "%llx",
+        static_cast<unsigned long long>(value)));  // NOLINT(runtime/int)
+  });
+  Run("ToString<16>", values, [](nx::uint64_t value, char*buffer) {
+    return nx::ToString<16>(value, buffer);
+  });
+  using nx::detail::HexKernel;
+  const struct {
+    HexKernel kernel;
+    const char*name;
+  } kernels[] = {
+    { HexKernel::kScalar, "scalar" },
+    { HexKernel::kSsse3, "SSSE3" },
+    { HexKernel::kAvx2, "AVX2" }
+  };
+  const nx::size_t length = values.size() * sizeof(nx::uint64_t);
+  const nx::uint8_t*bytes = reinterpret_cast<const nx::uint8_t*>(
+      values.data());
+  std::string text(length * 2, ' ');
+  for (const auto&entry : kernels) {
+    if (!nx::detail::HexSupported(entry.kernel)) {
+      continue;
+    }
+    benchmark::Report(std::string(entry.name) + " hex kernel",
+                      benchmark::Measure([&] {
+      nx::detail::WriteHex(entry.kernel, bytes, length, &text[0],
+                           nx::LetterCase::kLower);
+      benchmark::Escape(&text[0]);
+    }), static_cast<double>(length), "byte");
+  }
+}
+
+/// @brief Reads a value back with the C library.
+double ReadFloat(const char*text, double) {
+  return std::strtod(text, nullptr);
+}
+
+float ReadFloat(const char*text, float) {
+  return std::strtof(text, nullptr);
+}
+
+/// @brief Measures the floating-point conversions over the values, and
+/// reports how many of them ToString() did not write as the same value.
+template <class T>
+void RunFloatingPoint(const std::string&name, const std::vector<T>&values,
+                      int precision) {
+  Run("snprintf %." + std::to_string(precision) + "g " + name, values,
+      [precision](T value, char*buffer) {
+    return static_cast<unsigned int>(snprintf(buffer, 64, "%.*g", precision,
+                                              static_cast<double>(value)));
+  });
+  Run("ToString " + name, values, [](T value, char*buffer) {
+    return nx::ToString(value, buffer);
+  });
+  unsigned int mismatches = 0;
+  for (T value : values) {
+    const std::string text = nx::ToString(value);
+    const T read = ReadFloat(text.c_str(), value);
+    mismatches += std::memcmp(&read, &value, sizeof(value)) != 0;
+  }
+  std::cout << "  round-trip mismatches: " << mismatches << " of "
+      << values.size() << std::endl;
+}
+
+/// @brief Finite values of T from random bit patterns.
+template <class T, class Bits>
+std::vector<T> RandomFloats(std::mt19937_64*random, nx::size_t length) {
+  std::vector<T> values;
+  while (values.size() < length) {
+    const Bits bits = static_cast<Bits>((*random)());
+    T value;
+    std::memcpy(&value, &bits, sizeof(value));
+    if (value - value == 0) {
+      values.push_back(value);
+    }
+  }
+  return values;
+}
+
+#if defined(NX_HAS_INT128)
+/// @brief One 128-bit division per digit.
+unsigned int NaiveToString(nx::uint128_t value, char*buffer) {
+  const unsigned int digits = nx::Digits(value);
+  for (char*end = buffer + digits; end != buffer; value /= 10) {
+    *(--end) = static_cast<char>('0' + static_cast<unsigned int>(value % 10));
+  }
+  return digits;
+}
+#endif
+
+}  // namespace
+
+int main() {
+  std::mt19937_64 random;
+  std::vector<nx::uint64_t> values64(4096);
+  for (nx::uint64_t&value : values64) {
+    value = random();
+  }
+  Run64("64-bit", values64);
+  std::vector<nx::uint64_t> small_values(4096);
+  for (nx::uint64_t&value : small_values) {
+    value = random() % 1000;
+  }
+  Run64("small", small_values);
+  RunArray("64-bit", values64);
+  RunArray("small", small_values);
+  RunHex(values64);
+
+  RunFloatingPoint("double", RandomFloats<double, nx::uint64_t>(&random, 4096),
+                   17);
+  RunFloatingPoint("float", RandomFloats<float, nx::uint32_t>(&random, 4096),
+                   9);
+  std::vector<double> decimals(4096);
+  for (double&value : decimals) {
+    value = static_cast<double>(random() % 10000000) / 100;
+  }
+  RunFloatingPoint("short decimal", decimals, 17);
+
+#if defined(NX_HAS_INT128)
+  std::vector<nx::uint128_t> values128(4096);
+  for (nx::uint128_t&value : values128) {
+    value = static_cast<nx::uint128_t>(random()) << 64 | random();
+  }
+  Run("naive ToString 128-bit", values128, NaiveToString);
+  Run("ToString 128-bit", values128, [](nx::uint128_t value, char*buffer) {
+    return nx::ToString(value, buffer);
+  });
+#endif
+  return 0;
+}
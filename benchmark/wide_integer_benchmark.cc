@@ -0,0 +1,129 @@
+//
+// Copyright (C) 2013 Jacob McIntosh <nacitar at ubercpp dot com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+/// @file wide_integer_benchmark.cc
+/// @brief Compares WideUInt addition and multiplication against a naive loop
+/// over 32-bit limbs, as portable big integer code is often written.
+
+#include <random>
+#include <string>
+#include <vector>
+#include "nx/core.h"
+#include "nx/to_string.h"
+#include "benchmark/benchmark.h"
+
+namespace {
+
+/// @brief An unsigned integer of kBits bits in 32-bit limbs, least
+/// significant first, with the carries propagated through 64-bit sums.
+template <unsigned int kBits>
+class NaiveUInt {
+ public:
+  static constexpr unsigned int kLimbs = kBits / 32;
+
+  NaiveUInt& operator+=(const NaiveUInt&other) {
+    nx::uint64_t carry = 0;
+    for (unsigned int i = 0; i < kLimbs; ++i) {
+      carry += static_cast<nx::uint64_t>(limbs[i]) + other.limbs[i];
+      limbs[i] = static_cast<nx::uint32_t>(carry);
+      carry >>= 32;
+    }
+    return *this;
+  }
+
+  NaiveUInt operator*(const NaiveUInt&other) const {
+    NaiveUInt product = NaiveUInt();
+    for (unsigned int i = 0; i < kLimbs; ++i) {
+      nx::uint64_t carry = 0;
+      for (unsigned int j = 0; i + j < kLimbs; ++j) {
+        carry += static_cast<nx::uint64_t>(limbs[i]) * other.limbs[j]
+            + product.limbs[i + j];
+        product.limbs[i + j] = static_cast<nx::uint32_t>(carry);
+        carry >>= 32;
+      }
+    }
+    return product;
+  }
+
+  nx::uint32_t limbs[kLimbs];
+};
+
+template <unsigned int kBits>
+void Benchmark() {
+  typedef nx::WideUInt<kBits> Wide;
+  typedef NaiveUInt<kBits> Naive;
+  const unsigned int count = 1024;
+  std::mt19937_64 random;
+  std::vector<Wide> wide(count);
+  std::vector<Naive> naive(count);
+  for (unsigned int i = 0; i < count; ++i) {
+    for (unsigned int word = 0; word < Wide::kWords; ++word) {
+      const nx::uint64_t value = random();
+      wide[i].data()[word] = value;
+      naive[i].limbs[2 * word] = static_cast<nx::uint32_t>(value);
+      naive[i].limbs[2 * word + 1] = static_cast<nx::uint32_t>(value >> 32);
+    }
+  }
+  const std::string suffix = " (" + nx::ToString(kBits) + " bits)";
+
+  benchmark::Report("naive add" + suffix, benchmark::Measure([&] {
+    Naive sum = Naive();
+    for (const Naive&value : naive) {
+      sum += value;
+    }
+    benchmark::Escape(&sum);
+  }), count, "add");
+  benchmark::Report("WideUInt add" + suffix, benchmark::Measure([&] {
+    Wide sum;
+    for (const Wide&value : wide) {
+      sum += value;
+    }
+    benchmark::Escape(&sum);
+  }), count, "add");
+
+  benchmark::Report("naive multiply" + suffix, benchmark::Measure([&] {
+    Naive product = naive[0];
+    for (const Naive&value : naive) {
+      product = product * value;
+    }
+    benchmark::Escape(&product);
+  }), count, "multiply");
+  benchmark::Report("WideUInt multiply" + suffix, benchmark::Measure([&] {
+    Wide product = wide[0];
+    for (const Wide&value : wide) {
+      product *= value;
+    }
+    benchmark::Escape(&product);
+  }), count, "multiply");
+
+  benchmark::Report("WideUInt ToString" + suffix, benchmark::Measure([&] {
+    char buffer[160];
+    unsigned int length = 0;
+    for (unsigned int i = 0; i < 64; ++i) {
+      length += nx::ToString(wide[i], buffer);
+      benchmark::Escape(buffer);
+    }
+    benchmark::Consume(length);
+  }), 64, "value");
+}
+
+}  // namespace
+
+int main() {
+  Benchmark<256>();
+  Benchmark<512>();
+  return 0;
+}
@@ -0,0 +1,474 @@
+//
+// Copyright (C) 2013 Jacob McIntosh <nacitar at ubercpp dot com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+/// @file arithmetic.h
+/// @brief Provides overflow-checked and saturating integer arithmetic.
+/// @details CheckedAdd(), CheckedSub() and CheckedMul() report whether the
+/// mathematical result fits in the operand type, using the compiler's
+/// overflow builtins where available.  The saturating functions and the
+/// Saturating type clamp such results to the nearest representable value
+/// instead of wrapping.  Saturating addition and subtraction of whole arrays
+/// selects an SSE2 or AVX2 kernel at runtime and is implemented in
+/// arithmetic.cc.
+
+#ifndef INCLUDE_NX_ARITHMETIC_H_
+#define INCLUDE_NX_ARITHMETIC_H_
+
+#include "nx/core.h"
+
+/// @brief Library namespace.
+namespace nx {
+
+/// @cond nx_detail
+namespace detail {
+
+/// @brief Provides the largest value of an integral type.
+template <class T>
+constexpr EnableIf<IsUnsigned<T>, T> MaximumValue() {
+  return static_cast<T>(~static_cast<T>(0));
+}
+
+/// @brief Provides the largest value of an integral type.
+template <class T>
+constexpr EnableIf<IsSigned<T>, T> MaximumValue() {
+  return static_cast<T>(MaximumValue<Invoke<MakeUnsigned<T>>>() >> 1);
+}
+
+/// @brief Provides the smallest value of an integral type.
+template <class T>
+constexpr EnableIf<IsUnsigned<T>, T> MinimumValue() {
+  return 0;
+}
+
+/// @brief Provides the smallest value of an integral type.
+template <class T>
+constexpr EnableIf<IsSigned<T>, T> MinimumValue() {
+  return static_cast<T>(-MaximumValue<T>() - 1);
+}
+
+/// @brief The unsigned type that arithmetic on T is done in without
+/// promotion to int, which could overflow.
+template <class T>
+using UnsignedArithmetic = decltype(0u + Invoke<MakeUnsigned<T>>());
+
+/// @brief Adds, wrapping; the sum fits if it is no less than an operand.
+template <class T>
+inline EnableIf<IsUnsigned<T>, bool> GenericCheckedAdd(
+    T lhs, T rhs, T*result) {
+  *result = static_cast<T>(static_cast<UnsignedArithmetic<T>>(lhs) + rhs);
+  return *result >= lhs;
+}
+
+/// @brief Adds, wrapping; the sum overflowed if its sign differs from that of
+/// both operands.
+template <class T>
+inline EnableIf<IsSigned<T>, bool> GenericCheckedAdd(
+    T lhs, T rhs, T*result) {
+  typedef UnsignedArithmetic<T> UT;
+  *result = static_cast<T>(static_cast<UT>(lhs) + static_cast<UT>(rhs));
+  return ((lhs ^ *result) & (rhs ^ *result)) >= 0;
+}
+
+/// @brief Subtracts, wrapping; the difference fits unless rhs exceeds lhs.
+template <class T>
+inline EnableIf<IsUnsigned<T>, bool> GenericCheckedSub(
+    T lhs, T rhs, T*result) {
+  *result = static_cast<T>(static_cast<UnsignedArithmetic<T>>(lhs) - rhs);
+  return rhs <= lhs;
+}
+
+/// @brief Subtracts, wrapping; the difference overflowed if the operands'
+/// signs differ and its sign differs from that of lhs.
+template <class T>
+inline EnableIf<IsSigned<T>, bool> GenericCheckedSub(
+    T lhs, T rhs, T*result) {
+  typedef UnsignedArithmetic<T> UT;
+  *result = static_cast<T>(static_cast<UT>(lhs) - static_cast<UT>(rhs));
+  return ((lhs ^ rhs) & (lhs ^ *result)) >= 0;
+}
+
+/// @brief Multiplies, wrapping; the product fits if dividing it by one
+/// operand gives back the other.
+template <class T>
+inline EnableIf<IsUnsigned<T>, bool> GenericCheckedMul(
+    T lhs, T rhs, T*result) {
+  *result = static_cast<T>(static_cast<UnsignedArithmetic<T>>(lhs) * rhs);
+  return !lhs || *result / lhs == rhs;
+}
+
+/// @brief Multiplies the magnitudes, which fit if the product's magnitude
+/// is within that of the limit for its sign.
+template <class T>
+inline EnableIf<IsSigned<T>, bool> GenericCheckedMul(
+    T lhs, T rhs, T*result) {
+  typedef Invoke<MakeUnsigned<T>> UT;
+  typedef UnsignedArithmetic<T> AT;
+  const bool negative = (lhs < 0) != (rhs < 0);
+  const UT lhs_magnitude = static_cast<UT>(
+      lhs < 0 ? 0u - static_cast<AT>(lhs) : static_cast<AT>(lhs));
+  const UT rhs_magnitude = static_cast<UT>(
+      rhs < 0 ? 0u - static_cast<AT>(rhs) : static_cast<AT>(rhs));
+  UT magnitude;
+  const bool fits = GenericCheckedMul(
+      lhs_magnitude, rhs_magnitude, &magnitude);
+  *result = static_cast<T>(negative ? 0u - static_cast<AT>(magnitude)
+                                    : static_cast<AT>(magnitude));
+  return fits && magnitude <= static_cast<UT>(MaximumValue<T>()) + negative;
+}
+
+}  // namespace detail
+/// @endcond
+
+#if !defined(NX_USE_GENERIC_CHECKED_ARITHMETIC) && \
+    (defined(NX_TC_CLANG) || (defined(NX_TC_GCC) && NX_TC_GCC >= 50000))
+// GCC/Clang checked arithmetic
+
+/// @brief Defined if CheckedAdd(), CheckedSub() and CheckedMul() are
+/// implemented with compiler intrinsics.
+#define NX_CHECKED_ARITHMETIC_INTRINSIC 1
+
+/// @brief Adds two integers, detecting overflow.
+///
+/// @tparam T The type of the operands and result.
+/// @param lhs The first addend.
+/// @param rhs The second addend.
+/// @param result Receives the sum, wrapped to T if it does not fit.
+///
+/// @return true if the sum fits in T.
+template <class T>
+inline EnableIf<IsIntegral<T>, bool> CheckedAdd(T lhs, T rhs, T*result) {
+  return !__builtin_add_overflow(lhs, rhs, result);
+}
+
+/// @brief Subtracts two integers, detecting overflow.
+///
+/// @tparam T The type of the operands and result.
+/// @param lhs The minuend.
+/// @param rhs The subtrahend.
+/// @param result Receives the difference, wrapped to T if it does not fit.
+///
+/// @return true if the difference fits in T.
+template <class T>
+inline EnableIf<IsIntegral<T>, bool> CheckedSub(T lhs, T rhs, T*result) {
+  return !__builtin_sub_overflow(lhs, rhs, result);
+}
+
+/// @brief Multiplies two integers, detecting overflow.
+///
+/// @tparam T The type of the operands and result.
+/// @param lhs The multiplicand.
+/// @param rhs The multiplier.
+/// @param result Receives the product, wrapped to T if it does not fit.
+///
+/// @return true if the product fits in T.
+template <class T>
+inline EnableIf<IsIntegral<T>, bool> CheckedMul(T lhs, T rhs, T*result) {
+  return !__builtin_mul_overflow(lhs, rhs, result);
+}
+
+#else
+// Generic checked arithmetic
+
+/// @brief Adds two integers, detecting overflow.
+///
+/// @tparam T The type of the operands and result.
+/// @param lhs The first addend.
+/// @param rhs The second addend.
+/// @param result Receives the sum, wrapped to T if it does not fit.
+///
+/// @return true if the sum fits in T.
+template <class T>
+inline EnableIf<IsIntegral<T>, bool> CheckedAdd(T lhs, T rhs, T*result) {
+  return detail::GenericCheckedAdd(lhs, rhs, result);
+}
+
+/// @brief Subtracts two integers, detecting overflow.
+///
+/// @tparam T The type of the operands and result.
+/// @param lhs The minuend.
+/// @param rhs The subtrahend.
+/// @param result Receives the difference, wrapped to T if it does not fit.
+///
+/// @return true if the difference fits in T.
+template <class T>
+inline EnableIf<IsIntegral<T>, bool> CheckedSub(T lhs, T rhs, T*result) {
+  return detail::GenericCheckedSub(lhs, rhs, result);
+}
+
+/// @brief Multiplies two integers, detecting overflow.
+///
+/// @tparam T The type of the operands and result.
+/// @param lhs The multiplicand.
+/// @param rhs The multiplier.
+/// @param result Receives the product, wrapped to T if it does not fit.
+///
+/// @return true if the product fits in T.
+template <class T>
+inline EnableIf<IsIntegral<T>, bool> CheckedMul(T lhs, T rhs, T*result) {
+  return detail::GenericCheckedMul(lhs, rhs, result);
+}
+
+#endif
+
+/// @brief Adds two integers, clamping the sum to the range of T.
+template <class T>
+inline EnableIf<IsUnsigned<T>, T> SaturatingAdd(T lhs, T rhs) {
+  T result;
+  return CheckedAdd(lhs, rhs, &result)
+      ? result : detail::MaximumValue<T>();
+}
+
+/// @brief Adds two integers, clamping the sum to the range of T.
+template <class T>
+inline EnableIf<IsSigned<T>, T> SaturatingAdd(T lhs, T rhs) {
+  // overflow requires operands of the same sign, that of the limit crossed
+  T result;
+  return CheckedAdd(lhs, rhs, &result) ? result
+      : lhs < 0 ? detail::MinimumValue<T>() : detail::MaximumValue<T>();
+}
+
+/// @brief Subtracts two integers, clamping the difference to the range of T.
+template <class T>
+inline EnableIf<IsUnsigned<T>, T> SaturatingSub(T lhs, T rhs) {
+  T result;
+  return CheckedSub(lhs, rhs, &result) ? result : 0;
+}
+
+/// @brief Subtracts two integers, clamping the difference to the range of T.
+template <class T>
+inline EnableIf<IsSigned<T>, T> SaturatingSub(T lhs, T rhs) {
+  // overflow requires operands of differing signs, lhs having that of the
+  // limit crossed
+  T result;
+  return CheckedSub(lhs, rhs, &result) ? result
+      : lhs < 0 ? detail::MinimumValue<T>() : detail::MaximumValue<T>();
+}
+
+/// @brief Multiplies two integers, clamping the product to the range of T.
+template <class T>
+inline EnableIf<IsUnsigned<T>, T> SaturatingMul(T lhs, T rhs) {
+  T result;
+  return CheckedMul(lhs, rhs, &result)
+      ? result : detail::MaximumValue<T>();
+}
+
+/// @brief Multiplies two integers, clamping the product to the range of T.
+template <class T>
+inline EnableIf<IsSigned<T>, T> SaturatingMul(T lhs, T rhs) {
+  T result;
+  return CheckedMul(lhs, rhs, &result) ? result
+      : (lhs < 0) != (rhs < 0)
+          ? detail::MinimumValue<T>() : detail::MaximumValue<T>();
+}
+
+/// @brief An integer whose arithmetic saturates at the limits of its range
+/// rather than wrapping, as is common for signal and pixel values.
+///
+/// @tparam T The integral type holding the value.
+template <class T>
+class Saturating {
+  static_assert(IsIntegral<T>::value, "Saturating requires an integral type");
+
+ public:
+  /// @brief The integral type holding the value.
+  typedef T value_type;
+
+  /// @brief Constructs the value zero.
+  constexpr Saturating() : value_() {
+  }
+
+  /// @brief Constructs from the given value.
+  constexpr Saturating(T value)  // NOLINT(runtime/explicit)
+      : value_(value) {
+  }
+
+  /// @brief Provides the value.
+  constexpr T value() const {
+    return value_;
+  }
+
+  /// @brief Provides the largest representable value.
+  static constexpr Saturating max() {
+    return Saturating(detail::MaximumValue<T>());
+  }
+
+  /// @brief Provides the smallest representable value.
+  static constexpr Saturating min() {
+    return Saturating(detail::MinimumValue<T>());
+  }
+
+  Saturating&operator+=(Saturating other) {
+    value_ = SaturatingAdd(value_, other.value_);
+    return *this;
+  }
+
+  Saturating&operator-=(Saturating other) {
+    value_ = SaturatingSub(value_, other.value_);
+    return *this;
+  }
+
+  Saturating&operator*=(Saturating other) {
+    value_ = SaturatingMul(value_, other.value_);
+    return *this;
+  }
+
+  friend Saturating operator+(Saturating lhs, Saturating rhs) {
+    return lhs += rhs;
+  }
+
+  friend Saturating operator-(Saturating lhs, Saturating rhs) {
+    return lhs -= rhs;
+  }
+
+  friend Saturating operator*(Saturating lhs, Saturating rhs) {
+    return lhs *= rhs;
+  }
+
+  friend constexpr bool operator==(Saturating lhs, Saturating rhs) {
+    return lhs.value_ == rhs.value_;
+  }
+
+  friend constexpr bool operator!=(Saturating lhs, Saturating rhs) {
+    return lhs.value_ != rhs.value_;
+  }
+
+  friend constexpr bool operator<(Saturating lhs, Saturating rhs) {
+    return lhs.value_ < rhs.value_;
+  }
+
+  friend constexpr bool operator<=(Saturating lhs, Saturating rhs) {
+    return lhs.value_ <= rhs.value_;
+  }
+
+  friend constexpr bool operator>(Saturating lhs, Saturating rhs) {
+    return lhs.value_ > rhs.value_;
+  }
+
+  friend constexpr bool operator>=(Saturating lhs, Saturating rhs) {
+    return lhs.value_ >= rhs.value_;
+  }
+
+ private:
+  T value_;
+};
+
+/// @brief An unsigned integer of exactly kBits bits with saturating
+/// arithmetic.
+template <unsigned int kBits>
+using SaturatingUInt = Saturating<uint_t<kBits>>;
+
+/// @brief A signed integer of exactly kBits bits with saturating arithmetic.
+template <unsigned int kBits>
+using SaturatingInt = Saturating<int_t<kBits>>;
+
+/// @cond nx_detail
+namespace detail {
+
+/// @brief The implementations available for saturating arithmetic on arrays.
+enum class SaturatingKernel {
+  /// @brief One SaturatingAdd() or SaturatingSub() call per element.
+  kScalar,
+  /// @brief SSE2, 16 bytes at a time; padds/paddus and psubs/psubus for 8
+  /// and 16-bit elements.
+  kSse2,
+  /// @brief AVX2, 32 bytes at a time; vpadds/vpaddus and vpsubs/vpsubus for
+  /// 8 and 16-bit elements.
+  kAvx2
+};
+
+/// @brief Determines if the running processor can execute the given kernel.
+bool SaturatingSupported(SaturatingKernel kernel);
+
+/// @brief Adds the elements of two arrays with saturation using the given
+/// kernel, which must be supported by the running processor.
+///
+/// @param kernel The implementation to use.
+/// @param lhs The first addends.
+/// @param rhs The second addends.
+/// @param result Where to store the sums; may equal lhs or rhs.
+/// @param length The number of elements.
+/// @param element_size The size of each element: 1, 2, 4 or 8 bytes.
+/// @param is_signed Whether the elements are signed.
+void SaturatingAddBuffer(
+    SaturatingKernel kernel, const void*lhs, const void*rhs, void*result,
+    size_t length, unsigned int element_size, bool is_signed);
+
+/// @brief Adds the elements of two arrays with saturation using the fastest
+/// kernel supported by the running processor.
+void SaturatingAddBuffer(
+    const void*lhs, const void*rhs, void*result,
+    size_t length, unsigned int element_size, bool is_signed);
+
+/// @brief Subtracts the elements of two arrays with saturation using the
+/// given kernel, which must be supported by the running processor.
+///
+/// @param kernel The implementation to use.
+/// @param lhs The minuends.
+/// @param rhs The subtrahends.
+/// @param result Where to store the differences; may equal lhs or rhs.
+/// @param length The number of elements.
+/// @param element_size The size of each element: 1, 2, 4 or 8 bytes.
+/// @param is_signed Whether the elements are signed.
+void SaturatingSubBuffer(
+    SaturatingKernel kernel, const void*lhs, const void*rhs, void*result,
+    size_t length, unsigned int element_size, bool is_signed);
+
+/// @brief Subtracts the elements of two arrays with saturation using the
+/// fastest kernel supported by the running processor.
+void SaturatingSubBuffer(
+    const void*lhs, const void*rhs, void*result,
+    size_t length, unsigned int element_size, bool is_signed);
+
+}  // namespace detail
+/// @endcond
+
+/// @brief Adds the elements of two arrays, clamping each sum to the range
+/// of T.
+///
+/// @tparam T The type of the array elements.
+/// @param lhs The first addends.
+/// @param rhs The second addends.
+/// @param result Where to store the sums; may be the same array as lhs or
+/// rhs, but must not otherwise overlap them.
+/// @param length The number of elements.
+template <class T>
+inline EnableIf<All<
+    IsIntegral<T>, Not<std::is_same<T, bool>>, BitRange<T, 0, 64>>,
+void> SaturatingAdd(const T*lhs, const T*rhs, T*result, size_t length) {
+  detail::SaturatingAddBuffer(
+      lhs, rhs, result, length, sizeof(T), IsSigned<T>::value);
+}
+
+/// @brief Subtracts the elements of one array from those of another,
+/// clamping each difference to the range of T.
+///
+/// @tparam T The type of the array elements.
+/// @param lhs The minuends.
+/// @param rhs The subtrahends.
+/// @param result Where to store the differences; may be the same array as
+/// lhs or rhs, but must not otherwise overlap them.
+/// @param length The number of elements.
+template <class T>
+inline EnableIf<All<
+    IsIntegral<T>, Not<std::is_same<T, bool>>, BitRange<T, 0, 64>>,
+void> SaturatingSub(const T*lhs, const T*rhs, T*result, size_t length) {
+  detail::SaturatingSubBuffer(
+      lhs, rhs, result, length, sizeof(T), IsSigned<T>::value);
+}
+
+}  // namespace nx
+
+#endif  // INCLUDE_NX_ARITHMETIC_H_
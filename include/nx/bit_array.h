@@ -0,0 +1,363 @@
+//
+// Copyright (C) 2013 Jacob McIntosh <nacitar at ubercpp dot com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+/// @file bit_array.h
+/// @brief Provides a fixed-size array of bits, like std::bitset, with
+/// constexpr construction and access, set bit search and iteration, and
+/// rank queries.
+/// @details Whole-array operations loop over words of known count, which
+/// compilers unroll and vectorize.  Counting fewer than kInlineCountWords
+/// words calls the inline single-word PopulationCount() on each, avoiding an
+/// indirect call; longer runs go through the runtime dispatched
+/// PopulationCount() buffer kernels, whose popcnt or vector instructions
+/// outweigh that call.
+
+#ifndef INCLUDE_NX_BIT_ARRAY_H_
+#define INCLUDE_NX_BIT_ARRAY_H_
+
+#include "nx/core.h"
+#include "nx/bit_scan_forward.h"
+#include "nx/bit_scan_reverse.h"
+#include "nx/population_count.h"
+#include "nx/set_bits.h"
+
+/// @brief Library namespace.
+namespace nx {
+
+/// @brief A fixed-size array of bits.
+/// @details Bit i is stored in word i / kWordBits, at bit i % kWordBits.
+/// The unused high bits of the last word are always zero.
+///
+/// @tparam kBits The number of bits.
+template <unsigned int kBits>
+class BitArray {
+ public:
+  /// @brief The type of the words holding the bits; the smallest that fits
+  /// all of them, up to 64 bits.
+  typedef uint_least_t<(kBits == 0 ? 1 : kBits < 64 ? kBits : 64)> word_type;
+
+  /// @brief The number of bits in each word.
+  static constexpr unsigned int kWordBits = BitSize<word_type>::value;
+
+  /// @brief The number of words.
+  static constexpr unsigned int kWords =
+      kBits == 0 ? 1 : (kBits + kWordBits - 1) / kWordBits;
+
+  /// @brief The bits of the last word that are part of the array.
+  static constexpr word_type kLastMask =
+      BitMask<word_type, kBits - (kWords - 1) * kWordBits>::value;
+
+  /// @brief The number of words below which counting is done inline rather
+  /// than through the PopulationCount() buffer kernels.
+  static constexpr unsigned int kInlineCountWords = 4;
+
+  /// @brief Constructs with all bits clear.
+  constexpr BitArray() : words_() {
+  }
+
+  /// @brief Constructs with the low bits set as in the given value; bits of
+  /// the value beyond kBits are ignored.
+  explicit constexpr BitArray(uint64_t value)
+      : BitArray(value, MakeIndexSequence<kWords>()) {
+  }
+
+  /// @brief Provides the number of bits.
+  static constexpr size_t size() {
+    return kBits;
+  }
+
+  /// @brief Provides the words holding the bits.
+  const word_type*data() const {
+    return words_;
+  }
+
+  /// @brief Provides the words holding the bits, which may be modified so
+  /// long as the unused bits of the last word are left clear.
+  word_type*data() {
+    return words_;
+  }
+
+  /// @brief Determines if a bit is set.
+  constexpr bool operator[](size_t index) const {
+    return Test(index);
+  }
+
+  /// @brief Determines if a bit is set.
+  constexpr bool Test(size_t index) const {
+    return (words_[index / kWordBits] >> (index % kWordBits)) & 1u;
+  }
+
+  /// @brief Sets a bit to the given value.
+  BitArray& Set(size_t index, bool value = true) {
+    const word_type bit = Bit(index);
+    word_type&word = words_[index / kWordBits];
+    word = static_cast<word_type>(value ? word | bit : word & ~bit);
+    return *this;
+  }
+
+  /// @brief Clears a bit.
+  BitArray& Reset(size_t index) {
+    return Set(index, false);
+  }
+
+  /// @brief Inverts a bit.
+  BitArray& Flip(size_t index) {
+    words_[index / kWordBits] ^= Bit(index);
+    return *this;
+  }
+
+  /// @brief Sets all bits.
+  BitArray& SetAll() {
+    for (unsigned int i = 0; i < kWords; ++i) {
+      words_[i] = static_cast<word_type>(~static_cast<word_type>(0));
+    }
+    words_[kWords - 1] = kLastMask;
+    return *this;
+  }
+
+  /// @brief Clears all bits.
+  BitArray& ResetAll() {
+    for (unsigned int i = 0; i < kWords; ++i) {
+      words_[i] = 0;
+    }
+    return *this;
+  }
+
+  /// @brief Provides the number of set bits.
+  size_t Count() const {
+    return CountWords(words_, kWords);
+  }
+
+  /// @brief Provides the number of set bits below the given index, which may
+  /// be up to size().
+  size_t Rank(size_t index) const {
+    const size_t word = index / kWordBits;
+    const unsigned int bit = index % kWordBits;
+    size_t rank = CountWords(words_, word);
+    if (bit) {
+      rank += PopulationCount(static_cast<word_type>(
+          words_[word] & (Bit(index) - 1)));
+    }
+    return rank;
+  }
+
+  /// @brief Determines if any bit is set.
+  bool Any() const {
+    word_type any = 0;
+    for (unsigned int i = 0; i < kWords; ++i) {
+      any |= words_[i];
+    }
+    return any != 0;
+  }
+
+  /// @brief Determines if no bit is set.
+  bool None() const {
+    return !Any();
+  }
+
+  /// @brief Determines if every bit is set.
+  bool All() const {
+    word_type all = kLastMask;
+    for (unsigned int i = 0; i + 1 < kWords; ++i) {
+      all &= words_[i];
+    }
+    return (all & words_[kWords - 1]) == kLastMask;
+  }
+
+  /// @brief Finds the lowest set bit.
+  ///
+  /// @return Its index, or size() if no bit is set.
+  size_t FindFirst() const {
+    return FindFrom(0, words_[0]);
+  }
+
+  /// @brief Finds the lowest set bit above the given index.
+  ///
+  /// @return Its index, or size() if there is none.
+  size_t FindNext(size_t index) const {
+    const size_t start = index + 1;
+    if (start >= kBits) {
+      return kBits;
+    }
+    const unsigned int word = static_cast<unsigned int>(start / kWordBits);
+    return FindFrom(word, static_cast<word_type>(
+        words_[word] & ~(Bit(start) - 1)));
+  }
+
+  /// @brief Finds the highest set bit.
+  ///
+  /// @return Its index, or size() if no bit is set.
+  size_t FindLast() const {
+    for (unsigned int i = kWords; i--;) {
+      if (words_[i]) {
+        return static_cast<size_t>(i) * kWordBits
+            + BitScanReverse(words_[i]);
+      }
+    }
+    return kBits;
+  }
+
+  /// @brief Calls a function with the index of each set bit, in increasing
+  /// order.
+  ///
+  /// @tparam Function A callable accepting a size_t.
+  template <class Function>
+  void ForEachSetBit(Function function) const {
+    nx::ForEachSetBit(words_, kWords, function);
+  }
+
+  /// @brief Clears the bits that are set in other.
+  BitArray& AndNot(const BitArray&other) {
+    for (unsigned int i = 0; i < kWords; ++i) {
+      words_[i] = static_cast<word_type>(words_[i] & ~other.words_[i]);
+    }
+    return *this;
+  }
+
+  /// @brief Keeps only the bits that are also set in other.
+  BitArray& operator&=(const BitArray&other) {
+    for (unsigned int i = 0; i < kWords; ++i) {
+      words_[i] &= other.words_[i];
+    }
+    return *this;
+  }
+
+  /// @brief Sets the bits that are set in other.
+  BitArray& operator|=(const BitArray&other) {
+    for (unsigned int i = 0; i < kWords; ++i) {
+      words_[i] |= other.words_[i];
+    }
+    return *this;
+  }
+
+  /// @brief Inverts the bits that are set in other.
+  BitArray& operator^=(const BitArray&other) {
+    for (unsigned int i = 0; i < kWords; ++i) {
+      words_[i] ^= other.words_[i];
+    }
+    return *this;
+  }
+
+  /// @brief Provides a copy with every bit inverted.
+  BitArray operator~() const {
+    BitArray result;
+    for (unsigned int i = 0; i < kWords; ++i) {
+      result.words_[i] = static_cast<word_type>(~words_[i]);
+    }
+    result.words_[kWords - 1] &= kLastMask;
+    return result;
+  }
+
+  /// @brief Determines if both arrays have the same bits set.
+  bool operator==(const BitArray&other) const {
+    word_type difference = 0;
+    for (unsigned int i = 0; i < kWords; ++i) {
+      difference |= words_[i] ^ other.words_[i];
+    }
+    return difference == 0;
+  }
+
+  /// @brief Determines if the arrays differ in any bit.
+  bool operator!=(const BitArray&other) const {
+    return !(*this == other);
+  }
+
+ private:
+  /// @brief Counts the set bits of the first count words.
+  static size_t CountWords(const word_type*words, size_t count) {
+    if (count >= kInlineCountWords) {
+      return static_cast<size_t>(PopulationCount(words, count));
+    }
+    size_t total = 0;
+    for (size_t i = 0; i < count; ++i) {
+      total += PopulationCount(words[i]);
+    }
+    return total;
+  }
+
+  template <unsigned int... kIndices>
+  constexpr BitArray(uint64_t value, IndexSequence<kIndices...>)
+      : words_{ WordOf(value, kIndices)... } {
+  }
+
+  /// @brief Provides the word at the given index of an array constructed
+  /// from value.
+  static constexpr word_type WordOf(uint64_t value, unsigned int index) {
+    return static_cast<word_type>(
+        (index * kWordBits < BitSize<uint64_t>::value
+            ? value >> (index * kWordBits) : 0)
+        & (index == kWords - 1 ? kLastMask : ~static_cast<word_type>(0)));
+  }
+
+  /// @brief Provides the bit for an index within its word.
+  static constexpr word_type Bit(size_t index) {
+    return static_cast<word_type>(
+        static_cast<word_type>(1) << (index % kWordBits));
+  }
+
+  /// @brief Finds the lowest set bit of the given bits of a word and of the
+  /// words above it.
+  size_t FindFrom(unsigned int word, word_type bits) const {
+    while (!bits) {
+      if (++word == kWords) {
+        return kBits;
+      }
+      bits = words_[word];
+    }
+    return static_cast<size_t>(word) * kWordBits + BitScanForward(bits);
+  }
+
+  /// @brief The bits, least significant first.
+  word_type words_[kWords];
+};
+
+template <unsigned int kBits>
+constexpr unsigned int BitArray<kBits>::kWordBits;
+
+template <unsigned int kBits>
+constexpr unsigned int BitArray<kBits>::kWords;
+
+template <unsigned int kBits>
+constexpr typename BitArray<kBits>::word_type BitArray<kBits>::kLastMask;
+
+template <unsigned int kBits>
+constexpr unsigned int BitArray<kBits>::kInlineCountWords;
+
+/// @brief Provides the bits set in both arrays.
+template <unsigned int kBits>
+inline BitArray<kBits> operator&(BitArray<kBits> lhs,
+                                 const BitArray<kBits>&rhs) {
+  return lhs &= rhs;
+}
+
+/// @brief Provides the bits set in either array.
+template <unsigned int kBits>
+inline BitArray<kBits> operator|(BitArray<kBits> lhs,
+                                 const BitArray<kBits>&rhs) {
+  return lhs |= rhs;
+}
+
+/// @brief Provides the bits set in exactly one of the arrays.
+template <unsigned int kBits>
+inline BitArray<kBits> operator^(BitArray<kBits> lhs,
+                                 const BitArray<kBits>&rhs) {
+  return lhs ^= rhs;
+}
+
+}  // namespace nx
+
+#endif  // INCLUDE_NX_BIT_ARRAY_H_
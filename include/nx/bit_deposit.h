@@ -0,0 +1,200 @@
+//
+// Copyright (C) 2013 Jacob McIntosh <nacitar at ubercpp dot com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+/// @file bit_deposit.h
+/// @brief Provides functions to scatter the low bits of a value to the set
+/// bit positions of a mask, and to gather them back.
+/// @details These are the BMI2 pdep and pext instructions, which are used
+/// when the build targets BMI2.  If you define NX_USE_GENERIC_BIT_DEPOSIT,
+/// even then a generic loop will be used; that is the better choice for
+/// builds targetting AMD processors before Zen 3, where pdep and pext are
+/// microcoded.
+
+#ifndef INCLUDE_NX_BIT_DEPOSIT_H_
+#define INCLUDE_NX_BIT_DEPOSIT_H_
+
+#include "nx/core.h"
+
+#if defined(NX_ARCH_X86_64)
+  #include <immintrin.h>
+#endif
+
+/// @brief Library namespace.
+namespace nx {
+// Enable this define to not use compiler builtins.
+// #define NX_USE_GENERIC_BIT_DEPOSIT
+
+/// @cond nx_detail
+namespace detail {
+
+/// @brief Provides all ones if the condition holds, and zero otherwise;
+/// this keeps the loops below free of unpredictable branches.
+template <class T>
+inline constexpr T AllIf(bool condition) {
+  return static_cast<T>(static_cast<T>(0) - static_cast<T>(condition));
+}
+
+/// @brief Deposits one bit per set bit of the mask, lowest first.
+template <class T>
+inline constexpr T BitDepositLoop(T value, T mask, T bit, T result) {
+  return mask ? BitDepositLoop(
+      value, static_cast<T>(mask & (mask - 1)), static_cast<T>(bit << 1),
+      static_cast<T>(
+          result | (mask & (~mask + 1) & AllIf<T>((value & bit) != 0))))
+      : result;
+}
+
+/// @brief Extracts one bit per set bit of the mask, lowest first.
+template <class T>
+inline constexpr T BitExtractLoop(T value, T mask, T bit, T result) {
+  return mask ? BitExtractLoop(
+      value, static_cast<T>(mask & (mask - 1)), static_cast<T>(bit << 1),
+      static_cast<T>(
+          result | (bit & AllIf<T>((value & mask & (~mask + 1)) != 0))))
+      : result;
+}
+
+}  // namespace detail
+/// @endcond
+
+#if !defined(NX_USE_GENERIC_BIT_DEPOSIT) && defined(NX_ARCH_X86_64) && \
+    (defined(__BMI2__) || (defined(NX_TC_VS) && defined(__AVX2__)))
+// BMI2 BitDeposit; the intrinsics are not constexpr.
+
+/// @brief Defined if BitDeposit and BitExtract are implemented with compiler
+/// intrinsics.
+#define NX_BIT_DEPOSIT_INTRINSIC 1
+
+/// @cond nx_detail
+namespace detail {
+
+/// @brief [33,64]-bit version
+template <class T>
+inline EnableIf<All<
+    std::is_unsigned<T>, BitRange<T, 33, 64>>,
+T> BitDeposit(T value, T mask) {
+  return _pdep_u64(value, mask);
+}
+
+/// @brief [0,32]-bit version
+template <class T>
+inline EnableIf<All<
+    std::is_unsigned<T>, BitRange<T, 0, 32>>,
+T> BitDeposit(T value, T mask) {
+  return static_cast<T>(_pdep_u32(value, mask));
+}
+
+/// @brief [33,64]-bit version
+template <class T>
+inline EnableIf<All<
+    std::is_unsigned<T>, BitRange<T, 33, 64>>,
+T> BitExtract(T value, T mask) {
+  return _pext_u64(value, mask);
+}
+
+/// @brief [0,32]-bit version
+template <class T>
+inline EnableIf<All<
+    std::is_unsigned<T>, BitRange<T, 0, 32>>,
+T> BitExtract(T value, T mask) {
+  return static_cast<T>(_pext_u32(value, mask));
+}
+
+}  // namespace detail
+/// @endcond
+#else
+// Generic BitDeposit
+
+/// @cond nx_detail
+namespace detail {
+
+/// @brief [33,64]-bit selector
+template <class T>
+inline constexpr EnableIf<All<
+    std::is_unsigned<T>, BitRange<T, 33, 64>>,
+T> BitDeposit(T value, T mask) {
+  return BitDepositLoop<uint64_t>(value, mask, 1, 0);
+}
+
+/// @brief [0,32]-bit selector
+template <class T>
+inline constexpr EnableIf<All<
+    std::is_unsigned<T>, BitRange<T, 0, 32>>,
+T> BitDeposit(T value, T mask) {
+  return static_cast<T>(BitDepositLoop<uint32_t>(value, mask, 1, 0));
+}
+
+/// @brief [33,64]-bit selector
+template <class T>
+inline constexpr EnableIf<All<
+    std::is_unsigned<T>, BitRange<T, 33, 64>>,
+T> BitExtract(T value, T mask) {
+  return BitExtractLoop<uint64_t>(value, mask, 1, 0);
+}
+
+/// @brief [0,32]-bit selector
+template <class T>
+inline constexpr EnableIf<All<
+    std::is_unsigned<T>, BitRange<T, 0, 32>>,
+T> BitExtract(T value, T mask) {
+  return static_cast<T>(BitExtractLoop<uint32_t>(value, mask, 1, 0));
+}
+
+}  // namespace detail
+/// @endcond
+
+#endif
+
+/// @brief Scatters the low bits of a value to the positions of the set bits
+/// of a mask (parallel bit deposit).
+///
+/// @tparam T The type of the passed values.
+/// @param value The bits to deposit, lowest first.
+/// @param mask The positions to deposit them at.
+///
+/// @return A value whose Nth lowest set bit of the mask holds bit N of the
+/// value, and which is zero wherever the mask is.
+template <class T>
+inline constexpr EnableIf<All<
+    std::is_integral<T>, BitRange<T, 0, 64>>,
+T> BitDeposit(T value, T mask) {
+  typedef typename std::make_unsigned<T>::type UT;
+  return static_cast<T>(detail::BitDeposit(
+      static_cast<UT>(value), static_cast<UT>(mask)));
+}
+
+/// @brief Gathers the bits of a value at the positions of the set bits of a
+/// mask into the low bits of the result (parallel bit extract).
+///
+/// @tparam T The type of the passed values.
+/// @param value The value to extract bits from.
+/// @param mask The positions to extract.
+///
+/// @return A value whose bit N holds the bit of the value at the Nth lowest
+/// set bit of the mask, with the bits above the mask's population zero.
+template <class T>
+inline constexpr EnableIf<All<
+    std::is_integral<T>, BitRange<T, 0, 64>>,
+T> BitExtract(T value, T mask) {
+  typedef typename std::make_unsigned<T>::type UT;
+  return static_cast<T>(detail::BitExtract(
+      static_cast<UT>(value), static_cast<UT>(mask)));
+}
+
+}  // namespace nx
+
+#endif  // INCLUDE_NX_BIT_DEPOSIT_H_
@@ -19,56 +19,26 @@
 /// set bit in an unsigned integral value.
 /// @details If you define NX_USE_GENERIC_BIT_SCAN_FORWARD, even on platforms
 /// with the appropriate compiler intrinsics, a generic fallback will be used.
+/// The fallback uses de Bruijn multiplication and a lookup table, or SWAR
+/// arithmetic if you define NX_USE_SWAR (see swar.h).
 
 #ifndef INCLUDE_NX_BIT_SCAN_FORWARD_H_
 #define INCLUDE_NX_BIT_SCAN_FORWARD_H_
 
 #include "nx/core.h"
+#include "nx/constant.h"
+#include "nx/swar.h"
+
+#if defined(NX_TC_VS)
+  #include <intrin.h>
+#endif
 
 /// @brief Library namespace.
 namespace nx {
 // Enable this define to not use compiler builtins.
 // #define NX_USE_GENERIC_BIT_SCAN_FORWARD
 
-#if !defined(NX_USE_GENERIC_BIT_SCAN_FORWARD) && defined(NX_TC_GCC)
-// GCC BitScanForward - finds the lowest set bit index
-
-/// @cond nx_detail
-namespace detail {
-
-/// @brief unsigned long long version
-template <class T>
-inline constexpr EnableIf<All<
-      std::is_integral<T>,
-      IntegerFits<T, unsigned long long>,  // NOLINT(runtime/int)
-      Not<IntegerFits<T, unsigned long>>>,  // NOLINT(runtime/int)
-unsigned int> BitScanForward(T value) {
-  return (value ? __builtin_ctzll(value) : 0);
-}
-
-/// @brief unsigned long version
-template <class T>
-inline constexpr EnableIf<All<
-      std::is_integral<T>,
-      IntegerFits<T, unsigned long>,  // NOLINT(runtime/int)
-      Not<IntegerFits<T, unsigned int>>>,
-unsigned int> BitScanForward(T value) {
-  return (value ? __builtin_ctzl(value) : 0);
-}
-
-/// @brief unsigned int version
-template <class T>
-inline constexpr EnableIf<All<
-      std::is_integral<T>,
-      IntegerFits<T, unsigned int>>,
-unsigned int> BitScanForward(T value) {
-  return (value ? __builtin_ctz(value) : 0);
-}
-
-}  // namespace detail
-/// @endcond
-#else
-// Generic BitScanForward
+// de Bruijn BitScanForward; used by the generic fallback.
 
 /// @cond nx_detail
 namespace detail {
@@ -79,7 +49,7 @@ namespace version {
 /// @brief 64-bit version
 template <unsigned int kVersion, class T>
 inline constexpr EnableIf<All<
-    std::is_integral<T>, Bool<kVersion == 64>>,
+    IsIntegral<T>, Bool<kVersion == 64>>,
 unsigned int> BitScanForward(T value) {
   typedef typename std::make_signed<
       typename std::add_const<T>::type
@@ -100,7 +70,7 @@ unsigned int> BitScanForward(T value) {
 /// @brief 32-bit version
 template <unsigned int kVersion, class T>
 inline constexpr EnableIf<All<
-    std::is_integral<T>, Bool<kVersion == 32>>,
+    IsIntegral<T>, Bool<kVersion == 32>>,
 unsigned int> BitScanForward(T value) {
   typedef typename std::make_signed<
     typename std::add_const<T>::type
@@ -121,10 +91,116 @@ unsigned int> BitScanForward(T value) {
 }  // namespace version
 /// @endcond
 
+}  // namespace detail
+/// @endcond
+
+#if !defined(NX_USE_GENERIC_BIT_SCAN_FORWARD) && \
+    (defined(NX_TC_GCC) || defined(NX_TC_CLANG))
+// GCC/Clang BitScanForward - finds the lowest set bit index
+
+/// @brief Defined if BitScanForward is implemented with compiler intrinsics.
+#define NX_BIT_SCAN_FORWARD_INTRINSIC 1
+
+/// @cond nx_detail
+namespace detail {
+
+/// @brief unsigned long long version
+template <class T>
+inline constexpr EnableIf<All<
+      IsIntegral<T>,
+      IntegerFits<T, unsigned long long>,  // NOLINT(runtime/int)
+      Not<IntegerFits<T, unsigned long>>>,  // NOLINT(runtime/int)
+unsigned int> BitScanForward(T value) {
+  return (value ? __builtin_ctzll(value) : 0);
+}
+
+/// @brief unsigned long version
+template <class T>
+inline constexpr EnableIf<All<
+      IsIntegral<T>,
+      IntegerFits<T, unsigned long>,  // NOLINT(runtime/int)
+      Not<IntegerFits<T, unsigned int>>>,
+unsigned int> BitScanForward(T value) {
+  return (value ? __builtin_ctzl(value) : 0);
+}
+
+/// @brief unsigned int version
+template <class T>
+inline constexpr EnableIf<All<
+      IsIntegral<T>,
+      IntegerFits<T, unsigned int>>,
+unsigned int> BitScanForward(T value) {
+  return (value ? __builtin_ctz(value) : 0);
+}
+
+}  // namespace detail
+/// @endcond
+#elif !defined(NX_USE_GENERIC_BIT_SCAN_FORWARD) && defined(NX_TC_VS)
+// Visual Studio BitScanForward; the intrinsics are not constexpr.
+
+/// @brief Defined if BitScanForward is implemented with compiler intrinsics.
+#define NX_BIT_SCAN_FORWARD_INTRINSIC 1
+
+/// @cond nx_detail
+namespace detail {
+
+/// @brief [33,64]-bit version
+template <class T>
+inline EnableIf<All<
+    IsIntegral<T>, BitRange<T, 33, 64>>,
+unsigned int> BitScanForward(T value) {
+  unsigned long index;  // NOLINT(runtime/int)
+#if defined(NX_ARCH_X86_64)
+  return _BitScanForward64(&index, static_cast<unsigned __int64>(value))
+      ? index : 0;
+#else
+  const unsigned __int64 bits = static_cast<unsigned __int64>(value);
+  if (_BitScanForward(&index, static_cast<unsigned long>(bits))) {
+    return index;
+  }
+  return _BitScanForward(&index, static_cast<unsigned long>(bits >> 32))
+      ? 32 + index : 0;
+#endif
+}
+
+/// @brief [0,32]-bit version
+template <class T>
+inline EnableIf<All<
+    IsIntegral<T>, BitRange<T, 0, 32>>,
+unsigned int> BitScanForward(T value) {
+  unsigned long index;  // NOLINT(runtime/int)
+  return _BitScanForward(&index, static_cast<unsigned long>(value))
+      ? index : 0;
+}
+
+}  // namespace detail
+/// @endcond
+#elif defined(NX_USE_SWAR)
+// SWAR BitScanForward
+
+/// @cond nx_detail
+namespace detail {
+
+/// @brief [0,64]-bit selector
+template <class T>
+inline constexpr EnableIf<All<
+    IsIntegral<T>, BitRange<T, 0, 64>>,
+unsigned int> BitScanForward(T value) {
+  return swar::BitScanForward(value);
+}
+
+}  // namespace detail
+/// @endcond
+#else
+// de Bruijn BitScanForward
+
+/// @cond nx_detail
+namespace detail {
+
 /// @brief [0,32]-bit selector
 template <class T>
 inline constexpr EnableIf<All<
-    std::is_integral<T>, BitRange<T, 0, 32>>,
+    IsIntegral<T>, BitRange<T, 0, 32>>,
 unsigned int> BitScanForward(T value) {
   return version::BitScanForward<32>(value);
 }
@@ -132,7 +208,7 @@ unsigned int> BitScanForward(T value) {
 /// @brief [33,64]-bit selector
 template <class T>
 inline constexpr EnableIf<All<
-    std::is_integral<T>, BitRange<T, 33, 64>>,
+    IsIntegral<T>, BitRange<T, 33, 64>>,
 unsigned int> BitScanForward(T value) {
   return version::BitScanForward<64>(value);
 }
@@ -142,18 +218,57 @@ unsigned int> BitScanForward(T value) {
 
 #endif
 
-/// @brief Determines the index of the most significant set bit.
+#if defined(NX_HAS_INT128)
+/// @cond nx_detail
+namespace detail {
+
+/// @brief [65,128]-bit selector; scans the low 64-bit half, then the high
+/// one.
+template <class T>
+inline constexpr EnableIf<All<
+    IsIntegral<T>, BitRange<T, 65, 128>>,
+unsigned int> BitScanForward(T value) {
+  return static_cast<uint64_t>(value)
+      ? BitScanForward(static_cast<uint64_t>(value))
+      : value ? 64 + BitScanForward(static_cast<uint64_t>(
+          static_cast<Invoke<MakeUnsigned<T>>>(value) >> 64)) : 0;
+}
+
+}  // namespace detail
+/// @endcond
+#endif
+
+/// @brief Determines the index of the least significant set bit.
 ///
 /// @tparam T The type of the passed value.
 /// @param value The value to examine.
 ///
-/// @return The index of the highest bit set, with 0 indicating the least
+/// @return The index of the lowest bit set, with 0 indicating the least
 /// significant bit.  If the value is 0, then 0 is returned.
 template <class T>
 constexpr unsigned int BitScanForward(T value) {
   return detail::BitScanForward(value);
 }
 
+/// @brief Determines the index of the least significant set bit of a wide
+/// integer.
+///
+/// @tparam kBits The size of the passed value.
+/// @param value The value to examine.
+///
+/// @return The index of the lowest bit set, with 0 indicating the least
+/// significant bit.  If the value is 0, then 0 is returned.
+template <unsigned int kBits>
+inline unsigned int BitScanForward(const WideUInt<kBits>&value) {
+  typedef WideUInt<kBits> Wide;
+  for (unsigned int i = 0; i < Wide::kWords; ++i) {
+    if (value.word(i)) {
+      return i * Wide::kWordBits + BitScanForward(value.word(i));
+    }
+  }
+  return 0;
+}
+
 }  // namespace nx
 
 #endif  // INCLUDE_NX_BIT_SCAN_FORWARD_H_
@@ -19,11 +19,20 @@
 /// set bit in an unsigned integral value.
 /// @details If you define NX_USE_GENERIC_BIT_SCAN_REVERSE, even on platforms
 /// with the appropriate compiler intrinsics, a generic fallback will be used.
+/// The fallback uses 8-bit lookup tables, 16-bit ones if you define
+/// NX_USE_WIDE_TABLES (see constant.h), or SWAR arithmetic if you define
+/// NX_USE_SWAR (see swar.h).
 
 #ifndef INCLUDE_NX_BIT_SCAN_REVERSE_H_
 #define INCLUDE_NX_BIT_SCAN_REVERSE_H_
 
 #include "nx/core.h"
+#include "nx/constant.h"
+#include "nx/swar.h"
+
+#if defined(NX_TC_VS)
+  #include <intrin.h>
+#endif
 
 /// @brief Library namespace.
 namespace nx {
@@ -31,46 +40,7 @@ namespace nx {
 // Enable this define to not use compiler builtins.
 // #define NX_USE_GENERIC_BIT_SCAN_REVERSE
 
-#if !defined(NX_USE_GENERIC_BIT_SCAN_REVERSE) && defined(NX_TC_GCC)
-// GCC BitScanReverse
-
-/// @cond nx_detail
-namespace detail {
-
-/// @brief unsigned long long version
-template <class T>
-inline constexpr EnableIf<All<
-    std::is_integral<T>,
-    IntegerFits<T, unsigned long long>,  // NOLINT(runtime/int)
-    Not<IntegerFits<T, unsigned long>>>,  // NOLINT(runtime/int)
-unsigned int> BitScanReverse(T value) {
-  return (value ? BitSize<T>::value - 1 - __builtin_clzll(value) : 0);
-}
-
-/// @brief unsigned long version
-template <class T>
-inline constexpr EnableIf<All<
-    std::is_integral<T>,
-    IntegerFits<T, unsigned long>,  // NOLINT(runtime/int)
-    Not<IntegerFits<T, unsigned int>>>,
-unsigned int> BitScanReverse(T value) {
-  return (value ? BitSize<T>::value - 1 - __builtin_clzl(value) : 0);
-}
-
-/// @brief unsigned int version
-template <class T>
-inline constexpr EnableIf<All<
-    std::is_integral<T>,
-    IntegerFits<T, unsigned int>>,
-unsigned int> BitScanReverse(T value) {
-  return (value ? BitSize<T>::value - 1 - __builtin_clz(value) : 0);
-}
-
-}  // namespace detail
-/// @endcond
-
-#else
-// Generic BitScanReverse - finds the highest set bit index
+// Lookup table BitScanReverse; used by the generic fallback.
 
 /// @cond nx_detail
 namespace detail {
@@ -81,7 +51,7 @@ namespace version {
 /// @brief 8-bit version
 template <unsigned int kVersion, class T>
 inline constexpr EnableIf<All<
-    std::is_integral<T>, Bool<kVersion == 8>>,
+    IsIntegral<T>, Bool<kVersion == 8>>,
 unsigned int> BitScanReverse(T value) {
   using constant::log_8bit;
   // for types <= 8
@@ -91,7 +61,7 @@ unsigned int> BitScanReverse(T value) {
 /// @brief 16-bit version
 template <unsigned int kVersion, class T>
 inline constexpr EnableIf<All<
-    std::is_integral<T>, Bool<kVersion == 16>>,
+    IsIntegral<T>, Bool<kVersion == 16>>,
 unsigned int> BitScanReverse(T value) {
   using constant::log_8bit;
   return (
@@ -102,7 +72,7 @@ unsigned int> BitScanReverse(T value) {
 /// @brief 32-bit version
 template <unsigned int kVersion, class T>
 constexpr EnableIf<All<
-    std::is_integral<T>, Bool<kVersion == 32>>,
+    IsIntegral<T>, Bool<kVersion == 32>>,
 unsigned int> BitScanReverse(T value) {
   using constant::log_8bit;
   return (
@@ -116,7 +86,7 @@ unsigned int> BitScanReverse(T value) {
 /// @brief 64-bit version
 template <unsigned int kVersion, class T>
 constexpr EnableIf<All<
-    std::is_integral<T>, Bool<kVersion == 64>>,
+    IsIntegral<T>, Bool<kVersion == 64>>,
 unsigned int> BitScanReverse(T value) {
   using constant::log_8bit;
   return (
@@ -130,39 +100,245 @@ unsigned int> BitScanReverse(T value) {
     : (BitScanReverse<32>(value)));
 }
 
+// 16-bit lookup table BitScanReverse; used by the generic fallback if you
+// define NX_USE_WIDE_TABLES.
+
+/// @brief 16-bit version
+template <unsigned int kVersion, class T>
+inline constexpr EnableIf<All<
+    IsIntegral<T>, Bool<kVersion == 16>>,
+unsigned int> WideBitScanReverse(T value) {
+  typedef constant::log_16bit table;
+  // for types <= 16
+  return table::value[value];
+}
+
+/// @brief 32-bit version
+template <unsigned int kVersion, class T>
+constexpr EnableIf<All<
+    IsIntegral<T>, Bool<kVersion == 32>>,
+unsigned int> WideBitScanReverse(T value) {
+  typedef constant::log_16bit table;
+  return (
+    // for types <= 32
+    (value >> 16) ? (16 + table::value[value >> 16])
+    : (table::value[value]));
+}
+
+/// @brief 64-bit version
+template <unsigned int kVersion, class T>
+constexpr EnableIf<All<
+    IsIntegral<T>, Bool<kVersion == 64>>,
+unsigned int> WideBitScanReverse(T value) {
+  typedef constant::log_16bit table;
+  return (
+    // for types <= 64
+    (value >> 32) ? (
+      (value >> 48) ? (
+        48 + table::value[value >> 48])
+      : (32 + table::value[(value >> 32) & 0xffff]))
+    : (WideBitScanReverse<32>(static_cast<uint32_t>(value))));
+}
+
 }  // namespace version
 /// @endcond
 
+}  // namespace detail
+/// @endcond
+
+#if !defined(NX_USE_GENERIC_BIT_SCAN_REVERSE) && \
+    (defined(NX_TC_GCC) || defined(NX_TC_CLANG))
+// GCC/Clang BitScanReverse
+
+/// @brief Defined if BitScanReverse is implemented with compiler intrinsics.
+#define NX_BIT_SCAN_REVERSE_INTRINSIC 1
+
+/// @cond nx_detail
+namespace detail {
+
+/// @brief unsigned long long version
+template <class T>
+inline constexpr EnableIf<All<
+    IsIntegral<T>,
+    IntegerFits<T, unsigned long long>,  // NOLINT(runtime/int)
+    Not<IntegerFits<T, unsigned long>>>,  // NOLINT(runtime/int)
+unsigned int> BitScanReverse(T value) {
+  typedef unsigned long long Word;  // NOLINT(runtime/int)
+  return (value ? BitSize<Word>::value - 1 - __builtin_clzll(
+      static_cast<Invoke<MakeUnsigned<T>>>(value)) : 0);
+}
+
+/// @brief unsigned long version
+template <class T>
+inline constexpr EnableIf<All<
+    IsIntegral<T>,
+    IntegerFits<T, unsigned long>,  // NOLINT(runtime/int)
+    Not<IntegerFits<T, unsigned int>>>,
+unsigned int> BitScanReverse(T value) {
+  typedef unsigned long Word;  // NOLINT(runtime/int)
+  return (value ? BitSize<Word>::value - 1 - __builtin_clzl(
+      static_cast<Invoke<MakeUnsigned<T>>>(value)) : 0);
+}
+
+/// @brief unsigned int version
+template <class T>
+inline constexpr EnableIf<All<
+    IsIntegral<T>,
+    IntegerFits<T, unsigned int>>,
+unsigned int> BitScanReverse(T value) {
+  typedef unsigned int Word;
+  return (value ? BitSize<Word>::value - 1 - __builtin_clz(
+      static_cast<Invoke<MakeUnsigned<T>>>(value)) : 0);
+}
+
+}  // namespace detail
+/// @endcond
+
+#elif !defined(NX_USE_GENERIC_BIT_SCAN_REVERSE) && defined(NX_TC_VS)
+// Visual Studio BitScanReverse; the intrinsics are not constexpr.  lzcnt is
+// only used when the build targets AVX2, as older processors execute it as
+// bsr, which counts from the other end.
+
+/// @brief Defined if BitScanReverse is implemented with compiler intrinsics.
+#define NX_BIT_SCAN_REVERSE_INTRINSIC 1
+
+/// @cond nx_detail
+namespace detail {
+
+/// @brief [33,64]-bit version
+template <class T>
+inline EnableIf<All<
+    IsIntegral<T>, BitRange<T, 33, 64>>,
+unsigned int> BitScanReverse(T value) {
+  const unsigned __int64 bits = static_cast<unsigned __int64>(value);
+#if defined(NX_ARCH_X86_64) && defined(__AVX2__)
+  return bits ? 63 - static_cast<unsigned int>(_lzcnt_u64(bits)) : 0;
+#elif defined(NX_ARCH_X86_64)
+  unsigned long index;  // NOLINT(runtime/int)
+  return _BitScanReverse64(&index, bits) ? index : 0;
+#else
+  unsigned long index;  // NOLINT(runtime/int)
+  if (_BitScanReverse(&index, static_cast<unsigned long>(bits >> 32))) {
+    return 32 + index;
+  }
+  return _BitScanReverse(&index, static_cast<unsigned long>(bits))
+      ? index : 0;
+#endif
+}
+
+/// @brief [0,32]-bit version
+template <class T>
+inline EnableIf<All<
+    IsIntegral<T>, BitRange<T, 0, 32>>,
+unsigned int> BitScanReverse(T value) {
+  unsigned long index;  // NOLINT(runtime/int)
+  return _BitScanReverse(&index, static_cast<unsigned long>(
+      static_cast<Invoke<MakeUnsigned<T>>>(value))) ? index : 0;
+}
+
+}  // namespace detail
+/// @endcond
+
+#elif defined(NX_USE_SWAR)
+// SWAR BitScanReverse
+
+/// @cond nx_detail
+namespace detail {
+
+/// @brief [0,64]-bit selector
+template <class T>
+inline constexpr EnableIf<All<
+    IsIntegral<T>, BitRange<T, 0, 64>>,
+unsigned int> BitScanReverse(T value) {
+  return swar::BitScanReverse(value);
+}
+
+}  // namespace detail
+/// @endcond
+#elif defined(NX_USE_WIDE_TABLES)
+// 16-bit lookup table BitScanReverse - finds the highest set bit index
+
+/// @cond nx_detail
+namespace detail {
+
 /// @brief [0, 8]-bit selector
 template <class T>
 inline constexpr EnableIf<All<
-    std::is_integral<T>, BitRange<T, 0, 8>>,
+    IsIntegral<T>, BitRange<T, 0, 8>>,
 unsigned int> BitScanReverse(T value) {
-  return version::BitScanReverse<8>(value);
+  return version::BitScanReverse<8>(
+      static_cast<Invoke<MakeUnsigned<T>>>(value));
 }
 
 /// @brief [9, 16]-bit selector
 template <class T>
 inline constexpr EnableIf<All<
-    std::is_integral<T>, BitRange<T, 9, 16>>,
+    IsIntegral<T>, BitRange<T, 9, 16>>,
 unsigned int> BitScanReverse(T value) {
-  return version::BitScanReverse<16>(value);
+  return version::WideBitScanReverse<16>(
+      static_cast<Invoke<MakeUnsigned<T>>>(value));
 }
 
 /// @brief [17, 32]-bit selector
 template <class T>
 inline constexpr EnableIf<All<
-    std::is_integral<T>, BitRange<T, 17, 32>>,
+    IsIntegral<T>, BitRange<T, 17, 32>>,
 unsigned int> BitScanReverse(T value) {
-  return version::BitScanReverse<32>(value);
+  return version::WideBitScanReverse<32>(
+      static_cast<Invoke<MakeUnsigned<T>>>(value));
 }
 
 /// @brief [33, 64]-bit selector
 template <class T>
 inline constexpr EnableIf<All<
-    std::is_integral<T>, BitRange<T, 33, 64>>,
+    IsIntegral<T>, BitRange<T, 33, 64>>,
 unsigned int> BitScanReverse(T value) {
-  return version::BitScanReverse<64>(value);
+  return version::WideBitScanReverse<64>(
+      static_cast<Invoke<MakeUnsigned<T>>>(value));
+}
+
+}  // namespace detail
+/// @endcond
+#else
+// Lookup table BitScanReverse - finds the highest set bit index
+
+/// @cond nx_detail
+namespace detail {
+
+/// @brief [0, 8]-bit selector
+template <class T>
+inline constexpr EnableIf<All<
+    IsIntegral<T>, BitRange<T, 0, 8>>,
+unsigned int> BitScanReverse(T value) {
+  return version::BitScanReverse<8>(
+      static_cast<Invoke<MakeUnsigned<T>>>(value));
+}
+
+/// @brief [9, 16]-bit selector
+template <class T>
+inline constexpr EnableIf<All<
+    IsIntegral<T>, BitRange<T, 9, 16>>,
+unsigned int> BitScanReverse(T value) {
+  return version::BitScanReverse<16>(
+      static_cast<Invoke<MakeUnsigned<T>>>(value));
+}
+
+/// @brief [17, 32]-bit selector
+template <class T>
+inline constexpr EnableIf<All<
+    IsIntegral<T>, BitRange<T, 17, 32>>,
+unsigned int> BitScanReverse(T value) {
+  return version::BitScanReverse<32>(
+      static_cast<Invoke<MakeUnsigned<T>>>(value));
+}
+
+/// @brief [33, 64]-bit selector
+template <class T>
+inline constexpr EnableIf<All<
+    IsIntegral<T>, BitRange<T, 33, 64>>,
+unsigned int> BitScanReverse(T value) {
+  return version::BitScanReverse<64>(
+      static_cast<Invoke<MakeUnsigned<T>>>(value));
 }
 
 }  // namespace detail
@@ -170,18 +346,57 @@ unsigned int> BitScanReverse(T value) {
 
 #endif
 
-/// @brief Determines the index of the least significant set bit.
+#if defined(NX_HAS_INT128)
+/// @cond nx_detail
+namespace detail {
+
+/// @brief [65,128]-bit selector; scans the high 64-bit half, then the low
+/// one.
+template <class T>
+inline constexpr EnableIf<All<
+    IsIntegral<T>, BitRange<T, 65, 128>>,
+unsigned int> BitScanReverse(T value) {
+  return (static_cast<Invoke<MakeUnsigned<T>>>(value) >> 64)
+      ? 64 + BitScanReverse(static_cast<uint64_t>(
+          static_cast<Invoke<MakeUnsigned<T>>>(value) >> 64))
+      : BitScanReverse(static_cast<uint64_t>(value));
+}
+
+}  // namespace detail
+/// @endcond
+#endif
+
+/// @brief Determines the index of the most significant set bit.
 ///
 /// @tparam T The type of the passed value.
 /// @param value The value to examine.
 ///
-/// @return The index of the lowest bit set, with 0 indicating the least
+/// @return The index of the highest bit set, with 0 indicating the least
 /// significant bit.  If the value is 0, then 0 is returned.
 template <class T>
 constexpr unsigned int BitScanReverse(T value) {
   return detail::BitScanReverse(value);
 }
 
+/// @brief Determines the index of the most significant set bit of a wide
+/// integer.
+///
+/// @tparam kBits The size of the passed value.
+/// @param value The value to examine.
+///
+/// @return The index of the highest bit set, with 0 indicating the least
+/// significant bit.  If the value is 0, then 0 is returned.
+template <unsigned int kBits>
+inline unsigned int BitScanReverse(const WideUInt<kBits>&value) {
+  typedef WideUInt<kBits> Wide;
+  for (unsigned int i = Wide::kWords; i--;) {
+    if (value.word(i)) {
+      return i * Wide::kWordBits + BitScanReverse(value.word(i));
+    }
+  }
+  return 0;
+}
+
 }  // namespace nx
 
 #endif  // INCLUDE_NX_BIT_SCAN_REVERSE_H_
@@ -0,0 +1,359 @@
+//
+// Copyright (C) 2013 Jacob McIntosh <nacitar at ubercpp dot com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+/// @file byte_order.h
+/// @brief Provides functions to swap the byte order of integral values and
+/// arrays, and wrappers that store integers in a fixed byte order.
+/// @details If you define NX_USE_GENERIC_BYTE_SWAP, even on platforms with
+/// the appropriate compiler intrinsics, a generic fallback will be used.  The
+/// array overloads select a pshufb-based kernel at runtime and are
+/// implemented in byte_order.cc.
+
+#ifndef INCLUDE_NX_BYTE_ORDER_H_
+#define INCLUDE_NX_BYTE_ORDER_H_
+
+#include <cstring>
+#include "nx/core.h"
+
+#if defined(NX_TC_VS)
+  #include <stdlib.h>
+#endif
+
+/// @brief Library namespace.
+namespace nx {
+// Enable this define to not use compiler builtins.
+// #define NX_USE_GENERIC_BYTE_SWAP
+
+/// @brief The order in which the bytes of an integer are stored in memory.
+enum class ByteOrder {
+  /// @brief Least significant byte first.
+  kLittleEndian,
+  /// @brief Most significant byte first.
+  kBigEndian,
+#if defined(NX_BIG_ENDIAN)
+  /// @brief The byte order of the build target.
+  kNative = kBigEndian
+#else
+  /// @brief The byte order of the build target.
+  kNative = kLittleEndian
+#endif
+};
+
+#if !defined(NX_USE_GENERIC_BYTE_SWAP) && \
+    (defined(NX_TC_GCC) || defined(NX_TC_CLANG))
+// GCC/Clang ByteSwap
+
+/// @brief Defined if ByteSwap is implemented with compiler intrinsics.
+#define NX_BYTE_SWAP_INTRINSIC 1
+
+/// @cond nx_detail
+namespace detail {
+
+/// @brief 64-bit version
+template <class T>
+inline constexpr EnableIf<All<
+    std::is_unsigned<T>, BitRange<T, 64, 64>>,
+T> ByteSwap(T value) {
+  return __builtin_bswap64(value);
+}
+
+/// @brief 32-bit version
+template <class T>
+inline constexpr EnableIf<All<
+    std::is_unsigned<T>, BitRange<T, 32, 32>>,
+T> ByteSwap(T value) {
+  return __builtin_bswap32(value);
+}
+
+/// @brief 16-bit version
+template <class T>
+inline constexpr EnableIf<All<
+    std::is_unsigned<T>, BitRange<T, 16, 16>>,
+T> ByteSwap(T value) {
+  return __builtin_bswap16(value);
+}
+
+}  // namespace detail
+/// @endcond
+#elif !defined(NX_USE_GENERIC_BYTE_SWAP) && defined(NX_TC_VS)
+// Visual Studio ByteSwap; the intrinsics are not constexpr.
+
+/// @brief Defined if ByteSwap is implemented with compiler intrinsics.
+#define NX_BYTE_SWAP_INTRINSIC 1
+
+/// @cond nx_detail
+namespace detail {
+
+/// @brief 64-bit version
+template <class T>
+inline EnableIf<All<
+    std::is_unsigned<T>, BitRange<T, 64, 64>>,
+T> ByteSwap(T value) {
+  return _byteswap_uint64(value);
+}
+
+/// @brief 32-bit version
+template <class T>
+inline EnableIf<All<
+    std::is_unsigned<T>, BitRange<T, 32, 32>>,
+T> ByteSwap(T value) {
+  return static_cast<T>(
+      _byteswap_ulong(static_cast<unsigned long>(value)));  // NOLINT
+}
+
+/// @brief 16-bit version
+template <class T>
+inline EnableIf<All<
+    std::is_unsigned<T>, BitRange<T, 16, 16>>,
+T> ByteSwap(T value) {
+  return _byteswap_ushort(value);
+}
+
+}  // namespace detail
+/// @endcond
+#else
+// Generic ByteSwap
+
+/// @cond nx_detail
+namespace detail {
+
+/// @brief 16-bit version
+template <class T>
+inline constexpr EnableIf<All<
+    std::is_unsigned<T>, BitRange<T, 16, 16>>,
+T> ByteSwap(T value) {
+  return static_cast<T>(value << 8 | value >> 8);
+}
+
+/// @brief 32-bit version
+template <class T>
+inline constexpr EnableIf<All<
+    std::is_unsigned<T>, BitRange<T, 32, 32>>,
+T> ByteSwap(T value) {
+  return
+      value << 24 |
+      (value <<  8 & 0x00ff0000u) |
+      (value >>  8 & 0x0000ff00u) |
+      value >> 24;
+}
+
+/// @brief 64-bit version
+template <class T>
+inline constexpr EnableIf<All<
+    std::is_unsigned<T>, BitRange<T, 64, 64>>,
+T> ByteSwap(T value) {
+  return
+      static_cast<T>(ByteSwap(static_cast<uint32_t>(value))) << 32 |
+      ByteSwap(static_cast<uint32_t>(value >> 32));
+}
+
+}  // namespace detail
+/// @endcond
+
+#endif
+
+/// @cond nx_detail
+namespace detail {
+
+/// @brief 8-bit version; a single byte has no order to swap.
+template <class T>
+inline constexpr EnableIf<All<
+    std::is_unsigned<T>, BitRange<T, 8, 8>>,
+T> ByteSwap(T value) {
+  return value;
+}
+
+/// @brief The implementations available for swapping the bytes of arrays.
+enum class ByteSwapKernel {
+  /// @brief One ByteSwap() call per element.
+  kScalar,
+  /// @brief SSSE3 pshufb, 16 bytes at a time.
+  kSsse3,
+  /// @brief AVX2 vpshufb, 32 bytes at a time.
+  kAvx2
+};
+
+/// @brief Determines if the running processor can execute the given kernel.
+bool ByteSwapSupported(ByteSwapKernel kernel);
+
+/// @brief Swaps the bytes of each element of an array using the given
+/// kernel, which must be supported by the running processor.
+///
+/// @param kernel The implementation to use.
+/// @param source The elements to swap.
+/// @param destination Where to store the results; may equal source.
+/// @param length The number of elements.
+/// @param element_size The size of each element: 1, 2, 4 or 8 bytes.
+void ByteSwapBuffer(
+    ByteSwapKernel kernel, const void*source, void*destination,
+    size_t length, unsigned int element_size);
+
+/// @brief Swaps the bytes of each element of an array using the fastest
+/// kernel supported by the running processor.
+void ByteSwapBuffer(
+    const void*source, void*destination,
+    size_t length, unsigned int element_size);
+
+/// @brief Builds the pshufb control that reverses the byte order of each
+/// element_size-byte element of a 16-byte lane; the byte swap and bit
+/// reversal kernels both start from it.
+inline void MakeByteOrder(unsigned char*order, unsigned int element_size) {
+  for (unsigned int i = 0; i < 16; ++i) {
+    order[i] = static_cast<unsigned char>(
+        i - i % element_size + element_size - 1 - i % element_size);
+  }
+}
+
+}  // namespace detail
+/// @endcond
+
+/// @brief Reverses the order of the bytes of an integral value.
+///
+/// @tparam T The type of the passed value.
+/// @param value The value to swap.
+///
+/// @return The value with its most significant byte least significant, and
+/// so on.
+template <class T>
+inline constexpr EnableIf<All<
+    std::is_integral<T>, BitRange<T, 0, 64>>,
+T> ByteSwap(T value) {
+  return static_cast<T>(detail::ByteSwap(
+      static_cast<uint_t<BitSize<T>::value>>(value)));
+}
+
+/// @brief Reverses the order of the bytes of each element of an array.
+///
+/// @tparam T The type of the array elements.
+/// @param source The elements to swap.
+/// @param destination Where to store the swapped elements; may be the same
+/// array as source, but must not otherwise overlap it.
+/// @param length The number of elements.
+template <class T>
+inline EnableIf<All<
+    std::is_integral<T>, BitRange<T, 0, 64>>,
+void> ByteSwap(const T*source, T*destination, size_t length) {
+  detail::ByteSwapBuffer(source, destination, length, sizeof(T));
+}
+
+/// @brief Reverses the order of the bytes of each element of an array in
+/// place.
+///
+/// @tparam T The type of the array elements.
+/// @param data The elements to swap.
+/// @param length The number of elements.
+template <class T>
+inline EnableIf<All<
+    std::is_integral<T>, BitRange<T, 0, 64>>,
+void> ByteSwap(T*data, size_t length) {
+  detail::ByteSwapBuffer(data, data, length, sizeof(T));
+}
+
+/// @brief Converts a value between the native byte order and the given one.
+/// The conversion is its own inverse, so this both encodes and decodes.
+///
+/// @tparam kOrder The byte order to convert to or from.
+/// @tparam T The type of the passed value.
+template <ByteOrder kOrder, class T>
+inline constexpr EnableIf<
+    std::is_integral<T>,
+T> ConvertByteOrder(T value) {
+  return kOrder == ByteOrder::kNative ? value : ByteSwap(value);
+}
+
+/// @brief Converts a value between the native and big-endian byte orders.
+template <class T>
+inline constexpr EnableIf<std::is_integral<T>, T> BigEndianValue(T value) {
+  return ConvertByteOrder<ByteOrder::kBigEndian>(value);
+}
+
+/// @brief Converts a value between the native and little-endian byte orders.
+template <class T>
+inline constexpr EnableIf<std::is_integral<T>, T> LittleEndianValue(T value) {
+  return ConvertByteOrder<ByteOrder::kLittleEndian>(value);
+}
+
+/// @brief Storage for an integral value in a fixed byte order.
+/// @details The value is kept as an unaligned array of bytes, so that a
+/// pointer to a buffer read from disk or the network can be cast to a
+/// pointer to these (or to a struct made of them) and read in place.
+/// Conversion happens only when the value is read or assigned.
+///
+/// @tparam T The integral type of the stored value.
+/// @tparam kOrder The byte order of the stored value.
+template <class T, ByteOrder kOrder>
+class EndianValue {
+  static_assert(std::is_integral<T>::value,
+                "EndianValue requires an integral type");
+
+ public:
+  /// @brief The type of the stored value.
+  typedef T value_type;
+
+  /// @brief Leaves the value uninitialized, as with an integer.
+  EndianValue() {}
+
+  /// @brief Stores the given value.
+  EndianValue(T value) {  // NOLINT(runtime/explicit)
+    set(value);
+  }
+
+  /// @brief Stores the given value.
+  EndianValue& operator=(T value) {
+    set(value);
+    return *this;
+  }
+
+  /// @brief Provides the stored value in the native byte order.
+  operator T() const {
+    return get();
+  }
+
+  /// @brief Provides the stored value in the native byte order.
+  T get() const {
+    T value;
+    std::memcpy(&value, bytes_, sizeof(value));
+    return ConvertByteOrder<kOrder>(value);
+  }
+
+  /// @brief Stores the given value.
+  void set(T value) {
+    value = ConvertByteOrder<kOrder>(value);
+    std::memcpy(bytes_, &value, sizeof(value));
+  }
+
+  /// @brief Provides the stored bytes.
+  const unsigned char*data() const {
+    return bytes_;
+  }
+
+ private:
+  unsigned char bytes_[sizeof(T)];
+};
+
+/// @brief Storage for an integral value with its most significant byte first.
+template <class T>
+using BigEndian = EndianValue<T, ByteOrder::kBigEndian>;
+
+/// @brief Storage for an integral value with its least significant byte
+/// first.
+template <class T>
+using LittleEndian = EndianValue<T, ByteOrder::kLittleEndian>;
+
+}  // namespace nx
+
+#endif  // INCLUDE_NX_BYTE_ORDER_H_
@@ -25,5 +25,7 @@
 #include "nx/core/os.h"
 #include "nx/core/mpl.h"
 #include "nx/core/integer.h"
+#include "nx/core/wide_integer.h"
+#include "nx/core/cpu.h"
 
 #endif  // INCLUDE_NX_CORE_H_
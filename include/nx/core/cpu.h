@@ -0,0 +1,149 @@
+//
+// Copyright (C) 2013 Jacob McIntosh <nacitar at ubercpp dot com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+/// @file cpu.h
+/// @brief Runtime detection of processor features, and a facility to select
+/// the implementation of a function best suited to the running processor.
+/// @details Compile-time detection only describes the processor the binary
+/// was built for.  A portable binary can instead compile its fast paths with
+/// NX_TARGET and choose between them at runtime through Dispatch.
+
+#ifndef INCLUDE_NX_CORE_CPU_H_
+#define INCLUDE_NX_CORE_CPU_H_
+
+#include <atomic>
+
+#include "nx/core/os.h"
+#include "nx/core/integer.h"
+
+/// @brief Library namespace.
+namespace nx {
+
+namespace cpu {
+
+/// @brief Instruction set extensions that can be queried at runtime.
+enum class Feature : unsigned int {
+  /// @brief SSE2; 128-bit integer vectors.
+  kSse2,
+  /// @brief Supplemental SSE3; pshufb.
+  kSsse3,
+  /// @brief SSE4.1.
+  kSse41,
+  /// @brief SSE4.2.
+  kSse42,
+  /// @brief The popcnt instruction.
+  kPopcnt,
+  /// @brief The lzcnt instruction.
+  kLzcnt,
+  /// @brief Bit manipulation instructions; tzcnt, andn, blsr.
+  kBmi1,
+  /// @brief Bit manipulation instructions 2; pdep, pext, mulx.
+  kBmi2,
+  /// @brief BMI2 with pdep/pext executed in hardware.  AMD processors before
+  /// family 19h (Zen 3) implement them in microcode, taking hundreds of
+  /// cycles, and only report kBmi2.
+  kFastBmi2,
+  /// @brief AVX, with operating system support for its registers.
+  kAvx,
+  /// @brief AVX2.
+  kAvx2,
+  /// @brief AVX-512 foundation, with operating system support for its
+  /// registers.
+  kAvx512f,
+  /// @brief AVX-512 byte and word instructions.
+  kAvx512bw,
+  /// @brief AVX-512 vector length extensions.
+  kAvx512vl,
+  /// @brief AVX-512 vpopcntd/vpopcntq.
+  kAvx512vpopcntdq
+};
+
+/// @brief Provides the detected features, with bit N set if the feature with
+/// the underlying value N is supported.  Detection happens upon the first
+/// call.
+uint_least32_t Features();
+
+/// @brief Determines if the running processor supports a feature.
+///
+/// @param feature The feature to check for.
+///
+/// @return true if the feature can be used.
+inline bool Supports(Feature feature) {
+  return (Features() >> static_cast<unsigned int>(feature)) & 1u;
+}
+
+/// @brief A function pointer bound, upon its first call, to the
+/// implementation returned by a resolver function.  The resolver typically
+/// consults Supports() to choose between versions built with NX_TARGET.
+/// @details The constructor is constexpr, so objects of this type at
+/// namespace scope are initialized before any dynamic initialization and can
+/// safely be called from it.  Concurrent first calls may each run the
+/// resolver, which must therefore always return the same function.
+template <class Signature>
+class Dispatch;
+
+/// @brief Specialization that unpacks the function signature.
+template <class Result, class... Arguments>
+class Dispatch<Result(Arguments...)> {
+ public:
+  /// @brief A pointer to an implementation.
+  typedef Result (*Function)(Arguments...);
+
+  /// @brief A function choosing the implementation to use.
+  typedef Function (*Resolver)();
+
+  /// @brief Constructs with the given resolver; does not call it.
+  explicit constexpr Dispatch(Resolver resolver)
+      : resolver_(resolver), function_(nullptr) {
+  }
+
+  /// @brief Provides the selected implementation, resolving it if needed.
+  Function get() const {
+    Function function = function_.load(std::memory_order_acquire);
+    if (NX_UNLIKELY(!function)) {
+      function = resolver_();
+      function_.store(function, std::memory_order_release);
+    }
+    return function;
+  }
+
+  /// @brief Replaces the selected implementation, overriding the resolver;
+  /// e.g. to avoid one that is supported but slow on the running processor.
+  void set(Function function) const {
+    function_.store(function, std::memory_order_release);
+  }
+
+  /// @brief Calls the selected implementation.
+  Result operator()(Arguments... arguments) const {
+    return get()(arguments...);
+  }
+
+ private:
+  NX_NONCOPYABLE(Dispatch);
+
+  /// @brief Chooses the implementation.
+  const Resolver resolver_;
+
+  /// @brief The chosen implementation, or null if not yet resolved.
+  mutable std::atomic<Function> function_;
+};
+
+}  // namespace cpu
+
+}  // namespace nx
+
+#endif  // INCLUDE_NX_CORE_CPU_H_
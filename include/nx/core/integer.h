@@ -17,7 +17,8 @@
 /// @file integer.h
 /// @brief Templates and typedefs for handling the selection of appropriate
 /// integral types, includind exact-sized types as well as types in certain
-/// bit ranges.
+/// bit ranges.  Unsigned types wider than the builtin ones are provided by
+/// WideUInt (see wide_integer.h).
 
 #ifndef INCLUDE_NX_CORE_INTEGER_H_
 #define INCLUDE_NX_CORE_INTEGER_H_
@@ -35,6 +36,11 @@
 /// @brief Library namespace.
 namespace nx {
 
+// Defined in nx/core/wide_integer.h; the unsigned types wider than the
+// builtin ones.
+template <unsigned int kBits>
+class WideUInt;
+
 /// @cond nx_detail
 namespace detail {
 
@@ -48,7 +54,7 @@ template <typename T, typename Preferred>
 class PreferIntegralTypeInternal<
     T,
     Preferred,
-    EnableIf<All<std::is_integral<T>, std::is_integral<Preferred>>>>
+    EnableIf<All<IsIntegral<T>, IsIntegral<Preferred>>>>
     : public std::conditional<
         sizeof(T) == sizeof(Preferred), Preferred, T> {
  private:
@@ -65,12 +71,41 @@ template <bool kSigned, typename T>
 class PreferIntegralSignInternal<
     kSigned,
     T,
-    EnableIf<std::is_integral<T>>>
+    EnableIf<IsIntegral<T>>>
     : public SetSigned<kSigned, T> {
  private:
   NX_UNINSTANTIABLE(PreferIntegralSignInternal);
 };
 
+/// @brief Provides the bits of the WideUInt holding at least kBitMin bits.
+template <unsigned int kBitMin>
+class WideUIntBits
+    : public UInt<(kBitMin <= 128 ? 128 : (kBitMin + 63) / 64 * 64)> {
+};
+
+/// @brief Provides the 128-bit integral type if it exists and lies within the
+/// bit range, then the smallest WideUInt in the range if unsigned, or
+/// InvalidType otherwise.  This ends the search of the builtin types in
+/// IntegralLeastRangeSearch.
+template <bool kSigned, unsigned int kBitMin, unsigned int kBitMax>
+class ExtendedIntegralSearch : public Identity<
+#if defined(NX_HAS_INT128)
+    Conditional<InRange<BitSize<Int128>::value, kBitMin, kBitMax>,
+        Int128,
+#endif
+    Conditional<
+        All<Bool<!kSigned>,
+            InRange<WideUIntBits<kBitMin>::value, kBitMin, kBitMax>>,
+        WideUInt<WideUIntBits<kBitMin>::value>,
+        InvalidType>
+#if defined(NX_HAS_INT128)
+    >
+#endif
+    > {
+ private:
+  NX_UNINSTANTIABLE(ExtendedIntegralSearch);
+};
+
 }  // namespace detail
 /// @endcond
 
@@ -124,7 +159,8 @@ class IntegralLeastRangeSearch
                         BitSize<long long>::value,  // NOLINT(runtime/int)
                         kBitMin, kBitMax>,
                       long long,  // NOLINT(runtime/int)
-                      InvalidType>
+                      Invoke<detail::ExtendedIntegralSearch<
+                        kSigned, kBitMin, kBitMax>>>
                   >
                 >
               >
@@ -237,6 +273,16 @@ typedef uint_t<64> uint64_t;
 /// @brief A signed integer type 64 bits in size.
 typedef int_t<64>  int64_t;
 
+#if defined(NX_HAS_INT128)
+/// @brief An unsigned integer type 128 bits in size.  Only defined where the
+/// compiler provides one (NX_HAS_INT128).
+typedef uint_t<128> uint128_t;
+
+/// @brief A signed integer type 128 bits in size.  Only defined where the
+/// compiler provides one (NX_HAS_INT128).
+typedef int_t<128>  int128_t;
+#endif
+
 /// @brief The smallest unsigned integer type at least 8 bits in size.
 typedef uint_least_t<8>  uint_least8_t;
 
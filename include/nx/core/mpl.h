@@ -231,6 +231,108 @@ class BitSize : public UInt<sizeof(T)*CHAR_BIT> {
 /// @cond nx_detail
 namespace detail {
 
+#if defined(NX_HAS_INT128)
+/// @brief The compiler's signed 128-bit integral type.
+__extension__ typedef __int128 Int128;
+
+/// @brief The compiler's unsigned 128-bit integral type.
+__extension__ typedef unsigned __int128 UInt128;
+#endif
+
+template <typename T>
+class IsIntegralInternal : public Bool<std::is_integral<T>::value> {
+};
+
+template <typename T>
+class IsSignedInternal : public Bool<std::is_signed<T>::value> {
+};
+
+template <typename T>
+class MakeSignedInternal : public std::make_signed<T> {
+};
+
+template <typename T>
+class MakeUnsignedInternal : public std::make_unsigned<T> {
+};
+
+#if defined(NX_HAS_INT128)
+// The standard library only knows of the 128-bit types in the GNU dialects.
+
+template <>
+class IsIntegralInternal<Int128> : public Bool<true> {
+};
+
+template <>
+class IsIntegralInternal<UInt128> : public Bool<true> {
+};
+
+template <>
+class IsSignedInternal<Int128> : public Bool<true> {
+};
+
+template <>
+class IsSignedInternal<UInt128> : public Bool<false> {
+};
+
+template <>
+class MakeSignedInternal<Int128> : public Identity<Int128> {
+};
+
+template <>
+class MakeSignedInternal<UInt128> : public Identity<Int128> {
+};
+
+template <>
+class MakeUnsignedInternal<Int128> : public Identity<UInt128> {
+};
+
+template <>
+class MakeUnsignedInternal<UInt128> : public Identity<UInt128> {
+};
+#endif
+
+}  // namespace detail
+/// @endcond
+
+/// @brief Determines if T is an integral type.  Unlike std::is_integral, the
+/// 128-bit types are included wherever the compiler provides them.
+template <typename T>
+class IsIntegral
+    : public detail::IsIntegralInternal<Invoke<std::remove_cv<T>>> {
+};
+
+/// @brief Determines if T is a signed arithmetic type; std::is_signed
+/// including the 128-bit types.
+template <typename T>
+class IsSigned : public detail::IsSignedInternal<Invoke<std::remove_cv<T>>> {
+};
+
+/// @brief Determines if T is an unsigned integral type; std::is_unsigned
+/// including the 128-bit types.
+template <typename T>
+class IsUnsigned : public All<IsIntegral<T>, Not<IsSigned<T>>> {
+};
+
+/// @brief Determines if T is a floating-point type; std::is_floating_point.
+template <typename T>
+class IsFloatingPoint : public Bool<std::is_floating_point<T>::value> {
+};
+
+/// @brief Provides the signed integral type of the same size as T;
+/// std::make_signed including the 128-bit types.
+template <typename T>
+class MakeSigned : public detail::MakeSignedInternal<T> {
+};
+
+/// @brief Provides the unsigned integral type of the same size as T;
+/// std::make_unsigned including the 128-bit types.
+template <typename T>
+class MakeUnsigned : public detail::MakeUnsignedInternal<T> {
+};
+
+/// @cond nx_detail
+namespace detail {
+
 template <
     typename T, unsigned int kBits, bool kAllowPartial, class Enable = void>
 class BitMaskInternal : public std::integral_constant<
@@ -240,7 +342,7 @@ class BitMaskInternal : public std::integral_constant<
 template <typename T, unsigned int kBits, bool kAllowPartial>
 class BitMaskInternal<
     T, kBits, kAllowPartial,
-    EnableIf<Not<std::is_integral<T>>>> : public UInt<0> {
+    EnableIf<Not<IsIntegral<T>>>> : public UInt<0> {
   static_assert(
       DependentBool<false, T>::value, "The provided type is not integral.");
 };
@@ -248,7 +350,7 @@ class BitMaskInternal<
 template <typename T, unsigned int kBits, bool kAllowPartial>
 class BitMaskInternal<
     T, kBits, kAllowPartial,
-    EnableIf<All<std::is_integral<T>, Bool<(kBits == BitSize<T>::value)>>>>
+    EnableIf<All<IsIntegral<T>, Bool<(kBits == BitSize<T>::value)>>>>
     : public std::integral_constant<T, ~static_cast<T>(0)> {
 };
 
@@ -257,7 +359,7 @@ class BitMaskInternal<
 template <typename T, unsigned int kBits>
 class BitMaskInternal<
     T, kBits, true,
-    EnableIf<All<std::is_integral<T>, Bool<(kBits > BitSize<T>::value)>>>>
+    EnableIf<All<IsIntegral<T>, Bool<(kBits > BitSize<T>::value)>>>>
     : public std::integral_constant<T, ~static_cast<T>(0)> {
 };
 
@@ -266,7 +368,7 @@ class BitMaskInternal<
 template <typename T, unsigned int kBits>
 class BitMaskInternal<
     T, kBits, false,
-    EnableIf<All<std::is_integral<T>, Bool<(kBits > BitSize<T>::value)>>>>
+    EnableIf<All<IsIntegral<T>, Bool<(kBits > BitSize<T>::value)>>>>
     : public std::integral_constant<T, 0> {
   static_assert(
       DependentBool<false, T>::value,
@@ -299,8 +401,8 @@ class BitRange : public InRange<BitSize<T>::value, kMin, kMax> {
 template <typename T, typename Destination>
 class IntegerFits
     : public All<
-          std::is_integral<T>,
-          std::is_integral<Destination>,
+          IsIntegral<T>,
+          IsIntegral<Destination>,
           InRange<BitSize<T>::value, 0, BitSize<Destination>::value>> {
 };
 
@@ -309,8 +411,8 @@ class IntegerFits
 template <bool kSigned, typename T>
 class SetSigned : public std::conditional<
     kSigned,
-    Invoke<std::make_signed<T>>,
-    Invoke<std::make_unsigned<T>>> {
+    Invoke<MakeSigned<T>>,
+    Invoke<MakeUnsigned<T>>> {
  private:
   NX_UNINSTANTIABLE(SetSigned);
 };
@@ -365,6 +467,63 @@ template <class T, T kBase, unsigned int kPower>
 class Power : public detail::Power<T, kBase, kPower> {
 };
 
+/// @brief A compile-time sequence of indices, for expanding parameter packs
+/// over arrays; equivalent to the C++14 std::integer_sequence.
+template <unsigned int... kIndices>
+class IndexSequence {
+ public:
+  /// @brief The sequence itself.
+  typedef IndexSequence type;
+
+  /// @brief Provides the number of indices.
+  static constexpr unsigned int size() {
+    return sizeof...(kIndices);
+  }
+};
+
+/// @cond nx_detail
+namespace detail {
+
+template <class First, class Second>
+class ConcatIndexSequence;
+
+template <unsigned int... kFirst, unsigned int... kSecond>
+class ConcatIndexSequence<IndexSequence<kFirst...>, IndexSequence<kSecond...>>
+    : public Identity<
+        IndexSequence<kFirst..., (sizeof...(kFirst) + kSecond)...>> {
+};
+
+#if defined(NX_TC_GCC) && NX_TC_GCC >= 80000
+// GCC generates the indices itself, which for long sequences, such as those
+// expanding 16-bit lookup tables, is much cheaper than concatenating them.
+template <unsigned int kSize>
+class MakeIndexSequence
+    : public Identity<IndexSequence<__integer_pack(kSize)...>> {
+};
+#else
+// Splitting in halves keeps the instantiation depth logarithmic.
+template <unsigned int kSize>
+class MakeIndexSequence : public ConcatIndexSequence<
+    Invoke<MakeIndexSequence<kSize / 2>>,
+    Invoke<MakeIndexSequence<kSize - kSize / 2>>> {
+};
+
+template <>
+class MakeIndexSequence<0> : public Identity<IndexSequence<>> {
+};
+
+template <>
+class MakeIndexSequence<1> : public Identity<IndexSequence<0>> {
+};
+#endif
+
+}  // namespace detail
+/// @endcond
+
+/// @brief Provides IndexSequence<0, 1, ..., kSize - 1>.
+template <unsigned int kSize>
+using MakeIndexSequence = Invoke<detail::MakeIndexSequence<kSize>>;
+
 }  // namespace nx
 
 #endif  // INCLUDE_NX_CORE_MPL_H_
@@ -68,8 +68,48 @@
   #define NX_OS_OTHER 1
 #endif
 
+// Architecture detection
+#if defined(__x86_64__) || defined(__amd64__) || defined(_M_X64)
+  /// @brief Defined if build target is 64-bit x86
+  #define NX_ARCH_X86_64 1
+#elif defined(__i386__) || defined(_M_IX86)
+  /// @brief Defined if build target is 32-bit x86
+  #define NX_ARCH_X86 1
+#else
+  /// @brief Defined if build target is an unknown architecture
+  #define NX_ARCH_OTHER 1
+#endif
+
+// Byte order detection
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__) && \
+    (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+  /// @brief Defined if build target stores the most significant byte first
+  #define NX_BIG_ENDIAN 1
+#else
+  /// @brief Defined if build target stores the least significant byte first
+  #define NX_LITTLE_ENDIAN 1
+#endif
+
+// Function multiversioning
+#if defined(NX_TC_GCC) || defined(NX_TC_CLANG)
+  /// @brief Compiles a single function for the given instruction set
+  /// extensions (e.g. "avx2,bmi2") regardless of the flags the rest of the
+  /// build uses.  Such functions must only be called after checking the
+  /// extensions with nx::cpu::Supports().
+  #define NX_TARGET(features) __attribute__((target(features)))
+  #if defined(NX_ARCH_X86_64) || defined(NX_ARCH_X86)
+    /// @brief Defined if x86 instruction set extensions can be targetted
+    /// per-function with NX_TARGET.
+    #define NX_TARGET_X86 1
+  #endif
+#else
+  /// @brief Compiles a single function for the given instruction set
+  /// extensions.  However, this macro is NOT IMPLEMENTED on this platform.
+  #define NX_TARGET(features)
+#endif
+
 // Compiler features
-#if defined(NX_TC_GCC)
+#if defined(NX_TC_GCC) || defined(NX_TC_CLANG)
   // #define NX_ALIGN_TO(bytes) __attribute__((aligned(bytes)))
   // #define NX_MAY_ALIAS __attribute__((__may_alias__))
 
@@ -81,6 +121,11 @@
   #define NX_UNLIKELY(x) __builtin_expect((x), 0)
   /// @brief Marks a function or variable as deprecated.
   #define NX_DEPRECATED(decl, msg) decl __attribute__((deprecated(msg)))
+  #if defined(__SIZEOF_INT128__)
+    /// @brief Defined if the compiler provides the 128-bit integral types
+    /// __int128 and unsigned __int128.
+    #define NX_HAS_INT128 1
+  #endif
 #else
   /// @brief Pass the conditional statement of an if statement to inform the
   /// compiler to structure branches expecting that the value is true.
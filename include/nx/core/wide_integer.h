@@ -0,0 +1,578 @@
+//
+// Copyright (C) 2013 Jacob McIntosh <nacitar at ubercpp dot com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+/// @file wide_integer.h
+/// @brief Provides fixed-width unsigned integers wider than the builtin types,
+/// which uint_t and uint_least_t resolve to beyond the widest builtin type.
+/// @details The words are added and subtracted through add-with-carry
+/// intrinsics and multiplied through full 64x64->128-bit products, which
+/// compilers turn into adc/sbb and mul/mulx chains.
+
+#ifndef INCLUDE_NX_CORE_WIDE_INTEGER_H_
+#define INCLUDE_NX_CORE_WIDE_INTEGER_H_
+
+#include "nx/core/os.h"
+#include "nx/core/mpl.h"
+#include "nx/core/integer.h"
+
+#if defined(NX_ARCH_X86_64) && (defined(NX_TC_GCC) || defined(NX_TC_CLANG))
+  #include <x86intrin.h>
+#elif defined(NX_ARCH_X86_64) && defined(NX_TC_VS)
+  #include <intrin.h>
+#endif
+
+/// @brief Library namespace.
+namespace nx {
+
+/// @cond nx_detail
+namespace detail {
+
+/// @brief Stores a + b + carry in sum, returning the carry out.
+inline unsigned char AddWithCarry(
+    unsigned char carry, uint64_t a, uint64_t b, uint64_t*sum) {
+#if defined(NX_ARCH_X86_64) && \
+    (defined(NX_TC_GCC) || defined(NX_TC_CLANG) || defined(NX_TC_VS))
+  unsigned long long result;  // NOLINT(runtime/int)
+  carry = _addcarry_u64(carry, a, b, &result);
+  *sum = result;
+  return carry;
+#else
+  const uint64_t partial = a + b;
+  *sum = partial + carry;
+  return static_cast<unsigned char>((partial < a) | (*sum < partial));
+#endif
+}
+
+/// @brief Stores a - b - borrow in difference, returning the borrow out.
+inline unsigned char SubtractWithBorrow(
+    unsigned char borrow, uint64_t a, uint64_t b, uint64_t*difference) {
+#if defined(NX_ARCH_X86_64) && \
+    (defined(NX_TC_GCC) || defined(NX_TC_CLANG) || defined(NX_TC_VS))
+  unsigned long long result;  // NOLINT(runtime/int)
+  borrow = _subborrow_u64(borrow, a, b, &result);
+  *difference = result;
+  return borrow;
+#else
+  const uint64_t partial = a - b;
+  *difference = partial - borrow;
+  return static_cast<unsigned char>((a < b) | (partial < borrow));
+#endif
+}
+
+/// @brief Provides the low word of the full product a * b, storing the high
+/// word in high.
+inline uint64_t MultiplyWords(uint64_t a, uint64_t b, uint64_t*high) {
+#if defined(NX_HAS_INT128)
+  const UInt128 product = static_cast<UInt128>(a) * b;
+  *high = static_cast<uint64_t>(product >> 64);
+  return static_cast<uint64_t>(product);
+#elif defined(NX_ARCH_X86_64) && defined(NX_TC_VS)
+  unsigned __int64 result_high;
+  const uint64_t low = _umul128(a, b, &result_high);
+  *high = result_high;
+  return low;
+#else
+  // 32-bit halves; the middle sum cannot overflow
+  const uint64_t a_low = a & 0xffffffffu;
+  const uint64_t a_high = a >> 32;
+  const uint64_t b_low = b & 0xffffffffu;
+  const uint64_t b_high = b >> 32;
+  const uint64_t low_low = a_low * b_low;
+  const uint64_t middle = (low_low >> 32) + (a_high * b_low & 0xffffffffu)
+      + a_low * b_high;
+  *high = a_high * b_high + (a_high * b_low >> 32) + (middle >> 32);
+  return (middle << 32) | (low_low & 0xffffffffu);
+#endif
+}
+
+/// @brief Divides the two-word value high:low by divisor, storing the
+/// remainder in remainder.  high must be less than divisor, so that the
+/// quotient fits in a word.
+inline uint64_t DivideWords(
+    uint64_t high, uint64_t low, uint64_t divisor, uint64_t*remainder) {
+#if defined(NX_ARCH_X86_64) && (defined(NX_TC_GCC) || defined(NX_TC_CLANG))
+  // a single divq; the generic 128-bit division is a library call
+  uint64_t quotient;
+  __asm__("divq %4"
+      : "=a"(quotient), "=d"(*remainder)
+      : "a"(low), "d"(high), "rm"(divisor));
+  return quotient;
+#elif defined(NX_HAS_INT128)
+  const UInt128 dividend = static_cast<UInt128>(high) << 64 | low;
+  *remainder = static_cast<uint64_t>(dividend % divisor);
+  return static_cast<uint64_t>(dividend / divisor);
+#else
+  // restoring division, one quotient bit per step
+  uint64_t quotient = 0;
+  for (unsigned int bit = 64; bit--;) {
+    const bool carry = (high >> 63) != 0;
+    high = high << 1 | low >> 63;
+    low <<= 1;
+    quotient <<= 1;
+    if (carry || high >= divisor) {
+      high -= divisor;
+      quotient |= 1;
+    }
+  }
+  *remainder = high;
+  return quotient;
+#endif
+}
+
+}  // namespace detail
+/// @endcond
+
+/// @brief An unsigned integer of kBits bits, supporting the arithmetic,
+/// bitwise and comparison operators of the builtin unsigned types with the
+/// same wrap-around semantics.
+/// @details Integral values convert implicitly, as they would to a wider
+/// builtin type, so the operators also accept them on either side.
+/// Conversions to integral types are explicit and keep the low bits.
+/// Division by a value that fits in a word is a single pass over the words;
+/// other divisors use bitwise long division, which is much slower.
+///
+/// @tparam kBits The number of bits; a multiple of 64, at least 128.
+template <unsigned int kBits>
+class WideUInt {
+  static_assert(kBits % 64 == 0 && kBits >= 128,
+                "WideUInt must be a multiple of 64 bits, and at least 128.");
+
+ public:
+  /// @brief The type of the words holding the bits.
+  typedef uint64_t word_type;
+
+  /// @brief The number of bits in each word.
+  static constexpr unsigned int kWordBits = 64;
+
+  /// @brief The number of words.
+  static constexpr unsigned int kWords = kBits / kWordBits;
+
+  /// @brief Constructs a zero value.
+  constexpr WideUInt() : words_() {
+  }
+
+  /// @brief Converts an integral value, sign-extending negative values as
+  /// the conversion to a builtin unsigned type would.
+  template <class T, class = EnableIf<IsIntegral<T>>>
+  constexpr WideUInt(T value)  // NOLINT(runtime/explicit)
+      : WideUInt(value, MakeIndexSequence<kWords>()) {
+  }
+
+  /// @brief Constructs from the words, least significant first; usable in
+  /// constant expressions, unlike the arithmetic that could build the value.
+  explicit constexpr WideUInt(const word_type (&words)[kWords])
+      : WideUInt(words, MakeIndexSequence<kWords>()) {
+  }
+
+  /// @brief Converts from a wide integer of another size, keeping the low
+  /// bits.
+  template <unsigned int kOtherBits>
+  explicit WideUInt(const WideUInt<kOtherBits>&other) : words_() {
+    for (unsigned int i = 0; i < kWords && i < other.kWords; ++i) {
+      words_[i] = other.word(i);
+    }
+  }
+
+  /// @brief Provides the words, least significant first.
+  const word_type*data() const {
+    return words_;
+  }
+
+  /// @brief Provides the words, least significant first.
+  word_type*data() {
+    return words_;
+  }
+
+  /// @brief Provides a word; word 0 is the least significant.
+  constexpr word_type word(unsigned int index) const {
+    return words_[index];
+  }
+
+  /// @brief Determines if the value fits in the lowest word.
+  bool FitsWord() const {
+    word_type high = 0;
+    for (unsigned int i = 1; i < kWords; ++i) {
+      high |= words_[i];
+    }
+    return high == 0;
+  }
+
+  /// @brief Determines if the value is not zero.
+  explicit operator bool() const {
+    word_type any = 0;
+    for (unsigned int i = 0; i < kWords; ++i) {
+      any |= words_[i];
+    }
+    return any != 0;
+  }
+
+  /// @brief Converts to an integral type, keeping the low bits.
+  template <class T, class = EnableIf<IsIntegral<T>>>
+  explicit operator T() const {
+    return static_cast<T>(Low<T>());
+  }
+
+  /// @brief Divides by a single word in place.
+  ///
+  /// @return The remainder.
+  word_type DivideBy(word_type divisor) {
+    word_type remainder = 0;
+    for (unsigned int i = kWords; i--;) {
+      words_[i] = detail::DivideWords(
+          remainder, words_[i], divisor, &remainder);
+    }
+    return remainder;
+  }
+
+  /// @brief Adds other.
+  WideUInt& operator+=(const WideUInt&other) {
+    unsigned char carry = 0;
+    for (unsigned int i = 0; i < kWords; ++i) {
+      carry = detail::AddWithCarry(
+          carry, words_[i], other.words_[i], &words_[i]);
+    }
+    return *this;
+  }
+
+  /// @brief Subtracts other.
+  WideUInt& operator-=(const WideUInt&other) {
+    unsigned char borrow = 0;
+    for (unsigned int i = 0; i < kWords; ++i) {
+      borrow = detail::SubtractWithBorrow(
+          borrow, words_[i], other.words_[i], &words_[i]);
+    }
+    return *this;
+  }
+
+  /// @brief Multiplies by other, keeping the low kBits bits of the product.
+  WideUInt& operator*=(const WideUInt&other) {
+    // schoolbook multiplication, skipping the products above kBits
+    WideUInt product;
+    for (unsigned int i = 0; i < kWords; ++i) {
+      word_type carry = 0;
+      for (unsigned int j = 0; i + j < kWords; ++j) {
+        word_type high;
+        const word_type low = detail::MultiplyWords(
+            words_[i], other.words_[j], &high);
+        word_type&sum = product.words_[i + j];
+        // a * b + c + d fits in two words, so high cannot overflow
+        high += detail::AddWithCarry(0, sum, low, &sum);
+        high += detail::AddWithCarry(0, sum, carry, &sum);
+        carry = high;
+      }
+    }
+    return *this = product;
+  }
+
+  /// @brief Divides by other, discarding the remainder.
+  WideUInt& operator/=(const WideUInt&other) {
+    if (other.FitsWord()) {
+      DivideBy(other.words_[0]);
+    } else {
+      *this = DivideLong(other, nullptr);
+    }
+    return *this;
+  }
+
+  /// @brief Replaces the value with the remainder of division by other.
+  WideUInt& operator%=(const WideUInt&other) {
+    if (other.FitsWord()) {
+      *this = DivideBy(other.words_[0]);
+    } else {
+      DivideLong(other, this);
+    }
+    return *this;
+  }
+
+  /// @brief Keeps only the bits that are also set in other.
+  WideUInt& operator&=(const WideUInt&other) {
+    for (unsigned int i = 0; i < kWords; ++i) {
+      words_[i] &= other.words_[i];
+    }
+    return *this;
+  }
+
+  /// @brief Sets the bits that are set in other.
+  WideUInt& operator|=(const WideUInt&other) {
+    for (unsigned int i = 0; i < kWords; ++i) {
+      words_[i] |= other.words_[i];
+    }
+    return *this;
+  }
+
+  /// @brief Inverts the bits that are set in other.
+  WideUInt& operator^=(const WideUInt&other) {
+    for (unsigned int i = 0; i < kWords; ++i) {
+      words_[i] ^= other.words_[i];
+    }
+    return *this;
+  }
+
+  /// @brief Shifts toward the most significant bit; shifts of kBits or more
+  /// leave zero.
+  WideUInt& operator<<=(unsigned int shift) {
+    const unsigned int words = shift / kWordBits;
+    const unsigned int bits = shift % kWordBits;
+    for (unsigned int i = kWords; i--;) {
+      word_type word = 0;
+      if (i >= words) {
+        word = words_[i - words] << bits;
+        if (bits && i > words) {
+          word |= words_[i - words - 1] >> (kWordBits - bits);
+        }
+      }
+      words_[i] = word;
+    }
+    return *this;
+  }
+
+  /// @brief Shifts toward the least significant bit; shifts of kBits or more
+  /// leave zero.
+  WideUInt& operator>>=(unsigned int shift) {
+    const unsigned int words = shift / kWordBits;
+    const unsigned int bits = shift % kWordBits;
+    for (unsigned int i = 0; i < kWords; ++i) {
+      word_type word = 0;
+      if (i + words < kWords) {
+        word = words_[i + words] >> bits;
+        if (bits && i + words + 1 < kWords) {
+          word |= words_[i + words + 1] << (kWordBits - bits);
+        }
+      }
+      words_[i] = word;
+    }
+    return *this;
+  }
+
+  /// @brief Increments the value.
+  WideUInt& operator++() {
+    for (unsigned int i = 0; i < kWords && !++words_[i]; ++i) {
+    }
+    return *this;
+  }
+
+  /// @brief Decrements the value.
+  WideUInt& operator--() {
+    for (unsigned int i = 0; i < kWords && !words_[i]--; ++i) {
+    }
+    return *this;
+  }
+
+  /// @brief Increments the value, returning its prior value.
+  WideUInt operator++(int) {
+    const WideUInt prior(*this);
+    ++*this;
+    return prior;
+  }
+
+  /// @brief Decrements the value, returning its prior value.
+  WideUInt operator--(int) {
+    const WideUInt prior(*this);
+    --*this;
+    return prior;
+  }
+
+  /// @brief Provides a copy with every bit inverted.
+  WideUInt operator~() const {
+    WideUInt result;
+    for (unsigned int i = 0; i < kWords; ++i) {
+      result.words_[i] = ~words_[i];
+    }
+    return result;
+  }
+
+  /// @brief Provides the two's complement negation, as for builtin unsigned
+  /// types.
+  WideUInt operator-() const {
+    return ++~*this;
+  }
+
+  /// @brief Provides the sum, wrapped to kBits bits.
+  friend WideUInt operator+(WideUInt lhs, const WideUInt&rhs) {
+    return lhs += rhs;
+  }
+
+  /// @brief Provides the difference, wrapped to kBits bits.
+  friend WideUInt operator-(WideUInt lhs, const WideUInt&rhs) {
+    return lhs -= rhs;
+  }
+
+  /// @brief Provides the product, wrapped to kBits bits.
+  friend WideUInt operator*(WideUInt lhs, const WideUInt&rhs) {
+    return lhs *= rhs;
+  }
+
+  /// @brief Provides the quotient.
+  friend WideUInt operator/(WideUInt lhs, const WideUInt&rhs) {
+    return lhs /= rhs;
+  }
+
+  /// @brief Provides the remainder.
+  friend WideUInt operator%(WideUInt lhs, const WideUInt&rhs) {
+    return lhs %= rhs;
+  }
+
+  /// @brief Provides the bits set in both values.
+  friend WideUInt operator&(WideUInt lhs, const WideUInt&rhs) {
+    return lhs &= rhs;
+  }
+
+  /// @brief Provides the bits set in either value.
+  friend WideUInt operator|(WideUInt lhs, const WideUInt&rhs) {
+    return lhs |= rhs;
+  }
+
+  /// @brief Provides the bits set in exactly one of the values.
+  friend WideUInt operator^(WideUInt lhs, const WideUInt&rhs) {
+    return lhs ^= rhs;
+  }
+
+  /// @brief Provides the value shifted toward the most significant bit.
+  friend WideUInt operator<<(WideUInt lhs, unsigned int shift) {
+    return lhs <<= shift;
+  }
+
+  /// @brief Provides the value shifted toward the least significant bit.
+  friend WideUInt operator>>(WideUInt lhs, unsigned int shift) {
+    return lhs >>= shift;
+  }
+
+  /// @brief Determines if the values are equal.
+  friend bool operator==(const WideUInt&lhs, const WideUInt&rhs) {
+    word_type difference = 0;
+    for (unsigned int i = 0; i < kWords; ++i) {
+      difference |= lhs.words_[i] ^ rhs.words_[i];
+    }
+    return difference == 0;
+  }
+
+  /// @brief Determines if the values differ.
+  friend bool operator!=(const WideUInt&lhs, const WideUInt&rhs) {
+    return !(lhs == rhs);
+  }
+
+  /// @brief Determines if lhs is less than rhs.
+  friend bool operator<(const WideUInt&lhs, const WideUInt&rhs) {
+    // the borrow out of lhs - rhs
+    unsigned char borrow = 0;
+    for (unsigned int i = 0; i < kWords; ++i) {
+      word_type difference;
+      borrow = detail::SubtractWithBorrow(
+          borrow, lhs.words_[i], rhs.words_[i], &difference);
+    }
+    return borrow != 0;
+  }
+
+  /// @brief Determines if lhs is greater than rhs.
+  friend bool operator>(const WideUInt&lhs, const WideUInt&rhs) {
+    return rhs < lhs;
+  }
+
+  /// @brief Determines if lhs is less than or equal to rhs.
+  friend bool operator<=(const WideUInt&lhs, const WideUInt&rhs) {
+    return !(rhs < lhs);
+  }
+
+  /// @brief Determines if lhs is greater than or equal to rhs.
+  friend bool operator>=(const WideUInt&lhs, const WideUInt&rhs) {
+    return !(lhs < rhs);
+  }
+
+ private:
+  template <class T, unsigned int... kIndices>
+  constexpr WideUInt(T value, IndexSequence<kIndices...>)
+      : words_{ WordOf(value, kIndices)... } {
+  }
+
+  template <unsigned int... kIndices>
+  constexpr WideUInt(const word_type (&words)[kWords],
+                     IndexSequence<kIndices...>)
+      : words_{ words[kIndices]... } {
+  }
+
+  /// @brief Provides the word at the given index of a value converted from
+  /// an integral value.
+  template <class T>
+  static constexpr word_type WordOf(T value, unsigned int index) {
+    // converting to an unsigned type sign-extends the lowest word
+    return index == 0 ? static_cast<word_type>(value)
+        : index * kWordBits < BitSize<T>::value
+        ? static_cast<word_type>(
+            static_cast<Invoke<MakeUnsigned<T>>>(value) >> (index * kWordBits))
+        : value < 0 ? ~static_cast<word_type>(0) : 0;
+  }
+
+  /// @brief Provides the low bits as an unsigned type of T's size.
+  template <class T>
+  EnableIf<BitRange<T, 0, 64>, Invoke<MakeUnsigned<T>>> Low() const {
+    return static_cast<Invoke<MakeUnsigned<T>>>(words_[0]);
+  }
+
+#if defined(NX_HAS_INT128)
+  /// @brief Provides the low bits as an unsigned type of T's size.
+  template <class T>
+  EnableIf<BitRange<T, 65, 128>, Invoke<MakeUnsigned<T>>> Low() const {
+    return static_cast<detail::UInt128>(words_[1]) << 64 | words_[0];
+  }
+#endif
+
+  /// @brief Bitwise long division by a divisor that does not fit in a word.
+  ///
+  /// @param divisor The divisor.
+  /// @param remainder Where to store the remainder, if not null.
+  ///
+  /// @return The quotient.
+  WideUInt DivideLong(const WideUInt&divisor, WideUInt*remainder) const {
+    WideUInt quotient;
+    WideUInt partial;
+    for (unsigned int bit = kBits; bit--;) {
+      partial <<= 1;
+      partial.words_[0] |= (words_[bit / kWordBits] >> (bit % kWordBits)) & 1;
+      if (partial >= divisor) {
+        partial -= divisor;
+        quotient.words_[bit / kWordBits] |=
+            static_cast<word_type>(1) << (bit % kWordBits);
+      }
+    }
+    if (remainder) {
+      *remainder = partial;
+    }
+    return quotient;
+  }
+
+  /// @brief The bits, least significant word first.
+  word_type words_[kWords];
+};
+
+template <unsigned int kBits>
+constexpr unsigned int WideUInt<kBits>::kWordBits;
+
+template <unsigned int kBits>
+constexpr unsigned int WideUInt<kBits>::kWords;
+
+/// @brief Determines if T is a WideUInt.
+template <typename T>
+class IsWideUInt : public Bool<false> {
+};
+
+/// @brief Specialization for WideUInt.
+template <unsigned int kBits>
+class IsWideUInt<WideUInt<kBits>> : public Bool<true> {
+};
+
+}  // namespace nx
+
+#endif  // INCLUDE_NX_CORE_WIDE_INTEGER_H_
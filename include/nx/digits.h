@@ -16,6 +16,9 @@
 
 /// @file digits.h
 /// @brief Provides a function to count the digits of an integer.
+/// @details Bases 2, 8 and 16 are supported as well as 10; as each of their
+/// digits holds a fixed number of bits, their counts follow directly from
+/// BitScanReverse().
 /// @todo If for some reason all types are above 64-bit, you should be able to
 /// optionally truncate the value down to 64-bits and use those versions.
 
@@ -27,11 +30,27 @@
 
 #include "nx/core.h"
 #include "nx/constant.h"
+#include "nx/bit_scan_reverse.h"
+
+#if defined(NX_BIT_SCAN_REVERSE_INTRINSIC) && \
+    (defined(NX_TC_GCC) || defined(NX_TC_CLANG))
+/// @brief Defined if the 32 and 64-bit versions of Digits count the digits
+/// from the highest set bit rather than by comparison tree.
+#define NX_DIGITS_BRANCHLESS 1
+#endif
 
 
 /// @brief Library namespace.
 namespace nx {
 
+/// @brief The case of the letters used for the digits above 9.
+enum class LetterCase {
+  /// @brief Digits such as "ff".
+  kLower,
+  /// @brief Digits such as "FF".
+  kUpper
+};
+
 /// @cond nx_detail
 namespace detail {
 
@@ -45,13 +64,89 @@ constexpr bool ValidDigit<2>(char ch) {
   return ch == '0' || ch == '1';
 }
 
+/// @brief Specialization for base 8
+template <>
+constexpr bool ValidDigit<8>(char ch) {
+  return ch >= '0' && ch <= '7';
+}
+
+/// @brief Specialization for base 10
+template <>
+constexpr bool ValidDigit<10>(char ch) {
+  return ch >= '0' && ch <= '9';
+}
+
+/// @brief Specialization for base 16; either case is accepted.
+template <>
+constexpr bool ValidDigit<16>(char ch) {
+  return (ch >= '0' && ch <= '9') || (ch >= 'a' && ch <= 'f') ||
+      (ch >= 'A' && ch <= 'F');
+}
+
+/// @brief The number of bits each digit of a power of 2 base holds, or 0 for
+/// other bases.
+template <unsigned int number_base>
+class DigitBits : public UInt<
+    number_base == 2 ? 1 : number_base == 8 ? 3 : number_base == 16 ? 4 : 0> {
+};
+
+/// @brief Computes floor(value / 2^shift) without relying on the rounding of
+/// negative values by >>.
+constexpr int FloorShift(int value, unsigned int shift) {
+  return value >= 0 ? value >> shift : ~(~value >> shift);
+}
+
+/// @brief Computes floor(log10(2^exponent)), or floor(log10(3/4 * 2^exponent))
+/// if three_quarters is set; exact for exponents within [-1500, 1500].
+constexpr int FloorLog10Pow2(int exponent, bool three_quarters = false) {
+  return FloorShift(exponent * 1262611 - (three_quarters ? 524031 : 0), 22);
+}
+
+/// @brief Computes floor(log2(10^exponent)); exact for exponents within
+/// [-400, 400].
+constexpr int FloorLog2Pow10(int exponent) {
+  return FloorShift(exponent * 1741647, 19);
+}
+
 /// @cond nx_detail_version
 namespace version {
 
+#if defined(NX_DIGITS_BRANCHLESS)
+/// @brief Corrects an estimate that is either the digits of the value or one
+/// fewer.
+template <class T>
+constexpr unsigned int DigitsCorrect(T value, unsigned int estimate) {
+  return estimate + (value >= constant::power_10_64bit[estimate]);
+}
+
+/// @brief Counts the digits of a nonzero value without branches, as
+/// 1233/4096 approximates log10(2) closely enough that scaling the bit length
+/// by it is off by at most one.
+template <class T>
+constexpr unsigned int DigitsFromBitLength(T value) {
+  return DigitsCorrect(value, (nx::BitScanReverse(value) + 1) * 1233 >> 12);
+}
+
+/// @brief 32-bit version
+template <unsigned int number_base, unsigned int version, class T>
+constexpr EnableIf<All<
+    IsUnsigned<T>, Bool<number_base == 10>, Bool<version == 32>>,
+unsigned int> Digits(T value) {
+  return DigitsFromBitLength(value | 1u);
+}
+
+/// @brief 64-bit version
+template <unsigned int number_base, unsigned int version, class T>
+constexpr EnableIf<All<
+    IsUnsigned<T>, Bool<number_base == 10>, Bool<version == 64>>,
+unsigned int> Digits(T value) {
+  return DigitsFromBitLength(value | 1u);
+}
+#else
 /// @brief 32-bit version
 template <unsigned int number_base, unsigned int version, class T>
 constexpr EnableIf<All<
-    std::is_unsigned<T>, Bool<number_base == 10>, Bool<version == 32>>,
+    IsUnsigned<T>, Bool<number_base == 10>, Bool<version == 32>>,
 unsigned int> Digits(T value) {
   return  (value < Power<T, 10, 5>::value) ?
       (value < Power<T, 10, 2>::value) ?
@@ -72,7 +167,7 @@ unsigned int> Digits(T value) {
 /// @brief 64-bit version
 template <unsigned int number_base, unsigned int version, class T>
 constexpr EnableIf<All<
-    std::is_unsigned<T>, Bool<number_base == 10>, Bool<version == 64>>,
+    IsUnsigned<T>, Bool<number_base == 10>, Bool<version == 64>>,
 unsigned int> Digits(T value) {
   return  (value < Power<T, 10, 10>::value) ?
       Digits<number_base, 32>(value)
@@ -92,11 +187,43 @@ unsigned int> Digits(T value) {
       (value < Power<T, 10, 18>::value) ? 18 : 19
     : 20;
 }
+#endif
+
+/// @brief Finds the digits of a value known to have between kMin and kMax
+/// digits, by binary search over the powers of 10.
+template <class T, unsigned int kMin, unsigned int kMax>
+constexpr EnableIf<
+    Bool<kMin == kMax>,
+unsigned int> DigitsSearch(T) {
+  return kMin;
+}
+
+/// @brief Finds the digits of a value known to have between kMin and kMax
+/// digits, by binary search over the powers of 10.
+template <class T, unsigned int kMin, unsigned int kMax>
+constexpr EnableIf<
+    Bool<(kMin < kMax)>,
+unsigned int> DigitsSearch(T value) {
+  return (value < Power<T, 10, (kMin + kMax) / 2>::value) ?
+      DigitsSearch<T, kMin, (kMin + kMax) / 2>(value)
+    : DigitsSearch<T, (kMin + kMax) / 2 + 1, kMax>(value);
+}
+
+/// @brief 128-bit version; values with a high word set have at least 20
+/// digits, which leaves 5 comparisons.
+template <unsigned int number_base, unsigned int version, class T>
+constexpr EnableIf<All<
+    IsUnsigned<T>, Bool<number_base == 10>, Bool<version == 128>>,
+unsigned int> Digits(T value) {
+  return (value >> 64) ?
+      DigitsSearch<T, 20, 39>(value)
+    : Digits<number_base, 64>(static_cast<uint64_t>(value));
+}
 
 /// @brief Version for large types, no longer constexpr
 template <unsigned int number_base, unsigned int version, class T>
 EnableIf<All<
-    std::is_unsigned<T>, Bool<number_base == 10>, Bool<version == 0>>,
+    IsUnsigned<T>, Bool<number_base == 10>, Bool<version == 0>>,
 unsigned int> Digits(T value) {
   constexpr const T next_pow10 = Power<T, 10, 20>::value;
   if (value < next_pow10) {
@@ -114,32 +241,34 @@ unsigned int> Digits(T value) {
 /// @brief Signed value forwarder for constexpr handled types.
 template <unsigned int number_base, unsigned int version, class T>
 inline constexpr EnableIf<All<
-    std::is_signed<T>, Bool<number_base == 10>, Bool<version != 0>>,
+    IsSigned<T>, Bool<number_base == 10>, Bool<version != 0>>,
 unsigned int> Digits(T value) {
-  typedef const typename std::make_unsigned<T>::type UT;
+  typedef const Invoke<MakeUnsigned<T>> UT;
   return Digits<number_base, version>(
-      static_cast<UT>((value < 0?-value:value)) );
+      static_cast<UT>(value < 0 ? -static_cast<UT>(value) : value));
 }
 
 /// @brief Signed value forwarder for larger types.
 template <unsigned int number_base, unsigned int version, class T>
 inline EnableIf<All<
-    std::is_signed<T>, Bool<number_base == 10>, Bool<version == 0>>,
+    IsSigned<T>, Bool<number_base == 10>, Bool<version == 0>>,
 unsigned int> Digits(T value) {
-  typedef const typename std::make_unsigned<T>::type UT;
+  typedef const Invoke<MakeUnsigned<T>> UT;
   return Digits<number_base, version>(
-      static_cast<UT>((value < 0?-value:value)) );
+      static_cast<UT>(value < 0 ? -static_cast<UT>(value) : value));
 }
 
 }  // namespace version
 /// @endcond
 
-/// @brief [0,32]-bit selector
+/// @brief [0,32]-bit selector; smaller types are widened, as the powers of 10
+/// the 32-bit version compares against would not fit in them.
 template <unsigned int number_base, class T>
 inline constexpr EnableIf<All<
     Bool<number_base == 10>, BitRange<T, 0, 32>>,
 unsigned int> Digits(T value) {
-  return version::Digits<number_base, 32>(value);
+  return version::Digits<number_base, 32>(static_cast<
+      Invoke<SetSigned<IsSigned<T>::value, uint_least32_t>>>(value));
 }
 
 /// @brief [33,64]-bit selector
@@ -150,14 +279,67 @@ unsigned int> Digits(T value) {
   return version::Digits<number_base, 64>(value);
 }
 
+/// @brief [65,128]-bit selector
+template <unsigned int number_base, class T>
+inline constexpr EnableIf<All<
+    Bool<number_base == 10>, BitRange<T, 65, 128>>,
+unsigned int> Digits(T value) {
+  return version::Digits<number_base, 128>(value);
+}
+
 /// @brief Large generic selector
 template <unsigned int number_base, class T>
 inline EnableIf<All<
-    Bool<number_base == 10>, BitRange<T, 65>>,
+    Bool<number_base == 10>, BitRange<T, 129>>,
 unsigned int> Digits(T value) {
   return version::Digits<number_base, 0>(value);
 }
 
+/// @brief Wide integer selector; divides off 19 digits at a time until the
+/// value fits in a word.
+template <unsigned int number_base, unsigned int kBits>
+EnableIf<
+    Bool<number_base == 10>,
+unsigned int> Digits(WideUInt<kBits> value) {
+  unsigned int digits = 0;
+  while (!value.FitsWord()) {
+    value.DivideBy(Power<uint64_t, 10, 19>::value);
+    digits += 19;
+  }
+  return digits + Digits<number_base>(value.word(0));
+}
+
+/// @brief Power of 2 base selector; the bits above the highest set bit are
+/// rounded up to whole digits, so no comparisons are needed.
+template <unsigned int number_base, class T>
+inline constexpr EnableIf<All<
+    IsUnsigned<T>, Bool<DigitBits<number_base>::value != 0>,
+    BitRange<T, 0, 128>>,
+unsigned int> Digits(T value) {
+  return (nx::BitScanReverse(value) + DigitBits<number_base>::value) /
+      DigitBits<number_base>::value;
+}
+
+/// @brief Power of 2 base signed value forwarder.
+template <unsigned int number_base, class T>
+inline constexpr EnableIf<All<
+    IsIntegral<T>, IsSigned<T>, Bool<DigitBits<number_base>::value != 0>,
+    BitRange<T, 0, 128>>,
+unsigned int> Digits(T value) {
+  typedef const Invoke<MakeUnsigned<T>> UT;
+  return Digits<number_base>(
+      static_cast<UT>(value < 0 ? -static_cast<UT>(value) : value));
+}
+
+/// @brief Power of 2 base wide integer selector.
+template <unsigned int number_base, unsigned int kBits>
+EnableIf<
+    Bool<DigitBits<number_base>::value != 0>,
+unsigned int> Digits(const WideUInt<kBits>&value) {
+  return (nx::BitScanReverse(value) + DigitBits<number_base>::value) /
+      DigitBits<number_base>::value;
+}
+
 }  // namespace detail
 /// @endcond
 
@@ -172,7 +354,7 @@ unsigned int> Digits(T value) {
 /// digits in a decimal number.  This does not count any negative sign.
 template <unsigned int number_base = 10, class T>
 constexpr EnableIf<
-    BitRange<T, 0, 64>,
+    BitRange<T, 0, 128>,
 unsigned int> Digits(T value) {
   return detail::Digits<number_base>(value);
 }
@@ -188,13 +370,14 @@ unsigned int> Digits(T value) {
 /// digits in a decimal number.  This does not count any negative sign.
 template <unsigned int number_base = 10, class T>
 EnableIf<
-    BitRange<T, 65>,
+    BitRange<T, 129>,
 unsigned int> Digits(T value) {
   return detail::Digits<number_base>(value);
 }
 
 
 /// @brief Determines if a given character is a valid digit in some base.
+/// @details Bases 2, 8, 10 and 16 are supported.
 ///
 /// @tparam number_base The base the number is to be checked against.
 /// @param ch The character to check.
@@ -203,6 +386,26 @@ constexpr bool ValidDigit(char ch) {
   return detail::ValidDigit<number_base>(ch);
 }
 
+/// @brief Provides the value of a digit in any base up to 36.
+///
+/// @param ch The digit, which must be valid in its base.
+constexpr unsigned int DigitValue(char ch) {
+  return (ch >= '0' && ch <= '9') ? static_cast<unsigned int>(ch - '0')
+      : (ch >= 'a' && ch <= 'z') ? static_cast<unsigned int>(ch - 'a' + 10)
+      : static_cast<unsigned int>(ch - 'A' + 10);
+}
+
+/// @brief Provides the character of a digit in any base up to 36; the
+/// inverse of DigitValue().
+///
+/// @param digit The value of the digit.
+/// @param letter_case The case of the letters used for digits above 9.
+constexpr char DigitChar(unsigned int digit,
+                         LetterCase letter_case = LetterCase::kLower) {
+  return static_cast<char>(digit < 10 ? '0' + digit
+      : (letter_case == LetterCase::kUpper ? 'A' : 'a') + digit - 10);
+}
+
 
 }  // namespace nx
 
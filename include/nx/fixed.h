@@ -0,0 +1,350 @@
+//
+// Copyright (C) 2013 Jacob McIntosh <nacitar at ubercpp dot com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+/// @file fixed.h
+/// @brief Provides a signed binary fixed-point number type.
+/// @details Fixed<kIntBits, kFracBits> holds a value scaled by 2^kFracBits in
+/// the smallest integer of at least kIntBits + kFracBits bits, so sums and
+/// products are exact or rounded the same way on every platform, without
+/// floating-point conversions.  Products are formed in an integer twice as
+/// wide (a 128-bit one for more than 32 bits) and rounded to the nearest
+/// value, ties upward.  Sums, differences and products that do not fit wrap
+/// around in two's complement at the width of the storage type, as the
+/// builtin unsigned types do.  Every fixed-point value has a finite
+/// decimal expansion, which ToString() writes exactly: @code
+/// nx::ToString(nx::Fixed<16, 16>(-2.375));  // "-2.375"
+/// @endcode
+
+#ifndef INCLUDE_NX_FIXED_H_
+#define INCLUDE_NX_FIXED_H_
+
+#include <string>
+#include "nx/core.h"
+#include "nx/bit_scan_forward.h"
+#include "nx/digits.h"
+#include "nx/to_string.h"
+
+/// @brief Library namespace.
+namespace nx {
+
+/// @cond nx_detail
+namespace detail {
+
+/// @brief Half of the unit in the last place of a product, added to round it
+/// to nearest.
+template <unsigned int kFracBits>
+constexpr uint64_t FixedHalf() {
+  return (static_cast<uint64_t>(1) << kFracBits) >> 1;
+}
+
+/// @brief Rounds scaled, given its integer part truncated, to nearest, ties
+/// away from zero.  The remainder scaled - truncated is exact, so unlike
+/// adding 0.5 before truncating this never rounds twice.
+template <class T>
+constexpr int64_t FixedRound(T scaled, int64_t truncated) {
+  return scaled - static_cast<T>(truncated) >= 0.5 ? truncated + 1
+      : scaled - static_cast<T>(truncated) <= -0.5 ? truncated - 1
+      : truncated;
+}
+
+/// @brief Rounds a floating-point value already scaled by 2^kFracBits to the
+/// nearest raw fixed-point value, ties away from zero.
+template <class T>
+constexpr int64_t FixedRound(T scaled) {
+  return FixedRound(scaled, static_cast<int64_t>(scaled));
+}
+
+/// @brief Multiplies the raw values of two fixed-point numbers of up to 32
+/// bits in a 64-bit integer.
+template <unsigned int kFracBits, class T>
+inline EnableIf<BitRange<T, 0, 32>, T> FixedMultiply(T lhs, T rhs) {
+  const int64_t product = static_cast<int64_t>(lhs) * rhs;
+  return static_cast<T>(
+      (product + static_cast<int64_t>(FixedHalf<kFracBits>())) >> kFracBits);
+}
+
+/// @brief Multiplies the raw values of two fixed-point numbers of up to 64
+/// bits with MultiplyWords(), producing the 128-bit product as two words.
+template <unsigned int kFracBits, class T>
+inline T FixedMultiplyWords(T lhs, T rhs) {
+  uint64_t high;
+  uint64_t low = MultiplyWords(
+      static_cast<uint64_t>(lhs), static_cast<uint64_t>(rhs), &high);
+  // The unsigned product of the two's complement words exceeds the signed
+  // one by 2^64 times each word whose operand is negative.
+  high -= lhs < 0 ? static_cast<uint64_t>(rhs) : 0;
+  high -= rhs < 0 ? static_cast<uint64_t>(lhs) : 0;
+  low += FixedHalf<kFracBits>();
+  high += low < FixedHalf<kFracBits>();
+  return static_cast<T>(kFracBits
+      ? low >> kFracBits | high << ((64 - kFracBits) % 64) : low);
+}
+
+/// @brief Multiplies the raw values of two fixed-point numbers of up to 64
+/// bits in a 128-bit integer.
+template <unsigned int kFracBits, class T>
+inline EnableIf<BitRange<T, 33, 64>, T> FixedMultiply(T lhs, T rhs) {
+#if defined(NX_HAS_INT128)
+  const Int128 product = static_cast<Int128>(lhs) * rhs;
+  return static_cast<T>(
+      (product + static_cast<Int128>(FixedHalf<kFracBits>())) >> kFracBits);
+#else
+  return FixedMultiplyWords<kFracBits>(lhs, rhs);
+#endif
+}
+
+}  // namespace detail
+/// @endcond
+
+/// @brief A signed binary fixed-point number.
+/// @details Conversions from integral and floating-point values are
+/// explicit and constexpr, as are those back and all arithmetic but
+/// multiplication.  A floating-point value is rounded to the nearest
+/// fixed-point one, ties away from zero.
+///
+/// @tparam kIntBits The number of bits before the binary point, including
+/// the sign bit.
+/// @tparam kFracBits The number of bits after the binary point.
+template <unsigned int kIntBits, unsigned int kFracBits>
+class Fixed {
+  static_assert(kIntBits >= 1, "Fixed needs an integer bit for the sign.");
+  static_assert(kIntBits + kFracBits <= 64, "Fixed is at most 64 bits.");
+
+ public:
+  /// @brief The integral type holding the scaled value.
+  typedef int_least_t<kIntBits + kFracBits> storage_type;
+
+  /// @brief The number of bits after the binary point.
+  static constexpr unsigned int kFractionBits = kFracBits;
+
+  /// @brief Constructs the value zero.
+  constexpr Fixed() : raw_() {
+  }
+
+  /// @brief Converts an integral value, which must fit in kIntBits bits.
+  template <class T, class = EnableIf<IsIntegral<T>>>
+  explicit constexpr Fixed(T value)
+      : raw_(static_cast<storage_type>(
+            static_cast<uint64_t>(value) << kFracBits)) {
+  }
+
+  /// @brief Converts a floating-point value, which must be within the range
+  /// of the type, rounding it to nearest.
+  template <class T, class = EnableIf<IsFloatingPoint<T>>, class = void>
+  explicit constexpr Fixed(T value)
+      : raw_(static_cast<storage_type>(
+            detail::FixedRound(value * Scale()))) {
+  }
+
+  /// @brief Constructs from the value scaled by 2^kFracBits.
+  static constexpr Fixed FromRaw(storage_type raw) {
+    return Fixed(raw, RawTag());
+  }
+
+  /// @brief Provides the value scaled by 2^kFracBits.
+  constexpr storage_type raw() const {
+    return raw_;
+  }
+
+  /// @brief Converts to a double, which is exact if the raw value fits in
+  /// its 53-bit significand.
+  constexpr double ToDouble() const {
+    return static_cast<double>(raw_) / Scale();
+  }
+
+  /// @brief Converts to an integer, rounding toward negative infinity.
+  constexpr storage_type ToInteger() const {
+    return static_cast<storage_type>(raw_ >> kFracBits);
+  }
+
+  Fixed&operator+=(Fixed other) {
+    return *this = *this + other;
+  }
+
+  Fixed&operator-=(Fixed other) {
+    return *this = *this - other;
+  }
+
+  Fixed&operator*=(Fixed other) {
+    return *this = *this * other;
+  }
+
+  // Negation, addition and subtraction are done on the unsigned words, since
+  // overflowing the signed storage type would be undefined.
+  constexpr Fixed operator-() const {
+    return FromRaw(static_cast<storage_type>(
+        0 - static_cast<uint64_t>(raw_)));
+  }
+
+  friend constexpr Fixed operator+(Fixed lhs, Fixed rhs) {
+    return FromRaw(static_cast<storage_type>(
+        static_cast<uint64_t>(lhs.raw_) + static_cast<uint64_t>(rhs.raw_)));
+  }
+
+  friend constexpr Fixed operator-(Fixed lhs, Fixed rhs) {
+    return FromRaw(static_cast<storage_type>(
+        static_cast<uint64_t>(lhs.raw_) - static_cast<uint64_t>(rhs.raw_)));
+  }
+
+  friend Fixed operator*(Fixed lhs, Fixed rhs) {
+    return FromRaw(detail::FixedMultiply<kFracBits>(lhs.raw_, rhs.raw_));
+  }
+
+  friend constexpr bool operator==(Fixed lhs, Fixed rhs) {
+    return lhs.raw_ == rhs.raw_;
+  }
+
+  friend constexpr bool operator!=(Fixed lhs, Fixed rhs) {
+    return lhs.raw_ != rhs.raw_;
+  }
+
+  friend constexpr bool operator<(Fixed lhs, Fixed rhs) {
+    return lhs.raw_ < rhs.raw_;
+  }
+
+  friend constexpr bool operator<=(Fixed lhs, Fixed rhs) {
+    return lhs.raw_ <= rhs.raw_;
+  }
+
+  friend constexpr bool operator>(Fixed lhs, Fixed rhs) {
+    return lhs.raw_ > rhs.raw_;
+  }
+
+  friend constexpr bool operator>=(Fixed lhs, Fixed rhs) {
+    return lhs.raw_ >= rhs.raw_;
+  }
+
+ private:
+  /// @brief Selects the constructor taking a raw value.
+  class RawTag {
+  };
+
+  constexpr Fixed(storage_type raw, RawTag) : raw_(raw) {
+  }
+
+  /// @brief Provides 2^kFracBits.
+  static constexpr double Scale() {
+    return static_cast<double>(static_cast<uint64_t>(1) << kFracBits);
+  }
+
+  storage_type raw_;
+};
+
+template <unsigned int kIntBits, unsigned int kFracBits>
+constexpr unsigned int Fixed<kIntBits, kFracBits>::kFractionBits;
+
+/// @cond nx_detail
+namespace detail {
+
+/// @brief Splits the magnitude of a fixed-point value into its integer part
+/// and its fraction bits, the latter left-aligned in a word.
+///
+/// @return true if the value is negative.
+template <unsigned int kIntBits, unsigned int kFracBits>
+inline bool SplitFixed(Fixed<kIntBits, kFracBits> value,
+                       uint_least_t<kIntBits + kFracBits>*integer,
+                       uint64_t*fraction) {
+  typedef uint_least_t<kIntBits + kFracBits> UT;
+  const bool negative = value.raw() < 0;
+  const uint64_t raw = static_cast<uint64_t>(value.raw());
+  const uint64_t magnitude = negative ? 0u - raw : raw;
+  *integer = static_cast<UT>(magnitude >> kFracBits);
+  *fraction = kFracBits ? magnitude << ((64 - kFracBits) % 64) : 0;
+  return negative;
+}
+
+/// @brief Counts the decimal digits of a left-aligned fraction; one that
+/// ends n bits after the binary point has exactly n of them.
+inline unsigned int FractionDigits(uint64_t fraction) {
+  return fraction ? 64 - BitScanForward(fraction) : 0;
+}
+
+/// @brief Writes the decimal digits of a left-aligned fraction; each digit
+/// is the word carried out of multiplying the remainder by 10.
+inline void WriteFraction(uint64_t fraction, char*buffer) {
+  while (fraction) {
+    uint64_t digit;
+    fraction = MultiplyWords(fraction, 10, &digit);
+    *buffer++ = static_cast<char>('0' + digit);
+  }
+}
+
+}  // namespace detail
+/// @endcond
+
+/// @brief Determines the digits of the exact decimal expansion of a
+/// fixed-point value; those of its integer part and those after the decimal
+/// point.  This does not count any negative sign or the decimal point.
+template <unsigned int number_base = 10,
+          unsigned int kIntBits, unsigned int kFracBits>
+inline unsigned int Digits(Fixed<kIntBits, kFracBits> value) {
+  static_assert(number_base == 10, "Fixed supports only base 10.");
+  uint_least_t<kIntBits + kFracBits> integer;
+  uint64_t fraction;
+  detail::SplitFixed(value, &integer, &fraction);
+  return Digits<10>(integer) + detail::FractionDigits(fraction);
+}
+
+/// @brief Writes the exact decimal expansion of a fixed-point value to the
+/// provided character buffer, with no decimal point if it is an integer.
+///
+/// @param value The value to process.
+/// @param buffer The location to write the string representation, which
+/// must have room for Digits(value) + 2 characters.
+///
+/// @return The number of characters written to the buffer.
+template <unsigned int kIntBits, unsigned int kFracBits>
+unsigned int ToString(Fixed<kIntBits, kFracBits> value, char*buffer) {
+  uint_least_t<kIntBits + kFracBits> integer;
+  uint64_t fraction;
+  char*position = buffer;
+  if (detail::SplitFixed(value, &integer, &fraction)) {
+    *position++ = '-';
+  }
+  position += ToString(integer, position);
+  if (fraction) {
+    *position++ = '.';
+    detail::WriteFraction(fraction, position);
+    position += detail::FractionDigits(fraction);
+  }
+  return static_cast<unsigned int>(position - buffer);
+}
+
+/// @brief Appends the exact decimal expansion of a fixed-point value to the
+/// provided string.
+///
+/// @return The number of characters appended to the string.
+template <unsigned int kIntBits, unsigned int kFracBits>
+unsigned int ToString(Fixed<kIntBits, kFracBits> value, std::string*buffer) {
+  const std::string::size_type offset = buffer->size();
+  // room for the digits, a - and a decimal point
+  buffer->resize(offset + Digits(value) + 2);
+  const unsigned int count = ToString(value, &((*buffer)[offset]));
+  buffer->resize(offset + count);
+  return count;
+}
+
+/// @brief Converts a fixed-point value into its exact decimal expansion.
+template <unsigned int kIntBits, unsigned int kFracBits>
+std::string ToString(Fixed<kIntBits, kFracBits> value) {
+  std::string buffer;
+  ToString(value, &buffer);
+  return buffer;
+}
+
+}  // namespace nx
+
+#endif  // INCLUDE_NX_FIXED_H_
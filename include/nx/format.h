@@ -0,0 +1,712 @@
+//
+// Copyright (C) 2013 Jacob McIntosh <nacitar at ubercpp dot com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+/// @file format.h
+/// @brief Provides Format(), which writes values into a buffer as described
+/// by a format string, without allocating.
+/// @details A format string holds text and replacement fields in braces,
+/// each of which is replaced by the next argument: @code
+/// constexpr nx::FormatString kLine("id={:016x} status={:>3} path={}");
+/// const size_t length = nx::Format(buffer, sizeof(buffer), kLine,
+///                                  id, status, path);
+/// @endcode
+/// A field may hold a colon followed by a spec of the form
+/// [[fill]align][0][width][type]:
+/// - align is < (left), > (right) or ^ (center), padding with the fill
+///   character, a space by default.  Numbers are right-aligned and other
+///   values left-aligned by default.
+/// - 0 pads numbers with zeros after their sign, unless an align is given.
+/// - width is the minimum number of characters, at most kMaxFormatWidth.
+/// - type writes an integer in base 10 (d), 16 (x or X), 8 (o) or 2 (b).
+///
+/// {{ and }} are written as { and }.  The string is parsed by a constexpr
+/// constructor, so a FormatString declared constexpr is parsed and checked
+/// at compile time, and a malformed one does not compile.  Passing such a
+/// string at namespace scope as a template argument also checks the
+/// arguments against it at compile time: @code
+/// const size_t length = nx::Format<kLine>(buffer, sizeof(buffer),
+///                                         id, status, path);
+/// @endcode
+/// Otherwise the arguments are checked at runtime, before anything is
+/// written.  Integers and floating-point values are written with
+/// ToString().
+
+#ifndef INCLUDE_NX_FORMAT_H_
+#define INCLUDE_NX_FORMAT_H_
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include "nx/core.h"
+#include "nx/digits.h"
+#include "nx/static_string.h"
+#include "nx/to_string.h"
+
+/// @brief Library namespace.
+namespace nx {
+
+/// @brief The widest field a format string may request.
+constexpr const unsigned int kMaxFormatWidth = 255;
+
+/// @brief The alignment of a value within its field.
+enum class FormatAlign : char {
+  /// @brief Right for numbers, left for everything else.
+  kDefault,
+  /// @brief Padded after the value.
+  kLeft,
+  /// @brief Padded before the value.
+  kRight,
+  /// @brief Padded evenly on both sides, with any odd character after.
+  kCenter
+};
+
+/// @brief A piece of a parsed format string: either literal text or a
+/// replacement field.
+struct FormatSegment {
+  /// @brief A literal text segment.
+  ///
+  /// @param text_begin The offset of the text in the format string.
+  /// @param text_end The offset just past the text.
+  constexpr FormatSegment(unsigned int text_begin, unsigned int text_end)
+      : begin(text_begin), end(text_end), field(false), fill(' '),
+        align(FormatAlign::kDefault), zero_pad(false), width(0), type('\0') {
+  }
+
+  /// @brief A replacement field.
+  constexpr FormatSegment(char fill_char, FormatAlign field_align,
+                          bool pad_zeros, unsigned int field_width,
+                          char presentation_type)
+      : begin(0), end(0), field(true), fill(fill_char), align(field_align),
+        zero_pad(pad_zeros), width(field_width), type(presentation_type) {
+  }
+
+  /// @brief The offset of a literal text segment.
+  unsigned int begin;
+  /// @brief The offset just past a literal text segment.
+  unsigned int end;
+  /// @brief True for a replacement field.
+  bool field;
+  /// @brief The padding character.
+  char fill;
+  /// @brief The alignment within the width.
+  FormatAlign align;
+  /// @brief True if numbers are padded with zeros after their sign.
+  bool zero_pad;
+  /// @brief The minimum number of characters.
+  unsigned int width;
+  /// @brief One of d, x, X, o or b, or the null character if none.
+  char type;
+};
+
+/// @cond nx_detail
+namespace detail {
+
+/// @brief Reports a malformed format string; in a constant expression, this
+/// makes the program fail to compile.
+inline unsigned int FormatError(const char*message) {
+  throw std::invalid_argument(message);
+}
+
+/// @brief Determines if a character is an alignment in a spec.
+constexpr bool IsFormatAlign(char ch) {
+  return ch == '<' || ch == '>' || ch == '^';
+}
+
+/// @brief Provides the alignment a character in a spec stands for.
+constexpr FormatAlign ToFormatAlign(char ch) {
+  return ch == '<' ? FormatAlign::kLeft
+      : ch == '>' ? FormatAlign::kRight : FormatAlign::kCenter;
+}
+
+/// @brief Determines if a character is a presentation type in a spec.
+constexpr bool IsFormatType(char ch) {
+  return ch == 'd' || ch == 'x' || ch == 'X' || ch == 'o' || ch == 'b';
+}
+
+/// @brief Finds the end of the literal text starting at the position.
+constexpr unsigned int FormatTextEnd(const char*text, unsigned int length,
+                                     unsigned int position) {
+  return (position < length && text[position] != '{' &&
+          text[position] != '}')
+      ? FormatTextEnd(text, length, position + 1) : position;
+}
+
+/// @brief Finds the } closing the replacement field that holds the
+/// position.
+constexpr unsigned int FormatFieldEnd(const char*text, unsigned int length,
+                                      unsigned int position) {
+  return position >= length ? FormatError("unterminated replacement field")
+      : text[position] == '}' ? position
+      : text[position] == '{' ? FormatError("{ within a replacement field")
+      : FormatFieldEnd(text, length, position + 1);
+}
+
+/// @brief Determines if the position holds an escaped { or }.
+constexpr bool IsFormatEscape(const char*text, unsigned int length,
+                              unsigned int position) {
+  return position + 1 < length && text[position + 1] == text[position];
+}
+
+/// @brief Finds the end of the segment starting at the position.
+constexpr unsigned int FormatSegmentEnd(const char*text, unsigned int length,
+                                        unsigned int position) {
+  return position >= length ? length
+      : IsFormatEscape(text, length, position) &&
+        (text[position] == '{' || text[position] == '}') ? position + 2
+      : text[position] == '{' ? FormatFieldEnd(text, length, position + 1) + 1
+      : text[position] == '}' ? FormatError("unmatched }")
+      : FormatTextEnd(text, length, position);
+}
+
+/// @brief Finds the start of the segment with the given index.
+constexpr unsigned int FormatSegmentStart(const char*text,
+                                          unsigned int length,
+                                          unsigned int index) {
+  return index ? FormatSegmentEnd(
+      text, length, FormatSegmentStart(text, length, index - 1)) : 0;
+}
+
+/// @brief Counts the segments starting at or after the position; if
+/// fields_only is set, only the replacement fields are counted.
+constexpr unsigned int CountFormatSegments(const char*text,
+                                           unsigned int length,
+                                           unsigned int position,
+                                           bool fields_only) {
+  return position < length
+      ? (!fields_only || (text[position] == '{' &&
+                          !IsFormatEscape(text, length, position))) +
+        CountFormatSegments(text, length,
+            FormatSegmentEnd(text, length, position), fields_only)
+      : 0;
+}
+
+/// @brief Parses the width in a spec, which ends at the first non-digit.
+constexpr unsigned int FormatWidth(const char*text, unsigned int position,
+                                   unsigned int end, unsigned int width) {
+  return width > kMaxFormatWidth ? FormatError("field width too large")
+      : (position < end && ValidDigit<10>(text[position]))
+      ? FormatWidth(text, position + 1, end,
+                    width * 10 + DigitValue(text[position]))
+      : width;
+}
+
+/// @brief Finds the end of the width in a spec.
+constexpr unsigned int FormatWidthEnd(const char*text, unsigned int position,
+                                      unsigned int end) {
+  return (position < end && ValidDigit<10>(text[position]))
+      ? FormatWidthEnd(text, position + 1, end) : position;
+}
+
+/// @brief Parses the presentation type, which must end the spec.
+constexpr char FormatType(const char*text, unsigned int position,
+                          unsigned int end) {
+  return position == end ? '\0'
+      : (position + 1 == end && IsFormatType(text[position]))
+      ? text[position]
+      : static_cast<char>(FormatError("invalid replacement field spec"));
+}
+
+/// @brief Parses a spec, given the position after its alignment.
+constexpr FormatSegment ParseFormatSpec(const char*text, unsigned int begin,
+                                        unsigned int end, char fill,
+                                        FormatAlign align) {
+  return FormatSegment(
+      fill, align, begin < end && text[begin] == '0',
+      FormatWidth(text, begin + (begin < end && text[begin] == '0'), end, 0),
+      FormatType(text, FormatWidthEnd(
+          text, begin + (begin < end && text[begin] == '0'), end), end));
+}
+
+/// @brief Parses the spec between the : and the } of a field.
+constexpr FormatSegment ParseFormatSpec(const char*text, unsigned int begin,
+                                        unsigned int end) {
+  return (end - begin >= 2 && IsFormatAlign(text[begin + 1]))
+      ? ParseFormatSpec(text, begin + 2, end, text[begin],
+                        ToFormatAlign(text[begin + 1]))
+      : (begin < end && IsFormatAlign(text[begin]))
+      ? ParseFormatSpec(text, begin + 1, end, ' ', ToFormatAlign(text[begin]))
+      : ParseFormatSpec(text, begin, end, ' ', FormatAlign::kDefault);
+}
+
+/// @brief Parses a replacement field; begin follows the { and end is the
+/// position of the }.
+constexpr FormatSegment ParseFormatField(const char*text, unsigned int begin,
+                                         unsigned int end) {
+  return begin == end ? FormatSegment(' ', FormatAlign::kDefault, false, 0,
+                                      '\0')
+      : text[begin] == ':' ? ParseFormatSpec(text, begin + 1, end)
+      : FormatSegment(' ', FormatAlign::kDefault, false, 0,
+                      static_cast<char>(FormatError(
+                          "replacement fields must be {} or {:spec}")));
+}
+
+/// @brief Parses the segment starting at the position.
+constexpr FormatSegment ParseFormatSegment(const char*text,
+                                           unsigned int length,
+                                           unsigned int position) {
+  return position >= length ? FormatSegment(length, length)
+      : (IsFormatEscape(text, length, position) &&
+         (text[position] == '{' || text[position] == '}'))
+      ? FormatSegment(position + 1, position + 2)
+      : text[position] == '{'
+      ? ParseFormatField(text, position + 1,
+                         FormatFieldEnd(text, length, position + 1))
+      : FormatSegment(position, FormatSegmentEnd(text, length, position));
+}
+
+}  // namespace detail
+/// @endcond
+
+/// @brief A parsed format string; see format.h for its syntax.
+/// @details Declare it constexpr to parse it at compile time; otherwise the
+/// constructor parses it at runtime, throwing std::invalid_argument if it is
+/// malformed.
+class FormatString {
+ public:
+  /// @brief The most segments, counting each run of text, escaped brace and
+  /// replacement field, that a format string may have.
+  static constexpr const unsigned int kMaxSegments = 32;
+
+  /// @brief Parses a string literal.
+  template <unsigned int kSize>
+  explicit constexpr FormatString(const char (&text)[kSize])
+      : FormatString(text, kSize - 1, MakeIndexSequence<kMaxSegments>()) {
+  }
+
+  /// @brief Provides the format string.
+  constexpr const char*text() const {
+    return text_;
+  }
+
+  /// @brief Provides the number of segments.
+  constexpr unsigned int size() const {
+    return size_;
+  }
+
+  /// @brief Provides the number of replacement fields, which is the number
+  /// of arguments the string must be given.
+  constexpr unsigned int fields() const {
+    return fields_;
+  }
+
+  /// @brief Provides the segment with the given index.
+  constexpr const FormatSegment&segment(unsigned int index) const {
+    return segments_[index];
+  }
+
+ private:
+  template <unsigned int... kIndices>
+  constexpr FormatString(const char*text, unsigned int length,
+                         IndexSequence<kIndices...>)
+      : text_(text),
+        size_(detail::CountFormatSegments(text, length, 0, false) <=
+              kMaxSegments
+            ? detail::CountFormatSegments(text, length, 0, false)
+            : detail::FormatError("too many format string segments")),
+        fields_(detail::CountFormatSegments(text, length, 0, true)),
+        segments_{detail::ParseFormatSegment(text, length,
+            detail::FormatSegmentStart(text, length, kIndices))...} {
+  }
+
+  /// @brief The format string.
+  const char*text_;
+  /// @brief The number of segments.
+  unsigned int size_;
+  /// @brief The number of replacement fields.
+  unsigned int fields_;
+  /// @brief The segments; those past size_ are empty.
+  FormatSegment segments_[kMaxSegments];
+};
+
+/// @cond nx_detail
+namespace detail {
+
+/// @brief Writes into a fixed buffer, dropping what does not fit but still
+/// counting it.
+class FormatBufferOutput {
+ public:
+  /// @brief Writes into the size bytes at buffer.
+  FormatBufferOutput(char*buffer, size_t size)
+      : position_(buffer), end_(buffer + size), length_(0) {
+  }
+
+  /// @brief Writes text.
+  void Append(const char*text, size_t length) {
+    const size_t count = std::min(length, Space());
+    std::memcpy(position_, text, count);
+    position_ += count;
+    length_ += length;
+  }
+
+  /// @brief Writes a character count times.
+  void Fill(char ch, size_t count) {
+    const size_t written = std::min(count, Space());
+    std::memset(position_, ch, written);
+    position_ += written;
+    length_ += count;
+  }
+
+  /// @brief Provides the number of characters written, including those
+  /// that did not fit.
+  size_t length() const {
+    return length_;
+  }
+
+ private:
+  size_t Space() const {
+    return static_cast<size_t>(end_ - position_);
+  }
+
+  char*position_;
+  char*const end_;
+  size_t length_;
+};
+
+/// @brief Appends to a std::string.
+class FormatStringOutput {
+ public:
+  /// @brief Appends to the given string.
+  explicit FormatStringOutput(std::string*buffer)
+      : buffer_(buffer), offset_(buffer->size()) {
+  }
+
+  /// @brief Writes text.
+  void Append(const char*text, size_t length) {
+    buffer_->append(text, length);
+  }
+
+  /// @brief Writes a character count times.
+  void Fill(char ch, size_t count) {
+    buffer_->append(count, ch);
+  }
+
+  /// @brief Provides the number of characters appended.
+  size_t length() const {
+    return buffer_->size() - offset_;
+  }
+
+ private:
+  std::string*const buffer_;
+  const std::string::size_type offset_;
+};
+
+/// @brief Writes a value's text padded to the width of its field.
+/// @details Zero padding goes after a leading -, so it is only requested
+/// for numbers.
+template <class Output>
+void WritePadded(Output*out, const FormatSegment&segment, const char*text,
+                 size_t length, FormatAlign default_align, bool numeric) {
+  const size_t padding = segment.width > length ? segment.width - length : 0;
+  if (!padding) {
+    out->Append(text, length);
+    return;
+  }
+  if (numeric && segment.zero_pad && segment.align == FormatAlign::kDefault) {
+    const size_t sign = (*text == '-');
+    out->Append(text, sign);
+    out->Fill('0', padding);
+    out->Append(text + sign, length - sign);
+    return;
+  }
+  const FormatAlign align = segment.align == FormatAlign::kDefault
+      ? default_align : segment.align;
+  const size_t before = align == FormatAlign::kRight ? padding
+      : align == FormatAlign::kCenter ? padding / 2 : 0;
+  out->Fill(segment.fill, before);
+  out->Append(text, length);
+  out->Fill(segment.fill, padding - before);
+}
+
+/// @brief Determines if a value of type T is written as an integer, and so
+/// may be given a presentation type.
+template <class T>
+class IsFormatInteger : public All<
+    IsIntegral<T>, Not<std::is_same<T, bool>>, Not<std::is_same<T, char>>> {
+};
+
+/// @brief Writes an integer in the given base, zero padding it through the
+/// digits argument of ToString() when requested.
+template <unsigned int number_base, LetterCase letter_case, class T>
+unsigned int WriteFormatInteger(T value, const FormatSegment&segment,
+                                char*text) {
+  unsigned int digits = Digits<number_base>(value);
+  if (segment.zero_pad && segment.align == FormatAlign::kDefault) {
+    const unsigned int sign = (value < 0);
+    digits = std::max(digits, segment.width - std::min(segment.width, sign));
+  }
+  return ToString<number_base, letter_case>(value, text, digits);
+}
+
+/// @brief Writes an integer.
+template <class Output, class T>
+EnableIf<
+    IsFormatInteger<T>,
+void> WriteArgument(Output*out, const FormatSegment&segment, T value) {
+  // a sign and 128 binary digits, or the widest zero-padded field
+  char text[kMaxFormatWidth + 130];
+  unsigned int length;
+  switch (segment.type) {
+    case 'x':
+      length = WriteFormatInteger<16, LetterCase::kLower>(value, segment, text);
+      break;
+    case 'X':
+      length = WriteFormatInteger<16, LetterCase::kUpper>(value, segment, text);
+      break;
+    case 'o':
+      length = WriteFormatInteger<8, LetterCase::kLower>(value, segment, text);
+      break;
+    case 'b':
+      length = WriteFormatInteger<2, LetterCase::kLower>(value, segment, text);
+      break;
+    default:
+      length = WriteFormatInteger<10, LetterCase::kLower>(value, segment, text);
+      break;
+  }
+  WritePadded(out, segment, text, length, FormatAlign::kRight, false);
+}
+
+/// @brief Writes a floating-point value as its shortest round-trip decimal.
+template <class Output, class T>
+EnableIf<
+    IsFloatingPoint<T>,
+void> WriteArgument(Output*out, const FormatSegment&segment, T value) {
+  char text[kShortestMaxLength];
+  const unsigned int length = WriteShortest(value, text);
+  WritePadded(out, segment, text, length, FormatAlign::kRight, true);
+}
+
+/// @brief Writes a bool as true or false.
+template <class Output>
+void WriteArgument(Output*out, const FormatSegment&segment, bool value) {
+  WritePadded(out, segment, value ? "true" : "false", value ? 4 : 5,
+              FormatAlign::kLeft, false);
+}
+
+/// @brief Writes a character.
+template <class Output>
+void WriteArgument(Output*out, const FormatSegment&segment, char value) {
+  WritePadded(out, segment, &value, 1, FormatAlign::kLeft, false);
+}
+
+/// @brief Writes a null-terminated string.
+template <class Output>
+void WriteArgument(Output*out, const FormatSegment&segment,
+                   const char*value) {
+  WritePadded(out, segment, value, std::strlen(value), FormatAlign::kLeft,
+              false);
+}
+
+/// @brief Writes a std::string.
+template <class Output>
+void WriteArgument(Output*out, const FormatSegment&segment,
+                   const std::string&value) {
+  WritePadded(out, segment, value.data(), value.size(), FormatAlign::kLeft,
+              false);
+}
+
+/// @brief Writes a StaticString.
+template <class Output, unsigned int kLength>
+void WriteArgument(Output*out, const FormatSegment&segment,
+                   const StaticString<kLength>&value) {
+  WritePadded(out, segment, value.c_str(), kLength, FormatAlign::kLeft,
+              false);
+}
+
+/// @brief Writes the literal segments starting at the index, returning the
+/// index of the next field or the number of segments.
+template <class Output>
+unsigned int WriteFormatText(Output*out, const FormatString&format,
+                             unsigned int index) {
+  for (; index < format.size() && !format.segment(index).field; ++index) {
+    const FormatSegment&segment = format.segment(index);
+    out->Append(format.text() + segment.begin, segment.end - segment.begin);
+  }
+  return index;
+}
+
+/// @brief Writes the text after the last field.
+template <class Output>
+void WriteFormat(Output*out, const FormatString&format, unsigned int index) {
+  WriteFormatText(out, format, index);
+}
+
+/// @brief Writes the text up to the next field, then the next argument into
+/// it.
+template <class Output, class T, class... Rest>
+void WriteFormat(Output*out, const FormatString&format, unsigned int index,
+                 const T&value, const Rest&... rest) {
+  index = WriteFormatText(out, format, index);
+  WriteArgument(out, format.segment(index), value);
+  WriteFormat(out, format, index + 1, rest...);
+}
+
+/// @brief Finds the segment of the replacement field with the given index,
+/// searching from the segment with the given index.
+constexpr unsigned int FormatFieldSegment(const FormatString&format,
+                                          unsigned int field,
+                                          unsigned int index) {
+  return index >= format.size() ? index
+      : !format.segment(index).field
+          ? FormatFieldSegment(format, field, index + 1)
+      : field == 0 ? index
+      : FormatFieldSegment(format, field - 1, index + 1);
+}
+
+/// @brief Determines if the arguments of the given types may be written into
+/// the replacement fields starting at the given one; only integers may be
+/// given a presentation type.
+template <class... Args>
+class FormatTypes;
+
+/// @brief Specialization for no arguments.
+template <>
+class FormatTypes<> {
+ public:
+  static constexpr bool Valid(const FormatString&, unsigned int) {
+    return true;
+  }
+};
+
+/// @brief Specialization that checks the first argument.
+template <class T, class... Rest>
+class FormatTypes<T, Rest...> {
+ public:
+  static constexpr bool Valid(const FormatString&format, unsigned int field) {
+    return (field >= format.fields() || IsFormatInteger<T>::value ||
+            format.segment(FormatFieldSegment(format, field, 0)).type == '\0')
+        && FormatTypes<Rest...>::Valid(format, field + 1);
+  }
+};
+
+/// @brief Checks that the format string has a field for each argument, and
+/// that each argument may be written into its field.
+template <class... Args>
+void CheckFormatArguments(const FormatString&format) {
+  if (format.fields() != sizeof...(Args)) {
+    FormatError("the arguments do not match the replacement fields");
+  }
+  if (!FormatTypes<Args...>::Valid(format, 0)) {
+    FormatError("presentation type given for a value that is not an integer");
+  }
+}
+
+}  // namespace detail
+/// @endcond
+
+/// @brief Writes the arguments into a character buffer as described by a
+/// format string.  Does not terminate the string.
+/// @details Nothing is allocated.  If the text does not fit, as much of it
+/// as fits is written and the full length is still returned, as snprintf
+/// does.  Throws std::invalid_argument, before writing anything, if the
+/// number of arguments differs from the number of replacement fields, or if
+/// an integer presentation type is given for any other value.
+///
+/// @param buffer The location to write the text.
+/// @param size The number of characters the buffer can hold.
+/// @param format The parsed format string.
+/// @param args The values to write; integral, floating-point, bool, char,
+/// const char*, std::string or StaticString.
+///
+/// @return The length of the text, which is more than size if it did not
+/// fit.
+template <class... Args>
+size_t Format(char*buffer, size_t size, const FormatString&format,
+              const Args&... args) {
+  detail::CheckFormatArguments<Args...>(format);
+  detail::FormatBufferOutput out(buffer, size);
+  detail::WriteFormat(&out, format, 0, args...);
+  return out.length();
+}
+
+/// @brief Appends the arguments to a string as described by a format
+/// string.  Only the string itself may allocate.
+/// @see Format(char*,size_t,const FormatString&,const Args&...)
+///
+/// @return The number of characters appended to the string.
+template <class... Args>
+size_t Format(std::string*buffer, const FormatString&format,
+              const Args&... args) {
+  detail::CheckFormatArguments<Args...>(format);
+  detail::FormatStringOutput out(buffer);
+  detail::WriteFormat(&out, format, 0, args...);
+  return out.length();
+}
+
+/// @brief Converts the arguments into a string as described by a format
+/// string, returning it.
+/// @see Format(char*,size_t,const FormatString&,const Args&...)
+template <class... Args>
+std::string Format(const FormatString&format, const Args&... args) {
+  std::string buffer;
+  Format(&buffer, format, args...);
+  return buffer;
+}
+
+/// @brief Writes the arguments into a character buffer as described by a
+/// format string, checking them against it at compile time.  Does not
+/// terminate the string.
+/// @details As Format(char*,size_t,const FormatString&,const Args&...), but
+/// the format string is a constexpr FormatString at namespace scope, and
+/// arguments that do not match its replacement fields fail to compile.
+///
+/// @tparam kFormat The parsed format string.
+/// @param buffer The location to write the text.
+/// @param size The number of characters the buffer can hold.
+/// @param args The values to write.
+///
+/// @return The length of the text, which is more than size if it did not
+/// fit.
+template <const FormatString&kFormat, class... Args>
+size_t Format(char*buffer, size_t size, const Args&... args) {
+  static_assert(kFormat.fields() == sizeof...(Args),
+                "the arguments do not match the replacement fields");
+  static_assert(detail::FormatTypes<Args...>::Valid(kFormat, 0),
+                "presentation type given for a value that is not an integer");
+  detail::FormatBufferOutput out(buffer, size);
+  detail::WriteFormat(&out, kFormat, 0, args...);
+  return out.length();
+}
+
+/// @brief Appends the arguments to a string as described by a format
+/// string, checking them against it at compile time.
+/// @see Format(char*,size_t,const Args&...)
+///
+/// @return The number of characters appended to the string.
+template <const FormatString&kFormat, class... Args>
+size_t Format(std::string*buffer, const Args&... args) {
+  static_assert(kFormat.fields() == sizeof...(Args),
+                "the arguments do not match the replacement fields");
+  static_assert(detail::FormatTypes<Args...>::Valid(kFormat, 0),
+                "presentation type given for a value that is not an integer");
+  detail::FormatStringOutput out(buffer);
+  detail::WriteFormat(&out, kFormat, 0, args...);
+  return out.length();
+}
+
+/// @brief Converts the arguments into a string as described by a format
+/// string, checking them against it at compile time, and returns it.
+/// @see Format(char*,size_t,const Args&...)
+template <const FormatString&kFormat, class... Args>
+std::string Format(const Args&... args) {
+  std::string buffer;
+  Format<kFormat>(&buffer, args...);
+  return buffer;
+}
+
+}  // namespace nx
+
+#endif  // INCLUDE_NX_FORMAT_H_
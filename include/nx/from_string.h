@@ -0,0 +1,418 @@
+//
+// Copyright (C) 2013 Jacob McIntosh <nacitar at ubercpp dot com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+/// @file from_string.h
+/// @brief Functions to parse integral and floating-point values from strings.
+/// @details Decimal digits are converted 8 at a time within a 64-bit word.
+/// The array overload of FromString() selects an SSE4.1 or AVX2 kernel at
+/// runtime, converting 16 digits at a time; it and ParseDouble() and
+/// ParseFloat() are implemented in from_string.cc.
+
+#ifndef INCLUDE_NX_FROM_STRING_H_
+#define INCLUDE_NX_FROM_STRING_H_
+
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+#include "nx/core.h"
+#include "nx/constant.h"
+#include "nx/bit_scan_forward.h"
+#include "nx/byte_order.h"
+#include "nx/digits.h"
+
+/// @brief Library namespace.
+namespace nx {
+
+/// @brief The outcome of parsing a value.
+enum class ParseStatus {
+  /// @brief The value was parsed.
+  kOk,
+  /// @brief No digits were found where a value was expected.
+  kInvalid,
+  /// @brief The digits represent a value too large for the type.
+  kOverflow
+};
+
+/// @brief The result of FromString().
+struct ParseResult {
+  /// @brief The first character that was not parsed.
+  const char*end;
+  /// @brief The outcome.
+  ParseStatus status;
+};
+
+/// @cond nx_detail
+namespace detail {
+
+/// @brief The values a type can hold, as magnitudes.
+struct ParseLimits {
+  /// @brief The largest positive value.
+  uint64_t max;
+  /// @brief The magnitude of the smallest negative value; 0 if a sign is not
+  /// accepted.
+  uint64_t negative_max;
+};
+
+/// @brief Provides the limits of an integral type.
+template <class T>
+constexpr ParseLimits MakeParseLimits() {
+  return ParseLimits{
+      static_cast<uint64_t>(std::numeric_limits<T>::max()),
+      IsSigned<T>::value ?
+          static_cast<uint64_t>(std::numeric_limits<T>::max()) + 1 : 0};
+}
+
+/// @brief Loads up to 8 characters with the first in the least significant
+/// byte; those past the end are 0, which is not a digit.
+inline uint64_t LoadDigitWord(const char*begin, const char*end) {
+  uint64_t word = 0;
+  if (end - begin >= 8) {
+    std::memcpy(&word, begin, sizeof(word));
+  } else {
+    std::memcpy(&word, begin, static_cast<size_t>(end - begin));
+  }
+  return LittleEndianValue(word);
+}
+
+/// @brief Counts the decimal digits at the start of a word of characters.
+/// @details The high bit of each byte is cleared before the comparisons, so
+/// that adding to a byte never carries into the next.
+inline unsigned int CountDigitWord(uint64_t word) {
+  constexpr const uint64_t high_bits = 0x8080808080808080ull;
+  const uint64_t low_bits = word & ~high_bits;
+  // the high bit of each byte is set if the byte is at least '0', and if it
+  // is past '9'
+  const uint64_t at_least_0 = low_bits + 0x5050505050505050ull;
+  const uint64_t past_9 = low_bits + 0x4646464646464646ull;
+  const uint64_t not_digit = (~at_least_0 | past_9 | word) & high_bits;
+  return not_digit ? BitScanForward(not_digit) / 8 : 8;
+}
+
+/// @brief Converts the given number of decimal digits at the start of a word
+/// of characters; the count must be between 1 and 8.
+/// @details The digits are shifted to the top of the word, leaving the
+/// bytes below as leading zeros.  Adjacent digits, then pairs, then
+/// quadruples are combined with one multiplication each.
+inline uint64_t ConvertDigitWord(uint64_t word, unsigned int count) {
+  word = (word ^ 0x3030303030303030ull) << (8 * (8 - count));
+  word = word * 10 + (word >> 8);
+  return ((word & 0x000000ff000000ffull) * (100 + (1000000ull << 32)) +
+      ((word >> 16) & 0x000000ff000000ffull) * (1 + (10000ull << 32))) >> 32;
+}
+
+/// @brief Parses any decimal digits following those of a magnitude, which
+/// began at begin.
+inline ParseResult FinishMagnitude(const char*begin, const char*position,
+                                   const char*end, uint64_t magnitude,
+                                   uint64_t max, uint64_t*value) {
+  constexpr const uint64_t max_tenth = ~0ull / 10;
+  constexpr const unsigned int max_last_digit = ~0ull % 10;
+  if (position == begin) {
+    return ParseResult{begin, ParseStatus::kInvalid};
+  }
+  // further digits are checked one at a time
+  bool overflow = false;
+  for (; position != end; ++position) {
+    const unsigned int digit = static_cast<unsigned char>(*position - '0');
+    if (digit > 9) {
+      break;
+    }
+    if (magnitude > max_tenth ||
+        (magnitude == max_tenth && digit > max_last_digit)) {
+      overflow = true;
+    } else {
+      magnitude = magnitude * 10 + digit;
+    }
+  }
+  if (overflow || magnitude > max) {
+    return ParseResult{position, ParseStatus::kOverflow};
+  }
+  *value = magnitude;
+  return ParseResult{position, ParseStatus::kOk};
+}
+
+/// @brief Parses decimal digits as a magnitude no greater than a limit.
+inline ParseResult ParseMagnitude(const char*begin, const char*end,
+                                  uint64_t max, uint64_t*value) {
+  const char*position = begin;
+  uint64_t magnitude = 0;
+  // up to 16 digits cannot overflow
+  for (unsigned int chunk = 0; chunk < 2; ++chunk) {
+    const uint64_t word = LoadDigitWord(position, end);
+    const unsigned int count = CountDigitWord(word);
+    if (!count) {
+      break;
+    }
+    magnitude = magnitude * constant::power_10_64bit[count] +
+        ConvertDigitWord(word, count);
+    position += count;
+    if (count < 8) {
+      break;
+    }
+  }
+  return FinishMagnitude(begin, position, end, magnitude, max, value);
+}
+
+/// @brief Parses digits in a base other than 10 as a magnitude no greater
+/// than a limit.
+template <unsigned int number_base>
+ParseResult ParseMagnitude(const char*begin, const char*end,
+                           uint64_t max, uint64_t*value) {
+  const uint64_t max_part = max / number_base;
+  const unsigned int max_last_digit = max % number_base;
+  const char*position = begin;
+  uint64_t magnitude = 0;
+  bool overflow = false;
+  for (; position != end && ValidDigit<number_base>(*position); ++position) {
+    const unsigned int digit = DigitValue(*position);
+    if (magnitude > max_part ||
+        (magnitude == max_part && digit > max_last_digit)) {
+      overflow = true;
+    } else {
+      magnitude = magnitude * number_base + digit;
+    }
+  }
+  if (position == begin) {
+    return ParseResult{begin, ParseStatus::kInvalid};
+  }
+  if (overflow) {
+    return ParseResult{position, ParseStatus::kOverflow};
+  }
+  *value = magnitude;
+  return ParseResult{position, ParseStatus::kOk};
+}
+
+/// @brief Decimal version
+template <unsigned int number_base>
+inline EnableIf<
+    Bool<number_base == 10>,
+ParseResult> ParseInteger(const char*begin, const char*end,
+                          const ParseLimits&limits, uint64_t*value) {
+  if (limits.negative_max && begin != end && *begin == '-') {
+    const ParseResult result = ParseMagnitude(
+        begin + 1, end, limits.negative_max, value);
+    if (result.status == ParseStatus::kOk) {
+      *value = -*value;
+    }
+    return result.status == ParseStatus::kInvalid ?
+        ParseResult{begin, ParseStatus::kInvalid} : result;
+  }
+  return ParseMagnitude(begin, end, limits.max, value);
+}
+
+/// @brief Version for other bases
+template <unsigned int number_base>
+inline EnableIf<
+    Bool<number_base != 10>,
+ParseResult> ParseInteger(const char*begin, const char*end,
+                          const ParseLimits&limits, uint64_t*value) {
+  if (limits.negative_max && begin != end && *begin == '-') {
+    const ParseResult result = ParseMagnitude<number_base>(
+        begin + 1, end, limits.negative_max, value);
+    if (result.status == ParseStatus::kOk) {
+      *value = -*value;
+    }
+    return result.status == ParseStatus::kInvalid ?
+        ParseResult{begin, ParseStatus::kInvalid} : result;
+  }
+  return ParseMagnitude<number_base>(begin, end, limits.max, value);
+}
+
+/// @brief The implementations available for parsing delimited integers.
+enum class FromStringKernel {
+  /// @brief One ParseInteger() call per field.
+  kScalar,
+  /// @brief SSE4.1, converting 16 digits of a field at a time.
+  kSse41,
+  /// @brief AVX2, converting 16 digits of two fields at a time.
+  kAvx2
+};
+
+/// @brief Determines if the running processor can execute the given kernel.
+bool FromStringSupported(FromStringKernel kernel);
+
+/// @brief Parses delimited decimal fields using the given kernel, which must
+/// be supported by the running processor.
+///
+/// @param kernel The implementation to use.
+/// @param begin The start of the first field.
+/// @param end The end of the text.
+/// @param delimiter The character between each field.
+/// @param limits The values accepted.
+/// @param values Receives the values parsed, negative ones in two's
+/// complement.
+/// @param length The most fields to parse.
+/// @param count Receives the number of fields parsed.
+///
+/// @return The end of the last field parsed and ParseStatus::kOk, or the
+/// start of the field that could not be parsed and the reason.  A field
+/// must end at the delimiter or the end of the text.
+ParseResult FromStringFields(
+    FromStringKernel kernel, const char*begin, const char*end,
+    char delimiter, const ParseLimits&limits, uint64_t*values,
+    size_t length, size_t*count);
+
+/// @brief Parses delimited decimal fields using the fastest kernel
+/// supported by the running processor.
+ParseResult FromStringFields(
+    const char*begin, const char*end, char delimiter,
+    const ParseLimits&limits, uint64_t*values, size_t length, size_t*count);
+
+}  // namespace detail
+/// @endcond
+
+/// @brief Parses an integral value from the start of a character buffer.
+/// @details An optional '-' is accepted for signed types, followed by at
+/// least one digit; parsing stops at the first character that is not one.
+///
+/// @tparam number_base The base of the digits: 2, 8, 10 or 16.
+/// @tparam T The type of the value.
+/// @param begin The start of the text.
+/// @param end The end of the text.
+/// @param value Receives the value, and is unchanged if it is not parsed.
+///
+/// @return The character after the last digit, and ParseStatus::kOk; or
+/// begin and ParseStatus::kInvalid if there were no digits; or the
+/// character after the last digit and ParseStatus::kOverflow if the value
+/// does not fit.
+template <unsigned int number_base = 10, class T>
+EnableIf<All<
+    IsIntegral<T>, BitRange<T, 0, 64>>,
+ParseResult> FromString(const char*begin, const char*end, T*value) {
+  uint64_t parsed;
+  const ParseResult result = detail::ParseInteger<number_base>(
+      begin, end, detail::MakeParseLimits<T>(), &parsed);
+  if (result.status == ParseStatus::kOk) {
+    *value = static_cast<T>(parsed);
+  }
+  return result;
+}
+
+/// @brief Parses an integral value that makes up an entire string.
+///
+/// @return ParseStatus::kOk, or ParseStatus::kInvalid if the string is not
+/// entirely a value, or ParseStatus::kOverflow if the value does not fit.
+/// @see FromString(const char*,const char*,T*)
+template <unsigned int number_base = 10, class T>
+EnableIf<All<
+    IsIntegral<T>, BitRange<T, 0, 64>>,
+ParseStatus> FromString(const std::string&text, T*value) {
+  const char*end = text.data() + text.size();
+  T parsed;
+  const ParseResult result = FromString<number_base>(
+      text.data(), end, &parsed);
+  if (result.status != ParseStatus::kOk) {
+    return result.status;
+  }
+  if (result.end != end) {
+    return ParseStatus::kInvalid;
+  }
+  *value = parsed;
+  return ParseStatus::kOk;
+}
+
+/// @brief Parses decimal integral values separated by a delimiter, appending
+/// them to a vector.
+/// @details Each field is parsed as by FromString(const char*,const char*,
+/// T*) and must be followed by the delimiter or the end of the text.  An
+/// empty text holds no values.
+///
+/// @tparam T The type of the values.
+/// @param begin The start of the text.
+/// @param end The end of the text.
+/// @param delimiter The character between each value.
+/// @param values The vector to append the values to.  The values parsed
+/// before an error are appended.
+///
+/// @return The end of the text and ParseStatus::kOk, or the start of the
+/// field that could not be parsed and the reason.
+template <class T>
+EnableIf<All<
+    IsIntegral<T>, BitRange<T, 0, 64>>,
+ParseResult> FromString(const char*begin, const char*end, char delimiter,
+                        std::vector<T>*values) {
+  constexpr const size_t block_length = 256;
+  const detail::ParseLimits limits = detail::MakeParseLimits<T>();
+  uint64_t block[block_length];
+  ParseResult result{begin, ParseStatus::kOk};
+  if (begin == end) {
+    return result;
+  }
+  for (;;) {
+    size_t count;
+    result = detail::FromStringFields(
+        result.end, end, delimiter, limits, block, block_length, &count);
+    for (size_t i = 0; i < count; ++i) {
+      values->push_back(static_cast<T>(block[i]));
+    }
+    if (result.status != ParseStatus::kOk || result.end == end) {
+      return result;
+    }
+    // the block was filled; continue after the delimiter
+    ++result.end;
+  }
+}
+
+/// @brief Parses a double from the start of a character buffer.
+/// @details Accepts an optional '-', then decimal digits with an optional
+/// '.' among them, then an optional exponent of 'e' or 'E', an optional sign
+/// and digits; or "inf", "infinity" or "nan" in any case.  Unlike strtod, no
+/// whitespace, '+', hexadecimal or locale-specific decimal point is
+/// accepted.  The value is correctly rounded: the Eisel-Lemire algorithm
+/// decides all but rare cases near a halfway point, which are compared
+/// exactly with big integers.  Values too small to represent become zero.
+///
+/// @param begin The start of the text.
+/// @param end The end of the text.
+/// @param value Receives the value, and is unchanged if it is not parsed.
+///
+/// @return The character after the value, and ParseStatus::kOk; or begin
+/// and ParseStatus::kInvalid if there was no value; or the character after
+/// the value and ParseStatus::kOverflow if it is too large for a double.
+ParseResult ParseDouble(const char*begin, const char*end, double*value);
+
+/// @brief Parses a float from the start of a character buffer.
+/// @see ParseDouble(const char*,const char*,double*)
+ParseResult ParseFloat(const char*begin, const char*end, float*value);
+
+/// @brief Parses doubles separated by a delimiter, appending them to a
+/// vector.
+/// @details Each field is parsed as by ParseDouble(const char*,const char*,
+/// double*) and must be followed by the delimiter or the end of the text.
+/// An empty text holds no values.
+///
+/// @param begin The start of the text.
+/// @param end The end of the text.
+/// @param delimiter The character between each value.
+/// @param values The vector to append the values to.  The values parsed
+/// before an error are appended.
+///
+/// @return The end of the text and ParseStatus::kOk, or the start of the
+/// field that could not be parsed and the reason.
+ParseResult ParseDouble(const char*begin, const char*end, char delimiter,
+                        std::vector<double>*values);
+
+/// @brief Parses floats separated by a delimiter, appending them to a
+/// vector.
+/// @see ParseDouble(const char*,const char*,char,std::vector<double>*)
+ParseResult ParseFloat(const char*begin, const char*end, char delimiter,
+                       std::vector<float>*values);
+
+}  // namespace nx
+
+#endif  // INCLUDE_NX_FROM_STRING_H_
@@ -16,10 +16,28 @@
 
 /// @file literal.h
 /// @brief Provides various user-defined literals.
+/// @details Besides binary literals, these include wide integer literals,
+/// whose base follows the prefix as for builtin integers: @code
+/// constexpr nx::uint_t<128> kKey =
+///     0x0123456789abcdef0123456789abcdef_nx_u128;
+/// constexpr nx::WideUInt<256> kPrime = "115792089237316195423570985008687"
+///     "907853269984665640564039457584007908834671663"_nx_u256;
+/// @endcode
+/// and byte literals, which keep the digits in the order written: @code
+/// constexpr auto kMagic = 0x89504e470d0a1a0a_nx_bytes;  // ByteArray<8>
+/// @endcode
+/// Numeric wide integer and byte literals are always evaluated at compile
+/// time, so a malformed one fails to compile.  The string forms of the wide
+/// integer literals also accept ' digit separators, as in
+/// "0xdead'beef"_nx_u128, which C++11 does not allow in numeric literals;
+/// they are evaluated at compile time when they initialize a constexpr
+/// variable, and otherwise throw std::invalid_argument or std::out_of_range
+/// at runtime.
 
 #ifndef INCLUDE_NX_LITERAL_H_
 #define INCLUDE_NX_LITERAL_H_
 
+#include <stdexcept>
 #include "nx/core.h"
 #include "nx/digits.h"
 
@@ -45,13 +63,11 @@ struct binary_literal_helper<
     + binary_literal_helper<void, digits...>::value;
 };
 
-/// @brief version for a _valid_ final digit.
-template<char high>
-struct binary_literal_helper<
-    EnableIf<Bool<ValidDigit<2>(high)>>,
-    high> {
+/// @brief version for the end of the digits.
+template<>
+struct binary_literal_helper<void> {
   typedef uint_least_t<1> uint_type;
-  static uint_type const value = (high - '0');
+  static uint_type const value = 0;
 };
 
 /// @brief dummy implementation for invalid digits to assert.
@@ -65,16 +81,264 @@ struct binary_literal_helper<
   static uint_type const value = 0;
 };
 
-/// @brief dummy implementation for an invalid final digit to assert.
-template<char high>
-struct binary_literal_helper<
-    EnableIf<Not<Bool<ValidDigit<2>(high)>>>,
-    high> {
-  typedef uint_least_t<1> uint_type;
-  static_assert(ValidDigit<2>(high), "invalid binary digit!");
-  static uint_type const value = 0;
+/// @brief Reports a malformed literal; in a constant expression, this makes
+/// the program fail to compile.
+template <class T>
+inline T LiteralError(const char*message) {
+  throw std::invalid_argument(message);
+}
+
+/// @brief Reports a literal too large for its type; in a constant
+/// expression, this makes the program fail to compile.
+template <class T>
+inline T LiteralOverflow() {
+  throw std::out_of_range("literal out of range");
+}
+
+/// @brief Determines the base of an integer literal from its prefix.
+constexpr unsigned int LiteralBase(const char*text, size_t length) {
+  return length > 1 && text[0] == '0' ? (
+      text[1] == 'x' || text[1] == 'X' ? 16
+      : text[1] == 'b' || text[1] == 'B' ? 2 : 8) : 10;
+}
+
+/// @brief Provides the value of a digit of a literal in the given base.
+constexpr unsigned int LiteralDigit(char ch, unsigned int number_base) {
+  return (number_base == 16 ? ValidDigit<16>(ch)
+      : number_base == 10 ? ValidDigit<10>(ch)
+      : number_base == 8 ? ValidDigit<8>(ch) : ValidDigit<2>(ch))
+      ? DigitValue(ch)
+      : LiteralError<unsigned int>("invalid digit in literal");
+}
+
+/// @brief The words of a wide integer literal while it is parsed.
+template <unsigned int kWords>
+class LiteralWords {
+ public:
+  /// @brief The words, least significant first.
+  uint64_t words[kWords];
+};
+
+/// @brief Provides the high word of word * multiplier + addend, for a
+/// multiplier and addend that fit in 32 bits.
+constexpr uint64_t LiteralHigh(uint64_t word, uint64_t multiplier,
+                               uint64_t addend) {
+  return ((word >> 32) * multiplier
+          + (((word & 0xffffffffu) * multiplier + addend) >> 32)) >> 32;
+}
+
+/// @brief Provides what carries into a word of value * base + digit; the
+/// digit itself for the lowest word.
+template <unsigned int kWords>
+constexpr uint64_t LiteralCarry(const LiteralWords<kWords>&value,
+                                unsigned int number_base, unsigned int digit,
+                                unsigned int index) {
+  return index == 0 ? digit
+      : LiteralHigh(value.words[index - 1], number_base,
+                    LiteralCarry(value, number_base, digit, index - 1));
+}
+
+/// @brief Computes value * base + digit.
+template <unsigned int kWords, unsigned int... kIndices>
+constexpr LiteralWords<kWords> LiteralAppend(
+    const LiteralWords<kWords>&value, unsigned int number_base,
+    unsigned int digit, IndexSequence<kIndices...>) {
+  return LiteralCarry(value, number_base, digit, kWords) != 0
+      ? LiteralOverflow<LiteralWords<kWords>>()
+      : LiteralWords<kWords>{{ (value.words[kIndices] * number_base
+          + LiteralCarry(value, number_base, digit, kIndices))... }};
+}
+
+/// @brief Determines if the separator at the position sits between two
+/// digits.
+constexpr bool LiteralSeparatorValid(const char*text, size_t length,
+                                     size_t first, size_t position) {
+  return position > first && position + 1 < length &&
+      text[position + 1] != '\'';
+}
+
+/// @brief Appends the digit at the position to the value, or checks the
+/// separator there.
+template <unsigned int kWords>
+constexpr LiteralWords<kWords> ParseLiteralCharacter(
+    const char*text, size_t length, unsigned int number_base, size_t first,
+    size_t position, const LiteralWords<kWords>&value) {
+  return text[position] == '\'' ? (
+          LiteralSeparatorValid(text, length, first, position) ? value
+          : LiteralError<LiteralWords<kWords>>(
+              "digit separator not between digits in literal"))
+      : LiteralAppend(value, number_base,
+                      LiteralDigit(text[position], number_base),
+                      nx::MakeIndexSequence<kWords>());
+}
+
+/// @brief Appends the digits from the position up to the end to the value.
+/// @details The range is split in halves, the first half's value feeding the
+/// second, so that the recursion is only logarithmically deep and a
+/// full-width binary literal stays within the compiler's constexpr depth
+/// limit.
+template <unsigned int kWords>
+constexpr LiteralWords<kWords> ParseLiteralDigits(
+    const char*text, size_t length, unsigned int number_base, size_t first,
+    size_t position, size_t end, const LiteralWords<kWords>&value) {
+  return end - position == 1
+      ? ParseLiteralCharacter(text, length, number_base, first, position,
+                              value)
+      : ParseLiteralDigits(text, length, number_base, first,
+                           position + (end - position) / 2, end,
+                           ParseLiteralDigits(
+                               text, length, number_base, first, position,
+                               position + (end - position) / 2, value));
+}
+
+/// @brief Parses the words of an integer literal, after the prefix that
+/// gave its base.
+template <unsigned int kWords>
+constexpr LiteralWords<kWords> ParseLiteralWords(
+    const char*text, size_t length, unsigned int number_base, size_t first) {
+  return first >= length
+      ? LiteralError<LiteralWords<kWords>>("literal has no digits")
+      : ParseLiteralDigits(text, length, number_base, first, first, length,
+                           LiteralWords<kWords>{{}});
+}
+
+/// @brief Converts the parsed words to a WideUInt.
+template <class T, unsigned int kWords>
+constexpr EnableIf<Not<IsIntegral<T>>, T> LiteralValue(
+    const LiteralWords<kWords>&value) {
+  return T(value.words);
+}
+
+/// @brief Converts the parsed words to the builtin 128-bit integer.
+template <class T>
+constexpr EnableIf<IsIntegral<T>, T> LiteralValue(
+    const LiteralWords<2>&value) {
+  return static_cast<T>(value.words[1]) << 64 | value.words[0];
+}
+
+/// @brief Parses an integer literal, with any prefix and digit separators,
+/// into uint_t<kBits>: the builtin 128-bit integer where there is one, and
+/// a WideUInt otherwise.
+template <unsigned int kBits>
+constexpr uint_t<kBits> ParseWideLiteral(const char*text, size_t length) {
+  return LiteralValue<uint_t<kBits>>(ParseLiteralWords<kBits / 64>(
+      text, length, LiteralBase(text, length),
+      LiteralBase(text, length) == 16 || LiteralBase(text, length) == 2
+      ? 2 : 0));
+}
+
+/// @brief Holds the value of a numeric wide integer literal; as a static
+/// member, it must be a constant expression, so a malformed literal fails to
+/// compile.
+template <unsigned int kBits, char... kChars>
+class WideLiteral {
+ public:
+  /// @brief The characters of the literal.
+  static constexpr char text[sizeof...(kChars)] = { kChars... };
+
+  /// @brief The value of the literal.
+  static constexpr uint_t<kBits> value =
+      ParseWideLiteral<kBits>(text, sizeof...(kChars));
 };
 
+template <unsigned int kBits, char... kChars>
+constexpr char WideLiteral<kBits, kChars...>::text[sizeof...(kChars)];
+
+template <unsigned int kBits, char... kChars>
+constexpr uint_t<kBits> WideLiteral<kBits, kChars...>::value;
+
+}  // namespace detail
+/// @endcond
+
+/// @brief A fixed-size sequence of bytes that can be built in constant
+/// expressions; the type of byte literals.
+///
+/// @tparam kSize The number of bytes.
+template <unsigned int kSize>
+class ByteArray {
+ public:
+  /// @brief Constructs from the given bytes, which must number kSize.
+  template <class... Bytes>
+  explicit constexpr ByteArray(Bytes... bytes)
+      : data_{ static_cast<uint8_t>(bytes)... } {
+    static_assert(sizeof...(Bytes) == kSize, "the bytes must number kSize");
+  }
+
+  /// @brief Provides the number of bytes.
+  static constexpr unsigned int size() {
+    return kSize;
+  }
+
+  /// @brief Provides the bytes.
+  constexpr const uint8_t*data() const {
+    return data_;
+  }
+
+  /// @brief Provides the byte at the given index, which must be less than
+  /// kSize.
+  constexpr uint8_t operator[](size_t index) const {
+    return data_[index];
+  }
+
+  /// @brief Provides the first byte, for range-based for loops.
+  constexpr const uint8_t*begin() const {
+    return data_;
+  }
+
+  /// @brief Provides one past the last byte, for range-based for loops.
+  constexpr const uint8_t*end() const {
+    return data_ + kSize;
+  }
+
+ private:
+  uint8_t data_[kSize];
+};
+
+/// @cond nx_detail
+namespace detail {
+
+/// @brief Provides the number of bytes of a byte literal of the given number
+/// of characters, which ByteLiteral checks.
+constexpr unsigned int ByteLiteralSize(unsigned int characters) {
+  return characters > 2 ? (characters - 2) / 2 : 1;
+}
+
+/// @brief Parses the bytes of a byte literal, after its 0x prefix.
+template <unsigned int... kIndices>
+constexpr ByteArray<sizeof...(kIndices)> ParseByteLiteral(
+    const char*text, IndexSequence<kIndices...>) {
+  return ByteArray<sizeof...(kIndices)>(
+      (LiteralDigit(text[2 + 2 * kIndices], 16) << 4
+       | LiteralDigit(text[3 + 2 * kIndices], 16))...);
+}
+
+/// @brief Holds the value of a byte literal; as a static member, it must be
+/// a constant expression, so a malformed literal fails to compile.
+template <char... kChars>
+class ByteLiteral {
+ public:
+  /// @brief The characters of the literal.
+  static constexpr char text[sizeof...(kChars)] = { kChars... };
+
+  static_assert(sizeof...(kChars) > 2 && text[0] == '0' &&
+                (text[1] == 'x' || text[1] == 'X'),
+                "byte literals must be hexadecimal, as in 0x0a1b_nx_bytes");
+  static_assert(sizeof...(kChars) % 2 == 0,
+                "byte literals must have two digits per byte");
+
+  /// @brief The value of the literal.
+  static constexpr ByteArray<ByteLiteralSize(sizeof...(kChars))> value =
+      ParseByteLiteral(text, nx::MakeIndexSequence<
+          ByteLiteralSize(sizeof...(kChars))>());
+};
+
+template <char... kChars>
+constexpr char ByteLiteral<kChars...>::text[sizeof...(kChars)];
+
+template <char... kChars>
+constexpr ByteArray<ByteLiteralSize(sizeof...(kChars))>
+ByteLiteral<kChars...>::value;
+
 }  // namespace detail
 /// @endcond
 
@@ -87,4 +351,53 @@ constexpr nx::uint_least_t<sizeof...(digits)> operator "" _nx_b() {
   return nx::detail::binary_literal_helper<void, digits...>::value;
 }
 
+/// @brief A 128-bit literal, such as
+/// @code 0xffffffffffffffffffffffffffffffff_nx_u128 @endcode
+/// Its type is uint_t<128>, the builtin 128-bit integer where there is one,
+/// so that it takes the same paths as other 128-bit values.
+template <char... digits>
+constexpr nx::uint_t<128> operator "" _nx_u128() {
+  return nx::detail::WideLiteral<128, digits...>::value;
+}
+
+/// @brief A 128-bit literal with digit separators, such as
+/// @code "0xffff'ffff'ffff'ffff'ffff'ffff'ffff'ffff"_nx_u128 @endcode
+constexpr nx::uint_t<128> operator "" _nx_u128(const char*text,
+                                                  nx::size_t length) {
+  return nx::detail::ParseWideLiteral<128>(text, length);
+}
+
+/// @brief A 256-bit WideUInt literal.
+template <char... digits>
+constexpr nx::WideUInt<256> operator "" _nx_u256() {
+  return nx::detail::WideLiteral<256, digits...>::value;
+}
+
+/// @brief A 256-bit WideUInt literal with digit separators.
+constexpr nx::WideUInt<256> operator "" _nx_u256(const char*text,
+                                                  nx::size_t length) {
+  return nx::detail::ParseWideLiteral<256>(text, length);
+}
+
+/// @brief A 512-bit WideUInt literal.
+template <char... digits>
+constexpr nx::WideUInt<512> operator "" _nx_u512() {
+  return nx::detail::WideLiteral<512, digits...>::value;
+}
+
+/// @brief A 512-bit WideUInt literal with digit separators.
+constexpr nx::WideUInt<512> operator "" _nx_u512(const char*text,
+                                                  nx::size_t length) {
+  return nx::detail::ParseWideLiteral<512>(text, length);
+}
+
+/// @brief A byte literal, giving the bytes in the order written as a
+/// ByteArray; it must be hexadecimal, with two digits per byte, as in
+/// @code 0xcafebabe_nx_bytes @endcode
+template <char... digits>
+constexpr nx::ByteArray<nx::detail::ByteLiteralSize(sizeof...(digits))>
+operator "" _nx_bytes() {
+  return nx::detail::ByteLiteral<digits...>::value;
+}
+
 #endif  // INCLUDE_NX_LITERAL_H_
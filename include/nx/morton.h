@@ -0,0 +1,242 @@
+//
+// Copyright (C) 2013 Jacob McIntosh <nacitar at ubercpp dot com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+/// @file morton.h
+/// @brief Provides functions to interleave the bits of 2D and 3D coordinates
+/// into Morton (Z-order) codes, and to split codes back into coordinates.
+/// @details Coordinate 0 (x) occupies the lowest bit of each group.  The
+/// single-value functions use BitDeposit/BitExtract when those compile to
+/// pdep/pext, and shift/mask ladders otherwise.  The array overloads choose
+/// between the two at runtime, preferring pdep/pext only where they are not
+/// microcoded; SetMortonKernel() overrides that choice.
+
+#ifndef INCLUDE_NX_MORTON_H_
+#define INCLUDE_NX_MORTON_H_
+
+#include "nx/core.h"
+#include "nx/bit_deposit.h"
+
+/// @brief Library namespace.
+namespace nx {
+
+/// @cond nx_detail
+namespace detail {
+
+/// @brief The bits of the first of two interleaved coordinates.
+constexpr uint64_t kMorton2Mask = 0x5555555555555555ull;
+
+/// @brief The bits of the first of three interleaved coordinates.
+constexpr uint64_t kMorton3Mask = 0x1249249249249249ull;
+
+/// @brief One step of a ladder that spreads bits apart.
+constexpr uint64_t SpreadStep(uint64_t value, unsigned int shift,
+                              uint64_t mask) {
+  return (value | value << shift) & mask;
+}
+
+/// @brief One step of a ladder that gathers spread bits together.
+constexpr uint64_t CompactStep(uint64_t value, unsigned int shift,
+                               uint64_t mask) {
+  return (value ^ value >> shift) & mask;
+}
+
+/// @brief Moves bit N of a 32-bit value to bit 2N.
+constexpr uint64_t Spread2(uint64_t value) {
+  return SpreadStep(SpreadStep(SpreadStep(SpreadStep(SpreadStep(
+      value & 0xffffffffull,
+      16, 0x0000ffff0000ffffull),
+      8, 0x00ff00ff00ff00ffull),
+      4, 0x0f0f0f0f0f0f0f0full),
+      2, 0x3333333333333333ull),
+      1, kMorton2Mask);
+}
+
+/// @brief Moves bit 2N of a value to bit N.
+constexpr uint64_t Compact2(uint64_t value) {
+  return CompactStep(CompactStep(CompactStep(CompactStep(CompactStep(
+      value & kMorton2Mask,
+      1, 0x3333333333333333ull),
+      2, 0x0f0f0f0f0f0f0f0full),
+      4, 0x00ff00ff00ff00ffull),
+      8, 0x0000ffff0000ffffull),
+      16, 0x00000000ffffffffull);
+}
+
+/// @brief Moves bit N of a 21-bit value to bit 3N.
+constexpr uint64_t Spread3(uint64_t value) {
+  return SpreadStep(SpreadStep(SpreadStep(SpreadStep(SpreadStep(
+      value & 0x1fffffull,
+      32, 0x001f00000000ffffull),
+      16, 0x001f0000ff0000ffull),
+      8, 0x100f00f00f00f00full),
+      4, 0x10c30c30c30c30c3ull),
+      2, kMorton3Mask);
+}
+
+/// @brief Moves bit 3N of a value to bit N.
+constexpr uint64_t Compact3(uint64_t value) {
+  return CompactStep(CompactStep(CompactStep(CompactStep(CompactStep(
+      value & kMorton3Mask,
+      2, 0x10c30c30c30c30c3ull),
+      4, 0x100f00f00f00f00full),
+      8, 0x001f0000ff0000ffull),
+      16, 0x001f00000000ffffull),
+      32, 0x00000000001fffffull);
+}
+
+#if defined(NX_BIT_DEPOSIT_INTRINSIC)
+
+inline uint64_t MortonSpread2(uint64_t value) {
+  return BitDeposit(value, kMorton2Mask);
+}
+
+inline uint64_t MortonCompact2(uint64_t value) {
+  return BitExtract(value, kMorton2Mask);
+}
+
+inline uint64_t MortonSpread3(uint64_t value) {
+  return BitDeposit(value, kMorton3Mask);
+}
+
+inline uint64_t MortonCompact3(uint64_t value) {
+  return BitExtract(value, kMorton3Mask);
+}
+
+#else
+
+inline uint64_t MortonSpread2(uint64_t value) {
+  return Spread2(value);
+}
+
+inline uint64_t MortonCompact2(uint64_t value) {
+  return Compact2(value);
+}
+
+inline uint64_t MortonSpread3(uint64_t value) {
+  return Spread3(value);
+}
+
+inline uint64_t MortonCompact3(uint64_t value) {
+  return Compact3(value);
+}
+
+#endif
+
+}  // namespace detail
+/// @endcond
+
+/// @brief The implementations available for the array overloads.
+enum class MortonKernel {
+  /// @brief Shift/mask ladders; fast everywhere.
+  kShiftMask,
+  /// @brief BMI2 pdep/pext; fastest where they are executed in hardware.
+  kBmi2
+};
+
+/// @brief Determines if the running processor can execute the given kernel.
+bool MortonSupported(MortonKernel kernel);
+
+/// @brief Makes the array overloads use the given kernel, which must be
+/// supported by the running processor, instead of the automatic choice.
+void SetMortonKernel(MortonKernel kernel);
+
+/// @brief Interleaves two 32-bit coordinates.
+///
+/// @param x The coordinate stored in the even bits.
+/// @param y The coordinate stored in the odd bits.
+///
+/// @return The Morton code.
+inline uint64_t MortonEncode(uint32_t x, uint32_t y) {
+  return detail::MortonSpread2(x) | detail::MortonSpread2(y) << 1;
+}
+
+/// @brief Interleaves three 21-bit coordinates; higher bits are ignored.
+///
+/// @param x The coordinate stored in bits 0, 3, 6, ...
+/// @param y The coordinate stored in bits 1, 4, 7, ...
+/// @param z The coordinate stored in bits 2, 5, 8, ...
+///
+/// @return The Morton code.
+inline uint64_t MortonEncode(uint32_t x, uint32_t y, uint32_t z) {
+  return detail::MortonSpread3(x & 0x1fffffu)
+      | detail::MortonSpread3(y & 0x1fffffu) << 1
+      | detail::MortonSpread3(z & 0x1fffffu) << 2;
+}
+
+/// @brief Splits a Morton code into two coordinates.
+///
+/// @param code The Morton code.
+/// @param x Where to store the coordinate from the even bits.
+/// @param y Where to store the coordinate from the odd bits.
+inline void MortonDecode(uint64_t code, uint32_t*x, uint32_t*y) {
+  *x = static_cast<uint32_t>(detail::MortonCompact2(code));
+  *y = static_cast<uint32_t>(detail::MortonCompact2(code >> 1));
+}
+
+/// @brief Splits a Morton code into three coordinates.
+///
+/// @param code The Morton code; bit 63 is ignored.
+/// @param x Where to store the coordinate from bits 0, 3, 6, ...
+/// @param y Where to store the coordinate from bits 1, 4, 7, ...
+/// @param z Where to store the coordinate from bits 2, 5, 8, ...
+inline void MortonDecode(uint64_t code, uint32_t*x, uint32_t*y, uint32_t*z) {
+  *x = static_cast<uint32_t>(detail::MortonCompact3(code));
+  *y = static_cast<uint32_t>(detail::MortonCompact3(code >> 1));
+  *z = static_cast<uint32_t>(detail::MortonCompact3(code >> 2));
+}
+
+/// @brief Interleaves arrays of two coordinates.
+///
+/// @param x The coordinates to store in the even bits.
+/// @param y The coordinates to store in the odd bits.
+/// @param codes Where to store the Morton codes.
+/// @param length The number of elements in each array.
+void MortonEncode(const uint32_t*x, const uint32_t*y, uint64_t*codes,
+                  size_t length);
+
+/// @brief Interleaves arrays of three 21-bit coordinates.
+///
+/// @param x The coordinates to store in bits 0, 3, 6, ...
+/// @param y The coordinates to store in bits 1, 4, 7, ...
+/// @param z The coordinates to store in bits 2, 5, 8, ...
+/// @param codes Where to store the Morton codes.
+/// @param length The number of elements in each array.
+void MortonEncode(const uint32_t*x, const uint32_t*y, const uint32_t*z,
+                  uint64_t*codes, size_t length);
+
+/// @brief Splits an array of Morton codes into two coordinates each.
+///
+/// @param codes The Morton codes.
+/// @param x Where to store the coordinates from the even bits.
+/// @param y Where to store the coordinates from the odd bits.
+/// @param length The number of elements in each array.
+void MortonDecode(const uint64_t*codes, uint32_t*x, uint32_t*y,
+                  size_t length);
+
+/// @brief Splits an array of Morton codes into three coordinates each.
+///
+/// @param codes The Morton codes.
+/// @param x Where to store the coordinates from bits 0, 3, 6, ...
+/// @param y Where to store the coordinates from bits 1, 4, 7, ...
+/// @param z Where to store the coordinates from bits 2, 5, 8, ...
+/// @param length The number of elements in each array.
+void MortonDecode(const uint64_t*codes, uint32_t*x, uint32_t*y, uint32_t*z,
+                  size_t length);
+
+}  // namespace nx
+
+#endif  // INCLUDE_NX_MORTON_H_
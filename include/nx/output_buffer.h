@@ -0,0 +1,229 @@
+//
+// Copyright (C) 2013 Jacob McIntosh <nacitar at ubercpp dot com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+/// @file output_buffer.h
+/// @brief Provides OutputBuffer, which formats values straight into blocks of
+/// memory that are written to a file descriptor together.
+/// @details Values are converted by ToString() and Format() directly into
+/// the spare capacity of the current block, so nothing is zero-filled or
+/// allocated per value.  Filled blocks are kept until the ring of blocks is
+/// full or Flush() is called, and are then written with a single writev
+/// call.  Optionally, a background thread does the writing, so that the
+/// thread appending only waits when every block is waiting to be written.
+
+#ifndef INCLUDE_NX_OUTPUT_BUFFER_H_
+#define INCLUDE_NX_OUTPUT_BUFFER_H_
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "nx/core.h"
+#include "nx/digits.h"
+#include "nx/format.h"
+#include "nx/to_string.h"
+
+/// @brief Library namespace.
+namespace nx {
+
+/// @brief Buffers text written to a file descriptor in a ring of blocks.
+/// @details Appending is not thread-safe; a single thread must append,
+/// flush and destroy the buffer, even when a flush thread is running.
+class OutputBuffer {
+ public:
+  /// @brief The default size of each block.
+  static constexpr const size_t kDefaultBlockSize = 64 * 1024;
+
+  /// @brief The default number of blocks.
+  static constexpr const unsigned int kDefaultBlocks = 8;
+
+  /// @brief The most blocks a buffer may have; also the most written by one
+  /// writev call.
+  static constexpr const unsigned int kMaxBlocks = 64;
+
+  /// @brief Constructs a buffer writing to the given file descriptor, which
+  /// it does not close.  Only the first block is allocated up front; the
+  /// others are allocated when first used, and then reused.
+  ///
+  /// @param descriptor The file descriptor to write to.
+  /// @param block_size The size of each block.  This is also the longest
+  /// text Reserve() can provide room for.
+  /// @param blocks The number of blocks, from 2 to kMaxBlocks.
+  explicit OutputBuffer(int descriptor,
+                        size_t block_size = kDefaultBlockSize,
+                        unsigned int blocks = kDefaultBlocks);
+
+  /// @brief Flushes the buffer and stops any flush thread.
+  ~OutputBuffer();
+
+  /// @brief Starts a thread that writes blocks as they are filled or
+  /// flushed, instead of the appending thread writing them.  Does nothing if
+  /// the thread is already running.
+  void StartFlushThread();
+
+  /// @brief Writes everything appended so far, returning once it has been
+  /// written.
+  ///
+  /// @return false if any write has failed; see error().
+  bool Flush();
+
+  /// @brief Provides the errno of the first write that failed, or 0 if none
+  /// has.  Once a write fails, the text of the blocks it was writing is
+  /// dropped.
+  int error() const;
+
+  /// @brief Provides room for at least length characters in the current
+  /// block, moving on to the next block if needed.  The characters written
+  /// are kept only once passed to Commit().
+  ///
+  /// @param length The most characters that will be written; at most the
+  /// block size.
+  ///
+  /// @return Where to write the characters.
+  char*Reserve(size_t length) {
+    if (NX_UNLIKELY(static_cast<size_t>(end_ - position_) < length)) {
+      NextBlock(length);
+    }
+    return position_;
+  }
+
+  /// @brief Keeps the given number of characters written to the room
+  /// provided by Reserve().
+  void Commit(size_t length) {
+    position_ += length;
+  }
+
+  /// @brief Appends text, which may span blocks.
+  void Append(const char*text, size_t length);
+
+  /// @brief Appends a null-terminated string.
+  void Append(const char*text) {
+    Append(text, std::strlen(text));
+  }
+
+  /// @brief Appends a std::string.
+  void Append(const std::string&text) {
+    Append(text.data(), text.size());
+  }
+
+  /// @brief Appends a character.
+  void Append(char ch) {
+    *Reserve(1) = ch;
+    Commit(1);
+  }
+
+  /// @brief Appends an integral value as ToString() writes it.
+  ///
+  /// @tparam number_base The base to write the value in: 2, 8, 10 or 16.
+  /// @tparam letter_case The case of the base 16 digits above 9.
+  /// @param value The value to write.
+  /// @param digits The number of digits to zero-pad the value to.  Unlike
+  /// ToString(), this never truncates the value.
+  template <unsigned int number_base = 10,
+            LetterCase letter_case = LetterCase::kLower, class T>
+  EnableIf<
+      IsIntegral<T>,
+  void> Append(T value, unsigned int digits = 0) {
+    digits = std::max(digits, Digits<number_base>(value));
+    Commit(ToString<number_base, letter_case>(
+        value, Reserve((value < 0) + digits), digits));
+  }
+
+  /// @brief Appends the shortest round-trip representation of a
+  /// floating-point value.
+  template <class T>
+  EnableIf<
+      IsFloatingPoint<T>,
+  void> Append(T value) {
+    Commit(ToString(value, Reserve(detail::kShortestMaxLength)));
+  }
+
+  /// @brief Appends the arguments as described by a format string.
+  /// @details The text is formatted straight into the current block, and
+  /// formatted again into the next one if it did not fit.
+  template <class... Args>
+  void AppendFormat(const FormatString&format, const Args&... args) {
+    const size_t space = static_cast<size_t>(end_ - position_);
+    const size_t length = Format(position_, space, format, args...);
+    if (length > space) {
+      if (length > block_size_) {
+        std::string text;
+        Format(&text, format, args...);
+        Append(text);
+        return;
+      }
+      Format(Reserve(length), length, format, args...);
+    }
+    Commit(length);
+  }
+
+ private:
+  NX_NONCOPYABLE(OutputBuffer);
+
+  /// @brief Hands the current block over to be written and moves to the
+  /// next one, which must have room for length characters.
+  void NextBlock(size_t length);
+
+  /// @brief Hands the current block over to be written if it holds any
+  /// text, waiting for a free block if the next one is still pending.
+  void ReleaseBlock(std::unique_lock<std::mutex>*lock);
+
+  /// @brief Writes the pending blocks; the mutex must not be held.
+  int WriteBlocks(unsigned int first, unsigned int count);
+
+  /// @brief Writes every pending block on the appending thread.
+  void WritePending(std::unique_lock<std::mutex>*lock);
+
+  /// @brief The body of the flush thread.
+  void FlushLoop();
+
+  /// @brief The file descriptor written to.
+  const int descriptor_;
+  /// @brief The size of each block.
+  const size_t block_size_;
+  /// @brief The ring of blocks, allocated when first used.
+  std::vector<std::unique_ptr<char[]>> blocks_;
+  /// @brief The length of the text in each pending block.
+  std::vector<size_t> lengths_;
+  /// @brief The first pending block.
+  unsigned int head_;
+  /// @brief The number of pending blocks, which follow head_ in the ring.
+  unsigned int pending_;
+  /// @brief The block being appended to, which follows the pending ones.
+  unsigned int current_;
+  /// @brief Where the next character is appended.
+  char*position_;
+  /// @brief The end of the current block.
+  char*end_;
+  /// @brief The errno of the first failed write, or 0.
+  int error_;
+  /// @brief Set to make the flush thread exit once it is idle.
+  bool stopping_;
+  /// @brief Guards the pending blocks and the error.
+  mutable std::mutex mutex_;
+  /// @brief Signalled when blocks are handed over or written.
+  std::condition_variable changed_;
+  /// @brief The flush thread, if started.
+  std::thread thread_;
+};
+
+}  // namespace nx
+
+#endif  // INCLUDE_NX_OUTPUT_BUFFER_H_
@@ -19,11 +19,24 @@
 /// integral value.
 /// @details If you define NX_USE_GENERIC_POPULATION_COUNT, even on platforms
 /// with the appropriate compiler intrinsics, a generic fallback will be used.
+/// The fallback uses 8-bit lookup tables, 16-bit ones if you define
+/// NX_USE_WIDE_TABLES (see constant.h), or SWAR arithmetic if you define
+/// NX_USE_SWAR (see swar.h).  Unless the build targets a processor with
+/// popcnt, the builtins are software routines.  Counting the bits of whole
+/// buffers is also supported; those overloads select the kernel to use at
+/// runtime through nx::cpu::Dispatch, so they use the hardware instructions
+/// either way.  128-bit values are counted as two 64-bit halves.
 
 #ifndef INCLUDE_NX_POPULATION_COUNT_H_
 #define INCLUDE_NX_POPULATION_COUNT_H_
 
 #include "nx/core.h"
+#include "nx/constant.h"
+#include "nx/swar.h"
+
+#if defined(NX_TC_VS)
+  #include <intrin.h>
+#endif
 
 /// @brief Library namespace.
 namespace nx {
@@ -34,48 +47,14 @@ namespace nx {
 /// @cond nx_detail
 namespace detail {
 
-#if !defined(NX_USE_GENERIC_POPULATION_COUNT) && defined(NX_TC_GCC)
-// GCC PopulationCount - counts the number of set bits
-
-/// @brief unsigned long long selector
-template <class T>
-inline constexpr EnableIf<All<
-    std::is_integral<T>,
-    IntegerFits<T, unsigned long long>,  // NOLINT(runtime/int)
-    Not<IntegerFits<T, unsigned long>>>,  // NOLINT(runtime/int)
-unsigned int> PopulationCount(T value) {
-  return __builtin_popcountll(value);
-}
-
-/// @brief unsigned long selector
-template <class T>
-inline constexpr EnableIf<All<
-    std::is_integral<T>,
-    IntegerFits<T, unsigned long>,  // NOLINT(runtime/int)
-    Not<IntegerFits<T, unsigned int>>>,
-unsigned int> PopulationCount(T value) {
-  return __builtin_popcountl(value);
-}
-
-/// @brief unsigned int selector
-template <class T>
-inline constexpr EnableIf<All<
-    std::is_integral<T>,
-    IntegerFits<T, unsigned int>>,
-unsigned int> PopulationCount(T value) {
-  return __builtin_popcount(value);
-}
-
-#else
-
 /// @cond nx_detail_version
 namespace version {
-// Generic PopulationCount
+// Lookup table PopulationCount; used by the generic fallback.
 
 /// @brief 64-bit version
 template <unsigned int uVersion, class T>
 constexpr EnableIf<All<
-    std::is_unsigned<T>, Bool<uVersion == 64>>,
+    IsUnsigned<T>, Bool<uVersion == 64>>,
 unsigned int> PopulationCount(T value) {
   using nx::constant::population_count_8bit;
   return static_cast<unsigned int>(
@@ -92,7 +71,7 @@ unsigned int> PopulationCount(T value) {
 /// @brief 32-bit version
 template <unsigned int uVersion, class T>
 constexpr EnableIf<All<
-    std::is_unsigned<T>, Bool<uVersion == 32>>,
+    IsUnsigned<T>, Bool<uVersion == 32>>,
 unsigned int> PopulationCount(T value) {
   using nx::constant::population_count_8bit;
   return static_cast<unsigned int>(
@@ -105,7 +84,7 @@ unsigned int> PopulationCount(T value) {
 /// @brief 16-bit version
 template <unsigned int uVersion, class T>
 constexpr EnableIf<All<
-    std::is_unsigned<T>, Bool<uVersion == 16>>,
+    IsUnsigned<T>, Bool<uVersion == 16>>,
 unsigned int> PopulationCount(T value) {
   using nx::constant::population_count_8bit;
   return static_cast<unsigned int>(
@@ -116,58 +95,280 @@ unsigned int> PopulationCount(T value) {
 /// @brief 8-bit version
 template <unsigned int uVersion, class T>
 constexpr EnableIf<All<
-    std::is_unsigned<T>, Bool<uVersion == 8>>,
+    IsUnsigned<T>, Bool<uVersion == 8>>,
 unsigned int> PopulationCount(T value) {
   using nx::constant::population_count_8bit;
   return static_cast<unsigned int>(population_count_8bit[value]);
 }
 
+// 16-bit lookup table PopulationCount; used by the generic fallback if you
+// define NX_USE_WIDE_TABLES.
+
+/// @brief 64-bit version
+template <unsigned int uVersion, class T>
+constexpr EnableIf<All<
+    IsUnsigned<T>, Bool<uVersion == 64>>,
+unsigned int> WidePopulationCount(T value) {
+  typedef nx::constant::population_count_16bit table;
+  return static_cast<unsigned int>(
+    table::value[ value        & 0xffff]) +
+    table::value[(value >> 16) & 0xffff]  +
+    table::value[(value >> 32) & 0xffff]  +
+    table::value[(value >> 48) & 0xffff];
+}
+
+/// @brief 32-bit version
+template <unsigned int uVersion, class T>
+constexpr EnableIf<All<
+    IsUnsigned<T>, Bool<uVersion == 32>>,
+unsigned int> WidePopulationCount(T value) {
+  typedef nx::constant::population_count_16bit table;
+  return static_cast<unsigned int>(
+    table::value[ value        & 0xffff]) +
+    table::value[(value >> 16) & 0xffff];
+}
+
+/// @brief 16-bit version
+template <unsigned int uVersion, class T>
+constexpr EnableIf<All<
+    IsUnsigned<T>, Bool<uVersion == 16>>,
+unsigned int> WidePopulationCount(T value) {
+  typedef nx::constant::population_count_16bit table;
+  return static_cast<unsigned int>(table::value[value]);
+}
+
 }  // namespace version
 /// @endcond
 
+#if !defined(NX_USE_GENERIC_POPULATION_COUNT) && \
+    (defined(NX_TC_GCC) || defined(NX_TC_CLANG))
+// GCC/Clang PopulationCount - counts the number of set bits
+
+/// @brief Defined if PopulationCount is implemented with compiler intrinsics.
+#define NX_POPULATION_COUNT_INTRINSIC 1
+
+/// @brief unsigned long long selector
+template <class T>
+inline constexpr EnableIf<All<
+    IsIntegral<T>,
+    IntegerFits<T, unsigned long long>,  // NOLINT(runtime/int)
+    Not<IntegerFits<T, unsigned long>>>,  // NOLINT(runtime/int)
+unsigned int> PopulationCount(T value) {
+  return __builtin_popcountll(
+      static_cast<Invoke<MakeUnsigned<T>>>(value));
+}
+
+/// @brief unsigned long selector
+template <class T>
+inline constexpr EnableIf<All<
+    IsIntegral<T>,
+    IntegerFits<T, unsigned long>,  // NOLINT(runtime/int)
+    Not<IntegerFits<T, unsigned int>>>,
+unsigned int> PopulationCount(T value) {
+  return __builtin_popcountl(
+      static_cast<Invoke<MakeUnsigned<T>>>(value));
+}
+
+/// @brief unsigned int selector
+template <class T>
+inline constexpr EnableIf<All<
+    IsIntegral<T>,
+    IntegerFits<T, unsigned int>>,
+unsigned int> PopulationCount(T value) {
+  return __builtin_popcount(
+      static_cast<Invoke<MakeUnsigned<T>>>(value));
+}
+
+#elif !defined(NX_USE_GENERIC_POPULATION_COUNT) && defined(NX_TC_VS) && \
+    defined(__AVX__)
+// Visual Studio PopulationCount; the intrinsics are not constexpr.  Unlike
+// the GCC builtins they have no software fallback, so they are only used when
+// the build targets AVX, which implies popcnt.
+
+/// @brief Defined if PopulationCount is implemented with compiler intrinsics.
+#define NX_POPULATION_COUNT_INTRINSIC 1
+
+/// @brief [33,64]-bit version
+template <class T>
+inline EnableIf<All<
+    IsIntegral<T>, BitRange<T, 33, 64>>,
+unsigned int> PopulationCount(T value) {
+  const unsigned __int64 bits = static_cast<unsigned __int64>(value);
+#if defined(NX_ARCH_X86_64)
+  return static_cast<unsigned int>(__popcnt64(bits));
+#else
+  return __popcnt(static_cast<unsigned int>(bits))
+      + __popcnt(static_cast<unsigned int>(bits >> 32));
+#endif
+}
+
+/// @brief [0,32]-bit version
+template <class T>
+inline EnableIf<All<
+    IsIntegral<T>, BitRange<T, 0, 32>>,
+unsigned int> PopulationCount(T value) {
+  return __popcnt(static_cast<unsigned int>(
+      static_cast<Invoke<MakeUnsigned<T>>>(value)));
+}
+
+#elif defined(NX_USE_SWAR)
+// SWAR PopulationCount
+
+/// @brief [0,32]-bit selector
+template <class T>
+inline constexpr EnableIf<All<
+    IsUnsigned<T>, BitRange<T, 0, 32>>,
+unsigned int> PopulationCount(T value) {
+  return swar::PopulationCount(value);
+}
+
+/// @brief [33,64]-bit selector
+template <class T>
+inline constexpr EnableIf<All<
+    IsUnsigned<T>, BitRange<T, 33, 64>>,
+unsigned int> PopulationCount(T value) {
+  return swar::PopulationCount(value);
+}
+
+/// @brief signed-value converter
+template <class T>
+inline constexpr EnableIf<All<
+    IsSigned<T>, BitRange<T, 0, 64>>,
+unsigned int> PopulationCount(T value) {
+  typedef Invoke<MakeUnsigned<T>> UT;
+  return PopulationCount(static_cast<UT>(value));
+}
+
+#elif defined(NX_USE_WIDE_TABLES)
+// 16-bit lookup table PopulationCount
+
 /// @brief [0,8]-bit selector
 template <class T>
 inline constexpr EnableIf<All<
-    std::is_unsigned<T>, BitRange<T, 0, 8>>,
+    IsUnsigned<T>, BitRange<T, 0, 8>>,
 unsigned int> PopulationCount(T value) {
-  return detail::PopulationCount<8>(value);
+  return version::PopulationCount<8>(value);
 }
 
 /// @brief [9,16]-bit selector
 template <class T>
 inline constexpr EnableIf<All<
-    std::is_unsigned<T>, BitRange<T, 9, 16>>,
+    IsUnsigned<T>, BitRange<T, 9, 16>>,
 unsigned int> PopulationCount(T value) {
-  return detail::PopulationCount<16>(value);
+  return version::WidePopulationCount<16>(value);
 }
 
 /// @brief [17,32]-bit selector
 template <class T>
 inline constexpr EnableIf<All<
-    std::is_unsigned<T>, BitRange<T, 17, 32>>,
+    IsUnsigned<T>, BitRange<T, 17, 32>>,
 unsigned int> PopulationCount(T value) {
-  return detail::PopulationCount<32>(value);
+  return version::WidePopulationCount<32>(value);
 }
 
 /// @brief [33,64]-bit selector
 template <class T>
 inline constexpr EnableIf<All<
-    std::is_unsigned<T>, BitRange<T, 33, 64>>,
+    IsUnsigned<T>, BitRange<T, 33, 64>>,
 unsigned int> PopulationCount(T value) {
-  return detail::PopulationCount<64>(value);
+  return version::WidePopulationCount<64>(value);
 }
 
 /// @brief signed-value converter
 template <class T>
-inline constexpr EnableIf<
-    std::is_signed<T>,
+inline constexpr EnableIf<All<
+    IsSigned<T>, BitRange<T, 0, 64>>,
 unsigned int> PopulationCount(T value) {
-  typedef typename std::make_unsigned<T>::type UT;
+  typedef Invoke<MakeUnsigned<T>> UT;
   return PopulationCount(static_cast<UT>(value));
 }
 
+#else
+// Lookup table PopulationCount
+
+/// @brief [0,8]-bit selector
+template <class T>
+inline constexpr EnableIf<All<
+    IsUnsigned<T>, BitRange<T, 0, 8>>,
+unsigned int> PopulationCount(T value) {
+  return version::PopulationCount<8>(value);
+}
+
+/// @brief [9,16]-bit selector
+template <class T>
+inline constexpr EnableIf<All<
+    IsUnsigned<T>, BitRange<T, 9, 16>>,
+unsigned int> PopulationCount(T value) {
+  return version::PopulationCount<16>(value);
+}
+
+/// @brief [17,32]-bit selector
+template <class T>
+inline constexpr EnableIf<All<
+    IsUnsigned<T>, BitRange<T, 17, 32>>,
+unsigned int> PopulationCount(T value) {
+  return version::PopulationCount<32>(value);
+}
+
+/// @brief [33,64]-bit selector
+template <class T>
+inline constexpr EnableIf<All<
+    IsUnsigned<T>, BitRange<T, 33, 64>>,
+unsigned int> PopulationCount(T value) {
+  return version::PopulationCount<64>(value);
+}
+
+/// @brief signed-value converter
+template <class T>
+inline constexpr EnableIf<All<
+    IsSigned<T>, BitRange<T, 0, 64>>,
+unsigned int> PopulationCount(T value) {
+  typedef Invoke<MakeUnsigned<T>> UT;
+  return PopulationCount(static_cast<UT>(value));
+}
+
+#endif
+
+#if defined(NX_HAS_INT128)
+/// @brief [65,128]-bit selector; counts each 64-bit half.
+template <class T>
+inline constexpr EnableIf<All<
+    IsIntegral<T>, BitRange<T, 65, 128>>,
+unsigned int> PopulationCount(T value) {
+  return PopulationCount(static_cast<uint64_t>(value))
+      + PopulationCount(static_cast<uint64_t>(
+          static_cast<Invoke<MakeUnsigned<T>>>(value) >> 64));
+}
 #endif
 
+/// @brief The implementations available for counting the bits of a buffer.
+enum class PopulationCountKernel {
+  /// @brief One PopulationCount() call per 64-bit word.
+  kScalar,
+  /// @brief One popcnt instruction per 64-bit word.
+  kPopcnt,
+  /// @brief Harley-Seal carry-save adders over 64-bit words; one
+  /// PopulationCount() call per 16 words.
+  kHarleySeal,
+  /// @brief Harley-Seal carry-save adders over AVX2 registers, with the
+  /// counters reduced by a nibble-shuffle lookup.
+  kAvx2,
+  /// @brief AVX-512 VPOPCNTDQ.
+  kAvx512
+};
+
+/// @brief Determines if the running processor can execute the given kernel.
+bool PopulationCountSupported(PopulationCountKernel kernel);
+
+/// @brief Counts the set bits of a buffer using the given kernel, which must
+/// be supported by the running processor.
+uint64_t PopulationCountBuffer(
+    PopulationCountKernel kernel, const void*data, size_t bytes);
+
+/// @brief Counts the set bits of a buffer using the fastest kernel supported
+/// by the running processor, which is selected upon the first call.
+uint64_t PopulationCountBuffer(const void*data, size_t bytes);
+
 }  // namespace detail
 /// @endcond
 
@@ -178,10 +379,55 @@ unsigned int> PopulationCount(T value) {
 ///
 /// @return The number of bits set.
 template <class T>
-constexpr unsigned int PopulationCount(T value) {
+constexpr EnableIf<
+    IsIntegral<T>,
+unsigned int> PopulationCount(T value) {
   return detail::PopulationCount(value);
 }
 
+/// @brief Determines the number of set bits of a wide integer.
+///
+/// @tparam kBits The size of the passed value.
+/// @param value The value to examine.
+///
+/// @return The number of bits set.
+template <unsigned int kBits>
+inline unsigned int PopulationCount(const WideUInt<kBits>&value) {
+  unsigned int count = 0;
+  for (unsigned int i = 0; i < WideUInt<kBits>::kWords; ++i) {
+    count += PopulationCount(value.word(i));
+  }
+  return count;
+}
+
+/// @brief Determines the number of set bits in an array of integral values.
+///
+/// @tparam T The type of the array elements.
+/// @param data The first element of the array.
+/// @param length The number of elements in the array.
+///
+/// @return The number of bits set across all elements.
+template <class T>
+inline EnableIf<
+    IsIntegral<T>,
+uint64_t> PopulationCount(const T*data, size_t length) {
+  return detail::PopulationCountBuffer(data, length * sizeof(T));
+}
+
+/// @brief Determines the number of set bits in an array of integral values.
+///
+/// @tparam T The type of the array elements.
+/// @tparam kLength The number of elements in the array.
+/// @param data The array to examine.
+///
+/// @return The number of bits set across all elements.
+template <class T, size_t kLength>
+inline EnableIf<
+    IsIntegral<T>,
+uint64_t> PopulationCount(const T (&data)[kLength]) {
+  return detail::PopulationCountBuffer(data, sizeof(data));
+}
+
 }  // namespace nx
 
 #endif  // INCLUDE_NX_POPULATION_COUNT_H_
@@ -0,0 +1,154 @@
+//
+// Copyright (C) 2013 Jacob McIntosh <nacitar at ubercpp dot com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+/// @file rank_select_bit_vector.h
+/// @brief An immutable bit vector answering rank and select queries in
+/// constant time.
+
+#ifndef INCLUDE_NX_RANK_SELECT_BIT_VECTOR_H_
+#define INCLUDE_NX_RANK_SELECT_BIT_VECTOR_H_
+
+#include <vector>
+
+#include "nx/core.h"
+
+/// @brief Library namespace.
+namespace nx {
+
+/// @cond nx_detail
+namespace detail {
+
+class RankSelectKernels;
+
+}  // namespace detail
+/// @endcond
+
+/// @brief An immutable bit vector that can count the set bits preceding any
+/// position (rank) and find the position of the k-th set bit (select).
+/// @details Bits are stored least significant bit first in 64-bit words.
+/// Each 2048-bit block has one 64-bit entry interleaving the number of set
+/// bits before the block with the counts of its first three 512-bit
+/// sub-blocks, and every 2^32 bits a superblock holds the absolute count.
+/// Select narrows the search with the block of every 8192nd set bit, and
+/// finishes within a word with pdep/tzcnt when BMI2 is executed in hardware
+/// (cpu::Feature::kFastBmi2) or a broadword search otherwise.  The counters and samples cost roughly 3.5%
+/// of the size of the bits.
+class RankSelectBitVector {
+ public:
+  /// @brief Constructs an empty bit vector.
+  RankSelectBitVector();
+
+  /// @brief Constructs from a copy of the given bits.
+  ///
+  /// @param words The bits, least significant bit first.
+  /// @param size The number of bits to use from words.
+  RankSelectBitVector(const uint64_t*words, uint64_t size);
+
+  /// @brief Constructs by taking ownership of the given bits.
+  ///
+  /// @param words The bits, least significant bit first.  Bits past size
+  /// are ignored.
+  /// @param size The number of bits to use from words.
+  RankSelectBitVector(std::vector<uint64_t>&&words, uint64_t size);
+
+  /// @brief The number of bits.
+  uint64_t size() const;
+
+  /// @brief The number of set bits.
+  uint64_t count() const;
+
+  /// @brief Determines if a bit is set.
+  ///
+  /// @param index The position of the bit; must be less than size().
+  bool operator[](uint64_t index) const;
+
+  /// @brief Counts the set bits preceding a position.
+  ///
+  /// @param index The position; must not exceed size().
+  ///
+  /// @return The number of set bits in [0, index).
+  uint64_t Rank(uint64_t index) const;
+
+  /// @brief Finds the position of the k-th set bit.
+  ///
+  /// @param k The zero-based rank of the set bit; must be less than count().
+  ///
+  /// @return The position p of the bit, such that Rank(p) == k.
+  uint64_t Select(uint64_t k) const;
+
+  /// @brief The number of bytes used by the counters and samples.
+  size_t index_bytes() const;
+
+ private:
+  friend class detail::RankSelectKernels;
+
+  /// @brief Builds the counters and samples from words_ and size_.
+  void Build();
+
+  /// @brief The chosen Rank() implementation.
+  static const cpu::Dispatch<uint64_t(
+      const RankSelectBitVector*, uint64_t)> rank_;
+
+  /// @brief The chosen Select() implementation.
+  static const cpu::Dispatch<uint64_t(
+      const RankSelectBitVector*, uint64_t)> select_;
+
+  /// @brief The bits, padded with zeros to a whole number of blocks.
+  std::vector<uint64_t> words_;
+
+  /// @brief Per block: the set bits before it within its superblock in the
+  /// low 32 bits, then the set bits of its first three sub-blocks in 10 bits
+  /// each.  Ends with an entry for the position size().
+  std::vector<uint64_t> blocks_;
+
+  /// @brief The set bits before each superblock.
+  std::vector<uint64_t> superblocks_;
+
+  /// @brief The block containing every 8192nd set bit, followed by the
+  /// number of blocks.
+  std::vector<uint_least32_t> samples_;
+
+  /// @brief The number of bits.
+  uint64_t size_;
+
+  /// @brief The number of set bits.
+  uint64_t count_;
+};
+
+inline uint64_t RankSelectBitVector::size() const {
+  return size_;
+}
+
+inline uint64_t RankSelectBitVector::count() const {
+  return count_;
+}
+
+inline bool RankSelectBitVector::operator[](uint64_t index) const {
+  return (words_[index >> 6] >> (index & 63)) & 1;
+}
+
+inline uint64_t RankSelectBitVector::Rank(uint64_t index) const {
+  return rank_(this, index);
+}
+
+inline uint64_t RankSelectBitVector::Select(uint64_t k) const {
+  return select_(this, k);
+}
+
+}  // namespace nx
+
+#endif  // INCLUDE_NX_RANK_SELECT_BIT_VECTOR_H_
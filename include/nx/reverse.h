@@ -16,11 +16,21 @@
 
 /// @file reverse.h
 /// @brief Provides a function to reverse the bits of an integral value.
+/// @details The reversal uses 8-bit lookup tables, 16-bit ones if you define
+/// NX_USE_WIDE_TABLES (see constant.h), or SWAR arithmetic if you define
+/// NX_USE_SWAR (see swar.h).  Reversing the bits of every element of an
+/// array is also supported; that selects a pshufb-based kernel at runtime
+/// and is implemented in reverse.cc.  The bit-reversal permutation of an
+/// array (as used to reorder FFT inputs) is provided as well.
 
 #ifndef INCLUDE_NX_REVERSE_H_
 #define INCLUDE_NX_REVERSE_H_
 
+#include <vector>
+
 #include "nx/core.h"
+#include "nx/constant.h"
+#include "nx/swar.h"
 
 /// @brief Library namespace.
 namespace nx {
@@ -34,7 +44,7 @@ namespace version {
 /// @brief 64-bit version
 template <unsigned int uVersion, class T>
 constexpr EnableIf<All<
-    std::is_unsigned<T>, Bool<uVersion == 64>>,
+    IsUnsigned<T>, Bool<uVersion == 64>>,
 T> Reverse(T value) {
   using constant::reverse_8bit;
   return
@@ -51,7 +61,7 @@ T> Reverse(T value) {
 /// @brief 32-bit version
 template <unsigned int uVersion, class T>
 constexpr EnableIf<All<
-    std::is_unsigned<T>, Bool<uVersion == 32>>,
+    IsUnsigned<T>, Bool<uVersion == 32>>,
 T> Reverse(T value) {
   using constant::reverse_8bit;
   return
@@ -64,7 +74,7 @@ T> Reverse(T value) {
 /// @brief 16-bit version
 template <unsigned int uVersion, class T>
 constexpr EnableIf<All<
-    std::is_unsigned<T>, Bool<uVersion == 16>>,
+    IsUnsigned<T>, Bool<uVersion == 16>>,
 T> Reverse(T value) {
   using constant::reverse_8bit;
   return
@@ -75,20 +85,106 @@ T> Reverse(T value) {
 /// @brief 8-bit version
 template <unsigned int uVersion, class T>
 constexpr EnableIf<All<
-    std::is_unsigned<T>, Bool<uVersion == 8>>,
+    IsUnsigned<T>, Bool<uVersion == 8>>,
 T> Reverse(T value) {
   using constant::reverse_8bit;
   return
       static_cast<T>(reverse_8bit[value]);
 }
 
+// 16-bit lookup table Reverse; used by the generic fallback if you define
+// NX_USE_WIDE_TABLES.
+
+/// @brief 64-bit version
+template <unsigned int uVersion, class T>
+constexpr EnableIf<All<
+    IsUnsigned<T>, Bool<uVersion == 64>>,
+T> WideReverse(T value) {
+  typedef constant::reverse_16bit table;
+  return
+      static_cast<T>(table::value[ value        & 0xffff]) << 48 |
+      static_cast<T>(table::value[(value >> 16) & 0xffff]) << 32 |
+      static_cast<T>(table::value[(value >> 32) & 0xffff]) << 16 |
+      static_cast<T>(table::value[(value >> 48) & 0xffff]);
+}
+
+/// @brief 32-bit version
+template <unsigned int uVersion, class T>
+constexpr EnableIf<All<
+    IsUnsigned<T>, Bool<uVersion == 32>>,
+T> WideReverse(T value) {
+  typedef constant::reverse_16bit table;
+  return
+      static_cast<T>(table::value[ value        & 0xffff]) << 16 |
+      static_cast<T>(table::value[(value >> 16) & 0xffff]);
+}
+
+/// @brief 16-bit version
+template <unsigned int uVersion, class T>
+constexpr EnableIf<All<
+    IsUnsigned<T>, Bool<uVersion == 16>>,
+T> WideReverse(T value) {
+  typedef constant::reverse_16bit table;
+  return
+      static_cast<T>(table::value[value]);
+}
+
 }  // namespace version
 /// @endcond
 
+#if defined(NX_USE_SWAR)
+// SWAR Reverse
+
+/// @brief [0,64]-bit selector
+template <class T>
+inline constexpr EnableIf<All<
+    IsUnsigned<T>, BitRange<T, 0, 64>>,
+T> Reverse(T value) {
+  return swar::Reverse(value);
+}
+
+#elif defined(NX_USE_WIDE_TABLES)
+// 16-bit lookup table Reverse
+
+/// @brief [0,8]-bit selector
+template <class T>
+inline constexpr EnableIf<All<
+    IsUnsigned<T>, BitRange<T, 0, 8>>,
+T> Reverse(T value) {
+  return version::Reverse<8>(value);
+}
+
+/// @brief [9,16]-bit selector
+template <class T>
+inline constexpr EnableIf<All<
+    IsUnsigned<T>, BitRange<T, 9, 16>>,
+T> Reverse(T value) {
+  return version::WideReverse<16>(value);
+}
+
+/// @brief [17,32]-bit selector
+template <class T>
+inline constexpr EnableIf<All<
+    IsUnsigned<T>, BitRange<T, 17, 32>>,
+T> Reverse(T value) {
+  return version::WideReverse<32>(value);
+}
+
+/// @brief [33,64]-bit selector
+template <class T>
+inline constexpr EnableIf<All<
+    IsUnsigned<T>, BitRange<T, 33, 64>>,
+T> Reverse(T value) {
+  return version::WideReverse<64>(value);
+}
+
+#else
+// Lookup table Reverse
+
 /// @brief [0,8]-bit selector
 template <class T>
 inline constexpr EnableIf<All<
-    std::is_unsigned<T>, BitRange<T, 0, 8>>,
+    IsUnsigned<T>, BitRange<T, 0, 8>>,
 T> Reverse(T value) {
   return version::Reverse<8>(value);
 }
@@ -96,7 +192,7 @@ T> Reverse(T value) {
 /// @brief [9,16]-bit selector
 template <class T>
 inline constexpr EnableIf<All<
-    std::is_unsigned<T>, BitRange<T, 9, 16>>,
+    IsUnsigned<T>, BitRange<T, 9, 16>>,
 T> Reverse(T value) {
   return version::Reverse<16>(value);
 }
@@ -104,7 +200,7 @@ T> Reverse(T value) {
 /// @brief [17,32]-bit selector
 template <class T>
 inline constexpr EnableIf<All<
-    std::is_unsigned<T>, BitRange<T, 17, 32>>,
+    IsUnsigned<T>, BitRange<T, 17, 32>>,
 T> Reverse(T value) {
   return version::Reverse<32>(value);
 }
@@ -112,20 +208,69 @@ T> Reverse(T value) {
 /// @brief [33,64]-bit selector
 template <class T>
 inline constexpr EnableIf<All<
-    std::is_unsigned<T>, BitRange<T, 33, 64>>,
+    IsUnsigned<T>, BitRange<T, 33, 64>>,
 T> Reverse(T value) {
   return version::Reverse<64>(value);
 }
 
+#endif
+
+#if defined(NX_HAS_INT128)
+/// @brief [65,128]-bit selector; swaps the reversed 64-bit halves.
+template <class T>
+inline constexpr EnableIf<All<
+    IsUnsigned<T>, BitRange<T, 65, 128>>,
+T> Reverse(T value) {
+  return static_cast<T>(Reverse(static_cast<uint64_t>(value))) << 64
+      | Reverse(static_cast<uint64_t>(value >> 64));
+}
+#endif
+
 /// @brief signed-value converter
 template <class T>
 inline constexpr EnableIf<
-    std::is_signed<T>,
+    IsSigned<T>,
 T> Reverse(T value) {
-  typedef typename std::make_unsigned<T>::type UT;
+  typedef Invoke<MakeUnsigned<T>> UT;
   return Reverse(static_cast<UT>(value));
 }
 
+/// @brief The implementations available for reversing the bits of arrays.
+enum class ReverseBitsKernel {
+  /// @brief One Reverse() call per element.
+  kScalar,
+  /// @brief Nibble lookups with SSSE3 pshufb, 16 bytes at a time.
+  kSsse3,
+  /// @brief Nibble lookups with AVX2 vpshufb, 32 bytes at a time.
+  kAvx2
+};
+
+/// @brief Determines if the running processor can execute the given kernel.
+bool ReverseBitsSupported(ReverseBitsKernel kernel);
+
+/// @brief Reverses the bits of each element of an array using the given
+/// kernel, which must be supported by the running processor.
+///
+/// @param kernel The implementation to use.
+/// @param source The elements to reverse.
+/// @param destination Where to store the results; may equal source.
+/// @param length The number of elements.
+/// @param element_size The size of each element: 1, 2, 4 or 8 bytes.
+void ReverseBitsBuffer(
+    ReverseBitsKernel kernel, const void*source, void*destination,
+    size_t length, unsigned int element_size);
+
+/// @brief Reverses the bits of each element of an array using the fastest
+/// kernel supported by the running processor.
+void ReverseBitsBuffer(
+    const void*source, void*destination,
+    size_t length, unsigned int element_size);
+
+/// @brief Reverses the order of the lowest `bits` bits of a value.
+inline uint64_t ReverseLow(uint64_t value, unsigned int bits) {
+  return bits ? Reverse(value) >> (BitSize<uint64_t>::value - bits) : 0;
+}
+
 }  // namespace detail
 /// @endcond
 
@@ -140,6 +285,76 @@ constexpr T Reverse(T value) {
   return detail::Reverse(value);
 }
 
+/// @brief Reverses the bits of each element of an array.
+///
+/// @tparam T The type of the array elements.
+/// @param source The elements to reverse.
+/// @param destination Where to store the reversed elements; may be the same
+/// array as source, but must not otherwise overlap it.
+/// @param length The number of elements.
+template <class T>
+inline EnableIf<All<
+    IsIntegral<T>, BitRange<T, 0, 64>>,
+void> ReverseBits(const T*source, T*destination, size_t length) {
+  detail::ReverseBitsBuffer(source, destination, length, sizeof(T));
+}
+
+/// @brief Reverses the bits of each element of an array in place.
+///
+/// @tparam T The type of the array elements.
+/// @param data The elements to reverse.
+/// @param length The number of elements.
+template <class T>
+inline EnableIf<All<
+    IsIntegral<T>, BitRange<T, 0, 64>>,
+void> ReverseBits(T*data, size_t length) {
+  detail::ReverseBitsBuffer(data, data, length, sizeof(T));
+}
+
+/// @brief Stores each element of an array at the index formed by reversing
+/// the bits of its own index.
+/// @details The index is split into high, middle and low parts, the high and
+/// low parts covering a tile small enough for the L1 cache.  For each middle
+/// part, the tile is read in rows into a buffer under reversed high parts,
+/// then written out in rows under reversed low parts, so both the reads and
+/// the writes are sequential runs instead of a stride of half the array.
+///
+/// @tparam T The type of the array elements.
+/// @param source The array to permute, of 2^log2_length elements.
+/// @param destination Where to store the permuted array; must not overlap
+/// source.
+/// @param log2_length The base-2 logarithm of the number of elements.
+template <class T>
+void BitReversalPermutation(
+    const T*source, T*destination, unsigned int log2_length) {
+  // Tiles of 2^(2*tile_bits) elements, up to 8KiB.
+  constexpr unsigned int kMaxTileBits = sizeof(T) <= 8 ? 5 : 4;
+  const unsigned int tile_bits =
+      log2_length / 2 < kMaxTileBits ? log2_length / 2 : kMaxTileBits;
+  const unsigned int middle_bits = log2_length - 2 * tile_bits;
+  const size_t tile = static_cast<size_t>(1) << tile_bits;
+  const size_t middle_count = static_cast<size_t>(1) << middle_bits;
+  std::vector<T> buffer(tile * tile);
+  for (size_t middle = 0; middle < middle_count; ++middle) {
+    const size_t reversed_middle = detail::ReverseLow(middle, middle_bits);
+    for (size_t high = 0; high < tile; ++high) {
+      const T*row = source + (((high << middle_bits) | middle) << tile_bits);
+      T*buffer_row = &buffer[detail::ReverseLow(high, tile_bits) * tile];
+      for (size_t low = 0; low < tile; ++low) {
+        buffer_row[low] = row[low];
+      }
+    }
+    for (size_t low = 0; low < tile; ++low) {
+      T*row = destination + ((
+          (detail::ReverseLow(low, tile_bits) << middle_bits)
+          | reversed_middle) << tile_bits);
+      for (size_t high = 0; high < tile; ++high) {
+        row[high] = buffer[high * tile + low];
+      }
+    }
+  }
+}
+
 }  // namespace nx
 
 #endif  // INCLUDE_NX_REVERSE_H_
@@ -0,0 +1,204 @@
+//
+// Copyright (C) 2013 Jacob McIntosh <nacitar at ubercpp dot com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+/// @file set_bits.h
+/// @brief Provides iteration over the indices of the set bits of integral
+/// values and arrays of them.
+/// @details Iteration repeatedly takes BitScanForward() of the value and
+/// clears its lowest set bit with x & (x - 1).  Runs of zero words in arrays
+/// are skipped with vector compares, which is implemented in set_bits.cc.
+
+#ifndef INCLUDE_NX_SET_BITS_H_
+#define INCLUDE_NX_SET_BITS_H_
+
+#include <iterator>
+
+#include "nx/core.h"
+#include "nx/bit_scan_forward.h"
+
+/// @brief Library namespace.
+namespace nx {
+
+/// @cond nx_detail
+namespace detail {
+
+/// @brief Finds the first non-zero byte of a buffer, using vector compares
+/// where the running processor supports them.
+///
+/// @return The offset of the byte, or bytes if all bytes are zero.
+size_t FindNonZeroByte(const void*data, size_t bytes);
+
+}  // namespace detail
+/// @endcond
+
+/// @brief An input iterator over the indices of the set bits of a value, from
+/// least to most significant.
+template <class T>
+class SetBitIterator {
+ public:
+  /// @brief The iterator category.
+  typedef std::input_iterator_tag iterator_category;
+  /// @brief The type of the bit indices.
+  typedef unsigned int value_type;
+  /// @brief The type of the distance between iterators.
+  typedef std::ptrdiff_t difference_type;
+  /// @brief Indices are produced, not referenced.
+  typedef const unsigned int* pointer;
+  /// @brief Indices are produced, not referenced.
+  typedef unsigned int reference;
+
+  /// @brief The unsigned version of T.
+  typedef Invoke<std::make_unsigned<T>> bits_type;
+
+  /// @brief Constructs an iterator over the set bits of the given value.
+  explicit constexpr SetBitIterator(T bits = 0)
+      : bits_(static_cast<bits_type>(bits)) {
+  }
+
+  /// @brief The index of the current (lowest remaining) set bit.
+  constexpr unsigned int operator*() const {
+    return BitScanForward(bits_);
+  }
+
+  /// @brief Advances by clearing the lowest set bit.
+  SetBitIterator& operator++() {
+    bits_ &= static_cast<bits_type>(bits_ - 1);
+    return *this;
+  }
+
+  /// @brief Advances by clearing the lowest set bit.
+  SetBitIterator operator++(int) {
+    SetBitIterator previous(*this);
+    ++*this;
+    return previous;
+  }
+
+  /// @brief Iterators are equal if they have the same remaining bits.
+  constexpr bool operator==(const SetBitIterator&other) const {
+    return bits_ == other.bits_;
+  }
+
+  /// @brief Iterators are equal if they have the same remaining bits.
+  constexpr bool operator!=(const SetBitIterator&other) const {
+    return bits_ != other.bits_;
+  }
+
+ private:
+  /// @brief The set bits not yet visited.
+  bits_type bits_;
+};
+
+/// @brief A range over the indices of the set bits of a value, for use with
+/// range-based for loops.
+template <class T>
+class SetBitRange {
+ public:
+  /// @brief The iterator type.
+  typedef SetBitIterator<T> iterator;
+
+  /// @brief Constructs a range over the set bits of the given value.
+  explicit constexpr SetBitRange(T bits) : bits_(bits) {
+  }
+
+  /// @brief An iterator at the lowest set bit.
+  constexpr iterator begin() const {
+    return iterator(bits_);
+  }
+
+  /// @brief An iterator past the highest set bit.
+  constexpr iterator end() const {
+    return iterator();
+  }
+
+ private:
+  /// @brief The value whose set bits are iterated.
+  T bits_;
+};
+
+/// @brief Provides a range over the indices of the set bits of a value.
+/// @code for (unsigned int index : nx::SetBits(word)) { ... } @endcode
+///
+/// @tparam T The type of the passed value.
+/// @param bits The value to examine.
+///
+/// @return A range yielding the index of each set bit, least significant
+/// first.
+template <class T>
+constexpr EnableIf<
+    std::is_integral<T>,
+SetBitRange<T>> SetBits(T bits) {
+  return SetBitRange<T>(bits);
+}
+
+/// @brief Calls a function with the index of each set bit of an array,
+/// treating the array as one contiguous bit string with element 0 holding
+/// the least significant bits.
+///
+/// @tparam T The type of the array elements.
+/// @tparam Function A callable accepting a size_t.
+/// @param words The first element of the array.
+/// @param length The number of elements in the array.
+/// @param function Called with the index of each set bit, in increasing
+/// order.
+template <class T, class Function>
+EnableIf<
+    std::is_integral<T>,
+void> ForEachSetBit(const T*words, size_t length, Function function) {
+  typedef Invoke<std::make_unsigned<T>> UT;
+  // Check a few words inline before handing longer runs of zeros to the
+  // vectorized search.
+  constexpr size_t kInlineZeros = 4;
+  size_t zeros = 0;
+  for (size_t i = 0; i < length; ++i) {
+    UT bits = static_cast<UT>(words[i]);
+    if (!bits) {
+      if (++zeros == kInlineZeros) {
+        zeros = 0;
+        const size_t skipped = detail::FindNonZeroByte(
+            words + i + 1, (length - i - 1) * sizeof(T)) / sizeof(T);
+        i += skipped;
+      }
+      continue;
+    }
+    zeros = 0;
+    const size_t base = i * BitSize<T>::value;
+    do {
+      function(base + BitScanForward(bits));
+      bits &= static_cast<UT>(bits - 1);
+    } while (bits);
+  }
+}
+
+/// @brief Calls a function with the index of each set bit of an array.
+///
+/// @tparam T The type of the array elements.
+/// @tparam kLength The number of elements in the array.
+/// @tparam Function A callable accepting a size_t.
+/// @param words The array to examine.
+/// @param function Called with the index of each set bit, in increasing
+/// order.
+/// @see ForEachSetBit(const T*,size_t,Function)
+template <class T, size_t kLength, class Function>
+inline EnableIf<
+    std::is_integral<T>,
+void> ForEachSetBit(const T (&words)[kLength], Function function) {
+  ForEachSetBit(words, kLength, function);
+}
+
+}  // namespace nx
+
+#endif  // INCLUDE_NX_SET_BITS_H_
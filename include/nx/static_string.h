@@ -0,0 +1,172 @@
+//
+// Copyright (C) 2013 Jacob McIntosh <nacitar at ubercpp dot com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+/// @file static_string.h
+/// @brief Provides strings built entirely at compile time, such as the text
+/// of integral constants and their concatenations.
+/// @details A StaticString declared constexpr is a constant initialized
+/// array, so it is placed in read-only data rather than formatted during
+/// startup: @code
+/// constexpr auto kPath = nx::MakeStaticString("/v") +
+///     nx::ToStaticString<int, kVersion>();
+/// @endcode
+
+#ifndef INCLUDE_NX_STATIC_STRING_H_
+#define INCLUDE_NX_STATIC_STRING_H_
+
+#include "nx/core.h"
+#include "nx/digits.h"
+
+/// @brief Library namespace.
+namespace nx {
+
+/// @brief A null-terminated string of fixed length that can be built and
+/// concatenated in constant expressions.
+///
+/// @tparam kLength The number of characters, excluding the terminator.
+template <unsigned int kLength>
+class StaticString {
+ public:
+  /// @brief Copies a string literal of the same length.
+  explicit constexpr StaticString(const char (&text)[kLength + 1])
+      : StaticString(text, MakeIndexSequence<kLength>()) {
+  }
+
+  /// @brief Constructs from the given characters, which must number kLength.
+  template <class... Chars>
+  explicit constexpr StaticString(Chars... chars)
+      : data_{chars..., '\0'} {
+    static_assert(sizeof...(Chars) == kLength,
+                  "the characters must number kLength");
+  }
+
+  /// @brief Provides the number of characters, excluding the terminator.
+  static constexpr unsigned int size() {
+    return kLength;
+  }
+
+  /// @brief Provides the null-terminated characters.
+  constexpr const char*c_str() const {
+    return data_;
+  }
+
+  /// @brief Provides the character at the given index; the index kLength
+  /// holds the terminator.
+  constexpr char operator[](unsigned int index) const {
+    return data_[index];
+  }
+
+  /// @brief Provides this string followed by another.
+  template <unsigned int kOtherLength>
+  constexpr StaticString<kLength + kOtherLength> operator+(
+      const StaticString<kOtherLength>&other) const {
+    return Concatenate(other, MakeIndexSequence<kLength>(),
+                       MakeIndexSequence<kOtherLength>());
+  }
+
+ private:
+  template <unsigned int... kIndices>
+  constexpr StaticString(const char (&text)[kLength + 1],
+                         IndexSequence<kIndices...>)
+      : data_{text[kIndices]..., '\0'} {
+  }
+
+  template <unsigned int kOtherLength, unsigned int... kIndices,
+            unsigned int... kOtherIndices>
+  constexpr StaticString<kLength + kOtherLength> Concatenate(
+      const StaticString<kOtherLength>&other, IndexSequence<kIndices...>,
+      IndexSequence<kOtherIndices...>) const {
+    return StaticString<kLength + kOtherLength>(
+        data_[kIndices]..., other[kOtherIndices]...);
+  }
+
+  /// @brief The characters, followed by the terminator.
+  char data_[kLength + 1];
+};
+
+/// @brief Provides a StaticString copy of a string literal.
+template <unsigned int kSize>
+constexpr StaticString<kSize - 1> MakeStaticString(const char (&text)[kSize]) {
+  return StaticString<kSize - 1>(text);
+}
+
+/// @cond nx_detail
+namespace detail {
+
+/// @brief Provides the digit of a value the given number of places from the
+/// least significant one.
+template <class T>
+constexpr unsigned int DigitAt(T value, unsigned int number_base,
+                               unsigned int place) {
+  return place ? DigitAt(static_cast<T>(value / number_base), number_base,
+                         place - 1)
+      : static_cast<unsigned int>(value % number_base);
+}
+
+/// @brief Provides the magnitude of a value as its unsigned type.
+template <class T>
+constexpr Invoke<MakeUnsigned<T>> Magnitude(T value) {
+  return value < 0 ? -static_cast<Invoke<MakeUnsigned<T>>>(value)
+      : static_cast<Invoke<MakeUnsigned<T>>>(value);
+}
+
+/// @brief The number of characters of the text of an integral constant.
+template <class T, T kValue, unsigned int number_base>
+class IntegerTextLength : public UInt<
+    (kValue < 0) + Digits<number_base>(kValue)> {
+};
+
+/// @brief Provides the character at the given index of the text of an
+/// integral constant.
+template <class T, T kValue, unsigned int number_base, LetterCase letter_case>
+constexpr char IntegerTextChar(unsigned int index) {
+  return (kValue < 0 && !index) ? '-'
+      : DigitChar(DigitAt(Magnitude(kValue), number_base,
+          IntegerTextLength<T, kValue, number_base>::value - 1 - index),
+          letter_case);
+}
+
+/// @brief Builds the text of an integral constant a character per index.
+template <class T, T kValue, unsigned int number_base, LetterCase letter_case,
+          unsigned int... kIndices>
+constexpr StaticString<sizeof...(kIndices)> ToStaticString(
+    IndexSequence<kIndices...>) {
+  return StaticString<sizeof...(kIndices)>(
+      IntegerTextChar<T, kValue, number_base, letter_case>(kIndices)...);
+}
+
+}  // namespace detail
+/// @endcond
+
+/// @brief Provides the text of an integral constant as a StaticString, as
+/// ToString() would write it.
+///
+/// @tparam T The type of the constant.
+/// @tparam kValue The constant; e.g. a Power<> result or an _nx_b literal.
+/// @tparam number_base The base to write the value in: 2, 8, 10 or 16.
+/// @tparam letter_case The case of the base 16 digits above 9.
+template <class T, T kValue, unsigned int number_base = 10,
+          LetterCase letter_case = LetterCase::kLower>
+constexpr StaticString<detail::IntegerTextLength<
+    T, kValue, number_base>::value> ToStaticString() {
+  return detail::ToStaticString<T, kValue, number_base, letter_case>(
+      MakeIndexSequence<detail::IntegerTextLength<
+          T, kValue, number_base>::value>());
+}
+
+}  // namespace nx
+
+#endif  // INCLUDE_NX_STATIC_STRING_H_
@@ -0,0 +1,183 @@
+//
+// Copyright (C) 2013 Jacob McIntosh <nacitar at ubercpp dot com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+/// @file swar.h
+/// @brief Provides table-free implementations of the bit manipulation
+/// functions, using SIMD-within-a-register arithmetic on whole words.
+/// @details The generic fallbacks of population_count.h, bit_scan_forward.h,
+/// bit_scan_reverse.h and reverse.h index 8-bit lookup tables in constant.h.
+/// If you define NX_USE_SWAR, they use these functions instead, which trade
+/// a few more arithmetic instructions for no loads; which is faster depends
+/// on the processor and on how much of L1 the caller needs for itself.  The
+/// swar_benchmark executable compares the two.
+
+#ifndef INCLUDE_NX_SWAR_H_
+#define INCLUDE_NX_SWAR_H_
+
+#include "nx/core.h"
+
+/// @brief Library namespace.
+namespace nx {
+
+// Enable this define to use these functions in the generic fallbacks.
+// #define NX_USE_SWAR
+
+/// @brief Table-free bit manipulation.
+namespace swar {
+
+/// @cond nx_detail
+namespace detail {
+
+/// @brief Sums the bit counts of the bytes of a 32-bit word.
+constexpr unsigned int SumBytes(uint32_t value) {
+  return static_cast<unsigned int>(
+      ((value + (value >> 4)) & 0x0f0f0f0fu) * 0x01010101u >> 24);
+}
+
+/// @brief Sums the bit counts of the bytes of a 64-bit word.
+constexpr unsigned int SumBytes(uint64_t value) {
+  return static_cast<unsigned int>(
+      ((value + (value >> 4)) & 0x0f0f0f0f0f0f0f0full)
+      * 0x0101010101010101ull >> 56);
+}
+
+/// @brief Counts the bits of each 2-bit field, then of each 4-bit field.
+template <class T>
+constexpr T CountNibbles(T pairs, T mask) {
+  return static_cast<T>((pairs & mask) + ((pairs >> 2) & mask));
+}
+
+/// @brief Sets every bit below the highest set bit, halving the distance
+/// covered by each remaining step.
+template <class T>
+constexpr T Smear(T value, unsigned int shift) {
+  return shift ? Smear(static_cast<T>(value | value >> shift), shift / 2)
+               : value;
+}
+
+/// @brief Swaps the fields selected by mask with the fields shift bits above
+/// them.
+template <class T>
+constexpr T SwapFields(T value, unsigned int shift, T mask) {
+  return static_cast<T>(((value >> shift) & mask) | ((value & mask) << shift));
+}
+
+constexpr unsigned int PopulationCount32(uint32_t value) {
+  return SumBytes(CountNibbles<uint32_t>(
+      value - ((value >> 1) & 0x55555555u), 0x33333333u));
+}
+
+constexpr unsigned int PopulationCount64(uint64_t value) {
+  return SumBytes(CountNibbles<uint64_t>(
+      value - ((value >> 1) & 0x5555555555555555ull),
+      0x3333333333333333ull));
+}
+
+constexpr uint32_t Reverse32(uint32_t value) {
+  return SwapFields<uint32_t>(SwapFields<uint32_t>(SwapFields<uint32_t>(
+      SwapFields<uint32_t>(SwapFields<uint32_t>(
+      value,
+      1, 0x55555555u),
+      2, 0x33333333u),
+      4, 0x0f0f0f0fu),
+      8, 0x00ff00ffu),
+      16, 0x0000ffffu);
+}
+
+constexpr uint64_t Reverse64(uint64_t value) {
+  return SwapFields<uint64_t>(SwapFields<uint64_t>(SwapFields<uint64_t>(
+      SwapFields<uint64_t>(SwapFields<uint64_t>(SwapFields<uint64_t>(
+      value,
+      1, 0x5555555555555555ull),
+      2, 0x3333333333333333ull),
+      4, 0x0f0f0f0f0f0f0f0full),
+      8, 0x00ff00ff00ff00ffull),
+      16, 0x0000ffff0000ffffull),
+      32, 0x00000000ffffffffull);
+}
+
+}  // namespace detail
+/// @endcond
+
+/// @brief [0,32]-bit version
+template <class T>
+inline constexpr EnableIf<All<
+    std::is_integral<T>, BitRange<T, 0, 32>>,
+unsigned int> PopulationCount(T value) {
+  return detail::PopulationCount32(
+      static_cast<Invoke<std::make_unsigned<T>>>(value));
+}
+
+/// @brief [33,64]-bit version
+template <class T>
+inline constexpr EnableIf<All<
+    std::is_integral<T>, BitRange<T, 33, 64>>,
+unsigned int> PopulationCount(T value) {
+  return detail::PopulationCount64(
+      static_cast<Invoke<std::make_unsigned<T>>>(value));
+}
+
+/// @brief Finds the index of the least significant set bit by counting the
+/// bits below it.
+///
+/// @return The index, or 0 if the value is 0.
+template <class T>
+inline constexpr EnableIf<All<
+    std::is_integral<T>, BitRange<T, 0, 64>>,
+unsigned int> BitScanForward(T value) {
+  typedef Invoke<std::make_unsigned<T>> UT;
+  return value ? PopulationCount(static_cast<UT>(
+      (static_cast<UT>(value) & static_cast<UT>(~static_cast<UT>(value) + 1))
+      - 1)) : 0;
+}
+
+/// @brief Finds the index of the most significant set bit by setting all
+/// bits below it and counting them.
+///
+/// @return The index, or 0 if the value is 0.
+template <class T>
+inline constexpr EnableIf<All<
+    std::is_integral<T>, BitRange<T, 0, 64>>,
+unsigned int> BitScanReverse(T value) {
+  typedef Invoke<std::make_unsigned<T>> UT;
+  return value ? PopulationCount(detail::Smear(
+      static_cast<UT>(value), BitSize<UT>::value / 2)) - 1 : 0;
+}
+
+/// @brief [0,32]-bit version
+template <class T>
+inline constexpr EnableIf<All<
+    std::is_integral<T>, BitRange<T, 0, 32>>,
+T> Reverse(T value) {
+  return static_cast<T>(detail::Reverse32(static_cast<uint32_t>(
+      static_cast<Invoke<std::make_unsigned<T>>>(value)))
+      >> (32 - BitSize<T>::value));
+}
+
+/// @brief [33,64]-bit version
+template <class T>
+inline constexpr EnableIf<All<
+    std::is_integral<T>, BitRange<T, 33, 64>>,
+T> Reverse(T value) {
+  return static_cast<T>(detail::Reverse64(static_cast<uint64_t>(value)));
+}
+
+}  // namespace swar
+
+}  // namespace nx
+
+#endif  // INCLUDE_NX_SWAR_H_
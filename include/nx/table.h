@@ -0,0 +1,143 @@
+//
+// Copyright (C) 2013 Jacob McIntosh <nacitar at ubercpp dot com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+/// @file table.h
+/// @brief Provides lookup tables generated entirely at compile time.
+/// @details A Table declared constexpr is a constant initialized array, so it
+/// is placed in read-only data, and every Table starts on its own cache line:
+/// @code
+/// constexpr uint_least8_t Square(unsigned int index) {
+///   return static_cast<uint_least8_t>(index * index);
+/// }
+/// constexpr auto kSquares = nx::MakeTable<16>(Square);
+/// static_assert(kSquares[3] == 9, "generated at compile time");
+/// @endcode
+/// The generator is called with each index in turn, so it must be usable in
+/// constant expressions; a constexpr function or a literal class with a
+/// constexpr call operator.
+
+#ifndef INCLUDE_NX_TABLE_H_
+#define INCLUDE_NX_TABLE_H_
+
+#include <utility>
+#include "nx/core.h"
+
+/// @brief Library namespace.
+namespace nx {
+
+/// @brief The alignment of every Table, which is the size of a cache line.
+constexpr const size_t kTableAlignment = 64;
+
+/// @brief A fixed-size array of values, aligned to a cache line, that can be
+/// generated in constant expressions.
+///
+/// @tparam T The type of the values.
+/// @tparam kSize The number of values.
+template <class T, unsigned int kSize>
+class alignas(kTableAlignment) Table {
+ public:
+  /// @brief The type of the values.
+  typedef T value_type;
+
+  /// @brief Sets each value to the result of calling the generator with its
+  /// index.
+  template <class Generator>
+  explicit constexpr Table(Generator generator)
+      : Table(generator, MakeIndexSequence<kSize>()) {
+  }
+
+  /// @brief Provides the number of values.
+  static constexpr unsigned int size() {
+    return kSize;
+  }
+
+  /// @brief Provides the values.
+  constexpr const T*data() const {
+    return values_;
+  }
+
+  /// @brief Provides the value at the given index, which must be less than
+  /// kSize.
+  constexpr const T&operator[](size_t index) const {
+    return values_[index];
+  }
+
+  /// @brief Provides the first value, for range-based for loops.
+  constexpr const T*begin() const {
+    return values_;
+  }
+
+  /// @brief Provides one past the last value, for range-based for loops.
+  constexpr const T*end() const {
+    return values_ + kSize;
+  }
+
+ private:
+  template <class Generator, unsigned int... kIndices>
+  constexpr Table(Generator generator, IndexSequence<kIndices...>)
+      : values_{static_cast<T>(generator(kIndices))...} {
+  }
+
+  T values_[kSize];
+};
+
+/// @brief Generates a Table of the values the generator returns for each
+/// index below kSize.
+///
+/// @tparam kSize The number of values.
+/// @param generator Called with each index as an unsigned int; usable in
+/// constant expressions.
+///
+/// @return The generated table, whose values have the generator's return
+/// type.
+template <unsigned int kSize, class Generator>
+constexpr Table<
+    Invoke<std::decay<decltype(std::declval<Generator>()(0u))>>, kSize>
+MakeTable(Generator generator) {
+  return Table<
+      Invoke<std::decay<decltype(std::declval<Generator>()(0u))>>, kSize>(
+          generator);
+}
+
+/// @brief Provides a Table generated from a generator type, which exists once
+/// in the program however many translation units use it, and is only
+/// generated by those that do.
+/// @details This suits large tables, such as those indexed with 16-bit
+/// values, that would be costly to compile or to duplicate: @code
+/// typedef nx::StaticTable<SquareGenerator, 65536> squares;
+/// uint32_t square = squares::value[index];
+/// @endcode
+///
+/// @tparam Generator A literal class whose constexpr call operator is called
+/// with each index as an unsigned int.
+/// @tparam kSize The number of values.
+template <class Generator, unsigned int kSize>
+class StaticTable {
+ public:
+  /// @brief The type of the table.
+  typedef decltype(MakeTable<kSize>(Generator())) type;
+
+  /// @brief The table itself.
+  static constexpr type value = MakeTable<kSize>(Generator());
+};
+
+template <class Generator, unsigned int kSize>
+constexpr typename StaticTable<Generator, kSize>::type
+StaticTable<Generator, kSize>::value;
+
+}  // namespace nx
+
+#endif  // INCLUDE_NX_TABLE_H_
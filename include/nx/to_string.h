@@ -15,13 +15,23 @@
 //
 
 /// @file to_string.h
-/// @brief Functions to convert integral values into strings.
+/// @brief Functions to convert integral and floating-point values into
+/// strings.
+/// @details The array overload of ToString() selects an SSE4.1 or AVX2
+/// kernel at runtime, and ToHex() an SSSE3 or AVX2 one; they and the
+/// floating-point conversion are implemented in to_string.cc.
 
 #ifndef INCLUDE_NX_TO_STRING_H_
 #define INCLUDE_NX_TO_STRING_H_
 
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
 #include <string>
+#include <vector>
 #include "nx/core.h"
+#include "nx/byte_order.h"
+#include "nx/constant.h"
 #include "nx/digits.h"
 
 /// @brief Library namespace.
@@ -30,42 +40,149 @@ namespace nx {
 /// @cond nx_detail
 namespace detail {
 
+/// @brief Writes the two digits of a value below 100.
+inline void WriteDigitPair(uint_fast32_t value, char*buffer) {
+  std::memcpy(buffer, constant::decimal_digit_pairs.data() + value * 2, 2);
+}
+
+/// @brief Writes all 8 digits of a value below 10^8.
+/// @details The halves are split apart first so that the two pairs of each
+/// are independent; every division is by a constant, which compiles to a
+/// multiply and shift.
+inline void WriteDigits8(uint_fast32_t value, char*buffer) {
+  const uint_fast32_t high = value / 10000;
+  const uint_fast32_t low = value % 10000;
+  WriteDigitPair(high / 100, buffer);
+  WriteDigitPair(high % 100, buffer + 2);
+  WriteDigitPair(low / 100, buffer + 4);
+  WriteDigitPair(low % 100, buffer + 6);
+}
+
+/// @brief Writes the given number of least significant digits of a value
+/// below 10^8, zero-padding if it has fewer.
+inline void WriteDigits(uint_fast32_t value, char*buffer, unsigned int count) {
+  if (count == 8) {
+    WriteDigits8(value, buffer);
+    return;
+  }
+  buffer += count;
+  for (; count >= 2; count -= 2) {
+    buffer -= 2;
+    WriteDigitPair(value % 100, buffer);
+    value /= 100;
+  }
+  if (count) {
+    *(--buffer) = static_cast<char>('0' + value % 10);
+  }
+}
+
 /// @brief Writes the ascii representation of an unsigned integral value into a
 /// provided C-style string.  Does not terminate the string.
+/// @details The value is split by 10^8 into chunks that are written two
+/// digits at a time from a table of digit pairs.
 template <class T>
-EnableIf<
-    std::is_unsigned<T>,
+EnableIf<All<
+    IsUnsigned<T>, BitRange<T, 0, 64>>,
 unsigned int> ToString(T value, char*buffer, unsigned int digits = 0) {
+  constexpr const uint_fast32_t chunk = Power<uint_fast32_t, 10, 8>::value;
+  constexpr const unsigned int chunk_digits = 8;
   // Calculate the number of digits if it wasn't provided.
   if (!digits) {
     digits = Digits<10>(value);
   }
-  // Point 1-past the last character
-  buffer += digits;
-  // Counter for digits.  Can't use digits; we must return that.
+  // generate whole chunks starting at the end of the buffer
+  uint64_t remaining_value = value;
   unsigned int count = digits;
-  // generate digits starting at the end of the buffer
-  while (count--) {
-    *(--buffer) = value % 10 + '0';  // get next digit
-    value /= 10;  // remove that digit
+  while (count > chunk_digits && remaining_value >= chunk) {
+    count -= chunk_digits;
+    const uint64_t next = remaining_value / chunk;
+    WriteDigits8(static_cast<uint_fast32_t>(remaining_value - next * chunk),
+        buffer + count);
+    remaining_value = next;
   }
+  // only the least significant digits are wanted if the count was too low
+  if (remaining_value >= chunk) {
+    remaining_value %= chunk;
+  }
+  WriteDigits(static_cast<uint_fast32_t>(remaining_value), buffer, count);
   // return number of digits
   return digits;
 }
 
+/// @brief Writes the ascii representation of an unsigned 128-bit value into a
+/// provided C-style string.  Does not terminate the string.
+/// @details The value is split by 10^19 into chunks converted by the 64-bit
+/// version, so at most two 128-bit divisions are made.
+template <class T>
+EnableIf<All<
+    IsUnsigned<T>, BitRange<T, 65, 128>>,
+unsigned int> ToString(T value, char*buffer, unsigned int digits = 0) {
+  constexpr const uint64_t chunk = Power<uint64_t, 10, 19>::value;
+  constexpr const unsigned int chunk_digits = 19;
+  if (!digits) {
+    digits = Digits<10>(value);
+  }
+  // generate whole chunks starting at the end of the buffer
+  unsigned int count = digits;
+  while (count > chunk_digits && value >= chunk) {
+    count -= chunk_digits;
+    const T next = value / chunk;
+    ToString(static_cast<uint64_t>(value - next * chunk), buffer + count,
+        chunk_digits);
+    value = next;
+  }
+  // only the least significant digits are wanted if the count was too low
+  if (value >= chunk) {
+    value %= chunk;
+  }
+  ToString(static_cast<uint64_t>(value), buffer, count);
+  return digits;
+}
+
+/// @brief Writes the ascii representation of a wide integer into a provided
+/// C-style string.  Does not terminate the string.
+/// @details The value is split by 10^19 into chunks converted by the 64-bit
+/// version, which also yields the number of digits.
+template <unsigned int kBits>
+unsigned int ToString(
+    WideUInt<kBits> value, char*buffer, unsigned int digits = 0) {
+  constexpr const uint64_t chunk = Power<uint64_t, 10, 19>::value;
+  constexpr const unsigned int chunk_digits = 19;
+  // split into chunks, least significant first
+  uint64_t chunks[kBits / 63 + 1];
+  unsigned int count = 0;
+  while (value >= chunk) {
+    chunks[count++] = value.DivideBy(chunk);
+  }
+  chunks[count] = static_cast<uint64_t>(value);
+  if (!digits) {
+    digits = count * chunk_digits + Digits<10>(chunks[count]);
+  }
+  // generate whole chunks starting at the end of the buffer
+  unsigned int remaining = digits;
+  unsigned int index = 0;
+  for (; index < count && remaining > chunk_digits; ++index) {
+    remaining -= chunk_digits;
+    ToString(chunks[index], buffer + remaining, chunk_digits);
+  }
+  ToString(chunks[index], buffer, remaining);
+  return digits;
+}
+
 /// @brief Writes the ascii representation of a signed integral value into a
 /// provided C-style string.  Does not terminate the string.
 template <class T>
-EnableIf<
-    std::is_signed<T>,
+EnableIf<All<
+    IsIntegral<T>, IsSigned<T>>,
 unsigned int> ToString(T value, char*buffer, unsigned int digits = 0) {
   // Unsigned T
-  typedef const typename std::make_unsigned<T>::type UT;
+  typedef const Invoke<MakeUnsigned<T>> UT;
   if (value < 0) {
     // add the -
     *buffer = '-';
     // adjust by 1 to account for the -
-    return ToString(static_cast<UT>(-value), buffer+1, digits)+1;
+    return ToString(
+        static_cast<UT>(-static_cast<UT>(value)), buffer+1, digits)+1;
   }
   // just pass it on to the unsigned version
   return ToString(static_cast<UT>(value), buffer, digits);
@@ -74,8 +191,8 @@ unsigned int> ToString(T value, char*buffer, unsigned int digits = 0) {
 /// @brief Appends the ascii representation of an unsigned integral value into
 /// a provided std::string.
 template <class T>
-inline EnableIf<
-    std::is_unsigned<T>,
+inline EnableIf<Any<
+    IsUnsigned<T>, IsWideUInt<T>>,
 unsigned int> ToString(T value, std::string*buffer, unsigned int digits = 0) {
   if (!digits) {
     digits = Digits<10>(value);
@@ -90,13 +207,13 @@ unsigned int> ToString(T value, std::string*buffer, unsigned int digits = 0) {
 /// @brief Appends the ascii representation of a signed integral value into a
 /// provided std::string.
 template <class T>
-EnableIf<
-    std::is_signed<T>,
+EnableIf<All<
+    IsIntegral<T>, IsSigned<T>>,
 unsigned int> ToString(T value, std::string*buffer, unsigned int digits = 0) {
   // Unsigned T
-  typedef const typename std::make_unsigned<T>::type UT;
+  typedef const Invoke<MakeUnsigned<T>> UT;
   if (value < 0) {
-    const UT abs_value = static_cast<UT>(-value);
+    const UT abs_value = static_cast<UT>(-static_cast<UT>(value));
     if (!digits) {
       digits = Digits<10>(abs_value);
     }
@@ -110,28 +227,242 @@ unsigned int> ToString(T value, std::string*buffer, unsigned int digits = 0) {
     // advance
     ++offset_buffer;
     // convert the number
-    return ToString(abs_value, offset_buffer, digits);
+    return ToString(abs_value, offset_buffer, digits) + 1;
   }
   // pass on to unsigned version
   return ToString(static_cast<UT>(value), buffer, digits);
 }
 
-/// @brief Converts an integral value into a std::string, returning it.
+/// @brief Converts the nibbles of a value, each spread into its own byte,
+/// into the ascii hexadecimal digits they represent.
+/// @details Adding 6 carries into bit 4 exactly for the nibbles above 9,
+/// which then get the distance from '9' + 1 to the first letter added.
+template <LetterCase letter_case>
+constexpr uint64_t HexFromNibbles(uint64_t nibbles) {
+  return nibbles + 0x3030303030303030ull +
+      ((nibbles + 0x0606060606060606ull) >> 4 & 0x0101010101010101ull) *
+      (letter_case == LetterCase::kUpper ? 'A' - '9' - 1 : 'a' - '9' - 1);
+}
+
+/// @brief Moves the upper half of each field of twice the shift to the lower
+/// half of the next one.
+constexpr uint64_t SwarSpread(uint64_t value, unsigned int shift,
+                              uint64_t mask) {
+  return (value | value << shift) & mask;
+}
+
+/// @brief Spreads the 8 nibbles of a 32-bit value into the bytes of a
+/// 64-bit one, the least significant first.
+constexpr uint64_t SpreadNibbles(uint64_t value) {
+  return SwarSpread(SwarSpread(SwarSpread(value, 16, 0x0000ffff0000ffffull),
+      8, 0x00ff00ff00ff00ffull), 4, 0x0f0f0f0f0f0f0f0full);
+}
+
+/// @brief Writes all 16 hexadecimal digits of a 64-bit value, converting
+/// each 32-bit half as a single word.
+template <LetterCase letter_case>
+inline void WriteHexWord(uint64_t value, char*buffer) {
+  const uint64_t high = BigEndianValue(
+      HexFromNibbles<letter_case>(SpreadNibbles(value >> 32)));
+  const uint64_t low = BigEndianValue(
+      HexFromNibbles<letter_case>(SpreadNibbles(value & 0xffffffffu)));
+  std::memcpy(buffer, &high, sizeof(high));
+  std::memcpy(buffer + sizeof(high), &low, sizeof(low));
+}
+
+/// @brief Writes the given number of least significant digits of a value in
+/// base 2 or 8, zero-padding if it has fewer.
+template <unsigned int number_base, LetterCase, class T>
+inline EnableIf<
+    Bool<number_base == 2 || number_base == 8>,
+void> WriteRadixDigits(T value, char*buffer, unsigned int count) {
+  for (; count; value >>= DigitBits<number_base>::value) {
+    buffer[--count] = static_cast<char>('0' + (value & (number_base - 1)));
+  }
+}
+
+/// @brief Writes the given number of least significant hexadecimal digits
+/// of a value of up to 64 bits, zero-padding if it has fewer.
+template <unsigned int number_base, LetterCase letter_case, class T>
+inline EnableIf<All<
+    Bool<number_base == 16>, BitRange<T, 0, 64>>,
+void> WriteRadixDigits(T value, char*buffer, unsigned int count) {
+  constexpr const unsigned int word_digits = 16;
+  char text[word_digits];
+  WriteHexWord<letter_case>(value, text);
+  if (count > word_digits) {
+    std::memset(buffer, '0', count - word_digits);
+    buffer += count - word_digits;
+    count = word_digits;
+  }
+  std::memcpy(buffer, text + word_digits - count, count);
+}
+
+/// @brief Writes the given number of least significant hexadecimal digits
+/// of a 128-bit value, a 64-bit half at a time.
+template <unsigned int number_base, LetterCase letter_case, class T>
+inline EnableIf<All<
+    Bool<number_base == 16>, BitRange<T, 65, 128>>,
+void> WriteRadixDigits(T value, char*buffer, unsigned int count) {
+  constexpr const unsigned int word_digits = 16;
+  if (count > word_digits) {
+    WriteRadixDigits<number_base, letter_case>(
+        static_cast<uint64_t>(value >> 64), buffer, count - word_digits);
+    buffer += count - word_digits;
+    count = word_digits;
+  }
+  WriteRadixDigits<number_base, letter_case>(
+      static_cast<uint64_t>(value), buffer, count);
+}
+
+/// @brief Writes the ascii representation of an unsigned integral value in
+/// base 2, 8 or 16 into a provided C-style string.  Does not terminate the
+/// string.
+template <unsigned int number_base, LetterCase letter_case, class T>
+EnableIf<All<
+    IsUnsigned<T>, Bool<DigitBits<number_base>::value != 0>,
+    BitRange<T, 0, 128>>,
+unsigned int> ToString(T value, char*buffer, unsigned int digits) {
+  if (!digits) {
+    digits = Digits<number_base>(value);
+  }
+  WriteRadixDigits<number_base, letter_case>(value, buffer, digits);
+  return digits;
+}
+
+/// @brief Writes the ascii representation of a signed integral value in base
+/// 2, 8 or 16 into a provided C-style string, as a - followed by its
+/// magnitude if it is negative.  Does not terminate the string.
+template <unsigned int number_base, LetterCase letter_case, class T>
+EnableIf<All<
+    IsIntegral<T>, IsSigned<T>, Bool<DigitBits<number_base>::value != 0>,
+    BitRange<T, 0, 128>>,
+unsigned int> ToString(T value, char*buffer, unsigned int digits) {
+  typedef const Invoke<MakeUnsigned<T>> UT;
+  if (value < 0) {
+    *buffer = '-';
+    return ToString<number_base, letter_case>(
+        static_cast<UT>(-static_cast<UT>(value)), buffer + 1, digits) + 1;
+  }
+  return ToString<number_base, letter_case>(
+      static_cast<UT>(value), buffer, digits);
+}
+
+/// @brief Appends the ascii representation of an integral value in base 2, 8
+/// or 16 into a provided std::string.
+template <unsigned int number_base, LetterCase letter_case, class T>
+EnableIf<All<
+    IsIntegral<T>, Bool<DigitBits<number_base>::value != 0>,
+    BitRange<T, 0, 128>>,
+unsigned int> ToString(T value, std::string*buffer, unsigned int digits) {
+  if (!digits) {
+    digits = Digits<number_base>(value);
+  }
+  const std::string::size_type offset = buffer->size();
+  // add the size of textual data and the -, if any
+  buffer->resize(offset + (value < 0) + digits);
+  return ToString<number_base, letter_case>(
+      value, &((*buffer)[offset]), digits);
+}
+
+/// @brief The most characters WriteShortest() writes: a sign, 17 digits, a
+/// decimal point and a three-digit exponent such as "e-308".
+constexpr unsigned int kShortestMaxLength = 24;
+
+/// @brief Writes the shortest decimal representation that reads back as the
+/// same double into a provided C-style string.  Does not terminate the string.
+/// @details The digits are found with the Schubfach algorithm; see
+/// to_string.cc.  The value is written in fixed notation when its decimal
+/// exponent is in [-4, 17), and otherwise in scientific notation with at
+/// least two exponent digits, as printf's %g does.  Infinities are written
+/// as "inf" or "-inf", and NaNs as "nan".
+unsigned int WriteShortest(double value, char*buffer);
+
+/// @brief Writes the shortest decimal representation that reads back as the
+/// same float into a provided C-style string.  Does not terminate the string.
+/// @see WriteShortest(double,char*)
+unsigned int WriteShortest(float value, char*buffer);
+
+/// @brief Writes a long double as the shortest representation of its value
+/// rounded to a double.
+inline unsigned int WriteShortest(long double value, char*buffer) {
+  return WriteShortest(static_cast<double>(value), buffer);
+}
+
+/// @brief Writes the shortest round-trip representation of a floating-point
+/// value into a provided C-style string.  Does not terminate the string.
+/// A long double is written as the double it rounds to.
+template <class T>
+inline EnableIf<
+    IsFloatingPoint<T>,
+unsigned int> ToString(T value, char*buffer, unsigned int = 0) {
+  return WriteShortest(value, buffer);
+}
+
+/// @brief Appends the shortest round-trip representation of a floating-point
+/// value into a provided std::string.  A long double is written as the
+/// double it rounds to.
 template <class T>
 inline EnableIf<
-    std::is_integral<T>,
+    IsFloatingPoint<T>,
+unsigned int> ToString(T value, std::string*buffer, unsigned int = 0) {
+  char text[kShortestMaxLength];
+  const unsigned int length = WriteShortest(value, text);
+  buffer->append(text, length);
+  return length;
+}
+
+/// @brief Base 10 forwarder; there are no letters to choose the case of.
+template <unsigned int number_base, LetterCase, class T>
+inline EnableIf<
+    Bool<number_base == 10>,
+unsigned int> ToString(T value, char*buffer, unsigned int digits) {
+  return detail::ToString(value, buffer, digits);
+}
+
+/// @brief Base 10 forwarder; there are no letters to choose the case of.
+template <unsigned int number_base, LetterCase, class T>
+inline EnableIf<
+    Bool<number_base == 10>,
+unsigned int> ToString(T value, std::string*buffer, unsigned int digits) {
+  return detail::ToString(value, buffer, digits);
+}
+
+/// @brief Converts an integral or floating-point value into a std::string,
+/// returning it.
+template <class T>
+inline EnableIf<Any<
+    IsIntegral<T>, IsWideUInt<T>, IsFloatingPoint<T>>,
 std::string> ToString(T value, unsigned int digits = 0) {
   std::string buffer;
-  ToString(value, &buffer, digits);
+  detail::ToString(value, &buffer, digits);
   return std::move(buffer);
 }
 
+/// @brief Converts an integral value into a std::string in the given base,
+/// returning it.
+template <unsigned int number_base, LetterCase letter_case, class T>
+inline std::string ToString(T value, unsigned int digits) {
+  std::string buffer;
+  detail::ToString<number_base, letter_case>(value, &buffer, digits);
+  return buffer;
+}
+
 }  // namespace detail
 /// @endcond
 
 /// @brief Writes a string representation of an integral value to the provided
 /// character buffer.
+/// @details Floating-point values are written as the shortest decimal that
+/// reads back as the same value, using at most detail::kShortestMaxLength
+/// characters; see detail::WriteShortest().  A long double is first
+/// rounded to a double, so its text reads back as that double, which need
+/// not equal the long double itself.  Integral values may also be
+/// written in base 2, 8 or 16, in which case negative values are written as
+/// a - followed by their magnitude, as FromString() reads them.
 ///
+/// @tparam number_base The base to write integral values in: 2, 8, 10 or 16.
+/// @tparam letter_case The case of the base 16 digits above 9.
 /// @tparam T The type of the passed value.
 /// @param value The value to process.
 /// @param buffer The location to write the string representation.
@@ -140,11 +471,13 @@ std::string> ToString(T value, unsigned int digits = 0) {
 /// least significant digits by treating it as having less.  Furthermore, this
 /// can be used to zero-pad your values by specifying a greater length.
 /// The default value (0) causes the function to determine the length for you.
+/// It is ignored for floating-point values.
 ///
 /// @return The number of characters written to the buffer.
-template <class T>
+template <unsigned int number_base = 10,
+          LetterCase letter_case = LetterCase::kLower, class T>
 unsigned int ToString(T value, char*buffer, unsigned int digits = 0) {
-  return detail::ToString(value, buffer, digits);
+  return detail::ToString<number_base, letter_case>(value, buffer, digits);
 }
 
 /// @brief Appends a string representation of an integral value to the provided
@@ -156,9 +489,10 @@ unsigned int ToString(T value, char*buffer, unsigned int digits = 0) {
 /// @see ToString(T,char*,unsigned int)
 ///
 /// @return The number of characters appended to the string.
-template <class T>
+template <unsigned int number_base = 10,
+          LetterCase letter_case = LetterCase::kLower, class T>
 unsigned int ToString(T value, std::string*buffer, unsigned int digits = 0) {
-  return detail::ToString(value, buffer, digits);
+  return detail::ToString<number_base, letter_case>(value, buffer, digits);
 }
 
 /// @brief Converts an integral value into a string representation.
@@ -166,9 +500,217 @@ unsigned int ToString(T value, std::string*buffer, unsigned int digits = 0) {
 /// @see ToString(T,char*,unsigned int)
 ///
 /// @return The string representation of the passed value.
-template <class T>
+template <unsigned int number_base = 10,
+          LetterCase letter_case = LetterCase::kLower, class T>
 std::string ToString(T value, unsigned int digits = 0) {
-  return detail::ToString(value, digits);
+  return detail::ToString<number_base, letter_case>(value, digits);
+}
+
+/// @brief The text delimiting the fields written by the array overload of
+/// ToString().
+struct FieldFormat {
+  /// @brief Uses the given null-terminated strings.
+  ///
+  /// @param separator_text Written between each field.
+  /// @param terminator_text Written after the last field.
+  FieldFormat(  // NOLINT(runtime/explicit)
+      const char*separator_text = ",", const char*terminator_text = "")
+      : separator(separator_text),
+        separator_length(std::strlen(separator_text)),
+        terminator(terminator_text),
+        terminator_length(std::strlen(terminator_text)) {
+  }
+
+  /// @brief Written between each field.
+  const char*separator;
+  /// @brief The length of separator.
+  size_t separator_length;
+  /// @brief Written after the last field.
+  const char*terminator;
+  /// @brief The length of terminator.
+  size_t terminator_length;
+};
+
+/// @cond nx_detail
+namespace detail {
+
+/// @brief The implementations available for converting arrays of integers.
+enum class ToStringKernel {
+  /// @brief One ToString() call per element.
+  kScalar,
+  /// @brief SSE4.1, converting 16 digits of one element at a time.
+  kSse41,
+  /// @brief AVX2, converting 16 digits of two elements at a time.
+  kAvx2
+};
+
+/// @brief The number of bytes past the end of their text that the kernels
+/// may overwrite.
+constexpr const size_t kToStringFieldsSlack = 16;
+
+/// @brief Determines if the running processor can execute the given kernel.
+bool ToStringSupported(ToStringKernel kernel);
+
+/// @brief Writes each element of an array followed by the separator, using
+/// the given kernel, which must be supported by the running processor.
+///
+/// @param kernel The implementation to use.
+/// @param values The elements to convert.
+/// @param length The number of elements.
+/// @param format Provides the separator; the terminator is not written.
+/// @param begin The start of the buffer, which offsets are relative to.
+/// @param out Where to write the text, including the separator after the
+/// last element, with kToStringFieldsSlack bytes to spare after it.
+/// @param offsets If not null, receives the offset of each element's text.
+///
+/// @return The end of the text written.
+char*ToStringFields(
+    ToStringKernel kernel, const uint64_t*values, size_t length,
+    const FieldFormat&format, const char*begin, char*out, size_t*offsets);
+
+/// @brief Signed version.
+char*ToStringFields(
+    ToStringKernel kernel, const int64_t*values, size_t length,
+    const FieldFormat&format, const char*begin, char*out, size_t*offsets);
+
+/// @brief Writes each element of an array followed by the separator, using
+/// the fastest kernel supported by the running processor.
+char*ToStringFields(
+    const uint64_t*values, size_t length,
+    const FieldFormat&format, const char*begin, char*out, size_t*offsets);
+
+/// @brief Signed version.
+char*ToStringFields(
+    const int64_t*values, size_t length,
+    const FieldFormat&format, const char*begin, char*out, size_t*offsets);
+
+}  // namespace detail
+/// @endcond
+
+/// @brief Appends the string representations of the elements of an array to
+/// the provided string, delimited as specified.
+/// @details The length of the text is determined up front, so the string is
+/// resized only once.
+///
+/// @tparam T The type of the array elements.
+/// @param values The elements to convert.
+/// @param length The number of elements.
+/// @param buffer A pointer to the output string buffer.
+/// @param format The separator written between the elements and the
+/// terminator written after them.
+/// @param offsets If not null, the offset into buffer of each element's text
+/// is appended to this.
+///
+/// @return The number of characters appended to the string.
+template <class T>
+EnableIf<All<
+    IsIntegral<T>, BitRange<T, 0, 64>>,
+size_t> ToString(const T*values, size_t length, std::string*buffer,
+                 const FieldFormat&format = FieldFormat(),
+                 std::vector<size_t>*offsets = nullptr) {
+  typedef Invoke<SetSigned<IsSigned<T>::value, uint64_t>> Element;
+  constexpr const size_t block_length = 256;
+  // size the text
+  size_t text_length = format.terminator_length;
+  for (size_t i = 0; i < length; ++i) {
+    text_length += (values[i] < 0) + Digits<10>(values[i]);
+  }
+  if (length) {
+    text_length += (length - 1) * format.separator_length;
+  }
+  const size_t offset = buffer->size();
+  // the kernels also write a separator after the last element, which the
+  // terminator then replaces, and may overwrite the slack after that
+  buffer->resize(offset + text_length + format.separator_length +
+                 detail::kToStringFieldsSlack);
+  size_t*field_offsets = nullptr;
+  if (offsets) {
+    offsets->resize(offsets->size() + length);
+    field_offsets = offsets->data() + offsets->size() - length;
+  }
+  // convert blocks of elements, widened to 64 bits
+  const char*begin = &(*buffer)[0];
+  char*out = &(*buffer)[offset];
+  Element block[block_length];
+  for (size_t i = 0; i < length; i += block_length) {
+    const size_t count = std::min(block_length, length - i);
+    std::copy(values + i, values + i + count, block);
+    out = detail::ToStringFields(block, count, format, begin, out,
+        field_offsets ? field_offsets + i : nullptr);
+  }
+  // the last separator is replaced by the terminator
+  if (length) {
+    out -= format.separator_length;
+  }
+  std::memcpy(out, format.terminator, format.terminator_length);
+  buffer->resize(offset + text_length);
+  return text_length;
+}
+
+/// @cond nx_detail
+namespace detail {
+
+/// @brief The implementations available for writing bytes as hexadecimal.
+enum class HexKernel {
+  /// @brief 8 bytes at a time within a 64-bit word.
+  kScalar,
+  /// @brief SSSE3 pshufb, 16 bytes at a time.
+  kSsse3,
+  /// @brief AVX2 vpshufb, 32 bytes at a time.
+  kAvx2
+};
+
+/// @brief Determines if the running processor can execute the given kernel.
+bool HexSupported(HexKernel kernel);
+
+/// @brief Writes two hexadecimal digits for each byte of a buffer using the
+/// given kernel, which must be supported by the running processor.
+///
+/// @param kernel The implementation to use.
+/// @param data The bytes to convert.
+/// @param length The number of bytes.
+/// @param buffer Where to write the 2 * length digits.
+/// @param letter_case The case of the digits above 9.
+void WriteHex(HexKernel kernel, const uint8_t*data, size_t length,
+              char*buffer, LetterCase letter_case);
+
+/// @brief Writes two hexadecimal digits for each byte of a buffer using the
+/// fastest kernel supported by the running processor.
+void WriteHex(const uint8_t*data, size_t length, char*buffer,
+              LetterCase letter_case);
+
+}  // namespace detail
+/// @endcond
+
+/// @brief Writes the bytes of a buffer as hexadecimal text, two digits per
+/// byte in the order they are stored; e.g. to print a hash or an identifier.
+/// @details Unlike ToString<16>(), which writes the value of an integer, this
+/// writes the bytes of a little-endian integer least significant first.
+///
+/// @param data The bytes to convert.
+/// @param length The number of bytes.
+/// @param buffer The location to write the text, which must have room for
+/// 2 * length characters.  It is not terminated.
+/// @param letter_case The case of the digits above 9.
+///
+/// @return The number of characters written to the buffer.
+inline size_t ToHex(const void*data, size_t length, char*buffer,
+                    LetterCase letter_case = LetterCase::kLower) {
+  detail::WriteHex(static_cast<const uint8_t*>(data), length, buffer,
+                   letter_case);
+  return length * 2;
+}
+
+/// @brief Appends the bytes of a buffer as hexadecimal text to the provided
+/// string.
+/// @see ToHex(const void*,size_t,char*,LetterCase)
+///
+/// @return The number of characters appended to the string.
+inline size_t ToHex(const void*data, size_t length, std::string*buffer,
+                    LetterCase letter_case = LetterCase::kLower) {
+  const std::string::size_type offset = buffer->size();
+  buffer->resize(offset + length * 2);
+  return ToHex(data, length, &((*buffer)[offset]), letter_case);
 }
 
 }  // namespace nx
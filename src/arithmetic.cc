@@ -0,0 +1,385 @@
+//
+// Copyright (C) 2013 Jacob McIntosh <nacitar at ubercpp dot com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+/// @file arithmetic.cc
+/// @brief Implementation for the array overloads of arithmetic.h
+
+#include <cstring>
+#include "nx/arithmetic.h"
+
+#if defined(NX_TARGET_X86)
+  #include <immintrin.h>
+#endif
+
+/// @brief Library namespace.
+namespace nx {
+
+/// @cond nx_detail
+namespace detail {
+
+namespace {
+
+/// @brief The type of the elements for the given size and signedness.
+template <unsigned int kBits, bool kSigned>
+using SaturateElement = Conditional<Bool<kSigned>, int_t<kBits>, uint_t<kBits>>;
+
+/// @brief Applies a saturating operation to each pair of elements of two
+/// arrays, one at a time.
+template <unsigned int kBits, bool kSigned, bool kSubtract>
+void SaturateElements(const unsigned char*lhs, const unsigned char*rhs,
+                      unsigned char*result, size_t length) {
+  typedef SaturateElement<kBits, kSigned> T;
+  for (; length; --length) {
+    T a, b;
+    std::memcpy(&a, lhs, sizeof(a));
+    std::memcpy(&b, rhs, sizeof(b));
+    a = kSubtract ? SaturatingSub(a, b) : SaturatingAdd(a, b);
+    std::memcpy(result, &a, sizeof(a));
+    lhs += sizeof(T);
+    rhs += sizeof(T);
+    result += sizeof(T);
+  }
+}
+
+/// @brief One element at a time.
+class SaturateScalar {
+ public:
+  template <unsigned int kBits, bool kSigned, bool kSubtract>
+  static void Apply(const unsigned char*lhs, const unsigned char*rhs,
+                    unsigned char*result, size_t length) {
+    SaturateElements<kBits, kSigned, kSubtract>(lhs, rhs, result, length);
+  }
+};
+
+#if defined(NX_TARGET_X86)
+
+// There are no saturating instructions for 32 and 64-bit lanes, so those
+// wrap and then replace the lanes that overflowed.  Whether a lane did is
+// the top bit of a bitwise expression of its operands and wrapped result,
+// which is spread across the lane with an arithmetic shift; 64-bit lanes
+// take the shifted top half of each lane, lacking such a shift themselves.
+
+template <unsigned int kBits>
+NX_TARGET("sse2")
+inline __m128i AddSse2(__m128i a, __m128i b) {
+  return kBits == 32 ? _mm_add_epi32(a, b) : _mm_add_epi64(a, b);
+}
+
+template <unsigned int kBits>
+NX_TARGET("sse2")
+inline __m128i SubSse2(__m128i a, __m128i b) {
+  return kBits == 32 ? _mm_sub_epi32(a, b) : _mm_sub_epi64(a, b);
+}
+
+/// @brief Sets all bits of the lanes whose top bit is set.
+template <unsigned int kBits>
+NX_TARGET("sse2")
+inline __m128i LaneMaskSse2(__m128i v) {
+  const __m128i high = _mm_srai_epi32(v, 31);
+  return kBits == 32 ? high : _mm_shuffle_epi32(high, _MM_SHUFFLE(3, 3, 1, 1));
+}
+
+/// @brief The largest signed value of each lane.
+template <unsigned int kBits>
+NX_TARGET("sse2")
+inline __m128i MaximumSse2() {
+  return kBits == 32 ? _mm_set1_epi32(0x7fffffff)
+                     : _mm_set1_epi64x(0x7fffffffffffffffll);
+}
+
+template <unsigned int kBits, bool kSigned, bool kSubtract>
+NX_TARGET("sse2")
+inline __m128i SaturateSse2Vector(__m128i a, __m128i b) {
+  if (kBits == 8) {
+    return kSigned
+        ? (kSubtract ? _mm_subs_epi8(a, b) : _mm_adds_epi8(a, b))
+        : (kSubtract ? _mm_subs_epu8(a, b) : _mm_adds_epu8(a, b));
+  }
+  if (kBits == 16) {
+    return kSigned
+        ? (kSubtract ? _mm_subs_epi16(a, b) : _mm_adds_epi16(a, b))
+        : (kSubtract ? _mm_subs_epu16(a, b) : _mm_adds_epu16(a, b));
+  }
+  const __m128i r = kSubtract ? SubSse2<kBits>(a, b) : AddSse2<kBits>(a, b);
+  if (kSigned) {
+    // The sign of a is that of the limit crossed.
+    const __m128i overflow = LaneMaskSse2<kBits>(kSubtract
+        ? _mm_and_si128(_mm_xor_si128(a, b), _mm_xor_si128(a, r))
+        : _mm_and_si128(_mm_xor_si128(a, r), _mm_xor_si128(b, r)));
+    const __m128i limit = _mm_xor_si128(
+        LaneMaskSse2<kBits>(a), MaximumSse2<kBits>());
+    return _mm_or_si128(_mm_andnot_si128(overflow, r),
+                        _mm_and_si128(overflow, limit));
+  }
+  if (kSubtract) {
+    const __m128i borrow = LaneMaskSse2<kBits>(_mm_or_si128(
+        _mm_andnot_si128(a, b), _mm_andnot_si128(_mm_xor_si128(a, b), r)));
+    return _mm_andnot_si128(borrow, r);
+  }
+  const __m128i carry = LaneMaskSse2<kBits>(_mm_or_si128(
+      _mm_and_si128(a, b), _mm_andnot_si128(r, _mm_or_si128(a, b))));
+  return _mm_or_si128(r, carry);
+}
+
+/// @brief 16 bytes at a time with SSE2.
+class SaturateSse2 {
+ public:
+  template <unsigned int kBits, bool kSigned, bool kSubtract>
+  NX_TARGET("sse2")
+  static void Apply(const unsigned char*lhs, const unsigned char*rhs,
+                    unsigned char*result, size_t length) {
+    size_t bytes = length * (kBits / 8);
+    for (; bytes >= sizeof(__m128i); bytes -= sizeof(__m128i)) {
+      const __m128i a = _mm_loadu_si128(
+          reinterpret_cast<const __m128i*>(lhs));
+      const __m128i b = _mm_loadu_si128(
+          reinterpret_cast<const __m128i*>(rhs));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(result),
+                       SaturateSse2Vector<kBits, kSigned, kSubtract>(a, b));
+      lhs += sizeof(__m128i);
+      rhs += sizeof(__m128i);
+      result += sizeof(__m128i);
+    }
+    SaturateElements<kBits, kSigned, kSubtract>(
+        lhs, rhs, result, bytes / (kBits / 8));
+  }
+};
+
+template <unsigned int kBits>
+NX_TARGET("avx2")
+inline __m256i AddAvx2(__m256i a, __m256i b) {
+  return kBits == 32 ? _mm256_add_epi32(a, b) : _mm256_add_epi64(a, b);
+}
+
+template <unsigned int kBits>
+NX_TARGET("avx2")
+inline __m256i SubAvx2(__m256i a, __m256i b) {
+  return kBits == 32 ? _mm256_sub_epi32(a, b) : _mm256_sub_epi64(a, b);
+}
+
+/// @brief Sets all bits of the lanes whose top bit is set.
+template <unsigned int kBits>
+NX_TARGET("avx2")
+inline __m256i LaneMaskAvx2(__m256i v) {
+  const __m256i high = _mm256_srai_epi32(v, 31);
+  return kBits == 32
+      ? high : _mm256_shuffle_epi32(high, _MM_SHUFFLE(3, 3, 1, 1));
+}
+
+/// @brief The largest signed value of each lane.
+template <unsigned int kBits>
+NX_TARGET("avx2")
+inline __m256i MaximumAvx2() {
+  return kBits == 32 ? _mm256_set1_epi32(0x7fffffff)
+                     : _mm256_set1_epi64x(0x7fffffffffffffffll);
+}
+
+template <unsigned int kBits, bool kSigned, bool kSubtract>
+NX_TARGET("avx2")
+inline __m256i SaturateAvx2Vector(__m256i a, __m256i b) {
+  if (kBits == 8) {
+    return kSigned
+        ? (kSubtract ? _mm256_subs_epi8(a, b) : _mm256_adds_epi8(a, b))
+        : (kSubtract ? _mm256_subs_epu8(a, b) : _mm256_adds_epu8(a, b));
+  }
+  if (kBits == 16) {
+    return kSigned
+        ? (kSubtract ? _mm256_subs_epi16(a, b) : _mm256_adds_epi16(a, b))
+        : (kSubtract ? _mm256_subs_epu16(a, b) : _mm256_adds_epu16(a, b));
+  }
+  const __m256i r = kSubtract ? SubAvx2<kBits>(a, b) : AddAvx2<kBits>(a, b);
+  if (kSigned) {
+    // The sign of a is that of the limit crossed.
+    const __m256i overflow = LaneMaskAvx2<kBits>(kSubtract
+        ? _mm256_and_si256(_mm256_xor_si256(a, b), _mm256_xor_si256(a, r))
+        : _mm256_and_si256(_mm256_xor_si256(a, r), _mm256_xor_si256(b, r)));
+    const __m256i limit = _mm256_xor_si256(
+        LaneMaskAvx2<kBits>(a), MaximumAvx2<kBits>());
+    return _mm256_blendv_epi8(r, limit, overflow);
+  }
+  if (kSubtract) {
+    const __m256i borrow = LaneMaskAvx2<kBits>(_mm256_or_si256(
+        _mm256_andnot_si256(a, b),
+        _mm256_andnot_si256(_mm256_xor_si256(a, b), r)));
+    return _mm256_andnot_si256(borrow, r);
+  }
+  const __m256i carry = LaneMaskAvx2<kBits>(_mm256_or_si256(
+      _mm256_and_si256(a, b), _mm256_andnot_si256(r, _mm256_or_si256(a, b))));
+  return _mm256_or_si256(r, carry);
+}
+
+/// @brief 32 bytes at a time with AVX2.
+class SaturateAvx2 {
+ public:
+  template <unsigned int kBits, bool kSigned, bool kSubtract>
+  NX_TARGET("avx2")
+  static void Apply(const unsigned char*lhs, const unsigned char*rhs,
+                    unsigned char*result, size_t length) {
+    size_t bytes = length * (kBits / 8);
+    for (; bytes >= sizeof(__m256i); bytes -= sizeof(__m256i)) {
+      const __m256i a = _mm256_loadu_si256(
+          reinterpret_cast<const __m256i*>(lhs));
+      const __m256i b = _mm256_loadu_si256(
+          reinterpret_cast<const __m256i*>(rhs));
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(result),
+                          SaturateAvx2Vector<kBits, kSigned, kSubtract>(a, b));
+      lhs += sizeof(__m256i);
+      rhs += sizeof(__m256i);
+      result += sizeof(__m256i);
+    }
+    SaturateElements<kBits, kSigned, kSubtract>(
+        lhs, rhs, result, bytes / (kBits / 8));
+  }
+};
+
+#endif  // NX_TARGET_X86
+
+typedef void (*SaturateFunction)(
+    const unsigned char*, const unsigned char*, unsigned char*, size_t);
+
+/// @brief Provides the Kernel function for the given operation on elements
+/// of kBits bits.
+template <class Kernel, unsigned int kBits>
+SaturateFunction GetSaturateFunction(bool is_signed, bool subtract) {
+  return is_signed
+      ? (subtract ? &Kernel::template Apply<kBits, true, true>
+                  : &Kernel::template Apply<kBits, true, false>)
+      : (subtract ? &Kernel::template Apply<kBits, false, true>
+                  : &Kernel::template Apply<kBits, false, false>);
+}
+
+/// @brief Applies the given operation with the Kernel function for the
+/// element size.
+template <class Kernel>
+void SaturateBuffer(const unsigned char*lhs, const unsigned char*rhs,
+                    unsigned char*result, size_t length,
+                    unsigned int element_size, bool is_signed,
+                    bool subtract) {
+  SaturateFunction function;
+  switch (element_size) {
+    case 8:
+      function = GetSaturateFunction<Kernel, 64>(is_signed, subtract);
+      break;
+    case 4:
+      function = GetSaturateFunction<Kernel, 32>(is_signed, subtract);
+      break;
+    case 2:
+      function = GetSaturateFunction<Kernel, 16>(is_signed, subtract);
+      break;
+    default:
+      function = GetSaturateFunction<Kernel, 8>(is_signed, subtract);
+      break;
+  }
+  function(lhs, rhs, result, length);
+}
+
+typedef void (*SaturateBufferFunction)(
+    const unsigned char*, const unsigned char*, unsigned char*, size_t,
+    unsigned int, bool, bool);
+
+SaturateBufferFunction GetSaturateBufferFunction(SaturatingKernel kernel) {
+  switch (kernel) {
+#if defined(NX_TARGET_X86)
+    case SaturatingKernel::kAvx2:
+      return &SaturateBuffer<SaturateAvx2>;
+    case SaturatingKernel::kSse2:
+      return &SaturateBuffer<SaturateSse2>;
+#endif
+    default:
+      return &SaturateBuffer<SaturateScalar>;
+  }
+}
+
+SaturateBufferFunction SelectSaturateBufferFunction() {
+  const SaturatingKernel preference[] = {
+    SaturatingKernel::kAvx2,
+    SaturatingKernel::kSse2
+  };
+  for (SaturatingKernel kernel : preference) {
+    if (SaturatingSupported(kernel)) {
+      return GetSaturateBufferFunction(kernel);
+    }
+  }
+  return &SaturateBuffer<SaturateScalar>;
+}
+
+const cpu::Dispatch<void(
+    const unsigned char*, const unsigned char*, unsigned char*, size_t,
+    unsigned int, bool, bool)>
+    saturate_buffer(&SelectSaturateBufferFunction);
+
+}  // namespace
+
+bool SaturatingSupported(SaturatingKernel kernel) {
+  switch (kernel) {
+    case SaturatingKernel::kScalar:
+      return true;
+#if defined(NX_TARGET_X86)
+    case SaturatingKernel::kSse2:
+      return cpu::Supports(cpu::Feature::kSse2);
+    case SaturatingKernel::kAvx2:
+      return cpu::Supports(cpu::Feature::kAvx2);
+#endif
+    default:
+      return false;
+  }
+}
+
+void SaturatingAddBuffer(
+    SaturatingKernel kernel, const void*lhs, const void*rhs, void*result,
+    size_t length, unsigned int element_size, bool is_signed) {
+  GetSaturateBufferFunction(kernel)(
+      static_cast<const unsigned char*>(lhs),
+      static_cast<const unsigned char*>(rhs),
+      static_cast<unsigned char*>(result),
+      length, element_size, is_signed, false);
+}
+
+void SaturatingAddBuffer(
+    const void*lhs, const void*rhs, void*result,
+    size_t length, unsigned int element_size, bool is_signed) {
+  saturate_buffer(
+      static_cast<const unsigned char*>(lhs),
+      static_cast<const unsigned char*>(rhs),
+      static_cast<unsigned char*>(result),
+      length, element_size, is_signed, false);
+}
+
+void SaturatingSubBuffer(
+    SaturatingKernel kernel, const void*lhs, const void*rhs, void*result,
+    size_t length, unsigned int element_size, bool is_signed) {
+  GetSaturateBufferFunction(kernel)(
+      static_cast<const unsigned char*>(lhs),
+      static_cast<const unsigned char*>(rhs),
+      static_cast<unsigned char*>(result),
+      length, element_size, is_signed, true);
+}
+
+void SaturatingSubBuffer(
+    const void*lhs, const void*rhs, void*result,
+    size_t length, unsigned int element_size, bool is_signed) {
+  saturate_buffer(
+      static_cast<const unsigned char*>(lhs),
+      static_cast<const unsigned char*>(rhs),
+      static_cast<unsigned char*>(result),
+      length, element_size, is_signed, true);
+}
+
+}  // namespace detail
+/// @endcond
+
+}  // namespace nx
@@ -0,0 +1,192 @@
+//
+// Copyright (C) 2013 Jacob McIntosh <nacitar at ubercpp dot com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+/// @file byte_order.cc
+/// @brief Implementation for the array overloads of byte_order.h
+
+#include <cstring>
+#include "nx/byte_order.h"
+
+#if defined(NX_TARGET_X86)
+  #include <immintrin.h>
+#endif
+
+/// @brief Library namespace.
+namespace nx {
+
+/// @cond nx_detail
+namespace detail {
+
+namespace {
+
+/// @brief Swaps each element of an array of the given type.
+template <class T>
+void SwapElements(const unsigned char*source, unsigned char*destination,
+                  size_t length) {
+  for (; length; --length) {
+    T value;
+    std::memcpy(&value, source, sizeof(value));
+    value = ByteSwap(value);
+    std::memcpy(destination, &value, sizeof(value));
+    source += sizeof(T);
+    destination += sizeof(T);
+  }
+}
+
+void SwapScalar(const unsigned char*source, unsigned char*destination,
+                size_t length, unsigned int element_size) {
+  switch (element_size) {
+    case 8:
+      SwapElements<uint64_t>(source, destination, length);
+      break;
+    case 4:
+      SwapElements<uint32_t>(source, destination, length);
+      break;
+    case 2:
+      SwapElements<uint16_t>(source, destination, length);
+      break;
+    default:
+      if (source != destination) {
+        std::memmove(destination, source, length);
+      }
+      break;
+  }
+}
+
+#if defined(NX_TARGET_X86)
+
+NX_TARGET("ssse3")
+void SwapSsse3(const unsigned char*source, unsigned char*destination,
+               size_t length, unsigned int element_size) {
+  if (element_size < 2) {
+    SwapScalar(source, destination, length, element_size);
+    return;
+  }
+  alignas(16) unsigned char order_bytes[16];
+  MakeByteOrder(order_bytes, element_size);
+  const __m128i order = _mm_load_si128(
+      reinterpret_cast<const __m128i*>(order_bytes));
+  size_t bytes = length * element_size;
+  for (; bytes >= sizeof(__m128i); bytes -= sizeof(__m128i)) {
+    const __m128i v = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(source));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(destination),
+                     _mm_shuffle_epi8(v, order));
+    source += sizeof(__m128i);
+    destination += sizeof(__m128i);
+  }
+  SwapScalar(source, destination, bytes / element_size, element_size);
+}
+
+NX_TARGET("avx2")
+void SwapAvx2(const unsigned char*source, unsigned char*destination,
+              size_t length, unsigned int element_size) {
+  if (element_size < 2) {
+    SwapScalar(source, destination, length, element_size);
+    return;
+  }
+  alignas(16) unsigned char order_bytes[16];
+  MakeByteOrder(order_bytes, element_size);
+  // vpshufb works within 128-bit lanes, which hold whole elements.
+  const __m256i order = _mm256_broadcastsi128_si256(
+      _mm_load_si128(reinterpret_cast<const __m128i*>(order_bytes)));
+  size_t bytes = length * element_size;
+  for (; bytes >= 2 * sizeof(__m256i); bytes -= 2 * sizeof(__m256i)) {
+    const __m256i*in = reinterpret_cast<const __m256i*>(source);
+    __m256i*out = reinterpret_cast<__m256i*>(destination);
+    const __m256i a = _mm256_loadu_si256(in);
+    const __m256i b = _mm256_loadu_si256(in + 1);
+    _mm256_storeu_si256(out, _mm256_shuffle_epi8(a, order));
+    _mm256_storeu_si256(out + 1, _mm256_shuffle_epi8(b, order));
+    source += 2 * sizeof(__m256i);
+    destination += 2 * sizeof(__m256i);
+  }
+  SwapScalar(source, destination, bytes / element_size, element_size);
+}
+
+#endif  // NX_TARGET_X86
+
+typedef void (*SwapFunction)(
+    const unsigned char*, unsigned char*, size_t, unsigned int);
+
+SwapFunction GetSwapFunction(ByteSwapKernel kernel) {
+  switch (kernel) {
+#if defined(NX_TARGET_X86)
+    case ByteSwapKernel::kAvx2:
+      return &SwapAvx2;
+    case ByteSwapKernel::kSsse3:
+      return &SwapSsse3;
+#endif
+    default:
+      return &SwapScalar;
+  }
+}
+
+SwapFunction SelectSwapFunction() {
+  const ByteSwapKernel preference[] = {
+    ByteSwapKernel::kAvx2,
+    ByteSwapKernel::kSsse3
+  };
+  for (ByteSwapKernel kernel : preference) {
+    if (ByteSwapSupported(kernel)) {
+      return GetSwapFunction(kernel);
+    }
+  }
+  return &SwapScalar;
+}
+
+const cpu::Dispatch<void(
+    const unsigned char*, unsigned char*, size_t, unsigned int)>
+    swap_buffer(&SelectSwapFunction);
+
+}  // namespace
+
+bool ByteSwapSupported(ByteSwapKernel kernel) {
+  switch (kernel) {
+    case ByteSwapKernel::kScalar:
+      return true;
+#if defined(NX_TARGET_X86)
+    case ByteSwapKernel::kSsse3:
+      return cpu::Supports(cpu::Feature::kSsse3);
+    case ByteSwapKernel::kAvx2:
+      return cpu::Supports(cpu::Feature::kAvx2);
+#endif
+    default:
+      return false;
+  }
+}
+
+void ByteSwapBuffer(
+    ByteSwapKernel kernel, const void*source, void*destination,
+    size_t length, unsigned int element_size) {
+  GetSwapFunction(kernel)(
+      static_cast<const unsigned char*>(source),
+      static_cast<unsigned char*>(destination), length, element_size);
+}
+
+void ByteSwapBuffer(
+    const void*source, void*destination,
+    size_t length, unsigned int element_size) {
+  swap_buffer(
+      static_cast<const unsigned char*>(source),
+      static_cast<unsigned char*>(destination), length, element_size);
+}
+
+}  // namespace detail
+/// @endcond
+
+}  // namespace nx
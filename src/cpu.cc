@@ -0,0 +1,166 @@
+//
+// Copyright (C) 2013 Jacob McIntosh <nacitar at ubercpp dot com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+/// @file cpu.cc
+/// @brief Implementation for cpu.h
+
+#include "nx/core/cpu.h"
+
+#if defined(NX_ARCH_X86_64) || defined(NX_ARCH_X86)
+  #if defined(NX_TC_VS)
+    #include <intrin.h>
+  #else
+    #include <cpuid.h>
+  #endif
+#endif
+
+/// @brief Library namespace.
+namespace nx {
+
+namespace cpu {
+
+namespace {
+
+#if defined(NX_ARCH_X86_64) || defined(NX_ARCH_X86)
+
+/// @brief The registers produced by the cpuid instruction.
+struct CpuidRegisters {
+  uint32_t eax, ebx, ecx, edx;
+};
+
+CpuidRegisters Cpuid(uint32_t leaf, uint32_t subleaf) {
+  CpuidRegisters registers;
+#if defined(NX_TC_VS)
+  int values[4];
+  __cpuidex(values, static_cast<int>(leaf), static_cast<int>(subleaf));
+  registers.eax = static_cast<uint32_t>(values[0]);
+  registers.ebx = static_cast<uint32_t>(values[1]);
+  registers.ecx = static_cast<uint32_t>(values[2]);
+  registers.edx = static_cast<uint32_t>(values[3]);
+#else
+  __cpuid_count(leaf, subleaf,
+      registers.eax, registers.ebx, registers.ecx, registers.edx);
+#endif
+  return registers;
+}
+
+/// @brief Reads the register states the operating system saves on context
+/// switches; only valid if cpuid reports OSXSAVE.
+uint64_t ExtendedControlRegister() {
+#if defined(NX_TC_VS)
+  return _xgetbv(0);
+#else
+  uint32_t eax, edx;
+  __asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+  return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+}
+
+/// @brief Produces the bit for a feature within the Features() mask.
+constexpr uint_least32_t Bit(Feature feature) {
+  return static_cast<uint_least32_t>(1) << static_cast<unsigned int>(feature);
+}
+
+/// @brief Produces the bit for a feature if the given register bit is set.
+constexpr uint_least32_t BitIf(
+    uint32_t value, unsigned int bit, Feature feature) {
+  return ((value >> bit) & 1u) ? Bit(feature) : 0;
+}
+
+/// @brief Determines if pdep/pext are microcoded, as on AMD and Hygon
+/// processors before family 19h.
+bool SlowBitDeposit(const CpuidRegisters&leaf0, const CpuidRegisters&leaf1) {
+  // The vendor string is spread over ebx, edx and ecx.
+  const bool amd = leaf0.ebx == 0x68747541u && leaf0.edx == 0x69746e65u &&
+                   leaf0.ecx == 0x444d4163u;  // "AuthenticAMD"
+  const bool hygon = leaf0.ebx == 0x6f677948u && leaf0.edx == 0x6e65476eu &&
+                     leaf0.ecx == 0x656e6975u;  // "HygonGenuine"
+  uint32_t family = (leaf1.eax >> 8) & 0xF;
+  if (family == 0xF) {
+    family += (leaf1.eax >> 20) & 0xFF;
+  }
+  return (amd || hygon) && family < 0x19;
+}
+
+uint_least32_t DetectFeatures() {
+  const CpuidRegisters leaf0 = Cpuid(0, 0);
+  const uint32_t max_leaf = leaf0.eax;
+  if (max_leaf < 1) {
+    return 0;
+  }
+  uint_least32_t features = 0;
+  const CpuidRegisters leaf1 = Cpuid(1, 0);
+  features |= BitIf(leaf1.edx, 26, Feature::kSse2);
+  features |= BitIf(leaf1.ecx, 9, Feature::kSsse3);
+  features |= BitIf(leaf1.ecx, 19, Feature::kSse41);
+  features |= BitIf(leaf1.ecx, 20, Feature::kSse42);
+  features |= BitIf(leaf1.ecx, 23, Feature::kPopcnt);
+
+  // The vector registers are only usable if the operating system saves them.
+  bool avx_state = false;
+  bool avx512_state = false;
+  if ((leaf1.ecx >> 27) & 1u) {  // OSXSAVE
+    const uint64_t xcr0 = ExtendedControlRegister();
+    avx_state = (xcr0 & 0x6) == 0x6;  // XMM and YMM
+    avx512_state = avx_state && (xcr0 & 0xE0) == 0xE0;  // opmask and ZMM
+  }
+  if (avx_state) {
+    features |= BitIf(leaf1.ecx, 28, Feature::kAvx);
+  }
+
+  if (max_leaf >= 7) {
+    const CpuidRegisters leaf7 = Cpuid(7, 0);
+    features |= BitIf(leaf7.ebx, 3, Feature::kBmi1);
+    features |= BitIf(leaf7.ebx, 8, Feature::kBmi2);
+    if (!SlowBitDeposit(leaf0, leaf1)) {
+      features |= BitIf(leaf7.ebx, 8, Feature::kFastBmi2);
+    }
+    if (avx_state) {
+      features |= BitIf(leaf7.ebx, 5, Feature::kAvx2);
+    }
+    if (avx512_state) {
+      features |= BitIf(leaf7.ebx, 16, Feature::kAvx512f);
+      features |= BitIf(leaf7.ebx, 30, Feature::kAvx512bw);
+      features |= BitIf(leaf7.ebx, 31, Feature::kAvx512vl);
+      features |= BitIf(leaf7.ecx, 14, Feature::kAvx512vpopcntdq);
+    }
+  }
+
+  if (Cpuid(0x80000000u, 0).eax >= 0x80000001u) {
+    features |= BitIf(Cpuid(0x80000001u, 0).ecx, 5, Feature::kLzcnt);
+  }
+  return features;
+}
+
+#else
+
+uint_least32_t DetectFeatures() {
+  return 0;
+}
+
+#endif
+
+}  // namespace
+
+uint_least32_t Features() {
+  static const uint_least32_t features = DetectFeatures();
+  return features;
+}
+
+}  // namespace cpu
+
+}  // namespace nx
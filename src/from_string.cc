@@ -0,0 +1,905 @@
+//
+// Copyright (C) 2013 Jacob McIntosh <nacitar at ubercpp dot com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+/// @file from_string.cc
+/// @brief Implementation for the array overload of FromString() and the
+/// floating-point parsing in from_string.h
+
+#include <algorithm>
+#include <cfloat>
+#include <cstring>
+#include <limits>
+#include <vector>
+#include "nx/from_string.h"
+
+#if defined(NX_TARGET_X86)
+  #include <immintrin.h>
+#endif
+
+/// @brief Library namespace.
+namespace nx {
+
+/// @cond nx_detail
+namespace detail {
+
+namespace {
+
+/// @brief Determines the outcome of parsing the field starting at start.
+///
+/// @return true if the field was parsed and is followed by the delimiter,
+/// which parsed.end then points to.
+inline bool FinishField(const ParseResult&parsed, const char*start,
+                        const char*end, char delimiter,
+                        ParseResult*outcome) {
+  if (parsed.status != ParseStatus::kOk) {
+    *outcome = ParseResult{start, parsed.status};
+    return false;
+  }
+  if (parsed.end != end && *parsed.end != delimiter) {
+    *outcome = ParseResult{start, ParseStatus::kInvalid};
+    return false;
+  }
+  *outcome = parsed;
+  return parsed.end != end;
+}
+
+ParseResult ParseFieldsScalar(
+    const char*begin, const char*end, char delimiter,
+    const ParseLimits&limits, uint64_t*values, size_t length,
+    size_t*count) {
+  const char*position = begin;
+  ParseResult outcome;
+  size_t i = 0;
+  for (;;) {
+    const ParseResult parsed = ParseInteger<10>(
+        position, end, limits, values + i);
+    const bool more = FinishField(parsed, position, end, delimiter, &outcome);
+    i += outcome.status == ParseStatus::kOk;
+    if (!more || i == length) {
+      break;
+    }
+    position = parsed.end + 1;
+  }
+  *count = i;
+  return outcome;
+}
+
+#if defined(NX_TARGET_X86)
+
+/// @brief The bytes a field may span when read with one 16-byte load after
+/// its sign.
+constexpr const ptrdiff_t simd_field_bytes = 17;
+
+/// @brief Counts the digits at the start of 16 characters from which '0'
+/// has been subtracted.
+NX_TARGET("sse4.1")
+inline unsigned int CountDigitsSse41(__m128i digits) {
+  const __m128i is_digit = _mm_cmpeq_epi8(
+      _mm_min_epu8(digits, _mm_set1_epi8(9)), digits);
+  const unsigned int not_digit =
+      ~static_cast<unsigned int>(_mm_movemask_epi8(is_digit)) & 0xffffu;
+  return not_digit ? BitScanForward(not_digit) : 16;
+}
+
+/// @brief Moves the given number of leading digits to the end of the
+/// register, with zeros before them.
+NX_TARGET("sse4.1")
+inline __m128i AlignDigitsSse41(__m128i digits, unsigned int count) {
+  // indexes with the high bit set select zero
+  return _mm_shuffle_epi8(digits, _mm_add_epi8(
+      _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15),
+      _mm_set1_epi8(static_cast<char>(count - 16))));
+}
+
+/// @brief Combines 16 aligned digits into two 8-digit values, in the first
+/// two 32-bit elements, by multiplying adjacent digits, then pairs, then
+/// quadruples by their place values.
+NX_TARGET("sse4.1")
+inline __m128i CombineDigitsSse41(__m128i aligned) {
+  const __m128i pairs = _mm_maddubs_epi16(aligned, _mm_setr_epi8(
+      10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1));
+  const __m128i quadruples = _mm_madd_epi16(pairs, _mm_setr_epi16(
+      100, 1, 100, 1, 100, 1, 100, 1));
+  const __m128i packed = _mm_packus_epi32(quadruples, quadruples);
+  return _mm_madd_epi16(packed, _mm_setr_epi16(
+      10000, 1, 10000, 1, 10000, 1, 10000, 1));
+}
+
+/// @brief AVX2 version, combining the digits of both 128-bit lanes.
+NX_TARGET("avx2")
+inline __m256i CombineDigitsAvx2(__m256i aligned) {
+  const __m256i pairs = _mm256_maddubs_epi16(aligned, _mm256_setr_epi8(
+      10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1,
+      10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1));
+  const __m256i quadruples = _mm256_madd_epi16(pairs, _mm256_setr_epi16(
+      100, 1, 100, 1, 100, 1, 100, 1, 100, 1, 100, 1, 100, 1, 100, 1));
+  const __m256i packed = _mm256_packus_epi32(quadruples, quadruples);
+  return _mm256_madd_epi16(packed, _mm256_setr_epi16(
+      10000, 1, 10000, 1, 10000, 1, 10000, 1,
+      10000, 1, 10000, 1, 10000, 1, 10000, 1));
+}
+
+/// @brief Joins the two 8-digit values from CombineDigitsSse41().
+NX_TARGET("sse4.1")
+inline uint64_t JoinDigitsSse41(__m128i combined) {
+  return static_cast<uint64_t>(_mm_cvtsi128_si32(combined)) * 100000000 +
+      static_cast<uint32_t>(_mm_extract_epi32(combined, 1));
+}
+
+/// @brief A field whose digits have been located.
+struct SimdField {
+  /// @brief The characters of the field, less '0'.
+  __m128i digits;
+  /// @brief The first digit.
+  const char*position;
+  /// @brief The number of digits.
+  unsigned int count;
+  /// @brief Whether a '-' precedes the digits.
+  bool negative;
+};
+
+/// @brief Locates the digits of the field at begin, which must have
+/// simd_field_bytes characters after it.
+///
+/// @return false if the field has no digits, which is left to
+/// ParseInteger().
+NX_TARGET("sse4.1")
+inline bool LocateFieldSse41(const char*begin, const ParseLimits&limits,
+                             SimdField*field) {
+  field->negative = limits.negative_max && *begin == '-';
+  field->position = begin + field->negative;
+  field->digits = _mm_sub_epi8(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(field->position)),
+      _mm_set1_epi8('0'));
+  field->count = CountDigitsSse41(field->digits);
+  return field->count;
+}
+
+/// @brief Checks the magnitude of a located field against the limits.
+inline ParseResult StoreField(const SimdField&field, uint64_t magnitude,
+                              const ParseLimits&limits, uint64_t*value) {
+  const char*field_end = field.position + field.count;
+  if (magnitude > (field.negative ? limits.negative_max : limits.max)) {
+    return ParseResult{field_end, ParseStatus::kOverflow};
+  }
+  *value = field.negative ? -magnitude : magnitude;
+  return ParseResult{field_end, ParseStatus::kOk};
+}
+
+/// @brief Parses the field at begin, using SIMD if there are enough
+/// characters after it.
+NX_TARGET("sse4.1")
+inline ParseResult ParseFieldSse41(const char*begin, const char*end,
+                                   const ParseLimits&limits,
+                                   uint64_t*value) {
+  SimdField field;
+  if (end - begin < simd_field_bytes ||
+      !LocateFieldSse41(begin, limits, &field)) {
+    return ParseInteger<10>(begin, end, limits, value);
+  }
+  const uint64_t magnitude = JoinDigitsSse41(CombineDigitsSse41(
+      AlignDigitsSse41(field.digits, field.count)));
+  if (field.count < 16) {
+    return StoreField(field, magnitude, limits, value);
+  }
+  // digits past the first 16
+  uint64_t long_magnitude;
+  const ParseResult parsed = FinishMagnitude(
+      field.position, field.position + 16, end, magnitude,
+      field.negative ? limits.negative_max : limits.max, &long_magnitude);
+  if (parsed.status == ParseStatus::kOk) {
+    *value = field.negative ? -long_magnitude : long_magnitude;
+  }
+  return parsed;
+}
+
+NX_TARGET("sse4.1")
+ParseResult ParseFieldsSse41(
+    const char*begin, const char*end, char delimiter,
+    const ParseLimits&limits, uint64_t*values, size_t length,
+    size_t*count) {
+  const char*position = begin;
+  ParseResult outcome;
+  size_t i = 0;
+  for (;;) {
+    const ParseResult parsed = ParseFieldSse41(
+        position, end, limits, values + i);
+    const bool more = FinishField(parsed, position, end, delimiter, &outcome);
+    i += outcome.status == ParseStatus::kOk;
+    if (!more || i == length) {
+      break;
+    }
+    position = parsed.end + 1;
+  }
+  *count = i;
+  return outcome;
+}
+
+NX_TARGET("avx2")
+ParseResult ParseFieldsAvx2(
+    const char*begin, const char*end, char delimiter,
+    const ParseLimits&limits, uint64_t*values, size_t length,
+    size_t*count) {
+  const char*position = begin;
+  ParseResult outcome;
+  size_t i = 0;
+  for (;;) {
+    // Two fields of at most 15 digits that are each followed by the
+    // delimiter are converted together; anything else is left to the SSE4.1
+    // version.
+    SimdField first;
+    SimdField second;
+    if (i + 2 <= length && end - position >= 2 * simd_field_bytes + 1 &&
+        LocateFieldSse41(position, limits, &first) && first.count < 16 &&
+        first.position[first.count] == delimiter &&
+        LocateFieldSse41(first.position + first.count + 1, limits,
+                         &second) && second.count < 16 &&
+        second.position[second.count] == delimiter) {
+      const __m256i combined = CombineDigitsAvx2(_mm256_set_m128i(
+          AlignDigitsSse41(second.digits, second.count),
+          AlignDigitsSse41(first.digits, first.count)));
+      const ParseResult first_parsed = StoreField(
+          first, JoinDigitsSse41(_mm256_castsi256_si128(combined)),
+          limits, values + i);
+      if (first_parsed.status != ParseStatus::kOk) {
+        outcome = ParseResult{position, first_parsed.status};
+        break;
+      }
+      ++i;
+      const ParseResult second_parsed = StoreField(
+          second, JoinDigitsSse41(_mm256_extracti128_si256(combined, 1)),
+          limits, values + i);
+      if (second_parsed.status != ParseStatus::kOk) {
+        outcome = ParseResult{first_parsed.end + 1, second_parsed.status};
+        break;
+      }
+      ++i;
+      outcome = second_parsed;
+      if (i == length) {
+        break;
+      }
+      position = second_parsed.end + 1;
+      continue;
+    }
+    const ParseResult parsed = ParseFieldSse41(
+        position, end, limits, values + i);
+    const bool more = FinishField(parsed, position, end, delimiter, &outcome);
+    i += outcome.status == ParseStatus::kOk;
+    if (!more || i == length) {
+      break;
+    }
+    position = parsed.end + 1;
+  }
+  *count = i;
+  return outcome;
+}
+
+#endif  // NX_TARGET_X86
+
+typedef ParseResult (*ParseFieldsFunction)(
+    const char*, const char*, char, const ParseLimits&, uint64_t*, size_t,
+    size_t*);
+
+ParseFieldsFunction GetParseFieldsFunction(FromStringKernel kernel) {
+  switch (kernel) {
+#if defined(NX_TARGET_X86)
+    case FromStringKernel::kAvx2:
+      return &ParseFieldsAvx2;
+    case FromStringKernel::kSse41:
+      return &ParseFieldsSse41;
+#endif
+    default:
+      return &ParseFieldsScalar;
+  }
+}
+
+ParseFieldsFunction SelectParseFieldsFunction() {
+  const FromStringKernel preference[] = {
+    FromStringKernel::kAvx2,
+    FromStringKernel::kSse41
+  };
+  for (FromStringKernel kernel : preference) {
+    if (FromStringSupported(kernel)) {
+      return GetParseFieldsFunction(kernel);
+    }
+  }
+  return &ParseFieldsScalar;
+}
+
+const cpu::Dispatch<ParseResult(
+    const char*, const char*, char, const ParseLimits&, uint64_t*, size_t,
+    size_t*)> parse_fields(&SelectParseFieldsFunction);
+
+/// @brief The layout of an IEEE-754 binary format, and the decimal exponents
+/// each way of parsing it handles.
+template <class T>
+struct FloatFormat;
+
+template <>
+struct FloatFormat<double> {
+  typedef uint64_t Bits;
+  /// @brief The stored significand bits, excluding the hidden bit.
+  static constexpr unsigned int kSignificandBits = 52;
+  /// @brief The exponent bias, plus kSignificandBits so that the significand
+  /// is an integer.
+  static constexpr int kExponentBias = 1075;
+  /// @brief The biased exponent of infinity.
+  static constexpr int kInfiniteExponent = 0x7FF;
+  /// @brief Below this, 19 digits times 10 to the exponent round to zero.
+  static constexpr int kMinExponent = -342;
+  /// @brief Above this, any digits times 10 to the exponent are infinite.
+  static constexpr int kMaxExponent = 308;
+  /// @brief Significands up to this and powers of 10 up to this exponent
+  /// are exact.
+  static constexpr uint64_t kMaxExactSignificand = 1ull << 53;
+  static constexpr int kMaxExactExponent = 22;
+};
+
+template <>
+struct FloatFormat<float> {
+  typedef uint32_t Bits;
+  static constexpr unsigned int kSignificandBits = 23;
+  static constexpr int kExponentBias = 150;
+  static constexpr int kInfiniteExponent = 0xFF;
+  static constexpr int kMinExponent = -65;
+  static constexpr int kMaxExponent = 38;
+  static constexpr uint64_t kMaxExactSignificand = 1ull << 24;
+  static constexpr int kMaxExactExponent = 10;
+};
+
+/// @brief The powers of 10 that a double holds exactly.
+constexpr const double exact_power_10[23] = {
+  1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13,
+  1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/// @brief The parts of the text of a decimal number, after its sign.
+struct DecimalText {
+  /// @brief The first character of the digits and decimal point.
+  const char*digits_begin;
+  /// @brief The character after the digits and decimal point.
+  const char*digits_end;
+  /// @brief The number of digits before the decimal point.
+  int64_t integer_digits;
+  /// @brief The value of the exponent suffix.
+  int64_t exponent;
+  /// @brief Up to the first 19 significant digits.
+  uint64_t significand;
+  /// @brief The value is about significand * 10^significand_exponent.
+  int significand_exponent;
+  /// @brief Set if nonzero digits past those of significand were dropped.
+  bool truncated;
+};
+
+/// @brief Appends decimal digits to a value, 8 at a time; the value wraps
+/// around if there are more than 19.
+inline const char*AccumulateDigits(const char*position, const char*end,
+                                   uint64_t*value) {
+  uint64_t accumulated = *value;
+  while (position != end) {
+    const uint64_t word = LoadDigitWord(position, end);
+    const unsigned int count = CountDigitWord(word);
+    if (!count) {
+      break;
+    }
+    accumulated = accumulated * constant::power_10_64bit[count] +
+        ConvertDigitWord(word, count);
+    position += count;
+    if (count < 8) {
+      break;
+    }
+  }
+  *value = accumulated;
+  return position;
+}
+
+/// @brief Parses digits with an optional decimal point, and an optional
+/// exponent suffix.
+ParseResult ParseDecimalText(const char*begin, const char*end,
+                             DecimalText*text) {
+  const char*position = AccumulateDigits(begin, end, &text->significand);
+  const int64_t integer_digits = position - begin;
+  int64_t digits = integer_digits;
+  int64_t exponent = 0;
+  if (position != end && *position == '.') {
+    const char*fraction = ++position;
+    position = AccumulateDigits(position, end, &text->significand);
+    exponent = fraction - position;
+    digits += position - fraction;
+  }
+  if (!digits) {
+    return ParseResult{begin, ParseStatus::kInvalid};
+  }
+  text->digits_begin = begin;
+  text->digits_end = position;
+  text->integer_digits = integer_digits;
+  text->exponent = 0;
+  // the suffix is only consumed if it has digits
+  if (position != end && (*position == 'e' || *position == 'E')) {
+    const char*suffix = position + 1;
+    const bool negative = suffix != end && *suffix == '-';
+    if (suffix != end && (*suffix == '-' || *suffix == '+')) {
+      ++suffix;
+    }
+    if (suffix != end && static_cast<unsigned char>(*suffix - '0') <= 9) {
+      int64_t suffix_exponent = 0;
+      for (; suffix != end; ++suffix) {
+        const unsigned int digit = static_cast<unsigned char>(*suffix - '0');
+        if (digit > 9) {
+          break;
+        }
+        // anything larger is out of range regardless of the digits
+        if (suffix_exponent < 0x10000000) {
+          suffix_exponent = suffix_exponent * 10 + digit;
+        }
+      }
+      text->exponent = negative ? -suffix_exponent : suffix_exponent;
+      position = suffix;
+    }
+  }
+  text->truncated = false;
+  if (digits > 19) {
+    // the significand may have wrapped around; take the first 19 digits
+    // after any leading zeros instead
+    int64_t zeros = 0;
+    int64_t kept = 0;
+    text->significand = 0;
+    for (const char*digit = begin; digit != text->digits_end; ++digit) {
+      if (*digit == '.') {
+        continue;
+      }
+      if (*digit == '0' && !kept) {
+        ++zeros;
+      } else if (kept < 19) {
+        text->significand = text->significand * 10 +
+            static_cast<unsigned int>(*digit - '0');
+        ++kept;
+      } else if (*digit != '0') {
+        text->truncated = true;
+      }
+    }
+    exponent = integer_digits - zeros - kept;
+  }
+  exponent += text->exponent;
+  // beyond these the value is zero or infinite for any significand
+  text->significand_exponent = static_cast<int>(
+      std::max<int64_t>(-100000, std::min<int64_t>(exponent, 100000)));
+  return ParseResult{position, ParseStatus::kOk};
+}
+
+/// @brief Computes the value with one exactly rounded floating-point
+/// operation, if the significand and power of 10 are both exact.
+template <class T>
+bool ExactValue(const DecimalText&text, T*value) {
+  typedef FloatFormat<T> Format;
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+  const int exponent = text.significand_exponent;
+  if (text.truncated || text.significand > Format::kMaxExactSignificand ||
+      exponent < -Format::kMaxExactExponent ||
+      exponent > Format::kMaxExactExponent) {
+    return false;
+  }
+  const T significand = static_cast<T>(text.significand);
+  const T power = static_cast<T>(exact_power_10[exponent < 0 ?
+                                                -exponent : exponent]);
+  *value = exponent < 0 ? significand / power : significand * power;
+  return true;
+#else
+  // intermediate results with excess precision would be rounded twice
+  return false;
+#endif
+}
+
+/// @brief Rounds significand * 10^exponent to the bits of the nearest T,
+/// with the Eisel-Lemire algorithm.
+/// @details The significand is multiplied by the 64, or if needed 128, most
+/// significant bits of the power of 10.  The product is then below the
+/// exact one by less than 2 in its 128th bit, which decides the rounding
+/// unless the bits below the rounding bit are all zeros or all ones.
+///
+/// @return false if the rounding could not be decided, in which case bits
+/// receives a value within one unit in the last place.
+template <class T>
+bool EiselLemire(uint64_t significand, int exponent,
+                 typename FloatFormat<T>::Bits*bits) {
+  typedef FloatFormat<T> Format;
+  typedef typename Format::Bits Bits;
+  if (significand == 0 || exponent < Format::kMinExponent) {
+    *bits = 0;
+    return true;
+  }
+  if (exponent > Format::kMaxExponent) {
+    *bits = static_cast<Bits>(Format::kInfiniteExponent) <<
+        Format::kSignificandBits;
+    return true;
+  }
+  const unsigned int leading_zeros = 63 - nx::BitScanReverse(significand);
+  const uint64_t normalized = significand << leading_zeros;
+  const uint_least64_t*power = constant::power_10_128bit[
+      exponent - constant::power_10_128bit_min_exponent];
+  uint64_t high;
+  uint64_t low = MultiplyWords(normalized, power[0], &high);
+  // keep the significand and a rounding bit
+  const unsigned int shift = static_cast<unsigned int>(high >> 63) + 64 -
+      Format::kSignificandBits - 3;
+  const uint64_t below_mask = (1ull << shift) - 1;
+  bool decided = true;
+  if ((high & below_mask) == below_mask || (high & below_mask) == 0) {
+    uint64_t next;
+    MultiplyWords(normalized, power[1], &next);
+    low += next;
+    high += low < next;
+    const bool may_carry = (high & below_mask) == below_mask &&
+        low >= ~0ull - 1;
+    const bool may_tie = (high & below_mask) == 0 && low == 0 &&
+        ((high >> shift) & 1);
+    decided = !may_carry && !may_tie;
+  }
+  uint64_t mantissa = high >> shift;
+  int biased_exponent = FloorLog2Pow10(exponent) + static_cast<int>(shift) +
+      2 - static_cast<int>(leading_zeros) + Format::kExponentBias;
+  if (biased_exponent <= 0) {
+    // subnormal; the exact value cannot be halfway between two of these
+    if (1 - biased_exponent >= 64) {
+      *bits = 0;
+      return decided;
+    }
+    mantissa >>= 1 - biased_exponent;
+    mantissa += mantissa & 1;
+    // rounding up to the smallest normal value carries into the exponent
+    *bits = static_cast<Bits>(mantissa >> 1);
+    return decided;
+  }
+  mantissa += mantissa & 1;
+  mantissa >>= 1;
+  if (mantissa >> (Format::kSignificandBits + 1)) {
+    mantissa >>= 1;
+    ++biased_exponent;
+  }
+  if (biased_exponent >= Format::kInfiniteExponent) {
+    biased_exponent = Format::kInfiniteExponent;
+    mantissa = 0;
+  }
+  *bits = (static_cast<Bits>(biased_exponent) << Format::kSignificandBits) |
+      (static_cast<Bits>(mantissa) &
+       ((static_cast<Bits>(1) << Format::kSignificandBits) - 1));
+  return decided;
+}
+
+/// @brief An unsigned integer with room for the digits RoundDecimal()
+/// keeps, scaled by the powers of 2 and 5 it compares them with.
+class BigInteger {
+ public:
+  explicit BigInteger(uint64_t value) : size_(0) {
+    for (; value; value >>= 32) {
+      limbs_[size_++] = static_cast<uint32_t>(value);
+    }
+  }
+
+  /// @brief Sets the value to value * factor + addend.
+  void MultiplyAdd(uint32_t factor, uint32_t addend) {
+    uint64_t carry = addend;
+    for (unsigned int i = 0; i < size_; ++i) {
+      const uint64_t product =
+          static_cast<uint64_t>(limbs_[i]) * factor + carry;
+      limbs_[i] = static_cast<uint32_t>(product);
+      carry = product >> 32;
+    }
+    if (carry) {
+      limbs_[size_++] = static_cast<uint32_t>(carry);
+    }
+  }
+
+  /// @brief Multiplies the value by 5^exponent.
+  void MultiplyPower5(unsigned int exponent) {
+    // 5^13 is the largest power of 5 that fits in a limb
+    for (; exponent >= 13; exponent -= 13) {
+      MultiplyAdd(1220703125u, 0);
+    }
+    static const uint32_t powers[13] = {
+      1, 5, 25, 125, 625, 3125, 15625, 78125, 390625, 1953125, 9765625,
+      48828125, 244140625
+    };
+    MultiplyAdd(powers[exponent], 0);
+  }
+
+  /// @brief Multiplies the value by 2^exponent.
+  void ShiftLeft(unsigned int exponent) {
+    if (!size_) {
+      return;
+    }
+    const unsigned int limbs = exponent / 32;
+    const unsigned int bits = exponent % 32;
+    if (bits) {
+      uint32_t carry = 0;
+      for (unsigned int i = 0; i < size_; ++i) {
+        const uint32_t limb = limbs_[i];
+        limbs_[i] = (limb << bits) | carry;
+        carry = limb >> (32 - bits);
+      }
+      if (carry) {
+        limbs_[size_++] = carry;
+      }
+    }
+    if (limbs) {
+      std::memmove(limbs_ + limbs, limbs_, size_ * sizeof(uint32_t));
+      std::memset(limbs_, 0, limbs * sizeof(uint32_t));
+      size_ += limbs;
+    }
+  }
+
+  /// @return A negative value, zero or a positive value if this is less
+  /// than, equal to or greater than other.
+  int Compare(const BigInteger&other) const {
+    if (size_ != other.size_) {
+      return size_ < other.size_ ? -1 : 1;
+    }
+    for (unsigned int i = size_; i-- > 0; ) {
+      if (limbs_[i] != other.limbs_[i]) {
+        return limbs_[i] < other.limbs_[i] ? -1 : 1;
+      }
+    }
+    return 0;
+  }
+
+ private:
+  /// @brief 800 digits times 5^1124, or the same magnitude in twos, needs
+  /// fewer than 5400 bits.
+  static constexpr unsigned int kLimbs = 170;
+  uint32_t limbs_[kLimbs];
+  unsigned int size_;
+};
+
+/// @brief Compares digits * 10^exponent with significand * 2^binary_exponent.
+int CompareScaled(const BigInteger&digits, int exponent,
+                  uint64_t significand, int binary_exponent) {
+  BigInteger left(digits);
+  BigInteger right(significand);
+  // 10^exponent is 5^exponent * 2^exponent; the fives go to whichever side
+  // keeps them integral
+  if (exponent >= 0) {
+    left.MultiplyPower5(static_cast<unsigned int>(exponent));
+  } else {
+    right.MultiplyPower5(static_cast<unsigned int>(-exponent));
+  }
+  if (exponent > binary_exponent) {
+    left.ShiftLeft(static_cast<unsigned int>(exponent - binary_exponent));
+  } else {
+    right.ShiftLeft(static_cast<unsigned int>(binary_exponent - exponent));
+  }
+  return left.Compare(right);
+}
+
+/// @brief Rounds the decimal text to the nearest T exactly, given the bits
+/// of a value within a few units in the last place.
+/// @details The first 800 significant digits are compared with the points
+/// halfway to the neighbours of the value as big integers, moving to a
+/// neighbour until the value is between them.  Halfway points need at most
+/// 767 significant digits, so any digits past the 800th only matter for
+/// being nonzero, which appending a 1 preserves.
+template <class T>
+typename FloatFormat<T>::Bits RoundDecimal(
+    const DecimalText&text, typename FloatFormat<T>::Bits bits) {
+  typedef FloatFormat<T> Format;
+  typedef typename Format::Bits Bits;
+  constexpr const int64_t max_digits = 800;
+  BigInteger digits(0);
+  int64_t zeros = 0;
+  int64_t kept = 0;
+  bool sticky = false;
+  uint32_t chunk = 0;
+  unsigned int chunk_digits = 0;
+  for (const char*position = text.digits_begin; position != text.digits_end;
+       ++position) {
+    if (*position == '.') {
+      continue;
+    }
+    const uint32_t digit = static_cast<unsigned char>(*position - '0');
+    if (!digit && !kept) {
+      ++zeros;
+    } else if (kept == max_digits) {
+      sticky |= digit != 0;
+    } else {
+      chunk = chunk * 10 + digit;
+      ++kept;
+      if (++chunk_digits == 9) {
+        digits.MultiplyAdd(1000000000u, chunk);
+        chunk = 0;
+        chunk_digits = 0;
+      }
+    }
+  }
+  digits.MultiplyAdd(constant::power_10_32bit[chunk_digits], chunk);
+  int64_t exponent = text.integer_digits - zeros - kept + text.exponent;
+  if (sticky) {
+    digits.MultiplyAdd(10, 1);
+    --exponent;
+  }
+  const int decimal_exponent = static_cast<int>(exponent);
+
+  const Bits hidden_bit = static_cast<Bits>(1) << Format::kSignificandBits;
+  const Bits infinity =
+      static_cast<Bits>(Format::kInfiniteExponent) << Format::kSignificandBits;
+  for (;;) {
+    const int biased_exponent =
+        static_cast<int>(bits >> Format::kSignificandBits);
+    const uint64_t significand = biased_exponent ?
+        (bits & (hidden_bit - 1)) | hidden_bit : bits;
+    const int binary_exponent =
+        (biased_exponent ? biased_exponent : 1) - Format::kExponentBias;
+    if (bits != infinity) {
+      const int order = CompareScaled(digits, decimal_exponent,
+                                      2 * significand + 1,
+                                      binary_exponent - 1);
+      if (order > 0 || (order == 0 && (significand & 1))) {
+        ++bits;
+        continue;
+      }
+    }
+    if (bits != 0) {
+      // at a power of two the next value down is half as far away
+      const bool lower_closer =
+          (bits & (hidden_bit - 1)) == 0 && biased_exponent > 1;
+      const int order = lower_closer ?
+          CompareScaled(digits, decimal_exponent, 4 * significand - 1,
+                        binary_exponent - 2) :
+          CompareScaled(digits, decimal_exponent, 2 * significand - 1,
+                        binary_exponent - 1);
+      if (order < 0 || (order == 0 && (significand & 1))) {
+        --bits;
+        continue;
+      }
+    }
+    return bits;
+  }
+}
+
+/// @brief Determines if the text starts with a word, ignoring case.
+inline bool StartsWithWord(const char*begin, const char*end,
+                           const char*word) {
+  for (; *word; ++begin, ++word) {
+    if (begin == end || (*begin | 0x20) != *word) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <class T>
+ParseResult ParseFloatingPoint(const char*begin, const char*end, T*value) {
+  typedef FloatFormat<T> Format;
+  typedef typename Format::Bits Bits;
+  const bool negative = begin != end && *begin == '-';
+  const char*position = begin + negative;
+  DecimalText text;
+  text.significand = 0;
+  const ParseResult parsed = ParseDecimalText(position, end, &text);
+  if (parsed.status != ParseStatus::kOk) {
+    T special;
+    if (StartsWithWord(position, end, "inf")) {
+      position += StartsWithWord(position, end, "infinity") ? 8 : 3;
+      special = std::numeric_limits<T>::infinity();
+    } else if (StartsWithWord(position, end, "nan")) {
+      position += 3;
+      special = std::numeric_limits<T>::quiet_NaN();
+    } else {
+      return ParseResult{begin, ParseStatus::kInvalid};
+    }
+    *value = negative ? -special : special;
+    return ParseResult{position, ParseStatus::kOk};
+  }
+  T result;
+  if (!ExactValue(text, &result)) {
+    Bits bits;
+    bool decided = EiselLemire<T>(
+        text.significand, text.significand_exponent, &bits);
+    if (text.truncated) {
+      // the dropped digits may only matter if rounding one more up differs
+      Bits upper_bits;
+      decided = EiselLemire<T>(text.significand + 1,
+                               text.significand_exponent, &upper_bits) &&
+          decided && upper_bits == bits;
+    }
+    if (!decided) {
+      bits = RoundDecimal<T>(text, bits);
+    }
+    if (bits == static_cast<Bits>(Format::kInfiniteExponent) <<
+        Format::kSignificandBits) {
+      return ParseResult{parsed.end, ParseStatus::kOverflow};
+    }
+    std::memcpy(&result, &bits, sizeof(result));
+  }
+  *value = negative ? -result : result;
+  return parsed;
+}
+
+template <class T>
+ParseResult ParseFloatingPointFields(const char*begin, const char*end,
+                                     char delimiter, std::vector<T>*values) {
+  ParseResult outcome{begin, ParseStatus::kOk};
+  if (begin == end) {
+    return outcome;
+  }
+  const char*position = begin;
+  for (;;) {
+    T value;
+    const ParseResult parsed = ParseFloatingPoint(position, end, &value);
+    const bool more = FinishField(parsed, position, end, delimiter, &outcome);
+    if (outcome.status == ParseStatus::kOk) {
+      values->push_back(value);
+    }
+    if (!more) {
+      return outcome;
+    }
+    position = parsed.end + 1;
+  }
+}
+
+}  // namespace
+
+bool FromStringSupported(FromStringKernel kernel) {
+  switch (kernel) {
+    case FromStringKernel::kScalar:
+      return true;
+#if defined(NX_TARGET_X86)
+    case FromStringKernel::kSse41:
+      return cpu::Supports(cpu::Feature::kSse41);
+    case FromStringKernel::kAvx2:
+      return cpu::Supports(cpu::Feature::kAvx2);
+#endif
+    default:
+      return false;
+  }
+}
+
+ParseResult FromStringFields(
+    FromStringKernel kernel, const char*begin, const char*end,
+    char delimiter, const ParseLimits&limits, uint64_t*values,
+    size_t length, size_t*count) {
+  return GetParseFieldsFunction(kernel)(
+      begin, end, delimiter, limits, values, length, count);
+}
+
+ParseResult FromStringFields(
+    const char*begin, const char*end, char delimiter,
+    const ParseLimits&limits, uint64_t*values, size_t length,
+    size_t*count) {
+  return parse_fields(begin, end, delimiter, limits, values, length, count);
+}
+
+}  // namespace detail
+/// @endcond
+
+ParseResult ParseDouble(const char*begin, const char*end, double*value) {
+  return detail::ParseFloatingPoint(begin, end, value);
+}
+
+ParseResult ParseFloat(const char*begin, const char*end, float*value) {
+  return detail::ParseFloatingPoint(begin, end, value);
+}
+
+ParseResult ParseDouble(const char*begin, const char*end, char delimiter,
+                        std::vector<double>*values) {
+  return detail::ParseFloatingPointFields(begin, end, delimiter, values);
+}
+
+ParseResult ParseFloat(const char*begin, const char*end, char delimiter,
+                       std::vector<float>*values) {
+  return detail::ParseFloatingPointFields(begin, end, delimiter, values);
+}
+
+}  // namespace nx
@@ -0,0 +1,233 @@
+//
+// Copyright (C) 2013 Jacob McIntosh <nacitar at ubercpp dot com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+/// @file morton.cc
+/// @brief Implementation for the array overloads of morton.h
+
+#include "nx/morton.h"
+
+/// @brief Library namespace.
+namespace nx {
+
+namespace {
+
+using detail::kMorton2Mask;
+using detail::kMorton3Mask;
+
+void Encode2ShiftMask(const uint32_t*x, const uint32_t*y, uint64_t*codes,
+                      size_t length) {
+  for (size_t i = 0; i < length; ++i) {
+    codes[i] = detail::Spread2(x[i]) | detail::Spread2(y[i]) << 1;
+  }
+}
+
+void Encode3ShiftMask(const uint32_t*x, const uint32_t*y, const uint32_t*z,
+                      uint64_t*codes, size_t length) {
+  for (size_t i = 0; i < length; ++i) {
+    codes[i] = detail::Spread3(x[i])
+        | detail::Spread3(y[i]) << 1
+        | detail::Spread3(z[i]) << 2;
+  }
+}
+
+void Decode2ShiftMask(const uint64_t*codes, uint32_t*x, uint32_t*y,
+                      size_t length) {
+  for (size_t i = 0; i < length; ++i) {
+    x[i] = static_cast<uint32_t>(detail::Compact2(codes[i]));
+    y[i] = static_cast<uint32_t>(detail::Compact2(codes[i] >> 1));
+  }
+}
+
+void Decode3ShiftMask(const uint64_t*codes, uint32_t*x, uint32_t*y,
+                      uint32_t*z, size_t length) {
+  for (size_t i = 0; i < length; ++i) {
+    x[i] = static_cast<uint32_t>(detail::Compact3(codes[i]));
+    y[i] = static_cast<uint32_t>(detail::Compact3(codes[i] >> 1));
+    z[i] = static_cast<uint32_t>(detail::Compact3(codes[i] >> 2));
+  }
+}
+
+#if defined(NX_TARGET_X86) && defined(NX_ARCH_X86_64)
+
+NX_TARGET("bmi2")
+void Encode2Bmi2(const uint32_t*x, const uint32_t*y, uint64_t*codes,
+                 size_t length) {
+  for (size_t i = 0; i < length; ++i) {
+    codes[i] = _pdep_u64(x[i], kMorton2Mask)
+        | _pdep_u64(y[i], kMorton2Mask << 1);
+  }
+}
+
+NX_TARGET("bmi2")
+void Encode3Bmi2(const uint32_t*x, const uint32_t*y, const uint32_t*z,
+                 uint64_t*codes, size_t length) {
+  for (size_t i = 0; i < length; ++i) {
+    codes[i] = _pdep_u64(x[i], kMorton3Mask)
+        | _pdep_u64(y[i], kMorton3Mask << 1)
+        | _pdep_u64(z[i], kMorton3Mask << 2);
+  }
+}
+
+NX_TARGET("bmi2")
+void Decode2Bmi2(const uint64_t*codes, uint32_t*x, uint32_t*y,
+                 size_t length) {
+  for (size_t i = 0; i < length; ++i) {
+    x[i] = static_cast<uint32_t>(_pext_u64(codes[i], kMorton2Mask));
+    y[i] = static_cast<uint32_t>(_pext_u64(codes[i], kMorton2Mask << 1));
+  }
+}
+
+NX_TARGET("bmi2")
+void Decode3Bmi2(const uint64_t*codes, uint32_t*x, uint32_t*y,
+                 uint32_t*z, size_t length) {
+  for (size_t i = 0; i < length; ++i) {
+    x[i] = static_cast<uint32_t>(_pext_u64(codes[i], kMorton3Mask));
+    y[i] = static_cast<uint32_t>(_pext_u64(codes[i], kMorton3Mask << 1));
+    z[i] = static_cast<uint32_t>(_pext_u64(codes[i], kMorton3Mask << 2));
+  }
+}
+
+/// @brief Defined if the BMI2 kernel is compiled.
+#define NX_MORTON_BMI2 1
+
+#endif  // NX_TARGET_X86 && NX_ARCH_X86_64
+
+typedef void (*Encode2Function)(
+    const uint32_t*, const uint32_t*, uint64_t*, size_t);
+typedef void (*Encode3Function)(
+    const uint32_t*, const uint32_t*, const uint32_t*, uint64_t*, size_t);
+typedef void (*Decode2Function)(
+    const uint64_t*, uint32_t*, uint32_t*, size_t);
+typedef void (*Decode3Function)(
+    const uint64_t*, uint32_t*, uint32_t*, uint32_t*, size_t);
+
+/// @brief The kernel chosen when none has been set.
+MortonKernel DefaultKernel() {
+  // Where pdep/pext are microcoded, the ladders are several times faster.
+  return cpu::Supports(cpu::Feature::kFastBmi2) &&
+      MortonSupported(MortonKernel::kBmi2)
+      ? MortonKernel::kBmi2 : MortonKernel::kShiftMask;
+}
+
+Encode2Function GetEncode2(MortonKernel kernel) {
+#if defined(NX_MORTON_BMI2)
+  if (kernel == MortonKernel::kBmi2) {
+    return &Encode2Bmi2;
+  }
+#endif
+  return &Encode2ShiftMask;
+}
+
+Encode3Function GetEncode3(MortonKernel kernel) {
+#if defined(NX_MORTON_BMI2)
+  if (kernel == MortonKernel::kBmi2) {
+    return &Encode3Bmi2;
+  }
+#endif
+  return &Encode3ShiftMask;
+}
+
+Decode2Function GetDecode2(MortonKernel kernel) {
+#if defined(NX_MORTON_BMI2)
+  if (kernel == MortonKernel::kBmi2) {
+    return &Decode2Bmi2;
+  }
+#endif
+  return &Decode2ShiftMask;
+}
+
+Decode3Function GetDecode3(MortonKernel kernel) {
+#if defined(NX_MORTON_BMI2)
+  if (kernel == MortonKernel::kBmi2) {
+    return &Decode3Bmi2;
+  }
+#endif
+  return &Decode3ShiftMask;
+}
+
+Encode2Function SelectEncode2() {
+  return GetEncode2(DefaultKernel());
+}
+
+Encode3Function SelectEncode3() {
+  return GetEncode3(DefaultKernel());
+}
+
+Decode2Function SelectDecode2() {
+  return GetDecode2(DefaultKernel());
+}
+
+Decode3Function SelectDecode3() {
+  return GetDecode3(DefaultKernel());
+}
+
+const cpu::Dispatch<void(
+    const uint32_t*, const uint32_t*, uint64_t*, size_t)>
+    encode2(&SelectEncode2);
+const cpu::Dispatch<void(
+    const uint32_t*, const uint32_t*, const uint32_t*, uint64_t*, size_t)>
+    encode3(&SelectEncode3);
+const cpu::Dispatch<void(
+    const uint64_t*, uint32_t*, uint32_t*, size_t)>
+    decode2(&SelectDecode2);
+const cpu::Dispatch<void(
+    const uint64_t*, uint32_t*, uint32_t*, uint32_t*, size_t)>
+    decode3(&SelectDecode3);
+
+}  // namespace
+
+bool MortonSupported(MortonKernel kernel) {
+  switch (kernel) {
+    case MortonKernel::kShiftMask:
+      return true;
+#if defined(NX_MORTON_BMI2)
+    case MortonKernel::kBmi2:
+      return cpu::Supports(cpu::Feature::kBmi2);
+#endif
+    default:
+      return false;
+  }
+}
+
+void SetMortonKernel(MortonKernel kernel) {
+  encode2.set(GetEncode2(kernel));
+  encode3.set(GetEncode3(kernel));
+  decode2.set(GetDecode2(kernel));
+  decode3.set(GetDecode3(kernel));
+}
+
+void MortonEncode(const uint32_t*x, const uint32_t*y, uint64_t*codes,
+                  size_t length) {
+  encode2(x, y, codes, length);
+}
+
+void MortonEncode(const uint32_t*x, const uint32_t*y, const uint32_t*z,
+                  uint64_t*codes, size_t length) {
+  encode3(x, y, z, codes, length);
+}
+
+void MortonDecode(const uint64_t*codes, uint32_t*x, uint32_t*y,
+                  size_t length) {
+  decode2(codes, x, y, length);
+}
+
+void MortonDecode(const uint64_t*codes, uint32_t*x, uint32_t*y, uint32_t*z,
+                  size_t length) {
+  decode3(codes, x, y, z, length);
+}
+
+}  // namespace nx
@@ -19,5 +19,16 @@
 /// convenient to build a single file (a Unity Build).
 
 #include "application.cc"
+#include "arithmetic.cc"
+#include "byte_order.cc"
+#include "cpu.cc"
+#include "from_string.cc"
+#include "morton.cc"
+#include "output_buffer.cc"
+#include "population_count.cc"
+#include "rank_select_bit_vector.cc"
+#include "reverse.cc"
+#include "set_bits.cc"
 #include "string_util.cc"
 #include "time.cc"
+#include "to_string.cc"
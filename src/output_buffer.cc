@@ -0,0 +1,214 @@
+//
+// Copyright (C) 2013 Jacob McIntosh <nacitar at ubercpp dot com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+/// @file output_buffer.cc
+/// @brief Implementation for output_buffer.h
+
+#include <cerrno>
+#include <stdexcept>
+#include "nx/output_buffer.h"
+
+#if defined(NX_OS_WINDOWS)
+  #include <io.h>  // NOLINT(build/include_order)
+#else
+  #include <limits.h>  // NOLINT(build/include_order)
+  #include <sys/uio.h>  // NOLINT(build/include_order)
+#endif
+
+/// @brief Library namespace.
+namespace nx {
+
+constexpr const size_t OutputBuffer::kDefaultBlockSize;
+constexpr const unsigned int OutputBuffer::kDefaultBlocks;
+constexpr const unsigned int OutputBuffer::kMaxBlocks;
+
+OutputBuffer::OutputBuffer(int descriptor, size_t block_size,
+                           unsigned int blocks)
+    : descriptor_(descriptor),
+      block_size_(std::max<size_t>(block_size, 1)),
+      blocks_(std::min(std::max(blocks, 2u), kMaxBlocks)),
+      lengths_(blocks_.size()),
+      head_(0),
+      pending_(0),
+      current_(0),
+      position_(nullptr),
+      end_(nullptr),
+      error_(0),
+      stopping_(false) {
+  blocks_[0].reset(new char[block_size_]);
+  position_ = blocks_[0].get();
+  end_ = position_ + block_size_;
+}
+
+OutputBuffer::~OutputBuffer() {
+  Flush();
+  if (thread_.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+    }
+    changed_.notify_all();
+    thread_.join();
+  }
+}
+
+void OutputBuffer::StartFlushThread() {
+  if (!thread_.joinable()) {
+    thread_ = std::thread(&OutputBuffer::FlushLoop, this);
+  }
+}
+
+bool OutputBuffer::Flush() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  ReleaseBlock(&lock);
+  if (thread_.joinable()) {
+    changed_.wait(lock, [this] { return !pending_; });
+  } else {
+    WritePending(&lock);
+  }
+  return !error_;
+}
+
+int OutputBuffer::error() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return error_;
+}
+
+void OutputBuffer::Append(const char*text, size_t length) {
+  while (length) {
+    if (position_ == end_) {
+      NextBlock(1);
+    }
+    const size_t count = std::min(
+        length, static_cast<size_t>(end_ - position_));
+    std::memcpy(position_, text, count);
+    position_ += count;
+    text += count;
+    length -= count;
+  }
+}
+
+void OutputBuffer::NextBlock(size_t length) {
+  if (length > block_size_) {
+    throw std::length_error("OutputBuffer::Reserve exceeds the block size");
+  }
+  std::unique_lock<std::mutex> lock(mutex_);
+  ReleaseBlock(&lock);
+}
+
+void OutputBuffer::ReleaseBlock(std::unique_lock<std::mutex>*lock) {
+  const size_t used = static_cast<size_t>(
+      position_ - blocks_[current_].get());
+  if (!used) {
+    return;
+  }
+  lengths_[current_] = used;
+  ++pending_;
+  if (thread_.joinable()) {
+    changed_.notify_all();
+    changed_.wait(*lock, [this] { return pending_ < blocks_.size(); });
+  } else if (pending_ == blocks_.size()) {
+    WritePending(lock);
+  }
+  current_ = (head_ + pending_) % blocks_.size();
+  if (!blocks_[current_]) {
+    blocks_[current_].reset(new char[block_size_]);
+  }
+  position_ = blocks_[current_].get();
+  end_ = position_ + block_size_;
+}
+
+void OutputBuffer::WritePending(std::unique_lock<std::mutex>*lock) {
+  const unsigned int first = head_;
+  const unsigned int count = pending_;
+  lock->unlock();
+  const int error = WriteBlocks(first, count);
+  lock->lock();
+  head_ = (first + count) % blocks_.size();
+  pending_ -= count;
+  if (error && !error_) {
+    error_ = error;
+  }
+}
+
+void OutputBuffer::FlushLoop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  for (;;) {
+    changed_.wait(lock, [this] { return pending_ || stopping_; });
+    if (!pending_) {
+      return;
+    }
+    WritePending(&lock);
+    changed_.notify_all();
+  }
+}
+
+#if defined(NX_OS_WINDOWS)
+
+int OutputBuffer::WriteBlocks(unsigned int first, unsigned int count) {
+  for (unsigned int i = 0; i < count; ++i) {
+    const unsigned int block = (first + i) % blocks_.size();
+    const char*text = blocks_[block].get();
+    size_t remaining = lengths_[block];
+    while (remaining) {
+      const int written = _write(descriptor_, text, static_cast<unsigned int>(
+          std::min<size_t>(remaining, 1u << 30)));
+      if (written < 0) {
+        return errno;
+      }
+      text += written;
+      remaining -= static_cast<size_t>(written);
+    }
+  }
+  return 0;
+}
+
+#else
+
+int OutputBuffer::WriteBlocks(unsigned int first, unsigned int count) {
+  iovec vectors[kMaxBlocks];
+  for (unsigned int i = 0; i < count; ++i) {
+    const unsigned int block = (first + i) % blocks_.size();
+    vectors[i].iov_base = blocks_[block].get();
+    vectors[i].iov_len = lengths_[block];
+  }
+  // write all of the blocks, continuing after any partial write
+  unsigned int index = 0;
+  while (index < count) {
+    const ssize_t written = writev(descriptor_, vectors + index,
+        static_cast<int>(std::min<unsigned int>(count - index, IOV_MAX)));
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return errno;
+    }
+    size_t remaining = static_cast<size_t>(written);
+    for (; index < count && remaining >= vectors[index].iov_len; ++index) {
+      remaining -= vectors[index].iov_len;
+    }
+    if (index < count) {
+      vectors[index].iov_base =
+          static_cast<char*>(vectors[index].iov_base) + remaining;
+      vectors[index].iov_len -= remaining;
+    }
+  }
+  return 0;
+}
+
+#endif
+
+}  // namespace nx
@@ -0,0 +1,304 @@
+//
+// Copyright (C) 2013 Jacob McIntosh <nacitar at ubercpp dot com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+/// @file population_count.cc
+/// @brief Implementation for the buffer overloads of population_count.h
+
+#include <cstring>
+#include "nx/population_count.h"
+
+#if defined(NX_TARGET_X86)
+  #include <immintrin.h>
+#endif
+
+/// @brief Library namespace.
+namespace nx {
+
+/// @cond nx_detail
+namespace detail {
+
+namespace {
+
+/// @brief Loads a 64-bit word from a possibly unaligned address.
+inline uint64_t LoadWord(const unsigned char*data) {
+  uint64_t word;
+  std::memcpy(&word, data, sizeof(word));
+  return word;
+}
+
+/// @brief Counts the bits of the bytes that don't fill a whole word.
+inline uint64_t CountTail(const unsigned char*data, size_t bytes) {
+  uint64_t count = 0;
+  while (bytes--) {
+    count += PopulationCount(*data++);
+  }
+  return count;
+}
+
+uint64_t CountScalar(const unsigned char*data, size_t bytes) {
+  uint64_t count = 0;
+  for (; bytes >= sizeof(uint64_t); bytes -= sizeof(uint64_t)) {
+    count += PopulationCount(LoadWord(data));
+    data += sizeof(uint64_t);
+  }
+  return count + CountTail(data, bytes);
+}
+
+/// @brief Carry-save adder; sums three bit vectors into a high and low bit.
+template <class T>
+inline void CarrySaveAdd(T*high, T*low, T a, T b, T c) {
+  const T u = a ^ b;
+  *high = (a & b) | (u & c);
+  *low = u ^ c;
+}
+
+uint64_t CountHarleySeal(const unsigned char*data, size_t bytes) {
+  constexpr size_t kBlock = 16 * sizeof(uint64_t);
+  uint64_t total = 0;
+  uint64_t ones = 0, twos = 0, fours = 0, eights = 0, sixteens;
+  uint64_t twos_a, twos_b, fours_a, fours_b, eights_a, eights_b;
+  for (; bytes >= kBlock; bytes -= kBlock) {
+    uint64_t w[16];
+    std::memcpy(w, data, kBlock);
+    CarrySaveAdd(&twos_a, &ones, ones, w[0], w[1]);
+    CarrySaveAdd(&twos_b, &ones, ones, w[2], w[3]);
+    CarrySaveAdd(&fours_a, &twos, twos, twos_a, twos_b);
+    CarrySaveAdd(&twos_a, &ones, ones, w[4], w[5]);
+    CarrySaveAdd(&twos_b, &ones, ones, w[6], w[7]);
+    CarrySaveAdd(&fours_b, &twos, twos, twos_a, twos_b);
+    CarrySaveAdd(&eights_a, &fours, fours, fours_a, fours_b);
+    CarrySaveAdd(&twos_a, &ones, ones, w[8], w[9]);
+    CarrySaveAdd(&twos_b, &ones, ones, w[10], w[11]);
+    CarrySaveAdd(&fours_a, &twos, twos, twos_a, twos_b);
+    CarrySaveAdd(&twos_a, &ones, ones, w[12], w[13]);
+    CarrySaveAdd(&twos_b, &ones, ones, w[14], w[15]);
+    CarrySaveAdd(&fours_b, &twos, twos, twos_a, twos_b);
+    CarrySaveAdd(&eights_b, &fours, fours, fours_a, fours_b);
+    CarrySaveAdd(&sixteens, &eights, eights, eights_a, eights_b);
+    total += PopulationCount(sixteens);
+    data += kBlock;
+  }
+  total = 16 * total
+      + 8 * PopulationCount(eights)
+      + 4 * PopulationCount(fours)
+      + 2 * PopulationCount(twos)
+      + PopulationCount(ones);
+  return total + CountScalar(data, bytes);
+}
+
+#if defined(NX_TARGET_X86)
+
+NX_TARGET("popcnt")
+uint64_t CountPopcnt(const unsigned char*data, size_t bytes) {
+  uint64_t count = 0;
+  for (; bytes >= sizeof(uint64_t); bytes -= sizeof(uint64_t)) {
+    count += static_cast<uint64_t>(__builtin_popcountll(LoadWord(data)));
+    data += sizeof(uint64_t);
+  }
+  return count + CountTail(data, bytes);
+}
+
+/// @brief Counts the bits of each byte with a nibble lookup, then sums
+/// them into the four 64-bit lanes.
+NX_TARGET("avx2")
+inline __m256i CountAvx2Vector(__m256i v) {
+  const __m256i lookup = _mm256_setr_epi8(
+      0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+      0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+  const __m256i low_mask = _mm256_set1_epi8(0x0f);
+  const __m256i low = _mm256_and_si256(v, low_mask);
+  const __m256i high = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask);
+  const __m256i count = _mm256_add_epi8(
+      _mm256_shuffle_epi8(lookup, low), _mm256_shuffle_epi8(lookup, high));
+  return _mm256_sad_epu8(count, _mm256_setzero_si256());
+}
+
+NX_TARGET("avx2")
+inline void CarrySaveAdd(
+    __m256i*high, __m256i*low, __m256i a, __m256i b, __m256i c) {
+  const __m256i u = _mm256_xor_si256(a, b);
+  *high = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(u, c));
+  *low = _mm256_xor_si256(u, c);
+}
+
+NX_TARGET("avx2")
+inline __m256i LoadAvx2(const unsigned char*data, unsigned int index) {
+  return _mm256_loadu_si256(
+      reinterpret_cast<const __m256i*>(data) + index);
+}
+
+NX_TARGET("avx2")
+uint64_t CountAvx2(const unsigned char*data, size_t bytes) {
+  constexpr size_t kBlock = 16 * sizeof(__m256i);
+  __m256i total = _mm256_setzero_si256();
+  __m256i ones = _mm256_setzero_si256();
+  __m256i twos = _mm256_setzero_si256();
+  __m256i fours = _mm256_setzero_si256();
+  __m256i eights = _mm256_setzero_si256();
+  __m256i sixteens, twos_a, twos_b, fours_a, fours_b, eights_a, eights_b;
+  for (; bytes >= kBlock; bytes -= kBlock) {
+    CarrySaveAdd(&twos_a, &ones, ones,
+        LoadAvx2(data, 0), LoadAvx2(data, 1));
+    CarrySaveAdd(&twos_b, &ones, ones,
+        LoadAvx2(data, 2), LoadAvx2(data, 3));
+    CarrySaveAdd(&fours_a, &twos, twos, twos_a, twos_b);
+    CarrySaveAdd(&twos_a, &ones, ones,
+        LoadAvx2(data, 4), LoadAvx2(data, 5));
+    CarrySaveAdd(&twos_b, &ones, ones,
+        LoadAvx2(data, 6), LoadAvx2(data, 7));
+    CarrySaveAdd(&fours_b, &twos, twos, twos_a, twos_b);
+    CarrySaveAdd(&eights_a, &fours, fours, fours_a, fours_b);
+    CarrySaveAdd(&twos_a, &ones, ones,
+        LoadAvx2(data, 8), LoadAvx2(data, 9));
+    CarrySaveAdd(&twos_b, &ones, ones,
+        LoadAvx2(data, 10), LoadAvx2(data, 11));
+    CarrySaveAdd(&fours_a, &twos, twos, twos_a, twos_b);
+    CarrySaveAdd(&twos_a, &ones, ones,
+        LoadAvx2(data, 12), LoadAvx2(data, 13));
+    CarrySaveAdd(&twos_b, &ones, ones,
+        LoadAvx2(data, 14), LoadAvx2(data, 15));
+    CarrySaveAdd(&fours_b, &twos, twos, twos_a, twos_b);
+    CarrySaveAdd(&eights_b, &fours, fours, fours_a, fours_b);
+    CarrySaveAdd(&sixteens, &eights, eights, eights_a, eights_b);
+    total = _mm256_add_epi64(total, CountAvx2Vector(sixteens));
+    data += kBlock;
+  }
+  total = _mm256_slli_epi64(total, 4);
+  total = _mm256_add_epi64(total,
+      _mm256_slli_epi64(CountAvx2Vector(eights), 3));
+  total = _mm256_add_epi64(total,
+      _mm256_slli_epi64(CountAvx2Vector(fours), 2));
+  total = _mm256_add_epi64(total,
+      _mm256_slli_epi64(CountAvx2Vector(twos), 1));
+  total = _mm256_add_epi64(total, CountAvx2Vector(ones));
+  for (; bytes >= sizeof(__m256i); bytes -= sizeof(__m256i)) {
+    total = _mm256_add_epi64(total, CountAvx2Vector(LoadAvx2(data, 0)));
+    data += sizeof(__m256i);
+  }
+  uint64_t lanes[4];
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), total);
+  return lanes[0] + lanes[1] + lanes[2] + lanes[3]
+      + CountScalar(data, bytes);
+}
+
+NX_TARGET("avx512f,avx512vpopcntdq")
+uint64_t CountAvx512(const unsigned char*data, size_t bytes) {
+  constexpr size_t kBlock = 4 * sizeof(__m512i);
+  // Independent accumulators hide the latency of the popcount.
+  __m512i total_a = _mm512_setzero_si512();
+  __m512i total_b = _mm512_setzero_si512();
+  __m512i total_c = _mm512_setzero_si512();
+  __m512i total_d = _mm512_setzero_si512();
+  for (; bytes >= kBlock; bytes -= kBlock) {
+    const __m512i* vectors = reinterpret_cast<const __m512i*>(data);
+    total_a = _mm512_add_epi64(total_a,
+        _mm512_popcnt_epi64(_mm512_loadu_si512(vectors)));
+    total_b = _mm512_add_epi64(total_b,
+        _mm512_popcnt_epi64(_mm512_loadu_si512(vectors + 1)));
+    total_c = _mm512_add_epi64(total_c,
+        _mm512_popcnt_epi64(_mm512_loadu_si512(vectors + 2)));
+    total_d = _mm512_add_epi64(total_d,
+        _mm512_popcnt_epi64(_mm512_loadu_si512(vectors + 3)));
+    data += kBlock;
+  }
+  for (; bytes >= sizeof(__m512i); bytes -= sizeof(__m512i)) {
+    total_a = _mm512_add_epi64(total_a,
+        _mm512_popcnt_epi64(_mm512_loadu_si512(data)));
+    data += sizeof(__m512i);
+  }
+  const __m512i total = _mm512_add_epi64(
+      _mm512_add_epi64(total_a, total_b), _mm512_add_epi64(total_c, total_d));
+  uint64_t lanes[8];
+  _mm512_storeu_si512(lanes, total);
+  return lanes[0] + lanes[1] + lanes[2] + lanes[3]
+      + lanes[4] + lanes[5] + lanes[6] + lanes[7]
+      + CountScalar(data, bytes);
+}
+
+#endif  // NX_TARGET_X86
+
+typedef uint64_t (*CountFunction)(const unsigned char*, size_t);
+
+CountFunction GetCountFunction(PopulationCountKernel kernel) {
+  switch (kernel) {
+#if defined(NX_TARGET_X86)
+    case PopulationCountKernel::kAvx512:
+      return &CountAvx512;
+    case PopulationCountKernel::kAvx2:
+      return &CountAvx2;
+    case PopulationCountKernel::kPopcnt:
+      return &CountPopcnt;
+#endif
+    case PopulationCountKernel::kHarleySeal:
+      return &CountHarleySeal;
+    default:
+      return &CountScalar;
+  }
+}
+
+CountFunction SelectCountFunction() {
+  const PopulationCountKernel preference[] = {
+    PopulationCountKernel::kAvx512,
+    PopulationCountKernel::kAvx2,
+    PopulationCountKernel::kPopcnt,
+    PopulationCountKernel::kHarleySeal
+  };
+  for (PopulationCountKernel kernel : preference) {
+    if (PopulationCountSupported(kernel)) {
+      return GetCountFunction(kernel);
+    }
+  }
+  return &CountScalar;
+}
+
+const cpu::Dispatch<uint64_t(const unsigned char*, size_t)> count_buffer(
+    &SelectCountFunction);
+
+}  // namespace
+
+bool PopulationCountSupported(PopulationCountKernel kernel) {
+  switch (kernel) {
+    case PopulationCountKernel::kScalar:
+    case PopulationCountKernel::kHarleySeal:
+      return true;
+#if defined(NX_TARGET_X86)
+    case PopulationCountKernel::kPopcnt:
+      return cpu::Supports(cpu::Feature::kPopcnt);
+    case PopulationCountKernel::kAvx2:
+      return cpu::Supports(cpu::Feature::kAvx2);
+    case PopulationCountKernel::kAvx512:
+      return cpu::Supports(cpu::Feature::kAvx512f)
+          && cpu::Supports(cpu::Feature::kAvx512vpopcntdq);
+#endif
+    default:
+      return false;
+  }
+}
+
+uint64_t PopulationCountBuffer(
+    PopulationCountKernel kernel, const void*data, size_t bytes) {
+  return GetCountFunction(kernel)(
+      static_cast<const unsigned char*>(data), bytes);
+}
+
+uint64_t PopulationCountBuffer(const void*data, size_t bytes) {
+  return count_buffer(static_cast<const unsigned char*>(data), bytes);
+}
+
+}  // namespace detail
+/// @endcond
+
+}  // namespace nx
@@ -0,0 +1,298 @@
+//
+// Copyright (C) 2013 Jacob McIntosh <nacitar at ubercpp dot com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+/// @file rank_select_bit_vector.cc
+/// @brief Implementation for rank_select_bit_vector.h
+
+#include <utility>
+#include "nx/rank_select_bit_vector.h"
+#include "nx/population_count.h"
+#include "nx/bit_scan_forward.h"
+
+#if defined(NX_TARGET_X86)
+  #include <immintrin.h>
+#endif
+
+/// @brief Library namespace.
+namespace nx {
+
+namespace {
+
+/// @brief Bits per word.
+constexpr unsigned int kWordBits = 64;
+/// @brief Words per 512-bit sub-block.
+constexpr unsigned int kSubBlockWords = 8;
+/// @brief Words per 2048-bit block.
+constexpr unsigned int kBlockWords = 32;
+/// @brief log2 of the bits per block.
+constexpr unsigned int kBlockShift = 11;
+/// @brief log2 of the blocks per superblock; superblocks span 2^32 bits.
+constexpr unsigned int kSuperblockShift = 32 - kBlockShift;
+/// @brief log2 of the set bits between select samples.
+constexpr unsigned int kSampleShift = 13;
+
+/// @brief Word operations built from the portable bit operations.
+class GenericKernel {
+ public:
+  static unsigned int Count(uint64_t word) {
+    return PopulationCount(word);
+  }
+
+  /// @brief Broadword selection (Vigna): finds the byte holding the k-th set
+  /// bit from the byte-wise prefix sums, then searches within that byte.
+  static unsigned int SelectInWord(uint64_t word, unsigned int k) {
+    constexpr uint64_t kOnesStep4 = 0x1111111111111111ull;
+    constexpr uint64_t kOnesStep8 = 0x0101010101010101ull;
+    constexpr uint64_t kMsbsStep8 = 0x80 * kOnesStep8;
+    uint64_t sums = word - ((word & 0xA * kOnesStep4) >> 1);
+    sums = (sums & 3 * kOnesStep4) + ((sums >> 2) & 3 * kOnesStep4);
+    sums = ((sums + (sums >> 4)) & 0x0F * kOnesStep8) * kOnesStep8;
+    const uint64_t k_step8 = k * kOnesStep8;
+    const unsigned int byte_offset = static_cast<unsigned int>(
+        (((((k_step8 | kMsbsStep8) - sums) & kMsbsStep8) >> 7)
+            * kOnesStep8 >> 53) & ~0x7ull);
+    unsigned int byte_rank = k - static_cast<unsigned int>(
+        ((sums << 8) >> byte_offset) & 0xFF);
+    unsigned int byte = static_cast<unsigned int>(
+        (word >> byte_offset) & 0xFF);
+    while (byte_rank--) {
+      byte &= byte - 1;
+    }
+    return byte_offset + BitScanForward(byte);
+  }
+};
+
+#if defined(NX_TARGET_X86) && defined(NX_ARCH_X86_64)
+/// @brief Word operations using popcnt, pdep and tzcnt.
+class Bmi2Kernel {
+ public:
+  NX_TARGET("popcnt")
+  static unsigned int Count(uint64_t word) {
+    return static_cast<unsigned int>(_mm_popcnt_u64(word));
+  }
+
+  NX_TARGET("bmi,bmi2")
+  static unsigned int SelectInWord(uint64_t word, unsigned int k) {
+    return static_cast<unsigned int>(
+        _tzcnt_u64(_pdep_u64(static_cast<uint64_t>(1) << k, word)));
+  }
+};
+#endif
+
+}  // namespace
+
+/// @cond nx_detail
+namespace detail {
+
+/// @brief The Rank() and Select() implementations, instantiated with the
+/// word operations of each instruction set.
+class RankSelectKernels {
+ public:
+  /// @brief The signature of the implementations.
+  typedef uint64_t (*Query)(const RankSelectBitVector*, uint64_t);
+
+  /// @brief The number of set bits before a block.
+  static uint64_t BlockRank(const RankSelectBitVector*vector, uint64_t block) {
+    return vector->superblocks_[block >> kSuperblockShift]
+        + (vector->blocks_[block] & 0xFFFFFFFFu);
+  }
+
+  template <class Kernel>
+  static uint64_t Rank(const RankSelectBitVector*vector, uint64_t index) {
+    const uint64_t block = index >> kBlockShift;
+    const uint64_t entry = vector->blocks_[block];
+    uint64_t rank = vector->superblocks_[block >> kSuperblockShift]
+        + (entry & 0xFFFFFFFFu);
+    const unsigned int sub_block = (index >> 9) & 3;
+    rank += ((entry >> 32) & 0x3FF) * (sub_block > 0)
+        + ((entry >> 42) & 0x3FF) * (sub_block > 1)
+        + ((entry >> 52) & 0x3FF) * (sub_block > 2);
+    const uint64_t*words = vector->words_.data();
+    const uint64_t*word = words + ((index >> 9) * kSubBlockWords);
+    const uint64_t*end = words + (index / kWordBits);
+    for (; word != end; ++word) {
+      rank += Kernel::Count(*word);
+    }
+    if (index % kWordBits) {
+      rank += Kernel::Count(
+          *end & ((static_cast<uint64_t>(1) << (index % kWordBits)) - 1));
+    }
+    return rank;
+  }
+
+  template <class Kernel>
+  static uint64_t Select(const RankSelectBitVector*vector, uint64_t k) {
+    // The sampled blocks bound a binary search for the block holding k.
+    uint64_t low = vector->samples_[k >> kSampleShift];
+    uint64_t high = vector->samples_[(k >> kSampleShift) + 1] + 1;
+    while (high - low > 1) {
+      const uint64_t middle = low + (high - low) / 2;
+      if (BlockRank(vector, middle) <= k) {
+        low = middle;
+      } else {
+        high = middle;
+      }
+    }
+    k -= BlockRank(vector, low);
+    uint64_t word = low * kBlockWords;
+    const uint64_t entry = vector->blocks_[low];
+    for (unsigned int shift = 32; shift < 62; shift += 10) {
+      const uint64_t sub_block_count = (entry >> shift) & 0x3FF;
+      if (k < sub_block_count) {
+        break;
+      }
+      k -= sub_block_count;
+      word += kSubBlockWords;
+    }
+    const uint64_t*words = vector->words_.data();
+    for (;; ++word) {
+      const unsigned int count = Kernel::Count(words[word]);
+      if (k < count) {
+        break;
+      }
+      k -= count;
+    }
+    return word * kWordBits + Kernel::SelectInWord(
+        words[word], static_cast<unsigned int>(k));
+  }
+
+  static uint64_t RankGeneric(
+      const RankSelectBitVector*vector, uint64_t index) {
+    return Rank<GenericKernel>(vector, index);
+  }
+
+  static uint64_t SelectGeneric(
+      const RankSelectBitVector*vector, uint64_t k) {
+    return Select<GenericKernel>(vector, k);
+  }
+
+#if defined(NX_TARGET_X86) && defined(NX_ARCH_X86_64)
+  // Flattening inlines the targetted word operations through the templates.
+  NX_TARGET("popcnt") __attribute__((flatten))
+  static uint64_t RankBmi2(const RankSelectBitVector*vector, uint64_t index) {
+    return Rank<Bmi2Kernel>(vector, index);
+  }
+
+  NX_TARGET("popcnt,bmi,bmi2") __attribute__((flatten))
+  static uint64_t SelectBmi2(const RankSelectBitVector*vector, uint64_t k) {
+    return Select<Bmi2Kernel>(vector, k);
+  }
+#endif
+
+  static Query ResolveRank() {
+#if defined(NX_TARGET_X86) && defined(NX_ARCH_X86_64)
+    if (cpu::Supports(cpu::Feature::kPopcnt)) {
+      return &RankBmi2;
+    }
+#endif
+    return &RankGeneric;
+  }
+
+  static Query ResolveSelect() {
+#if defined(NX_TARGET_X86) && defined(NX_ARCH_X86_64)
+    // pdep is microcoded on AMD processors before Zen 3, where it is slower
+    // than the broadword search; those report kBmi2 but not kFastBmi2.
+    if (cpu::Supports(cpu::Feature::kPopcnt) &&
+        cpu::Supports(cpu::Feature::kFastBmi2)) {
+      return &SelectBmi2;
+    }
+#endif
+    return &SelectGeneric;
+  }
+};
+
+}  // namespace detail
+/// @endcond
+
+const cpu::Dispatch<uint64_t(const RankSelectBitVector*, uint64_t)>
+    RankSelectBitVector::rank_(&detail::RankSelectKernels::ResolveRank);
+
+const cpu::Dispatch<uint64_t(const RankSelectBitVector*, uint64_t)>
+    RankSelectBitVector::select_(&detail::RankSelectKernels::ResolveSelect);
+
+RankSelectBitVector::RankSelectBitVector() : size_(0), count_(0) {
+  Build();
+}
+
+RankSelectBitVector::RankSelectBitVector(
+    const uint64_t*words, uint64_t size)
+    : words_(words, words + (size + kWordBits - 1) / kWordBits),
+      size_(size),
+      count_(0) {
+  Build();
+}
+
+RankSelectBitVector::RankSelectBitVector(
+    std::vector<uint64_t>&&words, uint64_t size)
+    : words_(std::move(words)),
+      size_(size),
+      count_(0) {
+  Build();
+}
+
+size_t RankSelectBitVector::index_bytes() const {
+  return blocks_.size() * sizeof(blocks_[0])
+      + superblocks_.size() * sizeof(superblocks_[0])
+      + samples_.size() * sizeof(samples_[0]);
+}
+
+void RankSelectBitVector::Build() {
+  // Clear the bits past the end, and pad to a whole number of blocks.
+  const uint64_t word_count = (size_ + kWordBits - 1) / kWordBits;
+  words_.resize(word_count);
+  if (size_ % kWordBits) {
+    words_.back() &= (static_cast<uint64_t>(1) << (size_ % kWordBits)) - 1;
+  }
+  const uint64_t block_count = (word_count + kBlockWords - 1) / kBlockWords;
+  words_.resize(block_count * kBlockWords, 0);
+
+  blocks_.assign(block_count + 1, 0);
+  superblocks_.assign((block_count >> kSuperblockShift) + 1, 0);
+  samples_.clear();
+  uint64_t total = 0;
+  uint64_t next_sample = 0;
+  for (uint64_t block = 0; block <= block_count; ++block) {
+    const uint64_t superblock = block >> kSuperblockShift;
+    if (!(block & ((static_cast<uint64_t>(1) << kSuperblockShift) - 1))) {
+      superblocks_[superblock] = total;
+    }
+    uint64_t entry = total - superblocks_[superblock];
+    if (block == block_count) {
+      blocks_[block] = entry;
+      break;
+    }
+    uint64_t block_total = 0;
+    for (unsigned int sub_block = 0; sub_block < 4; ++sub_block) {
+      const uint64_t count = PopulationCount(
+          &words_[block * kBlockWords + sub_block * kSubBlockWords],
+          kSubBlockWords);
+      if (sub_block < 3) {
+        entry |= count << (32 + 10 * sub_block);
+      }
+      block_total += count;
+    }
+    blocks_[block] = entry;
+    total += block_total;
+    for (; next_sample < total; next_sample += 1u << kSampleShift) {
+      samples_.push_back(static_cast<uint_least32_t>(block));
+    }
+  }
+  samples_.push_back(static_cast<uint_least32_t>(block_count));
+  count_ = total;
+}
+
+}  // namespace nx
@@ -0,0 +1,236 @@
+//
+// Copyright (C) 2013 Jacob McIntosh <nacitar at ubercpp dot com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+/// @file reverse.cc
+/// @brief Implementation for the array overloads of reverse.h
+
+#include <cstring>
+#include "nx/byte_order.h"
+#include "nx/reverse.h"
+
+#if defined(NX_TARGET_X86)
+  #include <immintrin.h>
+#endif
+
+/// @brief Library namespace.
+namespace nx {
+
+/// @cond nx_detail
+namespace detail {
+
+namespace {
+
+/// @brief Reverses one element of the given type in memory.
+template <class T>
+inline void ReverseElement(const unsigned char*source,
+                           unsigned char*destination) {
+  T value;
+  std::memcpy(&value, source, sizeof(value));
+  value = Reverse(value);
+  std::memcpy(destination, &value, sizeof(value));
+}
+
+/// @brief Reverses each element of an array of the given type.
+template <class T>
+void ReverseElements(const unsigned char*source, unsigned char*destination,
+                     size_t length) {
+  for (; length; --length) {
+    ReverseElement<T>(source, destination);
+    source += sizeof(T);
+    destination += sizeof(T);
+  }
+}
+
+void ReverseScalar(const unsigned char*source, unsigned char*destination,
+                   size_t length, unsigned int element_size) {
+  switch (element_size) {
+    case 8:
+      ReverseElements<uint64_t>(source, destination, length);
+      break;
+    case 4:
+      ReverseElements<uint32_t>(source, destination, length);
+      break;
+    case 2:
+      ReverseElements<uint16_t>(source, destination, length);
+      break;
+    default:
+      ReverseElements<uint8_t>(source, destination, length);
+      break;
+  }
+}
+
+#if defined(NX_TARGET_X86)
+
+/// @brief The reverse of each nibble, placed in the high nibble.
+alignas(16) const unsigned char kReverseToHigh[16] = {
+  0x00, 0x80, 0x40, 0xc0, 0x20, 0xa0, 0x60, 0xe0,
+  0x10, 0x90, 0x50, 0xd0, 0x30, 0xb0, 0x70, 0xf0
+};
+
+/// @brief The reverse of each nibble, placed in the low nibble.
+alignas(16) const unsigned char kReverseToLow[16] = {
+  0x00, 0x08, 0x04, 0x0c, 0x02, 0x0a, 0x06, 0x0e,
+  0x01, 0x09, 0x05, 0x0d, 0x03, 0x0b, 0x07, 0x0f
+};
+
+NX_TARGET("ssse3")
+inline __m128i ReverseSsse3Vector(
+    __m128i v, __m128i order, __m128i to_high, __m128i to_low) {
+  const __m128i low_mask = _mm_set1_epi8(0x0f);
+  v = _mm_shuffle_epi8(v, order);
+  const __m128i low = _mm_and_si128(v, low_mask);
+  const __m128i high = _mm_and_si128(_mm_srli_epi16(v, 4), low_mask);
+  return _mm_or_si128(
+      _mm_shuffle_epi8(to_high, low), _mm_shuffle_epi8(to_low, high));
+}
+
+NX_TARGET("ssse3")
+void ReverseSsse3(const unsigned char*source, unsigned char*destination,
+                  size_t length, unsigned int element_size) {
+  alignas(16) unsigned char order_bytes[16];
+  MakeByteOrder(order_bytes, element_size);
+  const __m128i order = _mm_load_si128(
+      reinterpret_cast<const __m128i*>(order_bytes));
+  const __m128i to_high = _mm_load_si128(
+      reinterpret_cast<const __m128i*>(kReverseToHigh));
+  const __m128i to_low = _mm_load_si128(
+      reinterpret_cast<const __m128i*>(kReverseToLow));
+  size_t bytes = length * element_size;
+  for (; bytes >= sizeof(__m128i); bytes -= sizeof(__m128i)) {
+    const __m128i v = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(source));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(destination),
+                     ReverseSsse3Vector(v, order, to_high, to_low));
+    source += sizeof(__m128i);
+    destination += sizeof(__m128i);
+  }
+  ReverseScalar(source, destination, bytes / element_size, element_size);
+}
+
+NX_TARGET("avx2")
+inline __m256i ReverseAvx2Vector(
+    __m256i v, __m256i order, __m256i to_high, __m256i to_low) {
+  const __m256i low_mask = _mm256_set1_epi8(0x0f);
+  v = _mm256_shuffle_epi8(v, order);
+  const __m256i low = _mm256_and_si256(v, low_mask);
+  const __m256i high = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask);
+  return _mm256_or_si256(
+      _mm256_shuffle_epi8(to_high, low), _mm256_shuffle_epi8(to_low, high));
+}
+
+NX_TARGET("avx2")
+inline __m256i BroadcastAvx2(const unsigned char*lane) {
+  return _mm256_broadcastsi128_si256(
+      _mm_load_si128(reinterpret_cast<const __m128i*>(lane)));
+}
+
+NX_TARGET("avx2")
+void ReverseAvx2(const unsigned char*source, unsigned char*destination,
+                 size_t length, unsigned int element_size) {
+  alignas(16) unsigned char order_bytes[16];
+  MakeByteOrder(order_bytes, element_size);
+  // vpshufb works within 128-bit lanes, which hold whole elements.
+  const __m256i order = BroadcastAvx2(order_bytes);
+  const __m256i to_high = BroadcastAvx2(kReverseToHigh);
+  const __m256i to_low = BroadcastAvx2(kReverseToLow);
+  size_t bytes = length * element_size;
+  for (; bytes >= 2 * sizeof(__m256i); bytes -= 2 * sizeof(__m256i)) {
+    const __m256i*in = reinterpret_cast<const __m256i*>(source);
+    __m256i*out = reinterpret_cast<__m256i*>(destination);
+    const __m256i a = _mm256_loadu_si256(in);
+    const __m256i b = _mm256_loadu_si256(in + 1);
+    _mm256_storeu_si256(out, ReverseAvx2Vector(a, order, to_high, to_low));
+    _mm256_storeu_si256(out + 1,
+                        ReverseAvx2Vector(b, order, to_high, to_low));
+    source += 2 * sizeof(__m256i);
+    destination += 2 * sizeof(__m256i);
+  }
+  ReverseScalar(source, destination, bytes / element_size, element_size);
+}
+
+#endif  // NX_TARGET_X86
+
+typedef void (*ReverseFunction)(
+    const unsigned char*, unsigned char*, size_t, unsigned int);
+
+ReverseFunction GetReverseFunction(ReverseBitsKernel kernel) {
+  switch (kernel) {
+#if defined(NX_TARGET_X86)
+    case ReverseBitsKernel::kAvx2:
+      return &ReverseAvx2;
+    case ReverseBitsKernel::kSsse3:
+      return &ReverseSsse3;
+#endif
+    default:
+      return &ReverseScalar;
+  }
+}
+
+ReverseFunction SelectReverseFunction() {
+  const ReverseBitsKernel preference[] = {
+    ReverseBitsKernel::kAvx2,
+    ReverseBitsKernel::kSsse3
+  };
+  for (ReverseBitsKernel kernel : preference) {
+    if (ReverseBitsSupported(kernel)) {
+      return GetReverseFunction(kernel);
+    }
+  }
+  return &ReverseScalar;
+}
+
+const cpu::Dispatch<void(
+    const unsigned char*, unsigned char*, size_t, unsigned int)>
+    reverse_buffer(&SelectReverseFunction);
+
+}  // namespace
+
+bool ReverseBitsSupported(ReverseBitsKernel kernel) {
+  switch (kernel) {
+    case ReverseBitsKernel::kScalar:
+      return true;
+#if defined(NX_TARGET_X86)
+    case ReverseBitsKernel::kSsse3:
+      return cpu::Supports(cpu::Feature::kSsse3);
+    case ReverseBitsKernel::kAvx2:
+      return cpu::Supports(cpu::Feature::kAvx2);
+#endif
+    default:
+      return false;
+  }
+}
+
+void ReverseBitsBuffer(
+    ReverseBitsKernel kernel, const void*source, void*destination,
+    size_t length, unsigned int element_size) {
+  GetReverseFunction(kernel)(
+      static_cast<const unsigned char*>(source),
+      static_cast<unsigned char*>(destination), length, element_size);
+}
+
+void ReverseBitsBuffer(
+    const void*source, void*destination,
+    size_t length, unsigned int element_size) {
+  reverse_buffer(
+      static_cast<const unsigned char*>(source),
+      static_cast<unsigned char*>(destination), length, element_size);
+}
+
+}  // namespace detail
+/// @endcond
+
+}  // namespace nx
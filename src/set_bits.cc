@@ -0,0 +1,97 @@
+//
+// Copyright (C) 2013 Jacob McIntosh <nacitar at ubercpp dot com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+/// @file set_bits.cc
+/// @brief Implementation for set_bits.h
+
+#include <cstring>
+#include "nx/set_bits.h"
+
+#if defined(NX_TARGET_X86)
+  #include <immintrin.h>
+#endif
+
+/// @brief Library namespace.
+namespace nx {
+
+/// @cond nx_detail
+namespace detail {
+
+namespace {
+
+typedef size_t (*FindFunction)(const unsigned char*, size_t);
+
+size_t FindNonZeroByteScalar(const unsigned char*data, size_t bytes) {
+  size_t offset = 0;
+  for (; offset + sizeof(uint64_t) <= bytes; offset += sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, data + offset, sizeof(word));
+    if (word) {
+      break;
+    }
+  }
+  while (offset < bytes && !data[offset]) {
+    ++offset;
+  }
+  return offset;
+}
+
+#if defined(NX_TARGET_X86)
+
+NX_TARGET("avx2")
+size_t FindNonZeroByteAvx2(const unsigned char*data, size_t bytes) {
+  constexpr size_t kBlock = 4 * sizeof(__m256i);
+  size_t offset = 0;
+  // Test four vectors at a time; the scalar search locates the byte.
+  for (; offset + kBlock <= bytes; offset += kBlock) {
+    const __m256i* vectors = reinterpret_cast<const __m256i*>(data + offset);
+    const __m256i any = _mm256_or_si256(
+        _mm256_or_si256(_mm256_loadu_si256(vectors),
+                        _mm256_loadu_si256(vectors + 1)),
+        _mm256_or_si256(_mm256_loadu_si256(vectors + 2),
+                        _mm256_loadu_si256(vectors + 3)));
+    if (!_mm256_testz_si256(any, any)) {
+      break;
+    }
+  }
+  return offset + FindNonZeroByteScalar(data + offset, bytes - offset);
+}
+
+#endif  // NX_TARGET_X86
+
+FindFunction SelectFindFunction() {
+#if defined(NX_TARGET_X86)
+  if (cpu::Supports(cpu::Feature::kAvx2)) {
+    return &FindNonZeroByteAvx2;
+  }
+#endif
+  return &FindNonZeroByteScalar;
+}
+
+const cpu::Dispatch<size_t(const unsigned char*, size_t)> find_non_zero_byte(
+    &SelectFindFunction);
+
+}  // namespace
+
+size_t FindNonZeroByte(const void*data, size_t bytes) {
+  return find_non_zero_byte(static_cast<const unsigned char*>(data), bytes);
+}
+
+}  // namespace detail
+/// @endcond
+
+}  // namespace nx
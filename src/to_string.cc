@@ -0,0 +1,788 @@
+//
+// Copyright (C) 2013 Jacob McIntosh <nacitar at ubercpp dot com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+/// @file to_string.cc
+/// @brief Implementation for the array overload of ToString(), ToHex() and
+/// the floating-point conversion in to_string.h
+
+#include <cstring>
+#include "nx/constant.h"
+#include "nx/to_string.h"
+
+#if defined(NX_TARGET_X86)
+  #include <immintrin.h>
+#endif
+
+/// @brief Library namespace.
+namespace nx {
+
+/// @cond nx_detail
+namespace detail {
+
+namespace {
+
+/// @brief A value as decimal digits times 10 to the power of an exponent.
+struct Decimal {
+  uint64_t digits;
+  int exponent;
+};
+
+/// @brief The layout of an IEEE-754 binary format, and the Schubfach
+/// operations that depend on its width.
+template <class T>
+struct FloatTraits;
+
+template <>
+struct FloatTraits<double> {
+  typedef uint64_t Bits;
+  /// @brief The stored significand bits, excluding the hidden bit.
+  static constexpr unsigned int kSignificandBits = 52;
+  /// @brief The exponent bias, plus kSignificandBits so that the significand
+  /// is an integer.
+  static constexpr int kExponentBias = 1075;
+
+  /// @brief The 128 most significant bits of 10^exponent, plus one.
+  struct Power {
+    uint64_t high;
+    uint64_t low;
+  };
+
+  static Power GetPower(int exponent) {
+    const uint_least64_t*entry = constant::power_10_128bit[
+        exponent - constant::power_10_128bit_min_exponent];
+    Power power = {entry[0], entry[1] + 1};
+    power.high += power.low == 0;
+    return power;
+  }
+
+  /// @brief Computes the upper 64 bits of power * value, rounded to odd.
+  static Bits RoundToOdd(const Power&power, Bits value) {
+    uint64_t low_high;
+    MultiplyWords(power.low, value, &low_high);
+    uint64_t high;
+    const uint64_t middle = MultiplyWords(power.high, value, &high) + low_high;
+    high += middle < low_high;
+    return high | (middle > 1);
+  }
+};
+
+template <>
+struct FloatTraits<float> {
+  typedef uint32_t Bits;
+  static constexpr unsigned int kSignificandBits = 23;
+  static constexpr int kExponentBias = 150;
+
+  /// @brief The 64 most significant bits of 10^exponent, plus one.
+  typedef uint64_t Power;
+
+  static Power GetPower(int exponent) {
+    return constant::power_10_128bit[
+        exponent - constant::power_10_128bit_min_exponent][0] + 1;
+  }
+
+  /// @brief Computes the upper 32 bits of power * value, rounded to odd.
+  static Bits RoundToOdd(Power power, Bits value) {
+    const uint64_t low = (power & 0xFFFFFFFFu) * value;
+    const uint64_t high = (power >> 32) * value + (low >> 32);
+    return static_cast<Bits>(high >> 32) |
+        (static_cast<Bits>(high) > 1);
+  }
+};
+
+/// @brief Finds the shortest decimal within the rounding interval of a
+/// finite, nonzero value, choosing the closest if there are several.
+/// @details This is the Schubfach algorithm by Raffaello Giulietti: the
+/// interval's bounds are scaled by a power of 10 chosen so that at most one
+/// candidate with one digit fewer than the scaled value falls within it, so
+/// only that candidate and the two neighbours of the scaled value need to be
+/// checked.  The products are rounded to odd, which keeps them exact enough
+/// to compare with the bounds.
+template <class T>
+Decimal ToDecimal(typename FloatTraits<T>::Bits significand,
+                  int biased_exponent) {
+  typedef FloatTraits<T> Traits;
+  typedef typename Traits::Bits Bits;
+  Bits c;
+  int q;
+  if (biased_exponent != 0) {
+    c = (static_cast<Bits>(1) << Traits::kSignificandBits) | significand;
+    q = biased_exponent - Traits::kExponentBias;
+    // small integers are exact, and need all of their digits
+    if (q <= 0 && -q <= static_cast<int>(Traits::kSignificandBits) &&
+        (c & ((static_cast<Bits>(1) << -q) - 1)) == 0) {
+      return Decimal{c >> -q, 0};
+    }
+  } else {
+    // subnormal
+    c = significand;
+    q = 1 - Traits::kExponentBias;
+  }
+  // the interval is closed when the significand is even, since ties round
+  // to even
+  const bool is_even = c % 2 == 0;
+  // at a power of two the next value down is half as far away
+  const bool lower_closer = significand == 0 && biased_exponent > 1;
+  // the lower bound, value and upper bound, times 4 * 2^q
+  const Bits cbl = 4 * c - 2 + lower_closer;
+  const Bits cb = 4 * c;
+  const Bits cbr = 4 * c + 2;
+
+  const int k = FloorLog10Pow2(q, lower_closer);
+  const int h = q + FloorLog2Pow10(-k) + 1;
+  const typename Traits::Power power = Traits::GetPower(-k);
+  // the same, times 10^-k
+  const Bits vbl = Traits::RoundToOdd(power, cbl << h);
+  const Bits vb = Traits::RoundToOdd(power, cb << h);
+  const Bits vbr = Traits::RoundToOdd(power, cbr << h);
+  const Bits lower = vbl + !is_even;
+  const Bits upper = vbr - !is_even;
+
+  const Bits s = vb / 4;
+  if (s >= 10) {
+    // a candidate with one digit fewer
+    const Bits sp = s / 10;
+    const bool up_inside = lower <= 40 * sp;
+    const bool wp_inside = 40 * sp + 40 <= upper;
+    if (up_inside != wp_inside) {
+      return Decimal{sp + wp_inside, k + 1};
+    }
+  }
+  // the neighbours of the value
+  const bool u_inside = lower <= 4 * s;
+  const bool w_inside = 4 * s + 4 <= upper;
+  if (u_inside != w_inside) {
+    return Decimal{s + w_inside, k};
+  }
+  // both are inside, so take the closer, or the even one on a tie
+  const Bits middle = 4 * s + 2;
+  const bool round_up = vb > middle || (vb == middle && (s & 1) != 0);
+  return Decimal{s + round_up, k};
+}
+
+/// @brief Writes a decimal in fixed or scientific notation.
+unsigned int WriteDecimal(Decimal decimal, char*buffer) {
+  while (decimal.digits % 10 == 0) {
+    decimal.digits /= 10;
+    ++decimal.exponent;
+  }
+  const unsigned int count = Digits<10>(decimal.digits);
+  const int signed_count = static_cast<int>(count);
+  // the position of the decimal point after the first digit
+  const int point = decimal.exponent + signed_count;
+  if (point > -4 && point <= 17) {
+    if (decimal.exponent >= 0) {
+      // an integer
+      ToString(decimal.digits, buffer, count);
+      std::memset(buffer + count, '0', decimal.exponent);
+      return count + decimal.exponent;
+    }
+    if (point > 0) {
+      // move the fractional digits over for the decimal point
+      ToString(decimal.digits, buffer, count);
+      std::memmove(buffer + point + 1, buffer + point, count - point);
+      buffer[point] = '.';
+      return count + 1;
+    }
+    // leading zeros
+    buffer[0] = '0';
+    buffer[1] = '.';
+    std::memset(buffer + 2, '0', -point);
+    ToString(decimal.digits, buffer + 2 - point, count);
+    return count + 2 - point;
+  }
+  // scientific notation, with the first digit moved over the decimal point
+  ToString(decimal.digits, buffer + 1, count);
+  buffer[0] = buffer[1];
+  unsigned int length = 1;
+  if (count > 1) {
+    buffer[1] = '.';
+    length = count + 1;
+  }
+  char*out = buffer + length;
+  *out++ = 'e';
+  int exponent = point - 1;
+  if (exponent < 0) {
+    *out++ = '-';
+    exponent = -exponent;
+  } else {
+    *out++ = '+';
+  }
+  if (exponent < 10) {
+    *out++ = '0';
+  }
+  out += ToString(static_cast<unsigned int>(exponent), out);
+  return static_cast<unsigned int>(out - buffer);
+}
+
+/// @brief Writes the shortest round-trip representation of a float or
+/// double.
+template <class T>
+unsigned int WriteShortestFloat(T value, char*buffer) {
+  typedef FloatTraits<T> Traits;
+  typedef typename Traits::Bits Bits;
+  Bits bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  const unsigned int kExponentBits =
+      BitSize<Bits>::value - Traits::kSignificandBits - 1;
+  const Bits significand =
+      bits & ((static_cast<Bits>(1) << Traits::kSignificandBits) - 1);
+  const int biased_exponent = static_cast<int>(
+      (bits >> Traits::kSignificandBits) & ((1u << kExponentBits) - 1));
+  if (biased_exponent == (1 << kExponentBits) - 1 && significand != 0) {
+    std::memcpy(buffer, "nan", 3);
+    return 3;
+  }
+  char*out = buffer;
+  if (bits >> (BitSize<Bits>::value - 1)) {
+    *out++ = '-';
+  }
+  if (biased_exponent == (1 << kExponentBits) - 1) {
+    std::memcpy(out, "inf", 3);
+    out += 3;
+  } else if (biased_exponent == 0 && significand == 0) {
+    *out++ = '0';
+  } else {
+    out += WriteDecimal(ToDecimal<T>(significand, biased_exponent), out);
+  }
+  return static_cast<unsigned int>(out - buffer);
+}
+
+/// @brief Writes the separator following each field.
+/// @details Separators that fit in the slack after the text are padded and
+/// written with one fixed-size copy, rather than a call to memcpy.
+class FieldSeparator {
+ public:
+  explicit FieldSeparator(const FieldFormat&format)
+      : text_(format.separator), length_(format.separator_length) {
+    std::memset(padded_, 0, sizeof(padded_));
+    if (length_ <= sizeof(padded_)) {
+      std::memcpy(padded_, text_, length_);
+    }
+  }
+
+  /// @brief Writes the separator, returning the end of it.
+  char*Write(char*out) const {
+    if (length_ <= sizeof(padded_)) {
+      std::memcpy(out, padded_, sizeof(padded_));
+    } else {
+      std::memcpy(out, text_, length_);
+    }
+    return out + length_;
+  }
+
+ private:
+  const char*text_;
+  const size_t length_;
+  char padded_[kToStringFieldsSlack];
+};
+
+/// @brief Converts with one ToString() call per element.
+template <class T>
+char*FieldsScalar(const T*values, size_t length, const FieldFormat&format,
+                  const char*begin, char*out, size_t*offsets) {
+  const FieldSeparator separator(format);
+  for (size_t i = 0; i < length; ++i) {
+    if (offsets) {
+      offsets[i] = static_cast<size_t>(out - begin);
+    }
+    out += ToString(values[i], out);
+    out = separator.Write(out);
+  }
+  return out;
+}
+
+#if defined(NX_TARGET_X86)
+
+/// @brief 10^16; the SIMD kernels convert 16 digits at a time.
+constexpr const uint64_t field_chunk = Power<uint64_t, 10, 16>::value;
+
+/// @brief An element split for writing.
+/// @details Values with up to 4 digits are written without SIMD, entirely
+/// as the leading digits.
+struct Field {
+  /// @brief The leading digits, beyond the low 16, if any.
+  uint64_t high;
+  /// @brief The low 16 digits.
+  uint64_t low;
+  /// @brief The digits of high to write.
+  unsigned int high_digits;
+  /// @brief The digits of low to write.
+  unsigned int low_digits;
+  /// @brief Whether a '-' is written first.
+  bool negative;
+};
+
+/// @brief Splits a value that has no sign.
+Field SplitField(uint64_t value, bool negative) {
+  Field field;
+  field.negative = negative;
+  const unsigned int digits = Digits<10>(value);
+  if (digits > 16) {
+    field.high = value / field_chunk;
+    field.low = value - field.high * field_chunk;
+    field.high_digits = digits - 16;
+    field.low_digits = 16;
+  } else if (digits > 4) {
+    field.high = 0;
+    field.low = value;
+    field.high_digits = 0;
+    field.low_digits = digits;
+  } else {
+    field.high = value;
+    field.low = 0;
+    field.high_digits = digits;
+    field.low_digits = 0;
+  }
+  return field;
+}
+
+inline Field SplitField(uint64_t value) {
+  return SplitField(value, false);
+}
+
+inline Field SplitField(int64_t value) {
+  return value < 0
+      ? SplitField(-static_cast<uint64_t>(value), true)
+      : SplitField(static_cast<uint64_t>(value), false);
+}
+
+/// @brief The multipliers that, with the shifts below, divide the 4 copies
+/// of a 4-digit value (scaled by 4) by 1000, 100, 10 and 1 in a 64-bit lane.
+#define NX_FIELD_DIVIDE 8389, 5243, 13108, -32768
+/// @brief The multipliers that complete the divisions as right shifts of 7,
+/// 5, 3 and 1.
+#define NX_FIELD_SHIFT 128, 2048, 8192, -32768
+
+/// @brief Converts the two values below 10^8 in the 64-bit lanes of a
+/// register into 16 bytes, each holding a digit from 0 to 9, most
+/// significant first.
+/// @details Each value is split into two 4-digit values which are copied
+/// four times each; multiplying the copies by reciprocals of powers of 10
+/// yields each digit preceded by the digits above it, which are then
+/// subtracted out.
+NX_TARGET("sse4.1")
+inline __m128i DigitBytesSse41(__m128i values) {
+  // values / 10000 and values % 10000
+  const __m128i upper = _mm_srli_epi64(
+      _mm_mul_epu32(values, _mm_set1_epi64x(0xd1b71759)), 45);
+  const __m128i lower = _mm_sub_epi32(
+      values, _mm_mullo_epi32(upper, _mm_set1_epi32(10000)));
+  // 16-bit words 0 and 1 of each lane hold 4 times upper and lower
+  const __m128i halves = _mm_slli_epi64(
+      _mm_or_si128(upper, _mm_slli_epi64(lower, 16)), 2);
+  const __m128i first = _mm_unpacklo_epi16(halves, halves);
+  const __m128i second = _mm_unpackhi_epi16(halves, halves);
+  const __m128i divide = _mm_setr_epi16(NX_FIELD_DIVIDE, NX_FIELD_DIVIDE);
+  const __m128i shift = _mm_setr_epi16(NX_FIELD_SHIFT, NX_FIELD_SHIFT);
+  const __m128i ten = _mm_set1_epi16(10);
+  __m128i digits[2];
+  const __m128i copies[2] = {
+    _mm_unpacklo_epi32(first, first),
+    _mm_unpacklo_epi32(second, second)
+  };
+  for (unsigned int i = 0; i < 2; ++i) {
+    const __m128i prefixes = _mm_mulhi_epu16(
+        _mm_mulhi_epu16(copies[i], divide), shift);
+    digits[i] = _mm_sub_epi16(prefixes, _mm_slli_epi64(
+        _mm_mullo_epi16(prefixes, ten), 16));
+  }
+  return _mm_packus_epi16(digits[0], digits[1]);
+}
+
+/// @brief AVX2 version, converting the values of both 128-bit lanes.
+NX_TARGET("avx2")
+inline __m256i DigitBytesAvx2(__m256i values) {
+  const __m256i upper = _mm256_srli_epi64(
+      _mm256_mul_epu32(values, _mm256_set1_epi64x(0xd1b71759)), 45);
+  const __m256i lower = _mm256_sub_epi32(
+      values, _mm256_mullo_epi32(upper, _mm256_set1_epi32(10000)));
+  const __m256i halves = _mm256_slli_epi64(
+      _mm256_or_si256(upper, _mm256_slli_epi64(lower, 16)), 2);
+  const __m256i first = _mm256_unpacklo_epi16(halves, halves);
+  const __m256i second = _mm256_unpackhi_epi16(halves, halves);
+  const __m256i divide = _mm256_setr_epi16(
+      NX_FIELD_DIVIDE, NX_FIELD_DIVIDE, NX_FIELD_DIVIDE, NX_FIELD_DIVIDE);
+  const __m256i shift = _mm256_setr_epi16(
+      NX_FIELD_SHIFT, NX_FIELD_SHIFT, NX_FIELD_SHIFT, NX_FIELD_SHIFT);
+  const __m256i ten = _mm256_set1_epi16(10);
+  __m256i digits[2];
+  const __m256i copies[2] = {
+    _mm256_unpacklo_epi32(first, first),
+    _mm256_unpacklo_epi32(second, second)
+  };
+  for (unsigned int i = 0; i < 2; ++i) {
+    const __m256i prefixes = _mm256_mulhi_epu16(
+        _mm256_mulhi_epu16(copies[i], divide), shift);
+    digits[i] = _mm256_sub_epi16(prefixes, _mm256_slli_epi64(
+        _mm256_mullo_epi16(prefixes, ten), 16));
+  }
+  return _mm256_packus_epi16(digits[0], digits[1]);
+}
+
+#undef NX_FIELD_DIVIDE
+#undef NX_FIELD_SHIFT
+
+/// @brief Places the high and low 8 digits of a value below 10^16 in the
+/// two 64-bit lanes of a register.
+NX_TARGET("sse4.1")
+inline __m128i SplitDigitsSse41(uint64_t value) {
+  const uint64_t high = value / 100000000;
+  return _mm_set_epi64x(static_cast<int64_t>(value - high * 100000000),
+                        static_cast<int64_t>(high));
+}
+
+/// @brief Writes the low digits of a field as ascii, given the 16 digit
+/// bytes of its low value.  The store covers 16 bytes regardless.
+NX_TARGET("sse4.1")
+inline char*StoreFieldDigits(const Field&field, __m128i digit_bytes,
+                             char*out) {
+  if (!field.low_digits) {
+    return out;
+  }
+  // move the wanted digits to the front; the bytes after them are unused
+  const __m128i index = _mm_add_epi8(
+      _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15),
+      _mm_set1_epi8(static_cast<char>(16 - field.low_digits)));
+  const __m128i text = _mm_add_epi8(
+      _mm_shuffle_epi8(digit_bytes, index), _mm_set1_epi8('0'));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(out), text);
+  return out + field.low_digits;
+}
+
+/// @brief Writes the sign and the leading digits of a field, which are at
+/// most 4, with one 4-byte store.
+inline char*WriteFieldPrefixX86(const Field&field, char*out) {
+  *out = '-';
+  out += field.negative;
+  char pairs[4];
+  WriteDigitPair(static_cast<uint_fast32_t>(field.high / 100), pairs);
+  WriteDigitPair(static_cast<uint_fast32_t>(field.high % 100), pairs + 2);
+  uint32_t text;
+  std::memcpy(&text, pairs, sizeof(text));
+  // drop the leading zeros; x86 is little-endian, so they are the low bytes
+  text = static_cast<uint32_t>(
+      static_cast<uint64_t>(text) >> (8 * (4 - field.high_digits)));
+  std::memcpy(out, &text, sizeof(text));
+  return out + field.high_digits;
+}
+
+/// @brief Writes one element.
+NX_TARGET("sse4.1")
+inline char*WriteFieldSse41(const Field&field, char*out) {
+  out = WriteFieldPrefixX86(field, out);
+  if (!field.low_digits) {
+    return out;
+  }
+  return StoreFieldDigits(
+      field, DigitBytesSse41(SplitDigitsSse41(field.low)), out);
+}
+
+template <class T>
+NX_TARGET("sse4.1")
+char*FieldsSse41(const T*values, size_t length, const FieldFormat&format,
+                 const char*begin, char*out, size_t*offsets) {
+  const FieldSeparator separator(format);
+  for (size_t i = 0; i < length; ++i) {
+    if (offsets) {
+      offsets[i] = static_cast<size_t>(out - begin);
+    }
+    out = WriteFieldSse41(SplitField(values[i]), out);
+    out = separator.Write(out);
+  }
+  return out;
+}
+
+template <class T>
+NX_TARGET("avx2")
+char*FieldsAvx2(const T*values, size_t length, const FieldFormat&format,
+                const char*begin, char*out, size_t*offsets) {
+  const FieldSeparator separator(format);
+  size_t i = 0;
+  for (; i + 2 <= length; i += 2) {
+    const Field first = SplitField(values[i]);
+    const Field second = SplitField(values[i + 1]);
+    __m256i digit_bytes = _mm256_setzero_si256();
+    if (first.low_digits | second.low_digits) {
+      digit_bytes = DigitBytesAvx2(_mm256_set_m128i(
+          SplitDigitsSse41(second.low), SplitDigitsSse41(first.low)));
+    }
+    // each field is written after the one before it, as the 16-byte stores
+    // spill past the end of the field
+    if (offsets) {
+      offsets[i] = static_cast<size_t>(out - begin);
+    }
+    out = WriteFieldPrefixX86(first, out);
+    out = StoreFieldDigits(
+        first, _mm256_castsi256_si128(digit_bytes), out);
+    out = separator.Write(out);
+    if (offsets) {
+      offsets[i + 1] = static_cast<size_t>(out - begin);
+    }
+    out = WriteFieldPrefixX86(second, out);
+    out = StoreFieldDigits(
+        second, _mm256_extracti128_si256(digit_bytes, 1), out);
+    out = separator.Write(out);
+  }
+  return FieldsSse41(values + i, length - i, format, begin, out,
+                     offsets ? offsets + i : nullptr);
+}
+
+#endif  // NX_TARGET_X86
+
+/// @brief The signature of the kernels.
+template <class T>
+struct FieldsFunction {
+  typedef char*(*type)(const T*, size_t, const FieldFormat&, const char*,
+                       char*, size_t*);
+};
+
+template <class T>
+typename FieldsFunction<T>::type GetFieldsFunction(ToStringKernel kernel) {
+  switch (kernel) {
+#if defined(NX_TARGET_X86)
+    case ToStringKernel::kAvx2:
+      return &FieldsAvx2<T>;
+    case ToStringKernel::kSse41:
+      return &FieldsSse41<T>;
+#endif
+    default:
+      return &FieldsScalar<T>;
+  }
+}
+
+template <class T>
+typename FieldsFunction<T>::type SelectFieldsFunction() {
+  const ToStringKernel preference[] = {
+    ToStringKernel::kAvx2,
+    ToStringKernel::kSse41
+  };
+  for (ToStringKernel kernel : preference) {
+    if (ToStringSupported(kernel)) {
+      return GetFieldsFunction<T>(kernel);
+    }
+  }
+  return &FieldsScalar<T>;
+}
+
+const cpu::Dispatch<char*(
+    const uint64_t*, size_t, const FieldFormat&, const char*, char*, size_t*)>
+    unsigned_fields(&SelectFieldsFunction<uint64_t>);
+
+const cpu::Dispatch<char*(
+    const int64_t*, size_t, const FieldFormat&, const char*, char*, size_t*)>
+    signed_fields(&SelectFieldsFunction<int64_t>);
+
+/// @brief Writes the bytes left over by the kernels, or all of them, 8 at a
+/// time as big-endian words so that the first byte is written first.
+template <LetterCase letter_case>
+void HexBytesScalar(const uint8_t*data, size_t length, char*buffer) {
+  for (; length >= sizeof(uint64_t); length -= sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, data, sizeof(word));
+    WriteHexWord<letter_case>(BigEndianValue(word), buffer);
+    data += sizeof(uint64_t);
+    buffer += 2 * sizeof(uint64_t);
+  }
+  for (; length; --length) {
+    WriteRadixDigits<16, letter_case>(*data++, buffer, 2);
+    buffer += 2;
+  }
+}
+
+void HexScalar(const uint8_t*data, size_t length, char*buffer,
+               LetterCase letter_case) {
+  if (letter_case == LetterCase::kUpper) {
+    HexBytesScalar<LetterCase::kUpper>(data, length, buffer);
+  } else {
+    HexBytesScalar<LetterCase::kLower>(data, length, buffer);
+  }
+}
+
+#if defined(NX_TARGET_X86)
+
+/// @brief The digits indexed by pshufb, in each case.
+const char hex_digits[2][17] = {
+  "0123456789abcdef", "0123456789ABCDEF"
+};
+
+/// @brief Writes 16 bytes at a time; each nibble indexes the digits, and the
+/// digits of the high nibbles are interleaved before those of the low ones.
+NX_TARGET("ssse3")
+void HexSsse3(const uint8_t*data, size_t length, char*buffer,
+              LetterCase letter_case) {
+  const __m128i digits = _mm_loadu_si128(reinterpret_cast<const __m128i*>(
+      hex_digits[letter_case == LetterCase::kUpper]));
+  const __m128i nibble = _mm_set1_epi8(0x0f);
+  for (; length >= 16; length -= 16) {
+    const __m128i bytes = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(data));
+    const __m128i high = _mm_shuffle_epi8(
+        digits, _mm_and_si128(_mm_srli_epi16(bytes, 4), nibble));
+    const __m128i low = _mm_shuffle_epi8(
+        digits, _mm_and_si128(bytes, nibble));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(buffer),
+                     _mm_unpacklo_epi8(high, low));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(buffer + 16),
+                     _mm_unpackhi_epi8(high, low));
+    data += 16;
+    buffer += 32;
+  }
+  HexScalar(data, length, buffer, letter_case);
+}
+
+/// @brief Writes 32 bytes at a time; the interleaving stays within each
+/// 128-bit lane, so the halves are put back in order as they are stored.
+NX_TARGET("avx2")
+void HexAvx2(const uint8_t*data, size_t length, char*buffer,
+             LetterCase letter_case) {
+  const __m256i digits = _mm256_broadcastsi128_si256(_mm_loadu_si128(
+      reinterpret_cast<const __m128i*>(
+          hex_digits[letter_case == LetterCase::kUpper])));
+  const __m256i nibble = _mm256_set1_epi8(0x0f);
+  for (; length >= 32; length -= 32) {
+    const __m256i bytes = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(data));
+    const __m256i high = _mm256_shuffle_epi8(
+        digits, _mm256_and_si256(_mm256_srli_epi16(bytes, 4), nibble));
+    const __m256i low = _mm256_shuffle_epi8(
+        digits, _mm256_and_si256(bytes, nibble));
+    const __m256i first = _mm256_unpacklo_epi8(high, low);
+    const __m256i second = _mm256_unpackhi_epi8(high, low);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(buffer),
+                        _mm256_permute2x128_si256(first, second, 0x20));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(buffer + 32),
+                        _mm256_permute2x128_si256(first, second, 0x31));
+    data += 32;
+    buffer += 64;
+  }
+  HexSsse3(data, length, buffer, letter_case);
+}
+
+#endif  // NX_TARGET_X86
+
+/// @brief The signature of the kernels.
+typedef void (*HexFunction)(const uint8_t*, size_t, char*, LetterCase);
+
+HexFunction GetHexFunction(HexKernel kernel) {
+  switch (kernel) {
+#if defined(NX_TARGET_X86)
+    case HexKernel::kAvx2:
+      return &HexAvx2;
+    case HexKernel::kSsse3:
+      return &HexSsse3;
+#endif
+    default:
+      return &HexScalar;
+  }
+}
+
+HexFunction SelectHexFunction() {
+  const HexKernel preference[] = {
+    HexKernel::kAvx2,
+    HexKernel::kSsse3
+  };
+  for (HexKernel kernel : preference) {
+    if (HexSupported(kernel)) {
+      return GetHexFunction(kernel);
+    }
+  }
+  return &HexScalar;
+}
+
+const cpu::Dispatch<void(const uint8_t*, size_t, char*, LetterCase)>
+    hex_bytes(&SelectHexFunction);
+
+}  // namespace
+
+unsigned int WriteShortest(double value, char*buffer) {
+  return WriteShortestFloat(value, buffer);
+}
+
+unsigned int WriteShortest(float value, char*buffer) {
+  return WriteShortestFloat(value, buffer);
+}
+
+bool ToStringSupported(ToStringKernel kernel) {
+  switch (kernel) {
+    case ToStringKernel::kScalar:
+      return true;
+#if defined(NX_TARGET_X86)
+    case ToStringKernel::kSse41:
+      return cpu::Supports(cpu::Feature::kSse41);
+    case ToStringKernel::kAvx2:
+      return cpu::Supports(cpu::Feature::kAvx2);
+#endif
+    default:
+      return false;
+  }
+}
+
+char*ToStringFields(
+    ToStringKernel kernel, const uint64_t*values, size_t length,
+    const FieldFormat&format, const char*begin, char*out, size_t*offsets) {
+  return GetFieldsFunction<uint64_t>(kernel)(
+      values, length, format, begin, out, offsets);
+}
+
+char*ToStringFields(
+    ToStringKernel kernel, const int64_t*values, size_t length,
+    const FieldFormat&format, const char*begin, char*out, size_t*offsets) {
+  return GetFieldsFunction<int64_t>(kernel)(
+      values, length, format, begin, out, offsets);
+}
+
+char*ToStringFields(
+    const uint64_t*values, size_t length,
+    const FieldFormat&format, const char*begin, char*out, size_t*offsets) {
+  return unsigned_fields(values, length, format, begin, out, offsets);
+}
+
+char*ToStringFields(
+    const int64_t*values, size_t length,
+    const FieldFormat&format, const char*begin, char*out, size_t*offsets) {
+  return signed_fields(values, length, format, begin, out, offsets);
+}
+
+bool HexSupported(HexKernel kernel) {
+  switch (kernel) {
+    case HexKernel::kScalar:
+      return true;
+#if defined(NX_TARGET_X86)
+    case HexKernel::kSsse3:
+      return cpu::Supports(cpu::Feature::kSsse3);
+    case HexKernel::kAvx2:
+      return cpu::Supports(cpu::Feature::kAvx2);
+#endif
+    default:
+      return false;
+  }
+}
+
+void WriteHex(HexKernel kernel, const uint8_t*data, size_t length,
+              char*buffer, LetterCase letter_case) {
+  GetHexFunction(kernel)(data, length, buffer, letter_case);
+}
+
+void WriteHex(const uint8_t*data, size_t length, char*buffer,
+              LetterCase letter_case) {
+  hex_bytes(data, length, buffer, letter_case);
+}
+
+}  // namespace detail
+/// @endcond
+
+}  // namespace nx
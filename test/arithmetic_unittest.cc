@@ -0,0 +1,252 @@
+//
+// Copyright (C) 2013 Jacob McIntosh <nacitar at ubercpp dot com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+/// @file arithmetic_unittest.cc
+/// @brief Unit tests for arithmetic.h
+
+#include <cstring>
+#include <random>
+#include <vector>
+#include "gtest/gtest.h"
+#include "nx/arithmetic.h"
+
+namespace {
+
+/// @brief Clamps an exact result to the range of T.
+template <class T>
+T Clamp(nx::int64_t value) {
+  const nx::int64_t max = nx::detail::MaximumValue<T>();
+  const nx::int64_t min = nx::detail::MinimumValue<T>();
+  return static_cast<T>(value > max ? max : value < min ? min : value);
+}
+
+/// @brief Checks every pair of operands of an 8-bit type against exact
+/// arithmetic in a wider one.
+template <class T>
+void ExpectExhaustive() {
+  const int min = nx::detail::MinimumValue<T>();
+  const int max = nx::detail::MaximumValue<T>();
+  for (int i = min; i <= max; ++i) {
+    for (int j = min; j <= max; ++j) {
+      const T a = static_cast<T>(i);
+      const T b = static_cast<T>(j);
+      T result;
+      EXPECT_EQ(Clamp<T>(i + j) == i + j, nx::CheckedAdd(a, b, &result));
+      EXPECT_EQ(static_cast<T>(i + j), result);
+      EXPECT_EQ(Clamp<T>(i - j) == i - j, nx::CheckedSub(a, b, &result));
+      EXPECT_EQ(static_cast<T>(i - j), result);
+      EXPECT_EQ(Clamp<T>(i * j) == i * j, nx::CheckedMul(a, b, &result));
+      EXPECT_EQ(static_cast<T>(i * j), result);
+      EXPECT_EQ(Clamp<T>(i + j), nx::SaturatingAdd(a, b));
+      EXPECT_EQ(Clamp<T>(i - j), nx::SaturatingSub(a, b));
+      EXPECT_EQ(Clamp<T>(i * j), nx::SaturatingMul(a, b));
+    }
+  }
+}
+
+/// @brief Produces a random value, half of the time near a limit of T.
+template <class T>
+T RandomValue(std::mt19937_64*random) {
+  const nx::uint64_t bits = (*random)();
+  switch (bits & 7) {
+    case 0:
+      return static_cast<T>(nx::detail::MaximumValue<T>() - (bits >> 61));
+    case 1:
+      return static_cast<T>(nx::detail::MinimumValue<T>() + (bits >> 61));
+    case 2:
+      return static_cast<T>((bits >> 61) - 4);
+    case 3:
+      return static_cast<T>(nx::detail::MaximumValue<T>() / 2 + (bits >> 61));
+    default:
+      return static_cast<T>(bits >> 3);
+  }
+}
+
+template <class T>
+void ExpectKernelsSaturate(std::mt19937_64*random) {
+  using nx::detail::SaturatingKernel;
+  const SaturatingKernel kernels[] = {
+    SaturatingKernel::kScalar,
+    SaturatingKernel::kSse2,
+    SaturatingKernel::kAvx2
+  };
+  const bool is_signed = nx::IsSigned<T>::value;
+  // Lengths around the vector widths exercise the scalar tails.
+  for (nx::size_t length : { 0, 1, 7, 16, 31, 64, 67, 200 }) {
+    std::vector<T> lhs(length);
+    std::vector<T> rhs(length);
+    std::vector<T> sums(length);
+    std::vector<T> differences(length);
+    for (nx::size_t i = 0; i < length; ++i) {
+      lhs[i] = RandomValue<T>(random);
+      rhs[i] = RandomValue<T>(random);
+      sums[i] = nx::SaturatingAdd(lhs[i], rhs[i]);
+      differences[i] = nx::SaturatingSub(lhs[i], rhs[i]);
+    }
+    for (SaturatingKernel kernel : kernels) {
+      if (!nx::detail::SaturatingSupported(kernel)) {
+        continue;
+      }
+      std::vector<T> result(length);
+      nx::detail::SaturatingAddBuffer(kernel, lhs.data(), rhs.data(),
+                                      result.data(), length, sizeof(T),
+                                      is_signed);
+      EXPECT_EQ(sums, result)
+          << "kernel " << static_cast<int>(kernel) << ", length " << length;
+      nx::detail::SaturatingSubBuffer(kernel, lhs.data(), rhs.data(),
+                                      result.data(), length, sizeof(T),
+                                      is_signed);
+      EXPECT_EQ(differences, result)
+          << "kernel " << static_cast<int>(kernel) << ", length " << length;
+      std::vector<T> data(lhs);
+      nx::detail::SaturatingAddBuffer(kernel, data.data(), rhs.data(),
+                                      data.data(), length, sizeof(T),
+                                      is_signed);
+      EXPECT_EQ(sums, data)
+          << "kernel " << static_cast<int>(kernel) << ", length " << length;
+    }
+  }
+}
+
+}  // namespace
+
+TEST(ArithmeticTest, Exhaustive8Bit) {
+  ExpectExhaustive<nx::uint8_t>();
+  ExpectExhaustive<nx::int8_t>();
+}
+
+TEST(ArithmeticTest, Random16And32Bit) {
+  std::mt19937_64 random;
+  for (int i = 0; i < 100000; ++i) {
+    const nx::int16_t a = RandomValue<nx::int16_t>(&random);
+    const nx::int16_t b = RandomValue<nx::int16_t>(&random);
+    EXPECT_EQ(Clamp<nx::int16_t>(a * b), nx::SaturatingMul(a, b));
+    const nx::uint32_t c = RandomValue<nx::uint32_t>(&random);
+    const nx::uint32_t d = RandomValue<nx::uint32_t>(&random);
+    const nx::uint64_t product = static_cast<nx::uint64_t>(c) * d;
+    nx::uint32_t result;
+    EXPECT_EQ(product <= UINT32_MAX, nx::CheckedMul(c, d, &result));
+    EXPECT_EQ(static_cast<nx::uint32_t>(product), result);
+    const nx::int32_t e = RandomValue<nx::int32_t>(&random);
+    const nx::int32_t f = RandomValue<nx::int32_t>(&random);
+    EXPECT_EQ(Clamp<nx::int32_t>(static_cast<nx::int64_t>(e) + f),
+              nx::SaturatingAdd(e, f));
+    EXPECT_EQ(Clamp<nx::int32_t>(static_cast<nx::int64_t>(e) - f),
+              nx::SaturatingSub(e, f));
+    EXPECT_EQ(Clamp<nx::int32_t>(static_cast<nx::int64_t>(e) * f),
+              nx::SaturatingMul(e, f));
+  }
+}
+
+TEST(ArithmeticTest, Limits64Bit) {
+  const nx::int64_t max = INT64_MAX;
+  const nx::int64_t min = INT64_MIN;
+  nx::int64_t result;
+  EXPECT_TRUE(nx::CheckedAdd(max, min, &result));
+  EXPECT_EQ(-1, result);
+  EXPECT_FALSE(nx::CheckedAdd(max, nx::int64_t(1), &result));
+  EXPECT_EQ(min, result);
+  EXPECT_FALSE(nx::CheckedSub(min, nx::int64_t(1), &result));
+  EXPECT_EQ(max, result);
+  EXPECT_FALSE(nx::CheckedSub(nx::int64_t(0), min, &result));
+  EXPECT_TRUE(nx::CheckedMul(min, nx::int64_t(1), &result));
+  EXPECT_FALSE(nx::CheckedMul(min, nx::int64_t(-1), &result));
+  EXPECT_EQ(min, result);
+  EXPECT_TRUE(nx::CheckedMul(nx::int64_t(-4294967296ll),
+                             nx::int64_t(2147483648ll), &result));
+  EXPECT_EQ(min, result);
+  EXPECT_FALSE(nx::CheckedMul(nx::int64_t(4294967296ll),
+                              nx::int64_t(2147483648ll), &result));
+  EXPECT_EQ(max, nx::SaturatingMul(min, nx::int64_t(-1)));
+  EXPECT_EQ(min, nx::SaturatingMul(max, nx::int64_t(-2)));
+  EXPECT_EQ(min, nx::SaturatingSub(nx::int64_t(-2), max));
+  EXPECT_EQ(max, nx::SaturatingSub(nx::int64_t(0), min));
+
+  const nx::uint64_t umax = UINT64_MAX;
+  nx::uint64_t uresult;
+  EXPECT_FALSE(nx::CheckedAdd(umax, nx::uint64_t(1), &uresult));
+  EXPECT_EQ(0u, uresult);
+  EXPECT_TRUE(nx::CheckedMul(nx::uint64_t(4294967295u),
+                             nx::uint64_t(4294967297u), &uresult));
+  EXPECT_EQ(umax, uresult);
+  EXPECT_FALSE(nx::CheckedMul(nx::uint64_t(4294967296u),
+                              nx::uint64_t(4294967296u), &uresult));
+  EXPECT_EQ(umax, nx::SaturatingAdd(umax, umax));
+  EXPECT_EQ(0u, nx::SaturatingSub(nx::uint64_t(1), umax));
+  EXPECT_EQ(umax, nx::SaturatingMul(umax, nx::uint64_t(2)));
+}
+
+#if defined(NX_HAS_INT128)
+TEST(ArithmeticTest, Int128) {
+  const nx::int128_t max = nx::detail::MaximumValue<nx::int128_t>();
+  const nx::int128_t min = nx::detail::MinimumValue<nx::int128_t>();
+  EXPECT_TRUE(max == nx::SaturatingAdd(max, nx::int128_t(1)));
+  EXPECT_TRUE(min == nx::SaturatingMul(max, nx::int128_t(-3)));
+  EXPECT_TRUE(min + 1 == nx::SaturatingMul(max, nx::int128_t(-1)));
+  nx::uint128_t result;
+  EXPECT_FALSE(nx::CheckedMul(nx::uint128_t(1) << 64, nx::uint128_t(1) << 64,
+                              &result));
+  EXPECT_TRUE(nx::CheckedSub(nx::uint128_t(3), nx::uint128_t(2), &result));
+  EXPECT_TRUE(nx::uint128_t(1) == result);
+}
+#endif
+
+TEST(ArithmeticTest, SaturatingType) {
+  typedef nx::SaturatingUInt<8> Pixel;
+  Pixel pixel = 200;
+  pixel += 100;
+  EXPECT_EQ(255u, pixel.value());
+  EXPECT_EQ(Pixel::max(), pixel);
+  EXPECT_EQ(Pixel(0), Pixel(10) - Pixel(20));
+  EXPECT_EQ(Pixel(250), Pixel(25) * 10);
+  EXPECT_EQ(Pixel(255), Pixel(26) * 10);
+  EXPECT_TRUE(Pixel(3) < Pixel(4));
+
+  typedef nx::SaturatingInt<16> Sample;
+  static_assert(sizeof(Sample) == 2, "SaturatingInt<16> is 16 bits");
+  Sample sample = -30000;
+  sample -= 10000;
+  EXPECT_EQ(Sample::min(), sample);
+  sample *= -1;
+  EXPECT_EQ(Sample::max(), sample);
+  EXPECT_EQ(Sample(-1), Sample(Sample::max()) + Sample::min());
+  EXPECT_TRUE(Sample(-2) <= Sample(-2));
+  EXPECT_TRUE(Sample(1) != Sample(-1));
+}
+
+TEST(ArithmeticTest, Kernels) {
+  std::mt19937_64 random;
+  ExpectKernelsSaturate<nx::uint8_t>(&random);
+  ExpectKernelsSaturate<nx::int8_t>(&random);
+  ExpectKernelsSaturate<nx::uint16_t>(&random);
+  ExpectKernelsSaturate<nx::int16_t>(&random);
+  ExpectKernelsSaturate<nx::uint32_t>(&random);
+  ExpectKernelsSaturate<nx::int32_t>(&random);
+  ExpectKernelsSaturate<nx::uint64_t>(&random);
+  ExpectKernelsSaturate<nx::int64_t>(&random);
+}
+
+TEST(ArithmeticTest, Arrays) {
+  const nx::int16_t lhs[] = { 32000, -32000, 5, -5, 0 };
+  const nx::int16_t rhs[] = { 1000, -1000, 6, 4, -32768 };
+  nx::int16_t result[5];
+  nx::SaturatingAdd(lhs, rhs, result, 5);
+  const nx::int16_t sums[] = { 32767, -32768, 11, -1, -32768 };
+  EXPECT_EQ(0, std::memcmp(sums, result, sizeof(sums)));
+  nx::SaturatingSub(lhs, rhs, result, 5);
+  const nx::int16_t differences[] = { 31000, -31000, -1, -9, 32767 };
+  EXPECT_EQ(0, std::memcmp(differences, result, sizeof(differences)));
+}
@@ -0,0 +1,137 @@
+//
+// Copyright (C) 2013 Jacob McIntosh <nacitar at ubercpp dot com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+/// @file bit_array_unittest.cc
+/// @brief Unit tests for bit_array.h
+
+#include <algorithm>
+#include <bitset>
+#include <random>
+#include <vector>
+#include "gtest/gtest.h"
+#include "nx/bit_array.h"
+
+namespace {
+
+/// @brief Checks every query against std::bitset after random edits.
+template <unsigned int kBits>
+void ExpectMatchesBitset(std::mt19937*random) {
+  nx::BitArray<kBits> bits;
+  std::bitset<kBits> expected;
+  for (int round = 0; round < 50; ++round) {
+    const unsigned int edits = (*random)() % 8;
+    for (unsigned int i = 0; i < edits; ++i) {
+      const unsigned int index = (*random)() % kBits;
+      bits.Flip(index);
+      expected.flip(index);
+    }
+    ASSERT_EQ(expected.count(), bits.Count());
+    ASSERT_EQ(expected.any(), bits.Any());
+    ASSERT_EQ(expected.all(), bits.All());
+    std::vector<nx::size_t> indices;
+    for (nx::size_t i = bits.FindFirst(); i != bits.size();
+         i = bits.FindNext(i)) {
+      indices.push_back(i);
+    }
+    std::vector<nx::size_t> visited;
+    bits.ForEachSetBit([&visited](nx::size_t i) { visited.push_back(i); });
+    ASSERT_EQ(indices, visited);
+    nx::size_t rank = 0;
+    nx::size_t last = bits.size();
+    for (nx::size_t i = 0; i < kBits; ++i) {
+      ASSERT_EQ(expected[i], bits[i]);
+      ASSERT_EQ(rank, bits.Rank(i));
+      if (expected[i]) {
+        ASSERT_EQ(rank, static_cast<nx::size_t>(
+            std::find(indices.begin(), indices.end(), i) - indices.begin()));
+        ++rank;
+        last = i;
+      }
+    }
+    ASSERT_EQ(rank, bits.Rank(kBits));
+    ASSERT_EQ(last, bits.FindLast());
+  }
+}
+
+}  // namespace
+
+TEST(BitArrayTest, WordType) {
+  EXPECT_EQ(1u, sizeof(nx::BitArray<5>::word_type));
+  EXPECT_EQ(2u, sizeof(nx::BitArray<16>::word_type));
+  EXPECT_EQ(8u, sizeof(nx::BitArray<64>::word_type));
+  EXPECT_EQ(8u, sizeof(nx::BitArray<4096>::word_type));
+  EXPECT_EQ(64u, nx::BitArray<4096>::kWords);
+  EXPECT_EQ(sizeof(std::bitset<256>), sizeof(nx::BitArray<256>));
+  EXPECT_EQ(0x1fu, nx::BitArray<69>::kLastMask);
+}
+
+TEST(BitArrayTest, Constexpr) {
+  constexpr nx::BitArray<100> bits(0x8000000000000005ull);
+  static_assert(bits[0] && !bits[1] && bits[2] && bits[63] && !bits[64],
+                "BitArray must be constexpr");
+  static_assert(bits.size() == 100, "BitArray::size must be constexpr");
+  constexpr nx::BitArray<4> truncated(0xff);
+  static_assert(truncated[3] && !truncated.Test(4),
+                "bits beyond the size must be cleared");
+  EXPECT_EQ(4u, truncated.Count());
+  EXPECT_EQ(3u, bits.Count());
+}
+
+TEST(BitArrayTest, Modify) {
+  nx::BitArray<130> bits;
+  EXPECT_TRUE(bits.None());
+  EXPECT_EQ(130u, bits.FindFirst());
+  EXPECT_EQ(130u, bits.FindLast());
+  bits.Set(129).Set(64).Set(3);
+  EXPECT_EQ(3u, bits.FindFirst());
+  EXPECT_EQ(64u, bits.FindNext(3));
+  EXPECT_EQ(129u, bits.FindNext(64));
+  EXPECT_EQ(130u, bits.FindNext(129));
+  EXPECT_EQ(129u, bits.FindLast());
+  bits.Reset(64);
+  EXPECT_FALSE(bits[64]);
+  EXPECT_EQ(2u, bits.Count());
+  bits.SetAll();
+  EXPECT_TRUE(bits.All());
+  EXPECT_EQ(130u, bits.Count());
+  EXPECT_EQ(0u, (~bits).Count());
+  bits.ResetAll();
+  EXPECT_TRUE(bits.None());
+}
+
+TEST(BitArrayTest, Operators) {
+  const nx::BitArray<200> a = nx::BitArray<200>(0xf0).Set(150).Set(199);
+  const nx::BitArray<200> b = nx::BitArray<200>(0x3c).Set(150).Set(10);
+  EXPECT_EQ(nx::BitArray<200>(0x30).Set(150), a & b);
+  EXPECT_EQ(nx::BitArray<200>(0xfc).Set(150).Set(199).Set(10), a | b);
+  EXPECT_EQ(nx::BitArray<200>(0xcc).Set(199).Set(10), a ^ b);
+  nx::BitArray<200> c = a;
+  c.AndNot(b);
+  EXPECT_EQ(nx::BitArray<200>(0xc0).Set(199), c);
+  EXPECT_NE(a, b);
+  EXPECT_EQ(200u - a.Count(), (~a).Count());
+}
+
+TEST(BitArrayTest, Bitset) {
+  std::mt19937 random;
+  ExpectMatchesBitset<1>(&random);
+  ExpectMatchesBitset<13>(&random);
+  ExpectMatchesBitset<64>(&random);
+  ExpectMatchesBitset<65>(&random);
+  ExpectMatchesBitset<256>(&random);
+  ExpectMatchesBitset<1000>(&random);
+}
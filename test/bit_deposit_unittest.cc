@@ -0,0 +1,64 @@
+//
+// Copyright (C) 2013 Jacob McIntosh <nacitar at ubercpp dot com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+/// @file bit_deposit_unittest.cc
+/// @brief Unit tests for bit_deposit.h
+
+#include <random>
+#include "gtest/gtest.h"
+#include "nx/bit_deposit.h"
+
+TEST(BitDepositTest, Constexpr) {
+  static_assert(nx::detail::BitDepositLoop<nx::uint32_t>(0x5, 0xf0, 1, 0)
+                == 0x50, "BitDepositLoop must be constexpr");
+  static_assert(nx::detail::BitExtractLoop<nx::uint32_t>(0x50, 0xf0, 1, 0)
+                == 0x5, "BitExtractLoop must be constexpr");
+}
+
+TEST(BitDepositTest, Deposit) {
+  EXPECT_EQ(0u, nx::BitDeposit(0u, 0xffffffffu));
+  EXPECT_EQ(0x80000001u, nx::BitDeposit(0x3u, 0x80000001u));
+  EXPECT_EQ(0x10u, nx::BitDeposit(0x5u, 0x30u));
+  EXPECT_EQ(0x020000000000000bull,
+            nx::BitDeposit(0x2bull, 0x0f0000000000000full));
+  EXPECT_EQ(0x0f00, nx::BitDeposit<nx::int16_t>(-1, 0x0f00));
+}
+
+TEST(BitDepositTest, Extract) {
+  EXPECT_EQ(0x3u, nx::BitExtract(0x80000001u, 0x80000001u));
+  EXPECT_EQ(0x1u, nx::BitExtract(0x10u, 0x30u));
+  EXPECT_EQ(0x2bull, nx::BitExtract(0x020000000000000bull,
+                                    0x0f0000000000000full));
+  EXPECT_EQ(0xf, nx::BitExtract<nx::int16_t>(-1, 0x0f00));
+}
+
+TEST(BitDepositTest, Generic) {
+  // Whichever implementation is in use must agree with the generic loop.
+  std::mt19937_64 random;
+  for (int i = 0; i < 1000; ++i) {
+    const nx::uint64_t value = random();
+    const nx::uint64_t mask = random() & random();
+    const nx::uint64_t deposited = nx::BitDeposit(value, mask);
+    EXPECT_EQ(nx::detail::BitDepositLoop<nx::uint64_t>(value, mask, 1, 0),
+              deposited);
+    EXPECT_EQ(nx::detail::BitExtractLoop<nx::uint64_t>(value, mask, 1, 0),
+              nx::BitExtract(value, mask));
+    EXPECT_EQ(0u, deposited & ~mask);
+    EXPECT_EQ(deposited, nx::BitDeposit(nx::BitExtract(deposited, mask),
+                                        mask));
+  }
+}
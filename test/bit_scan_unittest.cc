@@ -0,0 +1,117 @@
+//
+// Copyright (C) 2013 Jacob McIntosh <nacitar at ubercpp dot com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+/// @file bit_scan_unittest.cc
+/// @brief Unit tests for bit_scan_forward.h and bit_scan_reverse.h
+
+#include <random>
+#include <vector>
+#include "gtest/gtest.h"
+#include "nx/bit_scan_forward.h"
+#include "nx/bit_scan_reverse.h"
+
+TEST(BitScanTest, Intrinsic) {
+  // Supported toolchains must not fall back to the lookup tables.
+#if (defined(NX_TC_GCC) || defined(NX_TC_CLANG) || defined(NX_TC_VS))
+#if !defined(NX_USE_GENERIC_BIT_SCAN_FORWARD)
+#if !defined(NX_BIT_SCAN_FORWARD_INTRINSIC)
+  ADD_FAILURE() << "BitScanForward is using the generic implementation.";
+#endif
+#endif
+#if !defined(NX_USE_GENERIC_BIT_SCAN_REVERSE)
+#if !defined(NX_BIT_SCAN_REVERSE_INTRINSIC)
+  ADD_FAILURE() << "BitScanReverse is using the generic implementation.";
+#endif
+#endif
+#endif
+}
+
+TEST(BitScanTest, Constexpr) {
+#if !defined(NX_TC_VS) || defined(NX_USE_GENERIC_BIT_SCAN_FORWARD)
+  static_assert(nx::BitScanForward(0x50u) == 4, "constexpr BitScanForward");
+#endif
+#if !defined(NX_TC_VS) || defined(NX_USE_GENERIC_BIT_SCAN_REVERSE)
+  static_assert(nx::BitScanReverse(0x50u) == 6, "constexpr BitScanReverse");
+#endif
+}
+
+TEST(BitScanTest, Forward) {
+  EXPECT_EQ(0u, nx::BitScanForward(0u));
+  EXPECT_EQ(0u, nx::BitScanForward(1u));
+  EXPECT_EQ(3u, nx::BitScanForward(static_cast<unsigned char>(0x88)));
+  EXPECT_EQ(15u, nx::BitScanForward(static_cast<unsigned short>(0x8000)));
+  EXPECT_EQ(31u, nx::BitScanForward(0x80000000u));
+  EXPECT_EQ(63u, nx::BitScanForward(0x8000000000000000ull));
+  EXPECT_EQ(0u, nx::BitScanForward(-1));
+  for (unsigned int bit = 0; bit < 64; ++bit) {
+    EXPECT_EQ(bit, nx::BitScanForward(~0ull << bit));
+  }
+}
+
+TEST(BitScanTest, Reverse) {
+  EXPECT_EQ(0u, nx::BitScanReverse(0u));
+  EXPECT_EQ(0u, nx::BitScanReverse(1u));
+  EXPECT_EQ(7u, nx::BitScanReverse(static_cast<unsigned char>(0x88)));
+  EXPECT_EQ(7u, nx::BitScanReverse(static_cast<signed char>(-1)));
+  EXPECT_EQ(0u, nx::BitScanReverse(static_cast<unsigned short>(1)));
+  EXPECT_EQ(15u, nx::BitScanReverse(static_cast<unsigned short>(0x8001)));
+  EXPECT_EQ(31u, nx::BitScanReverse(0x80000001u));
+  EXPECT_EQ(63u, nx::BitScanReverse(0x8000000000000001ull));
+  for (unsigned int bit = 0; bit < 64; ++bit) {
+    EXPECT_EQ(bit, nx::BitScanReverse(~0ull >> (63 - bit)));
+  }
+}
+
+TEST(BitScanTest, WideTables) {
+  using nx::detail::version::BitScanReverse;
+  using nx::detail::version::WideBitScanReverse;
+  std::mt19937_64 random;
+  std::vector<nx::uint64_t> values = { 0, 1, ~0ull, 0x8000000000000001ull };
+  for (unsigned int bit = 0; bit < 64; ++bit) {
+    values.push_back(1ull << bit);
+    values.push_back(~0ull >> bit);
+  }
+  for (int i = 0; i < 1000; ++i) {
+    // Shifting spreads the highest set bit over every position.
+    values.push_back(random() >> (i % 64));
+  }
+  for (nx::uint64_t value : values) {
+    const nx::uint32_t low32 = static_cast<nx::uint32_t>(value);
+    const nx::uint16_t low16 = static_cast<nx::uint16_t>(value);
+    EXPECT_EQ(BitScanReverse<64>(value), WideBitScanReverse<64>(value))
+        << value;
+    EXPECT_EQ(BitScanReverse<32>(low32), WideBitScanReverse<32>(low32))
+        << value;
+    EXPECT_EQ(BitScanReverse<16>(low16), WideBitScanReverse<16>(low16))
+        << value;
+    EXPECT_EQ(nx::BitScanReverse(value), WideBitScanReverse<64>(value))
+        << value;
+  }
+}
+
+#if defined(NX_HAS_INT128)
+TEST(BitScanTest, Int128) {
+  typedef nx::uint128_t uint128;
+  EXPECT_EQ(0u, nx::BitScanForward(static_cast<uint128>(0)));
+  EXPECT_EQ(0u, nx::BitScanReverse(static_cast<uint128>(0)));
+  EXPECT_EQ(127u, nx::BitScanReverse(static_cast<nx::int128_t>(-1)));
+  for (unsigned int bit = 0; bit < 128; ++bit) {
+    EXPECT_EQ(bit, nx::BitScanForward(~static_cast<uint128>(0) << bit));
+    EXPECT_EQ(bit, nx::BitScanReverse(~static_cast<uint128>(0) >> (127 - bit)));
+  }
+}
+#endif
@@ -0,0 +1,151 @@
+//
+// Copyright (C) 2013 Jacob McIntosh <nacitar at ubercpp dot com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+/// @file byte_order_unittest.cc
+/// @brief Unit tests for byte_order.h
+
+#include <random>
+#include <vector>
+#include "gtest/gtest.h"
+#include "nx/byte_order.h"
+
+namespace {
+
+template <class T>
+void ExpectKernelsSwap(std::mt19937_64*random) {
+  using nx::detail::ByteSwapKernel;
+  const ByteSwapKernel kernels[] = {
+    ByteSwapKernel::kScalar,
+    ByteSwapKernel::kSsse3,
+    ByteSwapKernel::kAvx2
+  };
+  // Lengths around the vector widths exercise the scalar tails.
+  for (nx::size_t length : { 0, 1, 7, 16, 31, 64, 67, 200 }) {
+    std::vector<T> source(length);
+    std::vector<T> expected(length);
+    for (nx::size_t i = 0; i < length; ++i) {
+      source[i] = static_cast<T>((*random)());
+      expected[i] = nx::ByteSwap(source[i]);
+    }
+    for (ByteSwapKernel kernel : kernels) {
+      if (!nx::detail::ByteSwapSupported(kernel)) {
+        continue;
+      }
+      std::vector<T> destination(length);
+      nx::detail::ByteSwapBuffer(kernel, source.data(), destination.data(),
+                                 length, sizeof(T));
+      EXPECT_EQ(expected, destination)
+          << "kernel " << static_cast<int>(kernel) << ", length " << length;
+      std::vector<T> data(source);
+      nx::detail::ByteSwapBuffer(kernel, data.data(), data.data(), length,
+                                 sizeof(T));
+      EXPECT_EQ(expected, data)
+          << "kernel " << static_cast<int>(kernel) << ", length " << length;
+    }
+  }
+}
+
+/// @brief A wire header, as it might be overlaid on a received packet.
+struct Header {
+  nx::uint8_t version;
+  nx::BigEndian<nx::uint16_t> length;
+  nx::BigEndian<nx::uint32_t> sequence;
+  nx::LittleEndian<nx::int64_t> offset;
+};
+
+}  // namespace
+
+TEST(ByteOrderTest, Intrinsic) {
+  // Supported toolchains must not fall back to the generic implementation.
+#if defined(NX_TC_GCC) || defined(NX_TC_CLANG) || defined(NX_TC_VS)
+#if !defined(NX_USE_GENERIC_BYTE_SWAP)
+#if !defined(NX_BYTE_SWAP_INTRINSIC)
+  ADD_FAILURE() << "ByteSwap is using the generic implementation.";
+#endif
+#endif
+#endif
+}
+
+TEST(ByteOrderTest, Scalar) {
+  EXPECT_EQ(0x12u, nx::ByteSwap(static_cast<nx::uint8_t>(0x12)));
+  EXPECT_EQ(0x3412u, nx::ByteSwap(static_cast<nx::uint16_t>(0x1234)));
+  EXPECT_EQ(0x78563412u, nx::ByteSwap(static_cast<nx::uint32_t>(0x12345678)));
+  EXPECT_EQ(0xefcdab8967452301ull, nx::ByteSwap(0x0123456789abcdefull));
+  EXPECT_EQ(-2, nx::ByteSwap(static_cast<nx::int16_t>(-257)));
+}
+
+TEST(ByteOrderTest, Constexpr) {
+#if !defined(NX_TC_VS) || defined(NX_USE_GENERIC_BYTE_SWAP)
+  static_assert(nx::ByteSwap(static_cast<nx::uint32_t>(0x11223344)) ==
+                0x44332211u, "ByteSwap must be constexpr");
+#endif
+}
+
+TEST(ByteOrderTest, Array) {
+  nx::uint32_t data[] = { 0x00000001u, 0xaabbccddu };
+  nx::ByteSwap(data, 2);
+  EXPECT_EQ(0x01000000u, data[0]);
+  EXPECT_EQ(0xddccbbaau, data[1]);
+  const nx::uint8_t bytes[] = { 1, 2, 3 };
+  nx::uint8_t copy[3];
+  nx::ByteSwap(bytes, copy, 3);
+  EXPECT_EQ(3, copy[2]);
+}
+
+TEST(ByteOrderTest, Kernels) {
+  std::mt19937_64 random;
+  ExpectKernelsSwap<nx::uint16_t>(&random);
+  ExpectKernelsSwap<nx::uint32_t>(&random);
+  ExpectKernelsSwap<nx::uint64_t>(&random);
+}
+
+TEST(ByteOrderTest, Conversion) {
+  const nx::uint32_t value = 0x01020304u;
+  unsigned char bytes[sizeof(value)];
+  const nx::uint32_t big = nx::BigEndianValue(value);
+  std::memcpy(bytes, &big, sizeof(big));
+  EXPECT_EQ(1, bytes[0]);
+  EXPECT_EQ(4, bytes[3]);
+  const nx::uint32_t little = nx::LittleEndianValue(value);
+  std::memcpy(bytes, &little, sizeof(little));
+  EXPECT_EQ(4, bytes[0]);
+  EXPECT_EQ(1, bytes[3]);
+  EXPECT_EQ(value, nx::BigEndianValue(nx::BigEndianValue(value)));
+}
+
+TEST(ByteOrderTest, Overlay) {
+  static_assert(sizeof(Header) == 15, "endian wrappers must not pad");
+  static_assert(alignof(nx::BigEndian<nx::uint64_t>) == 1,
+                "endian wrappers must overlay unaligned data");
+  const unsigned char packet[] = {
+    2,
+    0x01, 0x00,
+    0xde, 0xad, 0xbe, 0xef,
+    0xfe, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff
+  };
+  const Header*header = reinterpret_cast<const Header*>(packet);
+  EXPECT_EQ(2, header->version);
+  EXPECT_EQ(256u, header->length);
+  EXPECT_EQ(0xdeadbeefu, header->sequence.get());
+  EXPECT_EQ(-2, header->offset);
+
+  Header out;
+  out.length = 0x0102;
+  EXPECT_EQ(1, out.length.data()[0]);
+  EXPECT_EQ(2, out.length.data()[1]);
+  EXPECT_EQ(0x0102u, out.length);
+}
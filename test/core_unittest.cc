@@ -259,3 +259,49 @@ TEST(CoreTest, Power) {
   EXPECT_EQ((nx::Power<int, 9, 2>::value), 81);
   EXPECT_EQ((nx::Power<unsigned char, 2, bitsize-1>::value), high_bit);
 }
+
+TEST(CoreTest, IndexSequence) {
+  EXPECT_TYPE(nx::MakeIndexSequence<0>, nx::IndexSequence<>);
+  EXPECT_TYPE(nx::MakeIndexSequence<1>, nx::IndexSequence<0>);
+  typedef nx::IndexSequence<0, 1, 2, 3, 4> Five;
+  EXPECT_TYPE(nx::MakeIndexSequence<5>, Five);
+  EXPECT_EQ(300u, nx::MakeIndexSequence<300>::size());
+}
+
+TEST(CoreTest, IsIntegral) {
+  EXPECT_TRUE(nx::IsIntegral<int>::value);
+  EXPECT_TRUE(nx::IsIntegral<const unsigned char>::value);
+  EXPECT_FALSE(nx::IsIntegral<float>::value);
+  EXPECT_TRUE(nx::IsSigned<int>::value);
+  EXPECT_FALSE(nx::IsSigned<unsigned int>::value);
+  EXPECT_TRUE(nx::IsUnsigned<unsigned int>::value);
+  EXPECT_FALSE(nx::IsUnsigned<float>::value);
+  typedef nx::MakeUnsigned<long>::type unsigned_long;  // NOLINT(runtime/int)
+  EXPECT_TYPE(unsigned_long, unsigned long);  // NOLINT(runtime/int)
+  typedef nx::MakeSigned<unsigned char>::type signed_char;
+  EXPECT_TYPE(signed_char, signed char);
+}
+
+#if defined(NX_HAS_INT128)
+TEST(CoreTest, Int128) {
+  typedef nx::uint_t<128> uint128;
+  typedef nx::int_t<128> int128;
+  EXPECT_EQ(128u, nx::BitSize<uint128>::value);
+  EXPECT_EQ(128u, nx::BitSize<int128>::value);
+  EXPECT_TYPE(nx::uint_least_t<65>, nx::uint128_t);
+  EXPECT_TYPE(nx::int_least_t<100>, nx::int128_t);
+  EXPECT_TRUE(nx::IsIntegral<uint128>::value);
+  EXPECT_TRUE(nx::IsUnsigned<uint128>::value);
+  EXPECT_TRUE(nx::IsSigned<int128>::value);
+  typedef nx::MakeUnsigned<int128>::type unsigned_int128;
+  typedef nx::SetSigned<true, uint128>::type signed_int128;
+  EXPECT_TYPE(unsigned_int128, uint128);
+  EXPECT_TYPE(signed_int128, int128);
+  EXPECT_TRUE((nx::IntegerFits<unsigned long long, uint128>::value));  // NOLINT
+  EXPECT_FALSE((nx::IntegerFits<uint128, unsigned long long>::value));  // NOLINT
+  EXPECT_TRUE(
+      (nx::BitMask<uint128, 128>::value == ~static_cast<uint128>(0)));
+  EXPECT_TRUE((nx::Power<uint128, 10, 38>::value / 10000000000000000000ull
+      == nx::Power<uint128, 10, 19>::value));
+}
+#endif
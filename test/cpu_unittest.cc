@@ -0,0 +1,84 @@
+//
+// Copyright (C) 2013 Jacob McIntosh <nacitar at ubercpp dot com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+/// @file cpu_unittest.cc
+/// @brief Unit tests for cpu.h
+
+#include "gtest/gtest.h"
+#include "nx/core.h"
+
+namespace {
+
+unsigned int resolutions = 0;
+
+int Twice(int value) {
+  return value * 2;
+}
+
+nx::cpu::Dispatch<int(int)>::Function ResolveTwice() {
+  ++resolutions;
+  return &Twice;
+}
+
+const nx::cpu::Dispatch<int(int)> twice(&ResolveTwice);
+
+int Thrice(int value) {
+  return value * 3;
+}
+
+const nx::cpu::Dispatch<int(int)> overridden(&ResolveTwice);
+
+}  // namespace
+
+TEST(CpuTest, Implications) {
+  using nx::cpu::Feature;
+  using nx::cpu::Supports;
+  // Features are only reported alongside those they build upon.
+  if (Supports(Feature::kAvx2)) {
+    EXPECT_TRUE(Supports(Feature::kAvx));
+  }
+  if (Supports(Feature::kAvx512bw) || Supports(Feature::kAvx512vl) ||
+      Supports(Feature::kAvx512vpopcntdq)) {
+    EXPECT_TRUE(Supports(Feature::kAvx512f));
+  }
+  if (Supports(Feature::kFastBmi2)) {
+    EXPECT_TRUE(Supports(Feature::kBmi2));
+  }
+  if (Supports(Feature::kAvx)) {
+    EXPECT_TRUE(Supports(Feature::kSse42));
+  }
+  if (Supports(Feature::kSsse3)) {
+    EXPECT_TRUE(Supports(Feature::kSse2));
+  }
+  EXPECT_EQ(nx::cpu::Features(), nx::cpu::Features());
+}
+
+TEST(CpuTest, Dispatch) {
+  EXPECT_EQ(0u, resolutions);
+  EXPECT_EQ(4, twice(2));
+  EXPECT_EQ(10, twice(5));
+  EXPECT_EQ(&Twice, twice.get());
+  EXPECT_EQ(1u, resolutions);
+}
+
+TEST(CpuTest, Override) {
+  overridden.set(&Thrice);
+  EXPECT_EQ(6, overridden(2));
+  EXPECT_EQ(&Thrice, overridden.get());
+  overridden.set(&Twice);
+  EXPECT_EQ(4, overridden(2));
+}
@@ -23,3 +23,59 @@
 TEST(DigitsTest, Basic) {
   EXPECT_EQ(nx::Digits(12345), 5);
 }
+
+TEST(DigitsTest, Boundaries) {
+  EXPECT_EQ(1u, nx::Digits(0u));
+  EXPECT_EQ(1u, nx::Digits(9u));
+  EXPECT_EQ(2u, nx::Digits(10u));
+  EXPECT_EQ(10u, nx::Digits(4294967295u));
+  EXPECT_EQ(3u, nx::Digits(static_cast<signed char>(-128)));
+  EXPECT_EQ(19u, nx::Digits(9999999999999999999ull));
+  EXPECT_EQ(20u, nx::Digits(10000000000000000000ull));
+  EXPECT_EQ(20u, nx::Digits(18446744073709551615ull));
+  EXPECT_EQ(19u, nx::Digits(-9223372036854775807ll - 1));
+}
+
+TEST(DigitsTest, PowerOf2Bases) {
+  static_assert(nx::Digits<16>(0xffffu) == 4, "constexpr Digits");
+  EXPECT_EQ(1u, nx::Digits<2>(0u));
+  EXPECT_EQ(1u, nx::Digits<8>(0u));
+  EXPECT_EQ(1u, nx::Digits<16>(0u));
+  for (unsigned int bit = 0; bit < 64; ++bit) {
+    const nx::uint64_t power = static_cast<nx::uint64_t>(1) << bit;
+    EXPECT_EQ(bit + 1, nx::Digits<2>(power));
+    EXPECT_EQ(bit / 3 + 1, nx::Digits<8>(power));
+    EXPECT_EQ(bit / 4 + 1, nx::Digits<16>(power));
+    EXPECT_EQ(bit / 4 + 1, nx::Digits<16>(power | (power - 1)));
+  }
+  EXPECT_EQ(8u, nx::Digits<2>(static_cast<unsigned char>(255)));
+  EXPECT_EQ(2u, nx::Digits<16>(static_cast<signed char>(-128)));
+  EXPECT_EQ(22u, nx::Digits<8>(~0ull));
+  EXPECT_EQ(16u, nx::Digits<16>(-9223372036854775807ll - 1));
+  EXPECT_EQ(64u, nx::Digits<2>(nx::WideUInt<128>(1) << 63));
+  EXPECT_EQ(17u, nx::Digits<16>(nx::WideUInt<128>(1) << 64));
+}
+
+#if defined(NX_HAS_INT128)
+TEST(DigitsTest, Int128) {
+  typedef nx::uint128_t uint128;
+  static_assert(nx::Digits(static_cast<uint128>(1) << 64) == 20,
+                "constexpr Digits");
+  uint128 power = 1;
+  for (unsigned int digits = 1; digits <= 38; ++digits) {
+    power *= 10;
+    EXPECT_EQ(digits, nx::Digits(power - 1));
+    EXPECT_EQ(digits + 1, nx::Digits(power));
+  }
+  EXPECT_EQ(39u, nx::Digits(~static_cast<uint128>(0)));
+  const nx::int128_t min = static_cast<nx::int128_t>(
+      static_cast<uint128>(1) << 127);
+  EXPECT_EQ(39u, nx::Digits(min));
+  EXPECT_EQ(39u, nx::Digits(min + 1));
+  EXPECT_EQ(20u, nx::Digits(-static_cast<nx::int128_t>(
+      static_cast<uint128>(1) << 64)));
+  EXPECT_EQ(128u, nx::Digits<2>(~static_cast<uint128>(0)));
+  EXPECT_EQ(43u, nx::Digits<8>(~static_cast<uint128>(0)));
+  EXPECT_EQ(32u, nx::Digits<16>(min));
+}
+#endif
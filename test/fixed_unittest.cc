@@ -0,0 +1,134 @@
+//
+// Copyright (C) 2013 Jacob McIntosh <nacitar at ubercpp dot com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+/// @file fixed_unittest.cc
+/// @brief Unit tests for fixed.h
+
+#include <random>
+#include <string>
+#include "gtest/gtest.h"
+#include "nx/fixed.h"
+
+namespace {
+
+typedef nx::Fixed<16, 16> Q16;
+typedef nx::Fixed<32, 32> Q32;
+typedef nx::Fixed<4, 4> Q4;
+
+static_assert(sizeof(Q4) == 1, "Fixed<4, 4> is stored in 8 bits");
+static_assert(sizeof(Q16) == 4, "Fixed<16, 16> is stored in 32 bits");
+static_assert(sizeof(nx::Fixed<20, 20>) == 8,
+              "Fixed<20, 20> is stored in 64 bits");
+
+// conversions are usable in constant expressions
+static_assert(Q16(3).raw() == 3 << 16, "integral conversion");
+static_assert(Q16(-1.5).raw() == -(3 << 15), "floating-point conversion");
+static_assert(Q16(2.75).ToDouble() == 2.75, "conversion to double");
+static_assert(Q16(-2.25).ToInteger() == -3, "conversion to integer");
+static_assert((Q16(1.25) + Q16(2)).ToDouble() == 3.25, "addition");
+static_assert(Q16::FromRaw(1) < Q16::FromRaw(2), "comparison");
+
+}  // namespace
+
+TEST(FixedTest, Conversions) {
+  EXPECT_EQ(0, Q16().raw());
+  EXPECT_EQ(6554, Q16(0.1).raw());
+  EXPECT_EQ(-6554, Q16(-0.1).raw());
+  EXPECT_EQ(-5, Q4(-0.3).raw());
+  EXPECT_EQ(7, Q4(7).ToInteger());
+  EXPECT_EQ(-1, Q32(-0.5).ToInteger());
+  EXPECT_EQ(123456789.0, Q32(123456789).ToDouble());
+  EXPECT_DOUBLE_EQ(-0.000244140625, Q32(-0.000244140625).ToDouble());
+  // rounded once, from the exact scaled value
+  EXPECT_EQ(0, Q16(0.49999999999999994 / 65536.0).raw());
+  EXPECT_EQ(0, Q16(-0.49999999999999994 / 65536.0).raw());
+  EXPECT_EQ(9007199254740991,
+            (nx::Fixed<64, 0>(9007199254740991.0).raw()));
+  EXPECT_EQ(-9007199254740991,
+            (nx::Fixed<64, 0>(-9007199254740991.0).raw()));
+}
+
+TEST(FixedTest, Arithmetic) {
+  Q16 value(10);
+  value += Q16(0.5);
+  value -= Q16(3);
+  EXPECT_EQ(Q16(7.5), value);
+  value *= Q16(-2);
+  EXPECT_EQ(Q16(-15), value);
+  EXPECT_EQ(Q16(15), -value);
+  EXPECT_EQ(Q4(-2.25), Q4(1.5) * Q4(-1.5));
+  // 1/16 * 1/16 rounds to nearest, ties upward
+  EXPECT_EQ(Q4(0), Q4(0.0625) * Q4(0.0625));
+  EXPECT_EQ(Q4::FromRaw(1), Q4(0.5) * Q4(0.0625));
+  EXPECT_EQ(Q4::FromRaw(0), Q4(-0.5) * Q4(0.0625));
+  EXPECT_EQ(Q32(-1610612734.875), Q32(-1073741823.25) * Q32(1.5));
+  EXPECT_TRUE(Q16(-1) < Q16(0.5));
+  EXPECT_TRUE(Q16(2) >= Q16(2));
+  EXPECT_TRUE(Q16(2) != Q16(-2));
+}
+
+TEST(FixedTest, Wraps) {
+  EXPECT_EQ(Q16::FromRaw(INT32_MIN), Q16::FromRaw(INT32_MAX) + Q16::FromRaw(1));
+  EXPECT_EQ(Q16::FromRaw(INT32_MAX), Q16::FromRaw(INT32_MIN) - Q16::FromRaw(1));
+  EXPECT_EQ(Q16::FromRaw(INT32_MIN), -Q16::FromRaw(INT32_MIN));
+  EXPECT_EQ(Q32::FromRaw(INT64_MIN), Q32::FromRaw(INT64_MAX) + Q32::FromRaw(1));
+  EXPECT_EQ(Q32::FromRaw(INT64_MAX), Q32::FromRaw(INT64_MIN) - Q32::FromRaw(1));
+  EXPECT_EQ(Q32::FromRaw(INT64_MIN), -Q32::FromRaw(INT64_MIN));
+  EXPECT_EQ(Q4::FromRaw(-128), Q4::FromRaw(127) + Q4::FromRaw(1));
+}
+
+TEST(FixedTest, MultiplyMatchesWords) {
+  // The 128-bit product and the one made of two words agree, including
+  // their rounding.
+  std::mt19937_64 random;
+  for (int i = 0; i < 100000; ++i) {
+    const nx::int64_t a = static_cast<nx::int64_t>(random()) >> (i % 40);
+    const nx::int64_t b = static_cast<nx::int64_t>(random()) >> (i % 40);
+    EXPECT_EQ(nx::detail::FixedMultiply<32>(a, b),
+              nx::detail::FixedMultiplyWords<32>(a, b));
+    EXPECT_EQ(nx::detail::FixedMultiply<7>(a, b),
+              nx::detail::FixedMultiplyWords<7>(a, b));
+    EXPECT_EQ(nx::detail::FixedMultiply<0>(a, b),
+              nx::detail::FixedMultiplyWords<0>(a, b));
+    const nx::int32_t c = static_cast<nx::int32_t>(a);
+    const nx::int32_t d = static_cast<nx::int32_t>(b);
+    EXPECT_EQ(nx::detail::FixedMultiply<16>(c, d),
+              nx::detail::FixedMultiplyWords<16>(c, d));
+  }
+}
+
+TEST(FixedTest, ToString) {
+  EXPECT_EQ("0", nx::ToString(Q16()));
+  EXPECT_EQ("3", nx::ToString(Q16(3)));
+  EXPECT_EQ("-2.375", nx::ToString(Q16(-2.375)));
+  EXPECT_EQ("0.100006103515625", nx::ToString(Q16(0.1)));
+  EXPECT_EQ("-32768", nx::ToString(Q16(-32768)));
+  EXPECT_EQ("32767.9999847412109375", nx::ToString(Q16::FromRaw(0x7fffffff)));
+  EXPECT_EQ("-8", nx::ToString(Q4(-8)));
+  EXPECT_EQ("-0.0625", nx::ToString(Q4(-0.0625)));
+  EXPECT_EQ("-2147483648", nx::ToString(Q32::FromRaw(INT64_MIN)));
+  EXPECT_EQ("0.00000000023283064365386962890625",
+            nx::ToString(Q32::FromRaw(1)));
+  EXPECT_EQ("-0.5", nx::ToString(nx::Fixed<1, 63>(-0.5)));
+  EXPECT_EQ(64u, nx::Digits(nx::Fixed<1, 63>::FromRaw(1)));
+  EXPECT_EQ(4u, nx::Digits(Q16(-2.375)));
+  std::string text = "x=";
+  EXPECT_EQ(6u, nx::ToString(Q16(-2.375), &text));
+  EXPECT_EQ("x=-2.375", text);
+  char buffer[24];
+  EXPECT_EQ(5u, nx::ToString(Q16(12.25), buffer));
+  EXPECT_EQ("12.25", std::string(buffer, 5));
+}
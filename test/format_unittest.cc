@@ -0,0 +1,139 @@
+//
+// Copyright (C) 2013 Jacob McIntosh <nacitar at ubercpp dot com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+/// @file format_unittest.cc
+/// @brief Unit tests for format.h
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include "gtest/gtest.h"
+#include "nx/format.h"
+
+namespace {
+
+constexpr nx::FormatString kLine("[{}] {:>5} id={:016x} {{ok}}");
+
+static_assert(kLine.fields() == 3, "constexpr fields");
+static_assert(kLine.size() == 10, "constexpr segments");
+static_assert(kLine.segment(3).width == 5 &&
+              kLine.segment(3).align == nx::FormatAlign::kRight,
+              "constexpr spec");
+static_assert(kLine.segment(5).zero_pad && kLine.segment(5).type == 'x',
+              "constexpr spec");
+
+constexpr nx::FormatString kPair("{}-{:x}");
+
+static_assert(nx::detail::FormatTypes<int, int>::Valid(kPair, 0),
+              "an integer may be given a presentation type");
+static_assert(!nx::detail::FormatTypes<int, const char*>::Valid(kPair, 0),
+              "only an integer may be given a presentation type");
+
+}  // namespace
+
+TEST(FormatTest, Basic) {
+  EXPECT_EQ("[info]   GET id=00000000deadbeef {ok}",
+            nx::Format(kLine, "info", std::string("GET"), 0xdeadbeefu));
+  constexpr nx::FormatString kEmpty("");
+  EXPECT_EQ("", nx::Format(kEmpty));
+  constexpr nx::FormatString kText("no fields");
+  EXPECT_EQ("no fields", nx::Format(kText));
+  constexpr nx::FormatString kBraces("{{}}{}}}");
+  EXPECT_EQ("{}1}", nx::Format(kBraces, 1));
+}
+
+TEST(FormatTest, Integers) {
+  constexpr nx::FormatString kDefault("{}|{}|{}|{}");
+  EXPECT_EQ("0|-12345|255|-128",
+            nx::Format(kDefault, 0, -12345, static_cast<unsigned char>(255),
+                       static_cast<signed char>(-128)));
+  constexpr nx::FormatString kBases("{:d} {:x} {:X} {:o} {:b}");
+  EXPECT_EQ("255 ff FF 377 11111111",
+            nx::Format(kBases, 255, 255, 255, 255, 255));
+  constexpr nx::FormatString kZeros("{:05}|{:05}|{:08X}|{:02}");
+  EXPECT_EQ("00042|-0042|0000BEEF|12345",
+            nx::Format(kZeros, 42, -42, 0xbeef, 12345));
+  constexpr nx::FormatString kAlign("{:<6}|{:>6}|{:^6}|{:*^7}|{:6}");
+  EXPECT_EQ("42    |    42|  42  |**-42**|    42",
+            nx::Format(kAlign, 42, 42, 42, -42, 42));
+  constexpr nx::FormatString kAlignedZeros("{:<05}");
+  EXPECT_EQ("42   ", nx::Format(kAlignedZeros, 42));
+  constexpr nx::FormatString kMin("{}");
+  EXPECT_EQ("-9223372036854775808",
+            nx::Format(kMin, -9223372036854775807ll - 1));
+  constexpr nx::FormatString kWide("{:0255}");
+  EXPECT_EQ(std::string(254, '0') + "7", nx::Format(kWide, 7));
+}
+
+TEST(FormatTest, OtherValues) {
+  constexpr nx::FormatString kValues("{} {} {:>3} {:<4}| {} {:08}");
+  EXPECT_EQ("true false   x ab  | 0.1 -00001.5",
+            nx::Format(kValues, true, false, 'x', "ab", 0.1, -1.5));
+  constexpr nx::FormatString kStatic("{:>8}");
+  EXPECT_EQ("     404", nx::Format(kStatic, nx::ToStaticString<int, 404>()));
+}
+
+TEST(FormatTest, Buffer) {
+  constexpr nx::FormatString kFormat("{}-{}");
+  char buffer[8];
+  std::memset(buffer, '?', sizeof(buffer));
+  EXPECT_EQ(7u, nx::Format(buffer, sizeof(buffer), kFormat, 123, "abc"));
+  EXPECT_EQ("123-abc?", std::string(buffer, sizeof(buffer)));
+  // the full length is returned when the text does not fit
+  std::memset(buffer, '?', sizeof(buffer));
+  EXPECT_EQ(11u, nx::Format(buffer, 4, kFormat, 12345, "abcde"));
+  EXPECT_EQ("1234????", std::string(buffer, sizeof(buffer)));
+  std::string text("x=");
+  EXPECT_EQ(5u, nx::Format(&text, kFormat, 1, "abc"));
+  EXPECT_EQ("x=1-abc", text);
+}
+
+TEST(FormatTest, Errors) {
+  EXPECT_THROW(nx::FormatString("{"), std::invalid_argument);
+  EXPECT_THROW(nx::FormatString("}"), std::invalid_argument);
+  EXPECT_THROW(nx::FormatString("{:"), std::invalid_argument);
+  EXPECT_THROW(nx::FormatString("{x}"), std::invalid_argument);
+  EXPECT_THROW(nx::FormatString("{:q}"), std::invalid_argument);
+  EXPECT_THROW(nx::FormatString("{:5xx}"), std::invalid_argument);
+  EXPECT_THROW(nx::FormatString("{:256}"), std::invalid_argument);
+  EXPECT_THROW(nx::FormatString("a{b{}}"), std::invalid_argument);
+  constexpr nx::FormatString kTwo("{}{}");
+  EXPECT_THROW(nx::Format(kTwo, 1), std::invalid_argument);
+  EXPECT_THROW(nx::Format(kTwo, 1, 2, 3), std::invalid_argument);
+  constexpr nx::FormatString kHex("{:x}");
+  EXPECT_THROW(nx::Format(kHex, "text"), std::invalid_argument);
+  // the arguments are checked before anything is written
+  std::string text("x=");
+  EXPECT_THROW(nx::Format(&text, kPair, 5, "str"), std::invalid_argument);
+  EXPECT_EQ("x=", text);
+  char buffer[4] = { '?', '?', '?', '?' };
+  EXPECT_THROW(nx::Format(buffer, sizeof(buffer), kPair, 5),
+               std::invalid_argument);
+  EXPECT_EQ("????", std::string(buffer, sizeof(buffer)));
+}
+
+TEST(FormatTest, CompileTimeChecked) {
+  // a mismatched argument here fails to compile rather than throwing
+  char buffer[8];
+  std::memset(buffer, '?', sizeof(buffer));
+  EXPECT_EQ(5u, nx::Format<kPair>(buffer, sizeof(buffer), 12, 0xabu));
+  EXPECT_EQ("12-ab???", std::string(buffer, sizeof(buffer)));
+  std::string text("x=");
+  EXPECT_EQ(6u, nx::Format<kPair>(&text, "ab", 0xcde));
+  EXPECT_EQ("x=ab-cde", text);
+  EXPECT_EQ("[info]   GET id=00000000deadbeef {ok}",
+            nx::Format<kLine>("info", std::string("GET"), 0xdeadbeefu));
+}
@@ -0,0 +1,404 @@
+//
+// Copyright (C) 2013 Jacob McIntosh <nacitar at ubercpp dot com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+/// @file from_string_unittest.cc
+/// @brief Unit tests for from_string.h
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+#include "nx/from_string.h"
+#include "nx/to_string.h"
+
+namespace {
+
+/// @brief Parses a null-terminated string.
+template <class T>
+nx::ParseResult Parse(const char*text, T*value) {
+  return nx::FromString(text, text + std::strlen(text), value);
+}
+
+/// @brief Parses a null-terminated string as a double.
+nx::ParseResult ParseDouble(const char*text, double*value) {
+  return nx::ParseDouble(text, text + std::strlen(text), value);
+}
+
+/// @brief Checks that a string is parsed whole to the same double as
+/// strtod, and the same float as strtof.
+void ExpectMatchesStrtod(const std::string&text) {
+  const char*end = text.data() + text.size();
+  const double expected = std::strtod(text.c_str(), nullptr);
+  double value = 0;
+  const nx::ParseResult result = nx::ParseDouble(text.data(), end, &value);
+  if (std::isinf(expected)) {
+    EXPECT_EQ(nx::ParseStatus::kOverflow, result.status) << text;
+  } else {
+    EXPECT_EQ(nx::ParseStatus::kOk, result.status) << text;
+    EXPECT_EQ(0, std::memcmp(&expected, &value, sizeof(value))) << text;
+  }
+  EXPECT_EQ(end, result.end) << text;
+  const float expected_float = std::strtof(text.c_str(), nullptr);
+  float float_value = 0;
+  const nx::ParseStatus float_status =
+      nx::ParseFloat(text.data(), end, &float_value).status;
+  if (std::isinf(expected_float)) {
+    EXPECT_EQ(nx::ParseStatus::kOverflow, float_status) << text;
+  } else {
+    EXPECT_EQ(nx::ParseStatus::kOk, float_status) << text;
+    EXPECT_EQ(0, std::memcmp(&expected_float, &float_value,
+                             sizeof(float_value))) << text;
+  }
+}
+
+/// @brief Checks that ToString()'s text parses back to the value.
+template <class T>
+void ExpectRoundTrip(T value) {
+  const std::string text = nx::ToString(value);
+  T parsed = 0;
+  EXPECT_EQ(nx::ParseStatus::kOk, nx::FromString(text, &parsed)) << text;
+  EXPECT_EQ(value, parsed) << text;
+}
+
+/// @brief Writes delimited fields of every length for the kernels to parse,
+/// including the extremes of the type, runs of leading zeros that carry a
+/// field past 16 and 20 digits, and "-0" for signed types.
+///
+/// @return The values of the fields.
+template <class T>
+std::vector<T> MixedLengthFields(std::mt19937_64*random, nx::size_t length,
+                                 std::string*text) {
+  std::vector<T> values(length);
+  text->clear();
+  for (nx::size_t i = 0; i < length; ++i) {
+    values[i] = static_cast<T>((*random)() >> (i % 64));
+    if (i == 0 && length > 2) {
+      values[i] = std::numeric_limits<T>::max();
+    } else if (i == 1 && length > 2) {
+      values[i] = std::numeric_limits<T>::min();
+    } else if (i == 2 && length > 2) {
+      values[i] = 0;
+    }
+    std::string digits = nx::ToString(values[i]);
+    const bool negative = digits[0] == '-' ||
+        (i == 2 && std::numeric_limits<T>::is_signed);
+    if (digits[0] == '-') {
+      digits.erase(0, 1);
+    }
+    const nx::size_t zeros = (*random)() % 2 ? (*random)() % 24 : 0;
+    if (i != 0) {
+      *text += ';';
+    }
+    *text += std::string(negative, '-') + std::string(zeros, '0') + digits;
+  }
+  return values;
+}
+
+/// @brief Checks that every supported kernel parses the same fields.
+template <class T>
+void ExpectKernelsParse(std::mt19937_64*random) {
+  using nx::detail::FromStringKernel;
+  const FromStringKernel kernels[] = {
+    FromStringKernel::kScalar,
+    FromStringKernel::kSse41,
+    FromStringKernel::kAvx2
+  };
+  const nx::detail::ParseLimits limits = nx::detail::MakeParseLimits<T>();
+  for (nx::size_t length : { 1, 2, 3, 64, 67 }) {
+    std::string text;
+    const std::vector<T> expected =
+        MixedLengthFields<T>(random, length, &text);
+    for (FromStringKernel kernel : kernels) {
+      if (!nx::detail::FromStringSupported(kernel)) {
+        continue;
+      }
+      std::vector<nx::uint64_t> values(length);
+      nx::size_t count = 0;
+      const nx::ParseResult result = nx::detail::FromStringFields(
+          kernel, text.data(), text.data() + text.size(), ';', limits,
+          values.data(), length, &count);
+      EXPECT_EQ(nx::ParseStatus::kOk, result.status)
+          << "kernel " << static_cast<int>(kernel) << ", length " << length;
+      EXPECT_EQ(text.data() + text.size(), result.end)
+          << "kernel " << static_cast<int>(kernel) << ", length " << length;
+      ASSERT_EQ(length, count)
+          << "kernel " << static_cast<int>(kernel) << ", length " << length;
+      for (nx::size_t i = 0; i < length; ++i) {
+        EXPECT_EQ(expected[i], static_cast<T>(values[i]))
+            << "kernel " << static_cast<int>(kernel) << ", index " << i;
+      }
+      // Filling the output stops at the end of a field.
+      if (length > 2) {
+        const nx::ParseResult partial = nx::detail::FromStringFields(
+            kernel, text.data(), text.data() + text.size(), ';', limits,
+            values.data(), 2, &count);
+        EXPECT_EQ(2u, count);
+        EXPECT_EQ(';', *partial.end);
+      }
+      // Errors report the field at fault.
+      for (const char*bad : { ";x", ";", ";12x", ";99999999999999999999" }) {
+        std::string bad_text = text + bad;
+        nx::size_t bad_count = 0;
+        std::vector<nx::uint64_t> bad_values(length + 1);
+        const nx::ParseResult failed = nx::detail::FromStringFields(
+            kernel, bad_text.data(), bad_text.data() + bad_text.size(), ';',
+            limits, bad_values.data(), length + 1, &bad_count);
+        EXPECT_EQ(std::strcmp(bad, ";99999999999999999999") == 0 ?
+                  nx::ParseStatus::kOverflow : nx::ParseStatus::kInvalid,
+                  failed.status) << bad;
+        EXPECT_EQ(length, bad_count) << bad;
+        EXPECT_EQ(bad_text.data() + text.size() + 1, failed.end) << bad;
+      }
+    }
+  }
+}
+
+}  // namespace
+
+TEST(FromStringTest, Integers) {
+  int value = 0;
+  nx::ParseResult result = Parse("12345", &value);
+  EXPECT_EQ(nx::ParseStatus::kOk, result.status);
+  EXPECT_EQ(12345, value);
+  EXPECT_EQ('\0', *result.end);
+  result = Parse("-42,7", &value);
+  EXPECT_EQ(nx::ParseStatus::kOk, result.status);
+  EXPECT_EQ(-42, value);
+  EXPECT_EQ(',', *result.end);
+  nx::uint64_t big = 0;
+  EXPECT_EQ(nx::ParseStatus::kOk,
+            nx::FromString(std::string("18446744073709551615"), &big));
+  EXPECT_EQ(18446744073709551615ull, big);
+  EXPECT_EQ(nx::ParseStatus::kOk,
+            nx::FromString(std::string("000000000000000000000000123"), &big));
+  EXPECT_EQ(123u, big);
+}
+
+TEST(FromStringTest, Errors) {
+  int value = 7;
+  const char*text = "x1";
+  nx::ParseResult result = Parse(text, &value);
+  EXPECT_EQ(nx::ParseStatus::kInvalid, result.status);
+  EXPECT_EQ(text, result.end);
+  EXPECT_EQ(7, value);
+  text = "-";
+  EXPECT_EQ(text, Parse(text, &value).end);
+  unsigned int unsigned_value = 0;
+  EXPECT_EQ(nx::ParseStatus::kInvalid, Parse("-1", &unsigned_value).status);
+  EXPECT_EQ(nx::ParseStatus::kInvalid,
+            nx::FromString(std::string("12 "), &value));
+  EXPECT_EQ(nx::ParseStatus::kInvalid, nx::FromString(std::string(), &value));
+  // Overflow consumes every digit and leaves the value unchanged.
+  text = "18446744073709551616!";
+  nx::uint64_t big = 3;
+  result = Parse(text, &big);
+  EXPECT_EQ(nx::ParseStatus::kOverflow, result.status);
+  EXPECT_EQ(text + 20, result.end);
+  EXPECT_EQ(3u, big);
+  signed char small = 0;
+  EXPECT_EQ(nx::ParseStatus::kOverflow, Parse("128", &small).status);
+  EXPECT_EQ(nx::ParseStatus::kOk, Parse("-128", &small).status);
+  EXPECT_EQ(-128, small);
+  EXPECT_EQ(nx::ParseStatus::kOverflow, Parse("-129", &small).status);
+  EXPECT_EQ(nx::ParseStatus::kOverflow,
+            Parse("99999999999999999999999999", &big).status);
+}
+
+TEST(FromStringTest, RoundTrip) {
+  std::mt19937_64 random;
+  ExpectRoundTrip(std::numeric_limits<nx::int64_t>::min());
+  ExpectRoundTrip(std::numeric_limits<nx::int64_t>::max());
+  ExpectRoundTrip(std::numeric_limits<nx::uint64_t>::max());
+  ExpectRoundTrip(std::numeric_limits<nx::int8_t>::min());
+  ExpectRoundTrip(std::numeric_limits<nx::uint16_t>::max());
+  for (unsigned int i = 0; i < 10000; ++i) {
+    ExpectRoundTrip(random() >> (i % 64));
+    ExpectRoundTrip(static_cast<nx::int64_t>(random()) >> (i % 64));
+    ExpectRoundTrip(static_cast<nx::int32_t>(random()));
+  }
+}
+
+TEST(FromStringTest, Bases) {
+  unsigned int value = 0;
+  EXPECT_EQ(nx::ParseStatus::kOk, nx::FromString<16>(std::string("fF10"),
+                                                     &value));
+  EXPECT_EQ(0xff10u, value);
+  EXPECT_EQ(nx::ParseStatus::kOk, nx::FromString<8>(std::string("777"),
+                                                    &value));
+  EXPECT_EQ(0777u, value);
+  EXPECT_EQ(nx::ParseStatus::kOk, nx::FromString<2>(std::string("101"),
+                                                    &value));
+  EXPECT_EQ(5u, value);
+  EXPECT_EQ(nx::ParseStatus::kInvalid,
+            nx::FromString<8>(std::string("8"), &value));
+  EXPECT_EQ(nx::ParseStatus::kOverflow,
+            nx::FromString<16>(std::string("100000000"), &value));
+  int negative = 0;
+  EXPECT_EQ(nx::ParseStatus::kOk,
+            nx::FromString<16>(std::string("-80000000"), &negative));
+  EXPECT_EQ(std::numeric_limits<int>::min(), negative);
+  EXPECT_TRUE(nx::ValidDigit<16>('a'));
+  EXPECT_FALSE(nx::ValidDigit<16>('g'));
+  EXPECT_TRUE(nx::ValidDigit<10>('9'));
+  EXPECT_FALSE(nx::ValidDigit<8>('8'));
+  EXPECT_EQ(11u, nx::DigitValue('B'));
+}
+
+TEST(FromStringTest, Array) {
+  const std::string text("12,-345,0,2147483647");
+  std::vector<int> values;
+  nx::ParseResult result = nx::FromString(
+      text.data(), text.data() + text.size(), ',', &values);
+  EXPECT_EQ(nx::ParseStatus::kOk, result.status);
+  EXPECT_EQ(text.data() + text.size(), result.end);
+  EXPECT_EQ((std::vector<int>{ 12, -345, 0, 2147483647 }), values);
+  values.clear();
+  result = nx::FromString(text.data(), text.data(), ',', &values);
+  EXPECT_EQ(nx::ParseStatus::kOk, result.status);
+  EXPECT_TRUE(values.empty());
+  const std::string bad("1,2,,4");
+  result = nx::FromString(bad.data(), bad.data() + bad.size(), ',', &values);
+  EXPECT_EQ(nx::ParseStatus::kInvalid, result.status);
+  EXPECT_EQ(bad.data() + 4, result.end);
+  EXPECT_EQ((std::vector<int>{ 1, 2 }), values);
+  // Larger than the blocks the values are parsed in.
+  std::mt19937_64 random;
+  std::string long_text;
+  const std::vector<nx::int16_t> expected =
+      MixedLengthFields<nx::int16_t>(&random, 1000, &long_text);
+  std::vector<nx::int16_t> parsed;
+  result = nx::FromString(long_text.data(),
+                          long_text.data() + long_text.size(), ';', &parsed);
+  EXPECT_EQ(nx::ParseStatus::kOk, result.status);
+  EXPECT_EQ(expected, parsed);
+}
+
+TEST(FromStringTest, ArrayKernels) {
+  std::mt19937_64 random;
+  ExpectKernelsParse<nx::uint64_t>(&random);
+  ExpectKernelsParse<nx::int64_t>(&random);
+  ExpectKernelsParse<nx::int32_t>(&random);
+}
+
+TEST(FromStringTest, FloatingPoint) {
+  double value = 0;
+  nx::ParseResult result = ParseDouble("-12.5e-1,", &value);
+  EXPECT_EQ(nx::ParseStatus::kOk, result.status);
+  EXPECT_EQ(-1.25, value);
+  EXPECT_EQ(',', *result.end);
+  EXPECT_EQ(0.1, (ParseDouble("0.1", &value), value));
+  EXPECT_EQ(100.0, (ParseDouble("1E2", &value), value));
+  EXPECT_EQ(0.5, (ParseDouble(".5", &value), value));
+  EXPECT_EQ(3.0, (ParseDouble("3.", &value), value));
+  EXPECT_TRUE(std::signbit((ParseDouble("-0", &value), value)));
+  // An exponent without digits is not part of the value.
+  const char*text = "7e+x";
+  EXPECT_EQ(text + 1, ParseDouble(text, &value).end);
+  EXPECT_EQ(7.0, value);
+  EXPECT_EQ(std::numeric_limits<double>::infinity(),
+            (ParseDouble("Infinity", &value), value));
+  EXPECT_EQ(-std::numeric_limits<double>::infinity(),
+            (ParseDouble("-inf", &value), value));
+  EXPECT_TRUE(std::isnan((ParseDouble("NaN", &value), value)));
+  float float_value = 0;
+  EXPECT_EQ(nx::ParseStatus::kOk,
+            nx::ParseFloat(text, text + 1, &float_value).status);
+  EXPECT_EQ(7.0f, float_value);
+  // Errors leave the value unchanged.
+  value = 2;
+  for (const char*bad : { "", "-", ".", "e5", "+1", " 1", "-x" }) {
+    result = ParseDouble(bad, &value);
+    EXPECT_EQ(nx::ParseStatus::kInvalid, result.status) << bad;
+    EXPECT_EQ(bad, result.end) << bad;
+  }
+  EXPECT_EQ(nx::ParseStatus::kOverflow, ParseDouble("1e309", &value).status);
+  EXPECT_EQ(nx::ParseStatus::kOverflow, ParseDouble("-2e308", &value).status);
+  text = "1e39";
+  EXPECT_EQ(nx::ParseStatus::kOverflow,
+            nx::ParseFloat(text, text + 4, &float_value).status);
+  EXPECT_EQ(7.0f, float_value);
+  EXPECT_EQ(2.0, value);
+  EXPECT_EQ(0.0, (ParseDouble("1e-400", &value), value));
+}
+
+TEST(FromStringTest, FloatingPointMatchesStrtod) {
+  // Halfway between two doubles, which rounds to even, and just past it.
+  ExpectMatchesStrtod("9007199254740993");
+  ExpectMatchesStrtod("9007199254740995");
+  ExpectMatchesStrtod("9007199254740993.00000000000000000000000000001");
+  ExpectMatchesStrtod("2.4703282292062327208828439643411068618252990130716238"
+                      "221279284125033775364e-324");
+  ExpectMatchesStrtod("2.4703282292062327208828439643411068618252990130716238"
+                      "221279284125033775364e-324" + std::string(1000, '0') +
+                      "1");
+  ExpectMatchesStrtod("1.7976931348623158e308");
+  ExpectMatchesStrtod("1.7976931348623157e308");
+  ExpectMatchesStrtod("3.4028235677973366e38");
+  ExpectMatchesStrtod("0." + std::string(400, '0') + "123e400");
+  std::mt19937_64 random;
+  char buffer[1000];
+  for (unsigned int i = 0; i < 20000; ++i) {
+    const nx::uint64_t bits = random();
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    if (value - value != 0) {
+      continue;
+    }
+    snprintf(buffer, sizeof(buffer), "%.17g", value);
+    ExpectMatchesStrtod(buffer);
+    ExpectMatchesStrtod(nx::ToString(value));
+    // The exact value halfway to the next double.
+    const long double halfway = (static_cast<long double>(value) +
+        std::nextafter(value, std::numeric_limits<double>::infinity())) / 2;
+    snprintf(buffer, sizeof(buffer), "%.780Le", halfway);
+    ExpectMatchesStrtod(buffer);
+    // Random digits with random exponents.
+    std::string digits;
+    for (nx::uint64_t length = random() % 30 + 1; length; --length) {
+      digits += static_cast<char>('0' + random() % 10);
+    }
+    digits.insert(random() % digits.size(), ".");
+    ExpectMatchesStrtod(
+        digits + "e" + std::to_string(static_cast<int>(random() % 700) - 350));
+  }
+}
+
+TEST(FromStringTest, FloatingPointArray) {
+  const std::string text("1.5,-2,3e2,inf");
+  std::vector<double> values;
+  nx::ParseResult result = nx::ParseDouble(
+      text.data(), text.data() + text.size(), ',', &values);
+  EXPECT_EQ(nx::ParseStatus::kOk, result.status);
+  EXPECT_EQ(text.data() + text.size(), result.end);
+  EXPECT_EQ((std::vector<double>{
+      1.5, -2, 300, std::numeric_limits<double>::infinity() }), values);
+  std::vector<float> float_values;
+  result = nx::ParseFloat(text.data(), text.data(), ',', &float_values);
+  EXPECT_EQ(nx::ParseStatus::kOk, result.status);
+  EXPECT_TRUE(float_values.empty());
+  const std::string bad("0.25;1e;2");
+  result = nx::ParseFloat(bad.data(), bad.data() + bad.size(), ';',
+                          &float_values);
+  EXPECT_EQ(nx::ParseStatus::kInvalid, result.status);
+  EXPECT_EQ(bad.data() + 5, result.end);
+  EXPECT_EQ((std::vector<float>{ 0.25f }), float_values);
+}
@@ -0,0 +1,137 @@
+//
+// Copyright (C) 2013 Jacob McIntosh <nacitar at ubercpp dot com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+/// @file literal_unittest.cc
+/// @brief Unit tests for literal.h
+
+#include <stdexcept>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include "gtest/gtest.h"
+#include "nx/literal.h"
+#include "nx/to_string.h"
+
+namespace {
+
+typedef nx::uint_t<128> uint128;
+typedef nx::WideUInt<256> uint256;
+typedef nx::WideUInt<512> uint512;
+
+constexpr uint128 kHex = 0x0123456789ABCDEFfedcba9876543210_nx_u128;
+constexpr uint128 kMax = 340282366920938463463374607431768211455_nx_u128;
+constexpr uint256 kSeparated =
+    "0xffff'ffff'ffff'ffff'ffff'ffff'ffff'ffff'0000'0000'0000'0001"_nx_u256;
+constexpr auto kMagic = 0x89504e470d0a1a0a_nx_bytes;
+
+// Provides a word of a 128-bit value in constant expressions.
+#if defined(NX_HAS_INT128)
+constexpr nx::uint64_t Word(uint128 value, unsigned int index) {
+  return static_cast<nx::uint64_t>(value >> (64 * index));
+}
+#else
+constexpr nx::uint64_t Word(const uint128&value, unsigned int index) {
+  return value.word(index);
+}
+#endif
+
+static_assert(std::is_same<uint128, decltype(0_nx_u128)>::value &&
+              std::is_same<uint128, decltype("0"_nx_u128)>::value,
+              "128-bit literals have the library's 128-bit type");
+
+static_assert(Word(kHex, 0) == 0xfedcba9876543210ull &&
+              Word(kHex, 1) == 0x0123456789abcdefull, "constexpr hex");
+static_assert(Word(kMax, 0) == ~0ull && Word(kMax, 1) == ~0ull,
+              "constexpr decimal");
+static_assert(kSeparated.word(0) == 1 && kSeparated.word(1) == ~0ull &&
+              kSeparated.word(2) == ~0ull && kSeparated.word(3) == 0,
+              "constexpr separators");
+static_assert(kMagic.size() == 8 && kMagic[0] == 0x89 && kMagic[7] == 0x0a,
+              "constexpr bytes");
+
+}  // namespace
+
+TEST(LiteralTest, Binary) {
+  EXPECT_EQ(182u, 10110110_nx_b);
+  EXPECT_EQ(0u, 0_nx_b);
+}
+
+TEST(LiteralTest, WideBases) {
+  EXPECT_EQ(uint128(0), 0_nx_u128);
+  EXPECT_EQ(uint128(511), 0777_nx_u128);
+  EXPECT_EQ(uint128(0x5a), 0b01011010_nx_u128);
+  EXPECT_EQ(uint128(0xdeadbeef), 0XDEADbeef_nx_u128);
+  EXPECT_EQ(uint128(1) << 64, 18446744073709551616_nx_u128);
+  EXPECT_EQ(uint128(1) << 64, 0x10000000000000000_nx_u128);
+  EXPECT_EQ(uint128(1) << 127,
+            02000000000000000000000000000000000000000000_nx_u128);
+  EXPECT_EQ(~uint128(0), kMax);
+  EXPECT_EQ("340282366920938463463374607431768211455", nx::ToString(kMax));
+}
+
+TEST(LiteralTest, WideSizes) {
+  const uint256 prime = "115792089237316195423570985008687907853269984665"
+                        "640564039457584007908834671663"_nx_u256;
+  EXPECT_EQ((~uint256(0)) - (uint256(1) << 32) - 976, prime);
+  EXPECT_EQ("115792089237316195423570985008687907853269984665640564039457584"
+            "007908834671663", nx::ToString(prime));
+  const uint512 power = "0x1000000000000000'0000000000000000"
+                        "'0000000000000000'0000000000000000"
+                        "'0000000000000000'0000000000000000"
+                        "'0000000000000000'0000000000000000"_nx_u512;
+  EXPECT_EQ(uint512(1) << 508, power);
+  // A full-width binary literal, one digit per bit.
+  constexpr uint512 kTop =
+      0b10000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000_nx_u512;  // NOLINT(whitespace/line_length)
+  EXPECT_EQ(uint512(1) << 511, kTop);
+  EXPECT_EQ(~uint512(0), "0xffff'ffff'ffff'ffff'ffff'ffff'ffff'ffff"
+                         "'ffff'ffff'ffff'ffff'ffff'ffff'ffff'ffff"
+                         "'ffff'ffff'ffff'ffff'ffff'ffff'ffff'ffff"
+                         "'ffff'ffff'ffff'ffff'ffff'ffff'ffff'ffff"_nx_u512);
+}
+
+TEST(LiteralTest, WideStrings) {
+  EXPECT_EQ(uint128(1000000), "1'000'000"_nx_u128);
+  EXPECT_EQ(uint128(0x1234), "0x12'34"_nx_u128);
+  EXPECT_EQ(uint128(5), "0b1'01"_nx_u128);
+  // Outside constant expressions, malformed strings throw.
+  EXPECT_THROW("12a"_nx_u128, std::invalid_argument);
+  EXPECT_THROW("0x"_nx_u128, std::invalid_argument);
+  EXPECT_THROW(""_nx_u128, std::invalid_argument);
+  EXPECT_THROW("'1"_nx_u128, std::invalid_argument);
+  EXPECT_THROW("1'"_nx_u128, std::invalid_argument);
+  EXPECT_THROW("1''0"_nx_u128, std::invalid_argument);
+  EXPECT_THROW("0x'10"_nx_u128, std::invalid_argument);
+  EXPECT_THROW("09"_nx_u128, std::invalid_argument);
+  EXPECT_THROW("340282366920938463463374607431768211456"_nx_u128,
+               std::out_of_range);
+  EXPECT_THROW("0x1'0000'0000'0000'0000'0000'0000'0000'0000"_nx_u128,
+               std::out_of_range);
+}
+
+TEST(LiteralTest, Bytes) {
+  const unsigned char expected[] = {
+      0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a };
+  ASSERT_EQ(sizeof(expected), kMagic.size());
+  EXPECT_EQ(0, std::memcmp(expected, kMagic.data(), sizeof(expected)));
+  unsigned int count = 0;
+  for (nx::uint8_t byte : 0x00FF00ff_nx_bytes) {
+    EXPECT_EQ(count % 2 ? 0xff : 0, byte);
+    ++count;
+  }
+  EXPECT_EQ(4u, count);
+  EXPECT_EQ(1u, (0x00_nx_bytes).size());
+}
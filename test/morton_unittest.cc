@@ -0,0 +1,113 @@
+//
+// Copyright (C) 2013 Jacob McIntosh <nacitar at ubercpp dot com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+/// @file morton_unittest.cc
+/// @brief Unit tests for morton.h
+
+#include <random>
+#include <vector>
+#include "gtest/gtest.h"
+#include "nx/morton.h"
+
+namespace {
+
+nx::uint64_t NaiveEncode(const nx::uint32_t*coordinates,
+                         unsigned int dimensions, unsigned int bits) {
+  nx::uint64_t code = 0;
+  for (unsigned int bit = 0; bit < bits; ++bit) {
+    for (unsigned int d = 0; d < dimensions; ++d) {
+      code |= static_cast<nx::uint64_t>((coordinates[d] >> bit) & 1)
+          << (bit * dimensions + d);
+    }
+  }
+  return code;
+}
+
+}  // namespace
+
+TEST(MortonTest, Scalar) {
+  EXPECT_EQ(0x3u, nx::MortonEncode(1u, 1u));
+  EXPECT_EQ(0x2u, nx::MortonEncode(0u, 1u));
+  EXPECT_EQ(~0ull, nx::MortonEncode(~0u, ~0u));
+  EXPECT_EQ(0x7u, nx::MortonEncode(1u, 1u, 1u));
+  EXPECT_EQ(0x4u, nx::MortonEncode(0u, 0u, 1u));
+  EXPECT_EQ(0x7fffffffffffffffull, nx::MortonEncode(~0u, ~0u, ~0u));
+
+  std::mt19937 random;
+  for (int i = 0; i < 1000; ++i) {
+    const nx::uint32_t in[] = {
+      static_cast<nx::uint32_t>(random()),
+      static_cast<nx::uint32_t>(random()),
+      static_cast<nx::uint32_t>(random()) & 0x1fffff
+    };
+    const nx::uint64_t code2 = nx::MortonEncode(in[0], in[1]);
+    EXPECT_EQ(NaiveEncode(in, 2, 32), code2);
+    nx::uint32_t out[3];
+    nx::MortonDecode(code2, &out[0], &out[1]);
+    EXPECT_EQ(in[0], out[0]);
+    EXPECT_EQ(in[1], out[1]);
+
+    const nx::uint32_t in3[] = { in[0] & 0x1fffff, in[1] & 0x1fffff, in[2] };
+    const nx::uint64_t code3 = nx::MortonEncode(in3[0], in3[1], in3[2]);
+    EXPECT_EQ(NaiveEncode(in3, 3, 21), code3);
+    nx::MortonDecode(code3, &out[0], &out[1], &out[2]);
+    EXPECT_EQ(in3[0], out[0]);
+    EXPECT_EQ(in3[1], out[1]);
+    EXPECT_EQ(in3[2], out[2]);
+  }
+}
+
+TEST(MortonTest, Kernels) {
+  const nx::MortonKernel kernels[] = {
+    nx::MortonKernel::kShiftMask,
+    nx::MortonKernel::kBmi2
+  };
+  std::mt19937 random;
+  const nx::size_t length = 257;
+  std::vector<nx::uint32_t> x(length), y(length), z(length);
+  for (nx::size_t i = 0; i < length; ++i) {
+    x[i] = static_cast<nx::uint32_t>(random());
+    y[i] = static_cast<nx::uint32_t>(random());
+    z[i] = static_cast<nx::uint32_t>(random());
+  }
+  for (nx::MortonKernel kernel : kernels) {
+    if (!nx::MortonSupported(kernel)) {
+      continue;
+    }
+    nx::SetMortonKernel(kernel);
+    std::vector<nx::uint64_t> codes(length);
+    std::vector<nx::uint32_t> x_out(length), y_out(length), z_out(length);
+
+    nx::MortonEncode(x.data(), y.data(), codes.data(), length);
+    nx::MortonDecode(codes.data(), x_out.data(), y_out.data(), length);
+    for (nx::size_t i = 0; i < length; ++i) {
+      ASSERT_EQ(nx::MortonEncode(x[i], y[i]), codes[i]);
+    }
+    EXPECT_EQ(x, x_out);
+    EXPECT_EQ(y, y_out);
+
+    nx::MortonEncode(x.data(), y.data(), z.data(), codes.data(), length);
+    nx::MortonDecode(codes.data(), x_out.data(), y_out.data(), z_out.data(),
+                     length);
+    for (nx::size_t i = 0; i < length; ++i) {
+      ASSERT_EQ(nx::MortonEncode(x[i], y[i], z[i]), codes[i]);
+      ASSERT_EQ(x[i] & 0x1fffff, x_out[i]);
+      ASSERT_EQ(y[i] & 0x1fffff, y_out[i]);
+      ASSERT_EQ(z[i] & 0x1fffff, z_out[i]);
+    }
+  }
+}
@@ -0,0 +1,147 @@
+//
+// Copyright (C) 2013 Jacob McIntosh <nacitar at ubercpp dot com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+/// @file output_buffer_unittest.cc
+/// @brief Unit tests for output_buffer.h
+
+#include <cerrno>
+#include <cstdio>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include "gtest/gtest.h"
+#include "nx/output_buffer.h"
+
+namespace {
+
+/// @brief A temporary file to write to, which can be read back.
+class TemporaryFile {
+ public:
+  TemporaryFile() : file_(std::tmpfile()) {
+  }
+
+  ~TemporaryFile() {
+    std::fclose(file_);
+  }
+
+  /// @brief Provides the file descriptor.
+  int descriptor() const {
+    return fileno(file_);
+  }
+
+  /// @brief Reads everything written so far.
+  std::string Read() const {
+    std::string text;
+    std::fseek(file_, 0, SEEK_SET);
+    char buffer[4096];
+    size_t length;
+    while ((length = std::fread(buffer, 1, sizeof(buffer), file_)) != 0) {
+      text.append(buffer, length);
+    }
+    return text;
+  }
+
+ private:
+  std::FILE*const file_;
+};
+
+/// @brief Appends numbered lines, returning the text they should produce.
+std::string AppendLines(nx::OutputBuffer*buffer, unsigned int count) {
+  constexpr nx::FormatString kLine("line {:04} of {}\n");
+  std::string expected;
+  for (unsigned int i = 0; i < count; ++i) {
+    buffer->AppendFormat(kLine, i, count);
+    expected += nx::Format(kLine, i, count);
+  }
+  return expected;
+}
+
+}  // namespace
+
+TEST(OutputBufferTest, Values) {
+  TemporaryFile file;
+  {
+    nx::OutputBuffer buffer(file.descriptor());
+    buffer.Append("text ");
+    buffer.Append(std::string("string "));
+    buffer.Append('c');
+    buffer.Append(' ');
+    buffer.Append(-12345);
+    buffer.Append(' ');
+    buffer.Append(std::numeric_limits<nx::uint64_t>::max());
+    buffer.Append(' ');
+    buffer.Append(42, 5);
+    buffer.Append(' ');
+    buffer.Append<16>(0xbeefu, 8);
+    buffer.Append(' ');
+    buffer.Append<16, nx::LetterCase::kUpper>(0xbeefu);
+    buffer.Append(' ');
+    buffer.Append(0.1);
+    buffer.Append(' ');
+    buffer.Append(123456, 2);
+    EXPECT_EQ("", file.Read());
+    EXPECT_TRUE(buffer.Flush());
+    EXPECT_EQ("text string c -12345 18446744073709551615 00042 0000beef "
+              "BEEF 0.1 123456", file.Read());
+    constexpr nx::FormatString kFormat(" [{:>4}]");
+    buffer.AppendFormat(kFormat, 7);
+  }
+  // the destructor flushes
+  EXPECT_EQ("text string c -12345 18446744073709551615 00042 0000beef "
+            "BEEF 0.1 123456 [   7]", file.Read());
+}
+
+TEST(OutputBufferTest, Blocks) {
+  TemporaryFile file;
+  std::string expected;
+  {
+    // small blocks make the lines and long text span blocks, and fill the
+    // ring so that it is written before a flush
+    nx::OutputBuffer buffer(file.descriptor(), 16, 3);
+    expected += AppendLines(&buffer, 100);
+    const std::string long_text(1000, 'x');
+    buffer.Append(long_text);
+    expected += long_text;
+    constexpr nx::FormatString kLong("{}{}\n");
+    buffer.AppendFormat(kLong, long_text, 1);
+    expected += long_text + "1\n";
+    EXPECT_THROW(buffer.Reserve(17), std::length_error);
+  }
+  EXPECT_EQ(expected, file.Read());
+}
+
+TEST(OutputBufferTest, FlushThread) {
+  TemporaryFile file;
+  std::string expected;
+  {
+    nx::OutputBuffer buffer(file.descriptor(), 256, 4);
+    buffer.StartFlushThread();
+    expected = AppendLines(&buffer, 10000);
+    EXPECT_TRUE(buffer.Flush());
+    EXPECT_EQ(expected, file.Read());
+    expected += AppendLines(&buffer, 1000);
+  }
+  EXPECT_EQ(expected, file.Read());
+}
+
+TEST(OutputBufferTest, Error) {
+  nx::OutputBuffer buffer(-1);
+  EXPECT_EQ(0, buffer.error());
+  EXPECT_TRUE(buffer.Flush());
+  buffer.Append("lost");
+  EXPECT_FALSE(buffer.Flush());
+  EXPECT_EQ(EBADF, buffer.error());
+}
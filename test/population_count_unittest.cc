@@ -0,0 +1,140 @@
+//
+// Copyright (C) 2013 Jacob McIntosh <nacitar at ubercpp dot com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+/// @file population_count_unittest.cc
+/// @brief Unit tests for population_count.h
+
+#include <random>
+#include <vector>
+#include "gtest/gtest.h"
+#include "nx/population_count.h"
+
+namespace {
+
+nx::uint64_t NaiveCount(const unsigned char*data, nx::size_t bytes) {
+  nx::uint64_t count = 0;
+  for (nx::size_t i = 0; i < bytes; ++i) {
+    for (unsigned char byte = data[i]; byte; byte >>= 1) {
+      count += byte & 1;
+    }
+  }
+  return count;
+}
+
+}  // namespace
+
+TEST(PopulationCountTest, Intrinsic) {
+  // Supported toolchains must not fall back to the lookup tables.
+#if (defined(NX_TC_GCC) || defined(NX_TC_CLANG) || \
+    (defined(NX_TC_VS) && defined(__AVX__)))
+#if !defined(NX_USE_GENERIC_POPULATION_COUNT)
+#if !defined(NX_POPULATION_COUNT_INTRINSIC)
+  ADD_FAILURE() << "PopulationCount is using the generic implementation.";
+#endif
+#endif
+#endif
+}
+
+TEST(PopulationCountTest, Scalar) {
+  EXPECT_EQ(8u, nx::PopulationCount(static_cast<signed char>(-1)));
+  EXPECT_EQ(16u, nx::PopulationCount(static_cast<short>(-1)));  // NOLINT
+  EXPECT_EQ(0u, nx::PopulationCount(0u));
+  EXPECT_EQ(1u, nx::PopulationCount(static_cast<unsigned char>(0x80)));
+  EXPECT_EQ(8u, nx::PopulationCount(static_cast<unsigned char>(0xff)));
+  EXPECT_EQ(32u, nx::PopulationCount(~0u));
+  EXPECT_EQ(64u, nx::PopulationCount(~0ull));
+  EXPECT_EQ(3u, nx::PopulationCount(0x8000000000000101ull));
+}
+
+TEST(PopulationCountTest, WideTables) {
+  using nx::detail::version::PopulationCount;
+  using nx::detail::version::WidePopulationCount;
+  std::mt19937_64 random;
+  std::vector<nx::uint64_t> values = { 0, 1, ~0ull, 0x8000000000000001ull };
+  for (unsigned int bit = 0; bit < 64; ++bit) {
+    values.push_back(1ull << bit);
+    values.push_back(~0ull >> bit);
+  }
+  for (int i = 0; i < 1000; ++i) {
+    values.push_back(random());
+  }
+  for (nx::uint64_t value : values) {
+    const nx::uint32_t low32 = static_cast<nx::uint32_t>(value);
+    const nx::uint16_t low16 = static_cast<nx::uint16_t>(value);
+    EXPECT_EQ(PopulationCount<64>(value), WidePopulationCount<64>(value))
+        << value;
+    EXPECT_EQ(PopulationCount<32>(low32), WidePopulationCount<32>(low32))
+        << value;
+    EXPECT_EQ(PopulationCount<16>(low16), WidePopulationCount<16>(low16))
+        << value;
+    EXPECT_EQ(nx::PopulationCount(value), WidePopulationCount<64>(value))
+        << value;
+  }
+}
+
+TEST(PopulationCountTest, Array) {
+  const nx::uint64_t words[] = { ~0ull, 1, 0, 0x8000000000000001ull };
+  EXPECT_EQ(67u, nx::PopulationCount(words));
+  EXPECT_EQ(65u, nx::PopulationCount(words, 2));
+  const unsigned char bytes[] = { 0xff, 0x0f, 0x01 };
+  EXPECT_EQ(13u, nx::PopulationCount(bytes));
+}
+
+TEST(PopulationCountTest, Kernels) {
+  using nx::detail::PopulationCountKernel;
+  const PopulationCountKernel kernels[] = {
+    PopulationCountKernel::kScalar,
+    PopulationCountKernel::kPopcnt,
+    PopulationCountKernel::kHarleySeal,
+    PopulationCountKernel::kAvx2,
+    PopulationCountKernel::kAvx512
+  };
+  std::mt19937 random;
+  std::vector<unsigned char> data(4096 + 64);
+  for (unsigned char&byte : data) {
+    byte = static_cast<unsigned char>(random());
+  }
+  for (PopulationCountKernel kernel : kernels) {
+    if (!nx::detail::PopulationCountSupported(kernel)) {
+      continue;
+    }
+    // Every tail length and misalignment, plus several whole blocks.
+    for (nx::size_t offset = 0; offset < 8; ++offset) {
+      for (nx::size_t bytes = 0; bytes + offset <= data.size();
+          bytes += (bytes < 1100 ? 1 : 997)) {
+        const unsigned char*start = data.data() + offset;
+        ASSERT_EQ(NaiveCount(start, bytes),
+            nx::detail::PopulationCountBuffer(kernel, start, bytes))
+            << "kernel " << static_cast<int>(kernel)
+            << " offset " << offset << " bytes " << bytes;
+      }
+    }
+  }
+  EXPECT_EQ(NaiveCount(data.data(), data.size()),
+      nx::PopulationCount(data.data(), data.size()));
+}
+
+#if defined(NX_HAS_INT128)
+TEST(PopulationCountTest, Int128) {
+  typedef nx::uint128_t uint128;
+  EXPECT_EQ(0u, nx::PopulationCount(static_cast<uint128>(0)));
+  EXPECT_EQ(128u, nx::PopulationCount(~static_cast<uint128>(0)));
+  EXPECT_EQ(128u, nx::PopulationCount(static_cast<nx::int128_t>(-1)));
+  EXPECT_EQ(3u, nx::PopulationCount(
+      static_cast<uint128>(0x8000000000000001ull) << 64 | 1));
+}
+#endif
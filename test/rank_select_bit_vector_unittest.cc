@@ -0,0 +1,85 @@
+//
+// Copyright (C) 2013 Jacob McIntosh <nacitar at ubercpp dot com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+/// @file rank_select_bit_vector_unittest.cc
+/// @brief Unit tests for rank_select_bit_vector.h
+
+#include <random>
+#include <vector>
+#include "gtest/gtest.h"
+#include "nx/rank_select_bit_vector.h"
+
+namespace {
+
+// Checks every rank and select against a linear scan.
+void ExpectMatchesScan(const std::vector<nx::uint64_t>&words,
+    nx::uint64_t size) {
+  const nx::RankSelectBitVector vector(words.data(), size);
+  ASSERT_EQ(size, vector.size());
+  nx::uint64_t rank = 0;
+  for (nx::uint64_t i = 0; i < size; ++i) {
+    ASSERT_EQ(rank, vector.Rank(i)) << "index " << i;
+    const bool bit = (words[i / 64] >> (i % 64)) & 1;
+    ASSERT_EQ(bit, vector[i]);
+    if (bit) {
+      ASSERT_EQ(i, vector.Select(rank)) << "rank " << rank;
+      ++rank;
+    }
+  }
+  EXPECT_EQ(rank, vector.Rank(size));
+  EXPECT_EQ(rank, vector.count());
+}
+
+std::vector<nx::uint64_t> RandomWords(nx::size_t count, unsigned int sparsity) {
+  std::mt19937_64 random(count + sparsity);
+  std::vector<nx::uint64_t> words(count);
+  for (nx::uint64_t&word : words) {
+    word = random();
+    for (unsigned int i = 0; i < sparsity; ++i) {
+      word &= random();
+    }
+  }
+  return words;
+}
+
+}  // namespace
+
+TEST(RankSelectBitVectorTest, Empty) {
+  const nx::RankSelectBitVector vector;
+  EXPECT_EQ(0u, vector.size());
+  EXPECT_EQ(0u, vector.count());
+  EXPECT_EQ(0u, vector.Rank(0));
+}
+
+TEST(RankSelectBitVectorTest, Dense) {
+  ExpectMatchesScan(RandomWords(1000, 0), 1000 * 64 - 13);
+  ExpectMatchesScan(std::vector<nx::uint64_t>(96, ~0ull), 96 * 64);
+}
+
+TEST(RankSelectBitVectorTest, Sparse) {
+  ExpectMatchesScan(RandomWords(3000, 4), 3000 * 64);
+  std::vector<nx::uint64_t> words(5000, 0);
+  words[0] = 1;
+  words[4000] = 0x8000000000000000ull;
+  ExpectMatchesScan(words, 5000 * 64);
+}
+
+TEST(RankSelectBitVectorTest, Overhead) {
+  const std::vector<nx::uint64_t> words = RandomWords(1 << 16, 0);
+  const nx::RankSelectBitVector vector(words.data(), words.size() * 64);
+  EXPECT_LT(vector.index_bytes(), words.size() * 8 * 6 / 100);
+}
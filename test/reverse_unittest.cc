@@ -0,0 +1,145 @@
+//
+// Copyright (C) 2013 Jacob McIntosh <nacitar at ubercpp dot com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+/// @file reverse_unittest.cc
+/// @brief Unit tests for reverse.h
+
+#include <random>
+#include <vector>
+#include "gtest/gtest.h"
+#include "nx/reverse.h"
+
+namespace {
+
+template <class T>
+void ExpectKernelsReverse(std::mt19937_64*random) {
+  using nx::detail::ReverseBitsKernel;
+  const ReverseBitsKernel kernels[] = {
+    ReverseBitsKernel::kScalar,
+    ReverseBitsKernel::kSsse3,
+    ReverseBitsKernel::kAvx2
+  };
+  // Lengths around the vector widths exercise the scalar tails.
+  for (nx::size_t length : { 0, 1, 7, 16, 31, 64, 67, 200 }) {
+    std::vector<T> source(length);
+    std::vector<T> expected(length);
+    for (nx::size_t i = 0; i < length; ++i) {
+      source[i] = static_cast<T>((*random)());
+      expected[i] = nx::Reverse(source[i]);
+    }
+    for (ReverseBitsKernel kernel : kernels) {
+      if (!nx::detail::ReverseBitsSupported(kernel)) {
+        continue;
+      }
+      std::vector<T> destination(length);
+      nx::detail::ReverseBitsBuffer(kernel, source.data(),
+                                    destination.data(), length, sizeof(T));
+      EXPECT_EQ(expected, destination)
+          << "kernel " << static_cast<int>(kernel) << ", length " << length;
+      std::vector<T> data(source);
+      nx::detail::ReverseBitsBuffer(kernel, data.data(), data.data(),
+                                    length, sizeof(T));
+      EXPECT_EQ(expected, data)
+          << "kernel " << static_cast<int>(kernel) << ", length " << length;
+    }
+  }
+}
+
+}  // namespace
+
+TEST(ReverseTest, Scalar) {
+  EXPECT_EQ(0x80u, nx::Reverse(static_cast<nx::uint8_t>(0x01)));
+  EXPECT_EQ(0x8000u, nx::Reverse(static_cast<nx::uint16_t>(0x0001)));
+  EXPECT_EQ(0x0000f00fu, nx::Reverse(static_cast<nx::uint32_t>(0xf00f0000)));
+  EXPECT_EQ(0x8000000000000003ull, nx::Reverse(0xc000000000000001ull));
+  EXPECT_EQ(-128, nx::Reverse(static_cast<nx::int8_t>(1)));
+}
+
+TEST(ReverseTest, WideTables) {
+  using nx::detail::version::Reverse;
+  using nx::detail::version::WideReverse;
+  std::mt19937_64 random;
+  std::vector<nx::uint64_t> values = { 0, 1, ~0ull, 0xc000000000000001ull };
+  for (unsigned int bit = 0; bit < 64; ++bit) {
+    values.push_back(1ull << bit);
+  }
+  for (int i = 0; i < 1000; ++i) {
+    values.push_back(random());
+  }
+  for (nx::uint64_t value : values) {
+    const nx::uint32_t low32 = static_cast<nx::uint32_t>(value);
+    const nx::uint16_t low16 = static_cast<nx::uint16_t>(value);
+    EXPECT_EQ(Reverse<64>(value), WideReverse<64>(value)) << value;
+    EXPECT_EQ(Reverse<32>(low32), WideReverse<32>(low32)) << value;
+    EXPECT_EQ(Reverse<16>(low16), WideReverse<16>(low16)) << value;
+    EXPECT_EQ(nx::Reverse(value), WideReverse<64>(value)) << value;
+  }
+}
+
+#if defined(NX_HAS_INT128)
+TEST(ReverseTest, Int128) {
+  typedef nx::uint128_t uint128;
+  const uint128 value = static_cast<uint128>(0xc000000000000001ull) << 64 | 2;
+  const uint128 reversed =
+      static_cast<uint128>(0x4000000000000000ull) << 64 | 0x8000000000000003ull;
+  EXPECT_TRUE(reversed == nx::Reverse(value));
+  EXPECT_TRUE(value == nx::Reverse(nx::Reverse(value)));
+  EXPECT_TRUE(static_cast<nx::int128_t>(static_cast<uint128>(1) << 127)
+      == nx::Reverse(static_cast<nx::int128_t>(1)));
+}
+#endif
+
+TEST(ReverseTest, Array) {
+  nx::uint16_t data[] = { 0x0001, 0x8000, 0x00ff };
+  nx::ReverseBits(data, 3);
+  EXPECT_EQ(0x8000u, data[0]);
+  EXPECT_EQ(0x0001u, data[1]);
+  EXPECT_EQ(0xff00u, data[2]);
+  const nx::int32_t source[] = { 1, -1 };
+  nx::int32_t destination[2];
+  nx::ReverseBits(source, destination, 2);
+  EXPECT_EQ(nx::Reverse(1), destination[0]);
+  EXPECT_EQ(-1, destination[1]);
+}
+
+TEST(ReverseTest, Kernels) {
+  std::mt19937_64 random;
+  ExpectKernelsReverse<nx::uint8_t>(&random);
+  ExpectKernelsReverse<nx::uint16_t>(&random);
+  ExpectKernelsReverse<nx::uint32_t>(&random);
+  ExpectKernelsReverse<nx::uint64_t>(&random);
+}
+
+TEST(ReverseTest, Permutation) {
+  for (unsigned int log2_length = 0; log2_length <= 16; ++log2_length) {
+    const nx::size_t length = static_cast<nx::size_t>(1) << log2_length;
+    std::vector<nx::uint32_t> source(length);
+    for (nx::size_t i = 0; i < length; ++i) {
+      source[i] = static_cast<nx::uint32_t>(i);
+    }
+    std::vector<nx::uint32_t> destination(length);
+    nx::BitReversalPermutation(source.data(), destination.data(),
+                               log2_length);
+    for (nx::size_t i = 0; i < length; ++i) {
+      const nx::size_t reversed = log2_length ? static_cast<nx::size_t>(
+          nx::Reverse(static_cast<nx::uint64_t>(i)) >> (64 - log2_length))
+          : 0;
+      ASSERT_EQ(source[i], destination[reversed])
+          << "log2_length " << log2_length << ", index " << i;
+    }
+  }
+}
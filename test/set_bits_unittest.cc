@@ -0,0 +1,71 @@
+//
+// Copyright (C) 2013 Jacob McIntosh <nacitar at ubercpp dot com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+/// @file set_bits_unittest.cc
+/// @brief Unit tests for set_bits.h
+
+#include <random>
+#include <vector>
+#include "gtest/gtest.h"
+#include "nx/set_bits.h"
+
+TEST(SetBitsTest, Word) {
+  std::vector<unsigned int> indices;
+  for (unsigned int index : nx::SetBits(0x8000000000000105ull)) {
+    indices.push_back(index);
+  }
+  EXPECT_EQ((std::vector<unsigned int>{ 0, 2, 8, 63 }), indices);
+
+  indices.clear();
+  for (unsigned int index : nx::SetBits(static_cast<signed char>(-128))) {
+    indices.push_back(index);
+  }
+  EXPECT_EQ((std::vector<unsigned int>{ 7 }), indices);
+
+  for (unsigned int index : nx::SetBits(0u)) {
+    ADD_FAILURE() << "unexpected index " << index;
+  }
+}
+
+TEST(SetBitsTest, Array) {
+  const unsigned char bytes[] = { 0x81, 0, 0x10 };
+  std::vector<nx::size_t> indices;
+  nx::ForEachSetBit(bytes, [&indices](nx::size_t index) {
+    indices.push_back(index);
+  });
+  EXPECT_EQ((std::vector<nx::size_t>{ 0, 7, 20 }), indices);
+}
+
+TEST(SetBitsTest, SparseArray) {
+  // Long runs of zero words between set bits, ending with a run of zeros.
+  std::mt19937 random;
+  std::vector<nx::uint64_t> words(5000);
+  std::vector<nx::size_t> expected;
+  for (nx::size_t i = 0; i < 4900; i += 1 + random() % 300) {
+    words[i] |= 1ull << (random() % 64);
+  }
+  for (nx::size_t i = 0; i < words.size() * 64; ++i) {
+    if ((words[i / 64] >> (i % 64)) & 1) {
+      expected.push_back(i);
+    }
+  }
+  std::vector<nx::size_t> indices;
+  nx::ForEachSetBit(words.data(), words.size(), [&indices](nx::size_t index) {
+    indices.push_back(index);
+  });
+  EXPECT_EQ(expected, indices);
+}
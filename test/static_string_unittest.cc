@@ -0,0 +1,73 @@
+//
+// Copyright (C) 2013 Jacob McIntosh <nacitar at ubercpp dot com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+/// @file static_string_unittest.cc
+/// @brief Unit tests for static_string.h
+
+#include <string>
+#include "gtest/gtest.h"
+#include "nx/literal.h"
+#include "nx/static_string.h"
+
+namespace {
+
+constexpr auto kStatus = nx::ToStaticString<int, 404>();
+constexpr auto kMetric = nx::MakeStaticString("requests_") + kStatus +
+    nx::MakeStaticString("_total");
+
+static_assert(kStatus.size() == 3, "constexpr length");
+static_assert(kStatus[0] == '4' && kStatus[1] == '0' && kStatus[2] == '4' &&
+              kStatus[3] == '\0', "constexpr text");
+static_assert(kMetric.size() == 18, "constexpr concatenation");
+static_assert(kMetric[9] == '4' && kMetric[18] == '\0',
+              "constexpr concatenation");
+
+}  // namespace
+
+TEST(StaticStringTest, Integers) {
+  EXPECT_STREQ("404", kStatus.c_str());
+  EXPECT_STREQ("0", (nx::ToStaticString<unsigned int, 0>().c_str()));
+  EXPECT_STREQ("-128", (nx::ToStaticString<signed char, -128>().c_str()));
+  EXPECT_STREQ("18446744073709551615",
+               (nx::ToStaticString<nx::uint64_t, ~0ull>().c_str()));
+  EXPECT_STREQ("-9223372036854775808",
+               (nx::ToStaticString<nx::int64_t,
+                                   -9223372036854775807ll - 1>().c_str()));
+  EXPECT_STREQ("1000000000", (nx::ToStaticString<
+      nx::uint64_t, nx::Power<nx::uint64_t, 10, 9>::value>().c_str()));
+  EXPECT_STREQ("182", (nx::ToStaticString<unsigned int,
+                                          10110110_nx_b>().c_str()));
+}
+
+TEST(StaticStringTest, Bases) {
+  EXPECT_STREQ("10110110", (nx::ToStaticString<unsigned int,
+                                               10110110_nx_b, 2>().c_str()));
+  EXPECT_STREQ("777", (nx::ToStaticString<int, 511, 8>().c_str()));
+  EXPECT_STREQ("-ff10", (nx::ToStaticString<int, -0xff10, 16>().c_str()));
+  EXPECT_STREQ("DEADBEEF", (nx::ToStaticString<
+      nx::uint32_t, 0xdeadbeef, 16, nx::LetterCase::kUpper>().c_str()));
+}
+
+TEST(StaticStringTest, Concatenation) {
+  EXPECT_STREQ("requests_404_total", kMetric.c_str());
+  EXPECT_EQ(std::string("requests_404_total"), kMetric.c_str());
+  constexpr auto kEmpty = nx::MakeStaticString("") + nx::MakeStaticString("");
+  EXPECT_EQ(0u, kEmpty.size());
+  EXPECT_STREQ("", kEmpty.c_str());
+  constexpr auto kCharacters = nx::StaticString<2>('o', 'k') +
+      nx::MakeStaticString("!");
+  EXPECT_STREQ("ok!", kCharacters.c_str());
+}
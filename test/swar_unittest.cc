@@ -0,0 +1,79 @@
+//
+// Copyright (C) 2013 Jacob McIntosh <nacitar at ubercpp dot com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+/// @file swar_unittest.cc
+/// @brief Unit tests for swar.h
+
+#include <random>
+#include "gtest/gtest.h"
+#include "nx/swar.h"
+#include "nx/bit_scan_forward.h"
+#include "nx/bit_scan_reverse.h"
+#include "nx/population_count.h"
+#include "nx/reverse.h"
+
+namespace {
+
+template <class T>
+void ExpectMatches(T value) {
+  EXPECT_EQ(nx::PopulationCount(value), nx::swar::PopulationCount(value))
+      << value;
+  EXPECT_EQ(nx::BitScanForward(value), nx::swar::BitScanForward(value))
+      << value;
+  EXPECT_EQ(nx::BitScanReverse(value), nx::swar::BitScanReverse(value))
+      << value;
+  EXPECT_EQ(nx::Reverse(value), nx::swar::Reverse(value)) << value;
+}
+
+}  // namespace
+
+TEST(SwarTest, Constexpr) {
+  static_assert(nx::swar::PopulationCount(0xf0f0f0f0f0f0f0f0ull) == 32,
+                "PopulationCount must be constexpr");
+  static_assert(nx::swar::BitScanForward(0x100u) == 8,
+                "BitScanForward must be constexpr");
+  static_assert(nx::swar::BitScanReverse(0x8000000000000001ull) == 63,
+                "BitScanReverse must be constexpr");
+  static_assert(nx::swar::Reverse(static_cast<nx::uint8_t>(1)) == 0x80,
+                "Reverse must be constexpr");
+}
+
+TEST(SwarTest, Zero) {
+  EXPECT_EQ(0u, nx::swar::PopulationCount(0u));
+  EXPECT_EQ(0u, nx::swar::BitScanForward(0u));
+  EXPECT_EQ(0u, nx::swar::BitScanReverse(0ull));
+  EXPECT_EQ(0u, nx::swar::Reverse(0u));
+}
+
+TEST(SwarTest, Exhaustive16) {
+  for (unsigned int i = 0; i <= 0xffff; ++i) {
+    ExpectMatches(static_cast<nx::uint16_t>(i));
+    ExpectMatches(static_cast<nx::uint8_t>(i));
+  }
+}
+
+TEST(SwarTest, Random) {
+  std::mt19937_64 random;
+  for (int i = 0; i < 10000; ++i) {
+    // Shifting by a random amount covers every highest set bit.
+    const nx::uint64_t value = random() >> (random() % 64);
+    ExpectMatches(value);
+    ExpectMatches(static_cast<nx::uint32_t>(value));
+    ExpectMatches(static_cast<nx::int64_t>(value));
+    ExpectMatches(static_cast<nx::int32_t>(value));
+  }
+}
@@ -0,0 +1,162 @@
+//
+// Copyright (C) 2013 Jacob McIntosh <nacitar at ubercpp dot com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+/// @file table_unittest.cc
+/// @brief Unit tests for table.h and the tables of constant.h
+
+#include <cstdio>
+#include <cstring>
+#include "gtest/gtest.h"
+#include "nx/constant.h"
+#include "nx/table.h"
+
+namespace {
+
+constexpr nx::uint_least16_t Square(unsigned int index) {
+  return static_cast<nx::uint_least16_t>(index * index);
+}
+
+class Cube {
+ public:
+  constexpr nx::uint_least32_t operator()(unsigned int index) const {
+    return index * index * index;
+  }
+};
+
+constexpr auto kSquares = nx::MakeTable<16>(Square);
+
+static_assert(kSquares.size() == 16, "constexpr size");
+static_assert(kSquares[0] == 0 && kSquares[3] == 9 && kSquares[15] == 225,
+              "constexpr values");
+static_assert(alignof(decltype(kSquares)) == nx::kTableAlignment,
+              "aligned to a cache line");
+static_assert(nx::StaticTable<Cube, 8>::value[2] == 8,
+              "constexpr static table");
+static_assert(nx::constant::log_16bit::value[0x8000] == 15,
+              "constexpr wide table");
+
+/// @brief Computes the CRC-32 of a string one byte at a time.
+nx::uint_least32_t Crc32(const nx::Table<nx::uint_least32_t, 256>&table,
+                         const char*text) {
+  nx::uint_least32_t crc = 0xFFFFFFFFu;
+  for (; *text; ++text) {
+    crc = (crc >> 8) ^ table[(crc ^ static_cast<unsigned char>(*text)) & 0xFF];
+  }
+  return ~crc;
+}
+
+}  // namespace
+
+TEST(TableTest, MakeTable) {
+  EXPECT_EQ(0u, reinterpret_cast<nx::uintptr_t>(kSquares.data())
+            % nx::kTableAlignment);
+  unsigned int index = 0;
+  for (nx::uint_least16_t square : kSquares) {
+    EXPECT_EQ(index * index, square);
+    ++index;
+  }
+  EXPECT_EQ(16u, index);
+  const auto cubes = nx::MakeTable<5>(Cube());
+  EXPECT_EQ(64u, cubes[4]);
+  EXPECT_EQ(cubes.data() + 5, cubes.end());
+}
+
+TEST(TableTest, StaticTable) {
+  typedef nx::StaticTable<Cube, 8> cubes;
+  EXPECT_EQ(343u, cubes::value[7]);
+  // Every use refers to the single instance.
+  EXPECT_EQ(&cubes::value, (&nx::StaticTable<Cube, 8>::value));
+  EXPECT_EQ(0u, reinterpret_cast<nx::uintptr_t>(cubes::value.data())
+            % nx::kTableAlignment);
+}
+
+TEST(TableTest, BitTables) {
+  using nx::constant::log_8bit;
+  using nx::constant::parity_8bit;
+  using nx::constant::population_count_8bit;
+  using nx::constant::reverse_8bit;
+  typedef nx::constant::log_16bit log_16bit;
+  typedef nx::constant::population_count_16bit population_count_16bit;
+  typedef nx::constant::reverse_16bit reverse_16bit;
+  for (unsigned int value = 0; value < 65536; ++value) {
+    unsigned int log = 0;
+    unsigned int count = 0;
+    unsigned int reversed = 0;
+    for (unsigned int bit = 0; bit < 16; ++bit) {
+      if (value >> bit & 1) {
+        log = bit;
+        ++count;
+        reversed |= 1u << (15 - bit);
+      }
+    }
+    if (value < 256) {
+      EXPECT_EQ(log, log_8bit[value]);
+      EXPECT_EQ(count, population_count_8bit[value]);
+      EXPECT_EQ(count & 1, parity_8bit[value]);
+      EXPECT_EQ(reversed >> 8, reverse_8bit[value]);
+    }
+    EXPECT_EQ(log, log_16bit::value[value]);
+    EXPECT_EQ(count, population_count_16bit::value[value]);
+    EXPECT_EQ(reversed, reverse_16bit::value[value]);
+  }
+}
+
+TEST(TableTest, DeBruijnTables) {
+  using nx::constant::de_bruijn_32bit;
+  using nx::constant::de_bruijn_64bit;
+  using nx::constant::de_bruijn_multiplier_32bit;
+  using nx::constant::de_bruijn_multiplier_64bit;
+  for (unsigned int bit = 0; bit < 32; ++bit) {
+    EXPECT_EQ(bit, de_bruijn_32bit[static_cast<nx::uint32_t>(
+        (nx::uint32_t(1) << bit) * de_bruijn_multiplier_32bit) >> 27]);
+  }
+  for (unsigned int bit = 0; bit < 64; ++bit) {
+    EXPECT_EQ(bit, de_bruijn_64bit[
+        ((nx::uint64_t(1) << bit) * de_bruijn_multiplier_64bit) >> 58]);
+  }
+}
+
+TEST(TableTest, NumberTables) {
+  nx::uint64_t power = 1;
+  for (unsigned int exponent = 0; exponent < 20; ++exponent) {
+    if (exponent < 10) {
+      EXPECT_EQ(power, nx::constant::power_10_32bit[exponent]);
+    }
+    EXPECT_EQ(power, nx::constant::power_10_64bit[exponent]);
+    power *= 10;
+  }
+  for (unsigned int value = 0; value < 256; ++value) {
+    char text[3];
+    if (value < 100) {
+      std::snprintf(text, sizeof(text), "%02u", value);
+      EXPECT_EQ(0, std::memcmp(
+          text, nx::constant::decimal_digit_pairs.data() + value * 2, 2));
+    }
+    std::snprintf(text, sizeof(text), "%02x", value);
+    EXPECT_EQ(0, std::memcmp(
+        text, nx::constant::hex_digit_pairs_lower.data() + value * 2, 2));
+    std::snprintf(text, sizeof(text), "%02X", value);
+    EXPECT_EQ(0, std::memcmp(
+        text, nx::constant::hex_digit_pairs_upper.data() + value * 2, 2));
+  }
+}
+
+TEST(TableTest, Crc32Tables) {
+  // The check values of each algorithm.
+  EXPECT_EQ(0xCBF43926u, Crc32(nx::constant::crc32_8bit, "123456789"));
+  EXPECT_EQ(0xE3069283u, Crc32(nx::constant::crc32c_8bit, "123456789"));
+  EXPECT_EQ(0u, Crc32(nx::constant::crc32_8bit, ""));
+}
@@ -0,0 +1,427 @@
+//
+// Copyright (C) 2013 Jacob McIntosh <nacitar at ubercpp dot com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+/// @file to_string_unittest.cc
+/// @brief Unit tests for to_string.h
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+#include "nx/to_string.h"
+
+namespace {
+
+/// @brief Values of every length, including the extremes of the type.
+template <class T>
+std::vector<T> MixedLengthValues(std::mt19937_64*random, nx::size_t length) {
+  std::vector<T> values(length);
+  for (nx::size_t i = 0; i < length; ++i) {
+    values[i] = static_cast<T>((*random)() >> (i % 64));
+  }
+  if (length > 2) {
+    values[0] = std::numeric_limits<T>::max();
+    values[1] = std::numeric_limits<T>::min();
+  }
+  return values;
+}
+
+/// @brief Reads a value back with the C library.
+template <class T>
+T ReadFloat(const char*text);
+
+template <>
+double ReadFloat<double>(const char*text) {
+  return std::strtod(text, nullptr);
+}
+
+template <>
+float ReadFloat<float>(const char*text) {
+  return std::strtof(text, nullptr);
+}
+
+/// @brief The significant digits of a number in fixed or scientific
+/// notation, without leading or trailing zeros.
+std::string SignificantDigits(const std::string&text) {
+  std::string digits;
+  for (char c : text) {
+    if (c == 'e') {
+      break;
+    }
+    if (c >= '0' && c <= '9') {
+      digits += c;
+    }
+  }
+  digits.erase(0, digits.find_first_not_of('0'));
+  digits.erase(digits.find_last_not_of('0') + 1);
+  return digits;
+}
+
+/// @brief Checks that a value reads back as the same value, with no more
+/// digits than the shortest correctly rounded snprintf output that does, and
+/// the same digits if as many.
+/// @details A shorter result is possible when the correctly rounded digits
+/// fall just outside the rounding interval, but the next ones do not.
+template <class T>
+void ExpectShortest(T value) {
+  const std::string text = nx::ToString(value);
+  const T read = ReadFloat<T>(text.c_str());
+  EXPECT_EQ(0, std::memcmp(&value, &read, sizeof(value))) << text;
+  char expected[40];
+  for (int precision = 1; precision <= 17; ++precision) {
+    snprintf(expected, sizeof(expected), "%.*e", precision - 1,
+             static_cast<double>(value));
+    if (ReadFloat<T>(expected) == value) {
+      break;
+    }
+  }
+  const std::string expected_digits = SignificantDigits(expected);
+  const std::string digits = SignificantDigits(text);
+  EXPECT_LE(digits.size(), expected_digits.size()) << text;
+  if (digits.size() == expected_digits.size()) {
+    EXPECT_EQ(expected_digits, digits) << text;
+  }
+}
+
+/// @brief Random bit patterns of every finite, nonzero value of T.
+template <class T, class Bits>
+void ExpectRandomShortest(std::mt19937_64*random, unsigned int count) {
+  for (unsigned int i = 0; i < count; ++i) {
+    const Bits bits = static_cast<Bits>((*random)());
+    T value;
+    std::memcpy(&value, &bits, sizeof(value));
+    if (value != 0 && value - value == 0) {
+      ExpectShortest(value);
+    }
+  }
+}
+
+template <class T>
+void ExpectKernelsConvert(std::mt19937_64*random) {
+  using nx::detail::ToStringKernel;
+  const ToStringKernel kernels[] = {
+    ToStringKernel::kScalar,
+    ToStringKernel::kSse41,
+    ToStringKernel::kAvx2
+  };
+  const nx::FieldFormat format(", ");
+  // Odd lengths exercise the single element tail of the AVX2 kernel.
+  for (nx::size_t length : { 0, 1, 2, 3, 64, 67 }) {
+    const std::vector<T> values = MixedLengthValues<T>(random, length);
+    std::string expected;
+    std::vector<nx::size_t> expected_offsets;
+    for (const T&value : values) {
+      expected_offsets.push_back(expected.size());
+      nx::ToString(value, &expected);
+      expected += ", ";
+    }
+    for (ToStringKernel kernel : kernels) {
+      if (!nx::detail::ToStringSupported(kernel)) {
+        continue;
+      }
+      std::string text(expected.size() + nx::detail::kToStringFieldsSlack,
+                       ' ');
+      std::vector<nx::size_t> offsets(length);
+      char*end = nx::detail::ToStringFields(
+          kernel, values.data(), length, format, &text[0], &text[0],
+          offsets.data());
+      EXPECT_EQ(expected.size(), static_cast<nx::size_t>(end - &text[0]))
+          << "kernel " << static_cast<int>(kernel) << ", length " << length;
+      EXPECT_EQ(expected, text.substr(0, expected.size()))
+          << "kernel " << static_cast<int>(kernel) << ", length " << length;
+      EXPECT_EQ(expected_offsets, offsets)
+          << "kernel " << static_cast<int>(kernel) << ", length " << length;
+    }
+  }
+}
+
+}  // namespace
+
+TEST(ToStringTest, Integers) {
+  EXPECT_EQ("0", nx::ToString(0));
+  EXPECT_EQ("12345", nx::ToString(12345));
+  EXPECT_EQ("-12345", nx::ToString(-12345));
+  EXPECT_EQ("255", nx::ToString(static_cast<unsigned char>(255)));
+  EXPECT_EQ("-128", nx::ToString(static_cast<signed char>(-128)));
+  EXPECT_EQ("18446744073709551615", nx::ToString(~0ull));
+  EXPECT_EQ("-9223372036854775808",
+            nx::ToString(-9223372036854775807ll - 1));
+}
+
+TEST(ToStringTest, Digits) {
+  EXPECT_EQ("00042", nx::ToString(42, 5));
+  EXPECT_EQ("-00042", nx::ToString(-42, 5));
+  EXPECT_EQ("45", nx::ToString(12345, 2));
+  char buffer[8];
+  EXPECT_EQ(3u, nx::ToString(123u, buffer));
+  EXPECT_EQ("123", std::string(buffer, 3));
+  std::string text("x=");
+  EXPECT_EQ(2u, nx::ToString(-7, &text));
+  EXPECT_EQ("x=-7", text);
+}
+
+TEST(ToStringTest, PowersOf10) {
+  nx::uint64_t power = 1;
+  std::string expected("1");
+  for (unsigned int digits = 1; digits <= 19; ++digits) {
+    EXPECT_EQ(expected, nx::ToString(power));
+    EXPECT_EQ(std::string(digits, '9'), nx::ToString(power * 10 - 1));
+    if (digits > 1) {
+      EXPECT_EQ(expected.substr(0, digits - 1) + "1", nx::ToString(power + 1));
+    }
+    EXPECT_EQ(digits, nx::Digits(power));
+    EXPECT_EQ(digits, nx::Digits(power * 10 - 1));
+    power *= 10;
+    expected += '0';
+  }
+  // Padding and truncation across the 8-digit chunks.
+  EXPECT_EQ("000000001234567890", nx::ToString(1234567890u, 18));
+  EXPECT_EQ("34567890", nx::ToString(1234567890u, 8));
+  EXPECT_EQ("234567890", nx::ToString(1234567890u, 9));
+  EXPECT_EQ("4073709551615", nx::ToString(~0ull, 13));
+  EXPECT_EQ("0018446744073709551615", nx::ToString(~0ull, 22));
+}
+
+TEST(ToStringTest, MatchesSnprintf) {
+  std::mt19937_64 random;
+  char expected[32];
+  for (unsigned int i = 0; i < 10000; ++i) {
+    // Vary the length of the values as well as their digits.
+    const nx::uint64_t value = random() >> (i % 64);
+    snprintf(expected, sizeof(expected), "%llu",
+             static_cast<unsigned long long>(value));  // NOLINT(runtime/int)
+    EXPECT_EQ(expected, nx::ToString(value));
+    const nx::int64_t signed_value = static_cast<nx::int64_t>(random());
+    snprintf(expected, sizeof(expected), "%lld",
+             static_cast<long long>(signed_value));  // NOLINT(runtime/int)
+    EXPECT_EQ(expected, nx::ToString(signed_value));
+  }
+}
+
+TEST(ToStringTest, FloatingPoint) {
+  EXPECT_EQ("0", nx::ToString(0.0));
+  EXPECT_EQ("-0", nx::ToString(-0.0));
+  EXPECT_EQ("1", nx::ToString(1.0));
+  EXPECT_EQ("-2.5", nx::ToString(-2.5));
+  EXPECT_EQ("0.1", nx::ToString(0.1));
+  EXPECT_EQ("0.30000000000000004", nx::ToString(0.1 + 0.2));
+  EXPECT_EQ("0.1", nx::ToString(0.1f));
+  // long double is rounded to double, whose shortest text is shorter
+  EXPECT_EQ("0.1", nx::ToString(0.1L));
+  EXPECT_EQ("123456.79", nx::ToString(123456.789f));
+  EXPECT_EQ("1000", nx::ToString(1000.0));
+  EXPECT_EQ("0.001", nx::ToString(0.001));
+  EXPECT_EQ("0.000123", nx::ToString(0.000123));
+  EXPECT_EQ("1.23e-05", nx::ToString(0.0000123));
+  EXPECT_EQ("12345678901234568", nx::ToString(12345678901234567.0));
+  EXPECT_EQ("1e+17", nx::ToString(1e17));
+  EXPECT_EQ("1e+23", nx::ToString(1e23));
+  EXPECT_EQ("9007199254740994", nx::ToString(9007199254740994.0));
+  EXPECT_EQ("1.7976931348623157e+308",
+            nx::ToString(std::numeric_limits<double>::max()));
+  EXPECT_EQ("2.2250738585072014e-308",
+            nx::ToString(std::numeric_limits<double>::min()));
+  EXPECT_EQ("5e-324", nx::ToString(std::numeric_limits<double>::denorm_min()));
+  EXPECT_EQ("3.4028235e+38", nx::ToString(std::numeric_limits<float>::max()));
+  EXPECT_EQ("1e-45", nx::ToString(std::numeric_limits<float>::denorm_min()));
+  EXPECT_EQ("inf", nx::ToString(std::numeric_limits<double>::infinity()));
+  EXPECT_EQ("-inf", nx::ToString(-std::numeric_limits<float>::infinity()));
+  EXPECT_EQ("nan", nx::ToString(std::numeric_limits<double>::quiet_NaN()));
+  char buffer[nx::detail::kShortestMaxLength];
+  EXPECT_EQ(24u, nx::ToString(-2.2250738585072014e-300, buffer));
+  EXPECT_EQ("-2.2250738585072014e-300", std::string(buffer, 24));
+  std::string text("x=");
+  EXPECT_EQ(4u, nx::ToString(-0.5f, &text));
+  EXPECT_EQ("x=-0.5", text);
+}
+
+TEST(ToStringTest, FloatingPointShortest) {
+  // Powers of two have a lower neighbour half as far away as the upper one.
+  for (int exponent = -1074; exponent <= 1023; ++exponent) {
+    ExpectShortest(std::ldexp(1.0, exponent));
+  }
+  for (int exponent = -149; exponent <= 127; ++exponent) {
+    ExpectShortest(std::ldexp(1.0f, exponent));
+  }
+  std::mt19937_64 random;
+  ExpectRandomShortest<double, nx::uint64_t>(&random, 100000);
+  ExpectRandomShortest<float, nx::uint32_t>(&random, 100000);
+}
+
+TEST(ToStringTest, Array) {
+  const int values[] = { 12, -345, 0, 2147483647 };
+  std::string text("[");
+  std::vector<nx::size_t> offsets;
+  EXPECT_EQ(21u, nx::ToString(values, 4, &text, nx::FieldFormat(",", "]"),
+                              &offsets));
+  EXPECT_EQ("[12,-345,0,2147483647]", text);
+  EXPECT_EQ((std::vector<nx::size_t>{ 1, 4, 9, 11 }), offsets);
+  EXPECT_EQ(1u, nx::ToString(values, 0, &text, nx::FieldFormat(",", "\n")));
+  EXPECT_EQ("[12,-345,0,2147483647]\n", text);
+  // Larger than the blocks the elements are converted in.
+  std::mt19937_64 random;
+  const std::vector<nx::uint8_t> bytes =
+      MixedLengthValues<nx::uint8_t>(&random, 1000);
+  std::string expected;
+  for (nx::uint8_t value : bytes) {
+    nx::ToString(value, &expected);
+    expected += ' ';
+  }
+  text.clear();
+  nx::ToString(bytes.data(), bytes.size(), &text, nx::FieldFormat(" ", " "));
+  EXPECT_EQ(expected, text);
+  // A separator longer than the kernels' slack is still written after the
+  // last element before the terminator replaces it.
+  const char separator[] = "<--a-separator-longer-than-the-slack-->";
+  std::string fields;
+  EXPECT_EQ(2 * (sizeof(separator) - 1) + 7,
+            nx::ToString(values, 3, &fields, nx::FieldFormat(separator, "")));
+  EXPECT_EQ(std::string("12") + separator + "-345" + separator + "0", fields);
+}
+
+TEST(ToStringTest, PowerOf2Bases) {
+  EXPECT_EQ("0", nx::ToString<2>(0));
+  EXPECT_EQ("101", nx::ToString<2>(5u));
+  EXPECT_EQ("777", nx::ToString<8>(511));
+  EXPECT_EQ("ff10", nx::ToString<16>(0xff10));
+  EXPECT_EQ("FF10", (nx::ToString<16, nx::LetterCase::kUpper>(0xff10)));
+  EXPECT_EQ("-80", nx::ToString<16>(static_cast<signed char>(-128)));
+  EXPECT_EQ("-8000000000000000",
+            nx::ToString<16>(-9223372036854775807ll - 1));
+  EXPECT_EQ("1777777777777777777777", nx::ToString<8>(~0ull));
+  EXPECT_EQ(std::string(64, '1'), nx::ToString<2>(~0ull));
+  // zero-padding and truncation
+  EXPECT_EQ("000000000000000000ff", nx::ToString<16>(255, 20));
+  EXPECT_EQ("0011", nx::ToString<2>(3, 4));
+  EXPECT_EQ("cdef", nx::ToString<16>(0x89abcdefu, 4));
+  EXPECT_EQ("-0a", nx::ToString<16>(-10, 2));
+  std::string text("0x");
+  EXPECT_EQ(8u, nx::ToString<16>(0xdeadbeefu, &text));
+  EXPECT_EQ("0xdeadbeef", text);
+  char buffer[32];
+  std::mt19937_64 random;
+  for (unsigned int i = 0; i < 1000; ++i) {
+    const nx::uint64_t value = random() >> (i % 64);
+    const unsigned long long printed = value;  // NOLINT(runtime/int)
+    char expected[32];
+    std::snprintf(expected, sizeof(expected), "%llo", printed);
+    EXPECT_EQ(expected, std::string(buffer, nx::ToString<8>(value, buffer)));
+    std::snprintf(expected, sizeof(expected), "%llx", printed);
+    EXPECT_EQ(expected, std::string(buffer, nx::ToString<16>(value, buffer)));
+    std::snprintf(expected, sizeof(expected), "%llX", printed);
+    EXPECT_EQ(expected, std::string(buffer,
+        nx::ToString<16, nx::LetterCase::kUpper>(value, buffer)));
+  }
+}
+
+TEST(ToStringTest, Hex) {
+  const unsigned char id[] = {0x01, 0x23, 0xab, 0xcd, 0xef};
+  std::string text;
+  EXPECT_EQ(10u, nx::ToHex(id, sizeof(id), &text));
+  EXPECT_EQ("0123abcdef", text);
+  text.clear();
+  nx::ToHex(id, sizeof(id), &text, nx::LetterCase::kUpper);
+  EXPECT_EQ("0123ABCDEF", text);
+  EXPECT_EQ(0u, nx::ToHex(id, 0, &text));
+}
+
+TEST(ToStringTest, HexKernels) {
+  using nx::detail::HexKernel;
+  const HexKernel kernels[] = {
+    HexKernel::kScalar,
+    HexKernel::kSsse3,
+    HexKernel::kAvx2
+  };
+  const nx::LetterCase cases[] = {
+    nx::LetterCase::kLower,
+    nx::LetterCase::kUpper
+  };
+  std::mt19937_64 random;
+  std::vector<nx::uint8_t> bytes(100);
+  for (nx::uint8_t&byte : bytes) {
+    byte = static_cast<nx::uint8_t>(random());
+  }
+  for (nx::LetterCase letter_case : cases) {
+    const char*format = letter_case == nx::LetterCase::kUpper ? "%02X" : "%02x";
+    std::string expected;
+    for (nx::uint8_t byte : bytes) {
+      char digits[3];
+      std::snprintf(digits, sizeof(digits), format, byte);
+      expected += digits;
+    }
+    for (HexKernel kernel : kernels) {
+      if (!nx::detail::HexSupported(kernel)) {
+        continue;
+      }
+      for (nx::size_t length = 0; length <= bytes.size(); ++length) {
+        std::string text(length * 2, '?');
+        nx::detail::WriteHex(kernel, bytes.data(), length, &text[0],
+                             letter_case);
+        EXPECT_EQ(expected.substr(0, length * 2), text)
+            << "kernel " << static_cast<int>(kernel) << ", length " << length;
+      }
+    }
+  }
+}
+
+TEST(ToStringTest, ArrayKernels) {
+  std::mt19937_64 random;
+  ExpectKernelsConvert<nx::uint64_t>(&random);
+  ExpectKernelsConvert<nx::int64_t>(&random);
+}
+
+#if defined(NX_HAS_INT128)
+TEST(ToStringTest, Int128) {
+  typedef nx::uint128_t uint128;
+  EXPECT_EQ("0", nx::ToString(static_cast<uint128>(0)));
+  EXPECT_EQ("18446744073709551616",
+            nx::ToString(static_cast<uint128>(1) << 64));
+  EXPECT_EQ("340282366920938463463374607431768211455",
+            nx::ToString(~static_cast<uint128>(0)));
+  const nx::int128_t min = static_cast<nx::int128_t>(
+      static_cast<uint128>(1) << 127);
+  EXPECT_EQ("-170141183460469231731687303715884105728", nx::ToString(min));
+  // Chunks whose leading digits are zero must be padded.
+  uint128 value = 1;
+  std::string expected("1");
+  for (unsigned int digits = 2; digits <= 39; ++digits) {
+    value *= 10;
+    expected += '0';
+    EXPECT_EQ(expected, nx::ToString(value));
+    EXPECT_EQ(expected.substr(0, digits - 1) + "1", nx::ToString(value + 1));
+  }
+  EXPECT_EQ("0000000000000000000000000018446744073709551616",
+            nx::ToString(static_cast<uint128>(1) << 64, 46));
+  EXPECT_EQ("709551616", nx::ToString(static_cast<uint128>(1) << 64, 9));
+  EXPECT_EQ("1768211455", nx::ToString(~static_cast<uint128>(0), 10));
+  EXPECT_EQ("0938463463374607431768211455",
+            nx::ToString(~static_cast<uint128>(0), 28));
+  EXPECT_EQ("10000000000000000",
+            nx::ToString<16>(static_cast<uint128>(1) << 64));
+  EXPECT_EQ(std::string(32, 'F'), (nx::ToString<16, nx::LetterCase::kUpper>(
+      ~static_cast<uint128>(0))));
+  EXPECT_EQ("-8" + std::string(31, '0'), nx::ToString<16>(min));
+  EXPECT_EQ("0000000000000000000000000000000000000001",
+            nx::ToString<16>(static_cast<uint128>(1), 40));
+  EXPECT_EQ("3" + std::string(42, '7'),
+            nx::ToString<8>(~static_cast<uint128>(0)));
+}
+#endif
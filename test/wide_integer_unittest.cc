@@ -0,0 +1,207 @@
+//
+// Copyright (C) 2013 Jacob McIntosh <nacitar at ubercpp dot com>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+/// @file wide_integer_unittest.cc
+/// @brief Unit tests for wide_integer.h
+
+#include <random>
+#include <string>
+#include <type_traits>
+#include "gtest/gtest.h"
+#include "nx/core.h"
+#include "nx/bit_scan_forward.h"
+#include "nx/bit_scan_reverse.h"
+#include "nx/digits.h"
+#include "nx/population_count.h"
+#include "nx/to_string.h"
+
+#define EXPECT_TYPE(x, y) EXPECT_TRUE((std::is_same<x, y>::value))
+
+namespace {
+
+typedef nx::WideUInt<256> uint256;
+typedef nx::WideUInt<512> uint512;
+
+/// @brief Provides 10 to the given power.
+template <class T>
+T PowerOf10(unsigned int power) {
+  T result = 1;
+  while (power--) {
+    result *= 10;
+  }
+  return result;
+}
+
+}  // namespace
+
+TEST(WideIntegerTest, Resolution) {
+  EXPECT_TYPE(nx::uint_t<256>, uint256);
+  EXPECT_TYPE(nx::uint_t<512>, uint512);
+  EXPECT_TYPE(nx::uint_least_t<129>, nx::WideUInt<192>);
+  EXPECT_TYPE(nx::uint_least_t<300>, nx::WideUInt<320>);
+#if !defined(NX_HAS_INT128)
+  EXPECT_TYPE(nx::uint_t<128>, nx::WideUInt<128>);
+#endif
+  EXPECT_EQ(256u, nx::BitSize<uint256>::value);
+  EXPECT_EQ(512u, nx::BitSize<uint512>::value);
+  EXPECT_TRUE(nx::IsWideUInt<uint256>::value);
+  EXPECT_FALSE(nx::IsWideUInt<unsigned int>::value);
+}
+
+TEST(WideIntegerTest, Conversion) {
+  const uint256 all = -1;
+  for (unsigned int i = 0; i < uint256::kWords; ++i) {
+    EXPECT_EQ(~0ull, all.word(i));
+  }
+  EXPECT_TRUE(all == ~uint256());
+  const uint256 small = 1234u;
+  EXPECT_EQ(1234u, small.word(0));
+  EXPECT_EQ(0u, small.word(1));
+  EXPECT_TRUE(small.FitsWord());
+  EXPECT_FALSE(all.FitsWord());
+  EXPECT_EQ(1234u, static_cast<unsigned int>(small));
+  EXPECT_EQ(0xffu, static_cast<unsigned char>(all));
+  EXPECT_TRUE(static_cast<bool>(small));
+  EXPECT_FALSE(static_cast<bool>(uint256()));
+  const uint512 widened(all);
+  EXPECT_EQ(~0ull, widened.word(3));
+  EXPECT_EQ(0u, widened.word(4));
+  EXPECT_TRUE(uint256(widened) == all);
+  constexpr uint256 constant(5);
+  static_assert(constant.word(0) == 5, "constexpr construction");
+}
+
+TEST(WideIntegerTest, Arithmetic) {
+  const uint256 max = -1;
+  EXPECT_TRUE(max + 1 == 0);
+  EXPECT_TRUE(uint256() - 1 == max);
+  EXPECT_TRUE(max * max == 1);
+  EXPECT_TRUE(-uint256(1) == max);
+  uint256 value = max;
+  EXPECT_TRUE(++value == 0);
+  EXPECT_TRUE(value-- == 0);
+  EXPECT_TRUE(value == max);
+  // carries across every word
+  const uint256 word_carry = (uint256(1) << 192) - 1;
+  EXPECT_TRUE(word_carry + 1 == uint256(1) << 192);
+  EXPECT_EQ("10000000000000000000000000000030000000007000000000000000000000000"
+            "000021",
+            nx::ToString((PowerOf10<uint256>(40) + 7)
+                         * (PowerOf10<uint256>(30) + 3)));
+  uint512 power = 1;
+  for (unsigned int i = 0; i < 300; ++i) {
+    power *= 3;
+  }
+  EXPECT_EQ("136891479058588375991326027382088315966463695625337436471480190"
+            "078368997177499076593800206155688941388250484440597994042813512"
+            "732765695774566001",
+            nx::ToString(power));
+}
+
+TEST(WideIntegerTest, Division) {
+  std::mt19937_64 random;
+  for (unsigned int trial = 0; trial < 200; ++trial) {
+    uint256 a;
+    uint256 b;
+    uint256 c;
+    for (unsigned int i = 0; i < 2; ++i) {
+      a.data()[i] = random();
+      b.data()[i] = random();
+    }
+    // keep b above a word for some trials, so long division is used
+    b.data()[trial % 2] |= 1;
+    c = uint256(random()) % b;
+    EXPECT_TRUE((a * b + c) / b == a);
+    EXPECT_TRUE((a * b + c) % b == c);
+  }
+  uint256 value = PowerOf10<uint256>(50) + 12345;
+  EXPECT_EQ(12345u, value.DivideBy(100000));
+  EXPECT_TRUE(value == PowerOf10<uint256>(45));
+}
+
+TEST(WideIntegerTest, BitwiseAndComparison) {
+  const uint256 one = 1;
+  for (unsigned int shift = 0; shift < 256; ++shift) {
+    const uint256 bit = one << shift;
+    EXPECT_TRUE(bit >> shift == one);
+    EXPECT_EQ(shift, nx::BitScanForward(bit));
+    EXPECT_EQ(shift, nx::BitScanReverse(bit));
+    EXPECT_EQ(1u, nx::PopulationCount(bit));
+    EXPECT_TRUE(bit > bit - 1);
+    EXPECT_TRUE(bit - 1 < bit);
+    EXPECT_TRUE(bit <= bit);
+    EXPECT_FALSE(bit != bit);
+  }
+  EXPECT_TRUE(one << 256 == 0);
+  const uint256 pattern = (uint256(0xff00ff00ff00ff00ull) << 100) | 0xf0;
+  EXPECT_EQ(36u, nx::PopulationCount(pattern));
+  EXPECT_TRUE(((pattern ^ pattern) & pattern) == 0);
+  EXPECT_TRUE((pattern >> 100 & 0xffff) == 0xff00u);
+  EXPECT_EQ(256u, nx::PopulationCount(~uint256()));
+  EXPECT_EQ(0u, nx::BitScanReverse(uint256()));
+}
+
+TEST(WideIntegerTest, Text) {
+  EXPECT_EQ(78u, nx::Digits(~uint256()));
+  EXPECT_EQ(155u, nx::Digits(~uint512()));
+  EXPECT_EQ(1u, nx::Digits(uint256()));
+  for (unsigned int digits = 1; digits < 78; ++digits) {
+    const uint256 power = PowerOf10<uint256>(digits);
+    EXPECT_EQ(digits, nx::Digits(power - 1));
+    EXPECT_EQ(digits + 1, nx::Digits(power));
+    EXPECT_EQ("1" + std::string(digits, '0'), nx::ToString(power));
+  }
+  EXPECT_EQ("115792089237316195423570985008687907853269984665640564039457584"
+            "007913129639935",
+            nx::ToString(~uint256()));
+  EXPECT_EQ("134078079299425970995740249982058461274793658205923933777235614"
+            "437217640300735469768018742981669034276900318581864860508537538"
+            "82811946569946433649006084095",
+            nx::ToString(~uint512()));
+  EXPECT_EQ("0", nx::ToString(uint256()));
+  EXPECT_EQ("00012", nx::ToString(uint256(12), 5));
+  EXPECT_EQ("9639935", nx::ToString(~uint256(), 7));
+  EXPECT_EQ("4007913129639935", nx::ToString(~uint256(), 16));
+  EXPECT_EQ("0000000042", nx::ToString(uint256(42), 10));
+  std::string text("x=");
+  EXPECT_EQ(2u, nx::ToString(uint256(42), &text));
+  EXPECT_EQ("x=42", text);
+}
+
+#if defined(NX_HAS_INT128)
+TEST(WideIntegerTest, MatchesInt128) {
+  typedef nx::WideUInt<128> wide;
+  typedef nx::uint128_t native;
+  std::mt19937_64 random;
+  for (unsigned int trial = 0; trial < 1000; ++trial) {
+    const native a = static_cast<native>(random()) << 64 | random();
+    const native b = static_cast<native>(random() >> (trial % 64)) << 64
+        | random();
+    const unsigned int shift = random() % 128;
+    const wide wide_a = a;
+    const wide wide_b = b;
+    EXPECT_TRUE(static_cast<native>(wide_a + wide_b) == a + b);
+    EXPECT_TRUE(static_cast<native>(wide_a - wide_b) == a - b);
+    EXPECT_TRUE(static_cast<native>(wide_a * wide_b) == a * b);
+    EXPECT_TRUE(static_cast<native>(wide_a / wide_b) == a / b);
+    EXPECT_TRUE(static_cast<native>(wide_a % wide_b) == a % b);
+    EXPECT_TRUE(static_cast<native>(wide_a << shift) == a << shift);
+    EXPECT_TRUE(static_cast<native>(wide_a >> shift) == a >> shift);
+    EXPECT_EQ(a < b, wide_a < wide_b);
+    EXPECT_EQ(nx::ToString(a), nx::ToString(wide_a));
+  }
+}
+#endif